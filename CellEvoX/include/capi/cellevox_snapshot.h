@@ -0,0 +1,124 @@
+#ifndef CELLEVOX_SNAPSHOT_H
+#define CELLEVOX_SNAPSHOT_H
+
+/* C ABI over the population snapshot readers in io/PopulationSnapshotIO.hpp, built as the
+ * cellevox_snapshot shared library so that Python (ctypes), R or Julia can read snapshots
+ * without re-implementing the binary format.
+ *
+ * Columns are returned as (pointer, length, stride, type) descriptors into memory owned by the
+ * snapshot handle. For v2 snapshots they point straight into the memory-mapped file; v3
+ * (columnar) and older layouts are decoded once when the snapshot is opened. Either way a
+ * caller can wrap a column as an array with no per-row work. Column memory stays valid until
+ * cellevox_snapshot_close.
+ *
+ * Functions that can fail return NULL or a non-zero status; cellevox_last_error() then
+ * describes the failure for the calling thread. Handles are not thread-safe, but distinct
+ * handles may be used from different threads. */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(CELLEVOX_SNAPSHOT_BUILD)
+#define CELLEVOX_SNAPSHOT_API __declspec(dllexport)
+#else
+#define CELLEVOX_SNAPSHOT_API __declspec(dllimport)
+#endif
+#else
+#define CELLEVOX_SNAPSHOT_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a declaration below changes incompatibly. */
+#define CELLEVOX_SNAPSHOT_ABI_VERSION 1
+
+typedef struct cellevox_snapshot cellevox_snapshot; /* one generation */
+typedef struct cellevox_run cellevox_run;           /* the generations stored by a run */
+
+/* Per-record columns have cellevox_snapshot_info.record_count values; the PAYLOAD_MUTATION_*
+ * columns have cellevox_snapshot_info.mutation_count. A record's mutations are entries
+ * [PAYLOAD_OFFSET, PAYLOAD_OFFSET + PAYLOAD_COUNT) of the payload columns. */
+typedef enum cellevox_column_id {
+  CELLEVOX_COLUMN_ID = 0,
+  CELLEVOX_COLUMN_PARENT_ID = 1,
+  CELLEVOX_COLUMN_FITNESS = 2,
+  CELLEVOX_COLUMN_X = 3,
+  CELLEVOX_COLUMN_Y = 4,
+  CELLEVOX_COLUMN_Z = 5,
+  CELLEVOX_COLUMN_MUTATION_COUNT = 6,
+  CELLEVOX_COLUMN_PAYLOAD_COUNT = 7,
+  CELLEVOX_COLUMN_PAYLOAD_OFFSET = 8,
+  CELLEVOX_COLUMN_POSITION_VALID = 9,
+  CELLEVOX_COLUMN_PAYLOAD_MUTATION_ID = 10,
+  CELLEVOX_COLUMN_PAYLOAD_MUTATION_TYPE = 11,
+  CELLEVOX_COLUMN_COUNT = 12
+} cellevox_column_id;
+
+typedef enum cellevox_value_type {
+  CELLEVOX_TYPE_UINT8 = 0,
+  CELLEVOX_TYPE_UINT16 = 1,
+  CELLEVOX_TYPE_UINT32 = 2,
+  CELLEVOX_TYPE_FLOAT32 = 3
+} cellevox_value_type;
+
+typedef struct cellevox_column {
+  const void* data; /* first value; NULL when length is 0 */
+  uint64_t length;  /* number of values */
+  uint64_t stride;  /* bytes between consecutive values */
+  int32_t type;     /* cellevox_value_type; values are little-endian and may be unaligned */
+  int32_t reserved;
+} cellevox_column;
+
+/* Header fields of one snapshot. */
+typedef struct cellevox_snapshot_info {
+  double tau;
+  uint64_t record_count;
+  uint64_t mutation_count;
+  uint32_t format_version;     /* on-disk version 1, 2 or 3; 0 for legacy headerless files */
+  uint8_t spatial_dimensions;  /* 0, 2 or 3 */
+  uint8_t has_mutation_payload; /* payload columns hold driver (or all, see below) mutations */
+  uint8_t full_mutation_payload; /* payload holds every mutation, not just drivers */
+  uint8_t zero_copy;           /* columns point into the file mapping; v2 rows only, other
+                                  versions are decoded into library-owned rows on open */
+} cellevox_snapshot_info;
+
+CELLEVOX_SNAPSHOT_API uint32_t cellevox_snapshot_abi_version(void);
+
+/* Description of the last failure on the calling thread; never NULL. */
+CELLEVOX_SNAPSHOT_API const char* cellevox_last_error(void);
+
+/* Opens a population_generation_<n>.bin file. */
+CELLEVOX_SNAPSHOT_API cellevox_snapshot* cellevox_snapshot_open(const char* path);
+/* Opens the snapshot stored at bytes [offset, offset + size) of path, e.g. one frame of
+ * population_snapshots.bin located through its index. */
+CELLEVOX_SNAPSHOT_API cellevox_snapshot* cellevox_snapshot_open_range(const char* path,
+                                                                      uint64_t offset,
+                                                                      uint64_t size);
+CELLEVOX_SNAPSHOT_API void cellevox_snapshot_close(cellevox_snapshot* snapshot);
+CELLEVOX_SNAPSHOT_API int cellevox_snapshot_info_get(const cellevox_snapshot* snapshot,
+                                                     cellevox_snapshot_info* info);
+CELLEVOX_SNAPSHOT_API int cellevox_snapshot_column(const cellevox_snapshot* snapshot,
+                                                   int32_t column,
+                                                   cellevox_column* out);
+
+/* Lists the generations stored under a run directory, or its population_data directory:
+ * the frames of population_snapshots.bin when the run wrote a container, otherwise the
+ * population_generation_<n>.bin files. Generations are in ascending order. Generations that
+ * exist only in an event log are not listed. */
+CELLEVOX_SNAPSHOT_API cellevox_run* cellevox_run_open(const char* directory);
+CELLEVOX_SNAPSHOT_API void cellevox_run_close(cellevox_run* run);
+CELLEVOX_SNAPSHOT_API uint64_t cellevox_run_generation_count(const cellevox_run* run);
+/* Generation number at index [0, generation_count); -1 when out of range. */
+CELLEVOX_SNAPSHOT_API int64_t cellevox_run_generation(const cellevox_run* run, uint64_t index);
+/* Opens the snapshot at index; container frames share the run's mapping. The snapshot may
+ * outlive the run handle. */
+CELLEVOX_SNAPSHOT_API cellevox_snapshot* cellevox_run_open_snapshot(const cellevox_run* run,
+                                                                    uint64_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELLEVOX_SNAPSHOT_H */
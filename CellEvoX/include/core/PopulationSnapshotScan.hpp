@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ecs/Run.hpp"
+#include "io/PopulationSnapshotIO.hpp"
+
+namespace CellEvoX::core {
+
+// One stored generation as handed to the scan visitors. The spans are valid only during
+// PopulationSnapshotVisitor::visit.
+struct PopulationSnapshotFrame {
+  int generation = 0;
+  io::PopulationSnapshotFileHeader header{};
+  std::span<const io::PopulationSnapshotRecord> records;
+  std::span<const io::PopulationSnapshotDriverMutation> mutations;
+};
+
+// A post-run analysis fed by scanPopulationSnapshots. visit() is called concurrently for
+// different generations and in no particular order, so per-generation results must go into
+// thread-safe storage; finish() is called once on the scanning thread after the last visit.
+class PopulationSnapshotVisitor {
+ public:
+  virtual ~PopulationSnapshotVisitor() = default;
+  virtual void visit(const PopulationSnapshotFrame& frame) = 0;
+  virtual void finish() {}
+};
+
+// Reads every generation stored under output_dir exactly once and hands each decoded frame to
+// all visitors. Sources are tried in the same order as the analysis tools: the event log, then
+// the snapshot container, then per-generation .bin files. Container and file frames are
+// decoded and visited in parallel through a TBB pipeline with at most max_frames_in_flight
+// frames alive (0 picks twice the arena concurrency); event-log generations are replayed in
+// order and visited in batches of that size. Returns the number of generations visited.
+size_t scanPopulationSnapshots(const std::string& output_dir,
+                               std::span<PopulationSnapshotVisitor* const> visitors,
+                               size_t max_frames_in_flight = 0);
+
+// Hands every generation a run kept in memory to all visitors, as the frames
+// scanPopulationSnapshots would decode from the stored snapshots: no positions, and a payload of
+// the driver mutations, or of all mutations when full_mutation_payload is set. Generations are
+// converted and visited in parallel. Returns the number of generations visited.
+size_t scanPopulationReports(const std::vector<std::pair<int, ecs::CellMap>>& reports,
+                             const std::map<uint8_t, MutationType>& mutation_types,
+                             bool full_mutation_payload,
+                             std::span<PopulationSnapshotVisitor* const> visitors);
+
+}  // namespace CellEvoX::core
@@ -10,6 +10,15 @@
 
 namespace CellEvoX::core {
 
+// Post-run analyses that consume the population snapshots. The in-memory reports or the stored
+// snapshots are walked once for all enabled analyses.
+struct PopulationAnalyses {
+  bool csv_export = true;          // population_data/population_generation_<n>.csv (+ .arrow)
+  bool mutation_wave = true;       // mutation_histograms/
+  bool mutation_frequency = true;  // vaf_diagrams/
+  bool clone_populations = true;   // population_data/clone_populations.csv
+};
+
 class RunDataEngine {
  public:
   RunDataEngine(std::shared_ptr<SimulationConfig> config,
@@ -19,12 +28,18 @@ class RunDataEngine {
                 
   RunDataEngine(const std::string& analyze_directory);
 
+  // Continues writing into the existing output directory of a run resumed from a checkpoint.
+  RunDataEngine(std::shared_ptr<SimulationConfig> config,
+                const std::string& run_directory,
+                double generation_step = 0.005);
+
   void setRun(std::shared_ptr<ecs::Run> run);
 
   // Generate a graph in Graphviz DOT format
   void prepareOutputDir();
-  void exportToCSV();
+  void exportToCSV(bool include_population_snapshots = true);
   void exportPopulationSnapshotsToCSV();
+  void analyzePopulationSnapshots(const PopulationAnalyses& analyses = {});
   void plotLivingCellsOverGenerations();
   void plotFitnessStatistics();
   void plotMutationsStatistics();
@@ -40,6 +55,8 @@ class RunDataEngine {
   void exportPhylogeneticTreeToGEXF(const std::string& filename);
   // void exportToCSV(const tbb::concurrent_vector<Cell>& cells, const std::string& output_file);
  private:
+  void scanPopulation(const PopulationAnalyses& analyses);
+
   double generation_step;  // Time step for separating generations
   std::shared_ptr<SimulationConfig> config;
   std::shared_ptr<ecs::Run> run;
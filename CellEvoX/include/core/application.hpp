@@ -1,14 +1,17 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "io/EngineCheckpoint.hpp"
 #include "systems/SimulationEngine.hpp"
 
 class SimulationEngine3D;
 class SimulationEngine3DCapacity;
+class SimulationEngine3DLattice;
 
 namespace CellEvoX::core {
 
@@ -20,6 +23,7 @@ enum class PostprocessMode {
 struct CliOptions {
   std::optional<std::string> config_path;
   std::optional<std::string> analyze_path;
+  std::optional<std::string> resume_path;
   std::optional<std::size_t> max_threads;
   PostprocessMode postprocess_mode = PostprocessMode::Full;
 };
@@ -34,10 +38,13 @@ class Application {
   float calculateDeltaTime();
 
  private:
+  void runSimulation(uint32_t steps, const CellEvoX::io::EngineCheckpoint* resume);
+
   CliOptions options;
   std::unique_ptr<SimulationEngine> sim_engine;
   std::unique_ptr<SimulationEngine3D> sim_engine_3d;
   std::unique_ptr<SimulationEngine3DCapacity> sim_engine_3d_capacity;
+  std::unique_ptr<SimulationEngine3DLattice> sim_engine_3d_lattice;
   std::shared_ptr<SimulationConfig> sim_config;
   std::vector<std::shared_ptr<ecs::Run>> runs;
 };
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CellEvoX::io {
+
+// Minimal Apache Arrow IPC *file* writer (the Feather v2 format): one schema and one record
+// batch of integer, floating-point and large_utf8 columns, little-endian, metadata version V5.
+// Enough for pyarrow.ipc.open_file / pandas.read_feather / polars.read_ipc to memory-map the
+// result without parsing. The FlatBuffers metadata is encoded by the small builder below, so no
+// Arrow or FlatBuffers dependency is needed.
+
+// Column buffers and metadata scalars are copied in host byte order.
+static_assert(std::endian::native == std::endian::little,
+              "ArrowIpcWriter writes host byte order and requires a little-endian target");
+
+namespace detail {
+
+// Back-to-front FlatBuffers encoder covering tables, strings, offset vectors and struct
+// vectors. Offsets returned by the create/end calls count bytes from the end of the buffer, as
+// in the reference builder.
+class FlatBufferBuilder {
+ public:
+  uint32_t createString(std::string_view text) {
+    align(4, text.size() + 1);
+    pushBytes("\0", 1);
+    pushBytes(text.data(), text.size());
+    pushScalar(static_cast<uint32_t>(text.size()));
+    return size_;
+  }
+
+  uint32_t createOffsetVector(const std::vector<uint32_t>& offsets) {
+    align(4, 4 * offsets.size());
+    for (auto it = offsets.rbegin(); it != offsets.rend(); ++it) {
+      pushOffset(*it);
+    }
+    pushScalar(static_cast<uint32_t>(offsets.size()));
+    return size_;
+  }
+
+  template <typename Struct>
+  uint32_t createStructVector(const std::vector<Struct>& structs) {
+    align(std::max<size_t>(alignof(Struct), 4), sizeof(Struct) * structs.size());
+    pushBytes(structs.data(), sizeof(Struct) * structs.size());
+    pushScalar(static_cast<uint32_t>(structs.size()));
+    return size_;
+  }
+
+  void startTable() {
+    fields_.clear();
+    table_start_ = size_;
+  }
+
+  template <typename T>
+  void addScalar(uint16_t field, T value) {
+    pushScalar(value);
+    fields_.push_back({field, size_});
+  }
+
+  void addOffset(uint16_t field, uint32_t offset) {
+    pushOffset(offset);
+    fields_.push_back({field, size_});
+  }
+
+  uint32_t endTable() {
+    pushScalar(int32_t{0});  // soffset to the vtable, patched below
+    const uint32_t table = size_;
+
+    uint16_t field_count = 0;
+    for (const auto& [field, offset] : fields_) {
+      field_count = std::max<uint16_t>(field_count, field + 1);
+    }
+    std::vector<uint16_t> slots(field_count, 0);
+    for (const auto& [field, offset] : fields_) {
+      slots[field] = static_cast<uint16_t>(table - offset);
+    }
+    for (auto it = slots.rbegin(); it != slots.rend(); ++it) {
+      pushScalar(*it);
+    }
+    pushScalar(static_cast<uint16_t>(table - table_start_));
+    pushScalar(static_cast<uint16_t>(4 + 2 * field_count));
+    const uint32_t vtable = size_;
+
+    const auto soffset = static_cast<int32_t>(vtable - table);
+    std::memcpy(at(table), &soffset, sizeof(soffset));
+    return table;
+  }
+
+  // Finishes with `root` as the root table; the bytes are then [data(), data() + size()).
+  void finish(uint32_t root) {
+    align(max_align_, 4);
+    pushOffset(root);
+  }
+
+  const uint8_t* data() const { return bytes_.data() + bytes_.size() - size_; }
+  size_t size() const { return size_; }
+
+ private:
+  uint8_t* at(uint32_t offset) { return bytes_.data() + bytes_.size() - offset; }
+
+  void grow(size_t count) {
+    if (bytes_.size() - size_ >= count) {
+      return;
+    }
+    std::vector<uint8_t> grown(std::max<size_t>(2 * bytes_.size(), size_ + count + 256));
+    std::copy(bytes_.end() - static_cast<std::ptrdiff_t>(size_), bytes_.end(),
+              grown.end() - static_cast<std::ptrdiff_t>(size_));
+    bytes_ = std::move(grown);
+  }
+
+  void pushBytes(const void* data, size_t count) {
+    grow(count);
+    size_ += static_cast<uint32_t>(count);
+    std::memcpy(at(size_), data, count);
+  }
+
+  // Pads so that, after `additional` more bytes, the write position is a multiple of `alignment`.
+  void align(size_t alignment, size_t additional = 0) {
+    max_align_ = std::max(max_align_, alignment);
+    const size_t padding = (alignment - (size_ + additional) % alignment) % alignment;
+    static constexpr std::array<uint8_t, 16> kZeros{};
+    pushBytes(kZeros.data(), padding);
+  }
+
+  template <typename T>
+  void pushScalar(T value) {
+    align(sizeof(T));
+    pushBytes(&value, sizeof(T));
+  }
+
+  void pushOffset(uint32_t offset) {
+    align(4);
+    pushScalar(size_ + 4 - offset);
+  }
+
+  std::vector<uint8_t> bytes_;
+  uint32_t size_ = 0;
+  size_t max_align_ = 1;
+  uint32_t table_start_ = 0;
+  std::vector<std::pair<uint16_t, uint32_t>> fields_;
+};
+
+// Arrow format structs, laid out as in Message.fbs / File.fbs.
+struct ArrowFieldNode {
+  int64_t length;
+  int64_t null_count;
+};
+struct ArrowBuffer {
+  int64_t offset;
+  int64_t length;
+};
+struct ArrowBlock {
+  int64_t offset;
+  int32_t meta_data_length;
+  int32_t padding;
+  int64_t body_length;
+};
+
+inline constexpr int16_t kArrowMetadataV5 = 4;
+inline constexpr uint8_t kArrowMessageSchema = 1;
+inline constexpr uint8_t kArrowMessageRecordBatch = 3;
+inline constexpr uint8_t kArrowTypeInt = 2;
+inline constexpr uint8_t kArrowTypeFloatingPoint = 3;
+inline constexpr uint8_t kArrowTypeLargeUtf8 = 20;
+
+inline size_t arrowPadded(size_t size) { return (size + 7) & ~size_t{7}; }
+
+}  // namespace detail
+
+// Column-major table written as a single Arrow record batch. Columns are added in order and
+// must all hold row_count values.
+class ArrowTable {
+ public:
+  explicit ArrowTable(size_t row_count) : row_count_(row_count) {}
+
+  size_t rowCount() const { return row_count_; }
+
+  template <typename T>
+    requires(std::integral<T> || std::floating_point<T>)
+  void addColumn(std::string name, const std::vector<T>& values) {
+    addColumn(std::move(name), values, {});
+  }
+
+  // `valid` holds one byte per row (non-zero = valid); rows with valid == 0 are null.
+  template <typename T>
+    requires(std::integral<T> || std::floating_point<T>)
+  void addColumn(std::string name,
+                 const std::vector<T>& values,
+                 const std::vector<uint8_t>& valid) {
+    Column column;
+    column.name = std::move(name);
+    column.bit_width = static_cast<int32_t>(8 * sizeof(T));
+    column.is_float = std::floating_point<T>;
+    column.is_signed = std::is_signed_v<T>;
+    column.data.resize(values.size() * sizeof(T));
+    std::memcpy(column.data.data(), values.data(), column.data.size());
+    setValidity(column, valid);
+    columns_.push_back(std::move(column));
+  }
+
+  // UTF-8 strings with 64-bit offsets (Arrow large_utf8); offsets has row_count + 1 entries.
+  void addStringColumn(std::string name,
+                       const std::vector<int64_t>& offsets,
+                       std::string_view text) {
+    Column column;
+    column.name = std::move(name);
+    column.is_string = true;
+    column.offsets.resize(offsets.size() * sizeof(int64_t));
+    std::memcpy(column.offsets.data(), offsets.data(), column.offsets.size());
+    column.data.assign(text.begin(), text.end());
+    columns_.push_back(std::move(column));
+  }
+
+  // Schema-level key/value metadata, e.g. the snapshot's generation and tau.
+  void addMetadata(std::string key, std::string value) {
+    metadata_.emplace_back(std::move(key), std::move(value));
+  }
+
+  bool write(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    static constexpr char kMagic[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+    file.write(kMagic, sizeof(kMagic));
+    int64_t position = sizeof(kMagic);
+
+    // Body layout: per column a validity bitmap (empty when there are no nulls), then the
+    // offsets for strings, then the values, each padded to 8 bytes.
+    std::vector<detail::ArrowFieldNode> nodes;
+    std::vector<detail::ArrowBuffer> buffers;
+    int64_t body_length = 0;
+    const auto add_buffer = [&](size_t length) {
+      buffers.push_back({body_length, static_cast<int64_t>(length)});
+      body_length += static_cast<int64_t>(detail::arrowPadded(length));
+    };
+    for (const auto& column : columns_) {
+      nodes.push_back({static_cast<int64_t>(row_count_), column.null_count});
+      add_buffer(column.validity.size());
+      if (column.is_string) {
+        add_buffer(column.offsets.size());
+      }
+      add_buffer(column.data.size());
+    }
+
+    const auto schema_message = encodeMessage(detail::kArrowMessageSchema, 0, [&](auto& builder) {
+      return encodeSchema(builder);
+    });
+    writeMessage(file, position, schema_message);
+
+    const auto batch_message =
+        encodeMessage(detail::kArrowMessageRecordBatch, body_length, [&](auto& builder) {
+          const uint32_t node_vector = builder.createStructVector(nodes);
+          const uint32_t buffer_vector = builder.createStructVector(buffers);
+          builder.startTable();
+          builder.addScalar(0, static_cast<int64_t>(row_count_));
+          builder.addOffset(1, node_vector);
+          builder.addOffset(2, buffer_vector);
+          return builder.endTable();
+        });
+    const int64_t batch_offset = position;
+    const int32_t batch_metadata = writeMessage(file, position, batch_message);
+    static constexpr std::array<char, 8> kZeros{};
+    for (const auto& column : columns_) {
+      for (const auto* buffer : {&column.validity, &column.offsets, &column.data}) {
+        if (buffer == &column.offsets && !column.is_string) {
+          continue;
+        }
+        file.write(reinterpret_cast<const char*>(buffer->data()),
+                   static_cast<std::streamsize>(buffer->size()));
+        const size_t padding = detail::arrowPadded(buffer->size()) - buffer->size();
+        file.write(kZeros.data(), static_cast<std::streamsize>(padding));
+      }
+    }
+    position += body_length;
+
+    // Footer: the schema again plus the location of the record batch.
+    detail::FlatBufferBuilder footer;
+    const uint32_t schema = encodeSchema(footer);
+    const uint32_t blocks = footer.createStructVector(
+        std::vector<detail::ArrowBlock>{{batch_offset, batch_metadata, 0, body_length}});
+    const uint32_t dictionaries = footer.createStructVector(std::vector<detail::ArrowBlock>{});
+    footer.startTable();
+    footer.addScalar(0, detail::kArrowMetadataV5);
+    footer.addOffset(1, schema);
+    footer.addOffset(2, dictionaries);
+    footer.addOffset(3, blocks);
+    footer.finish(footer.endTable());
+    file.write(reinterpret_cast<const char*>(footer.data()),
+               static_cast<std::streamsize>(footer.size()));
+    const auto footer_size = static_cast<int32_t>(footer.size());
+    file.write(reinterpret_cast<const char*>(&footer_size), sizeof(footer_size));
+    file.write(kMagic, 6);
+    return file.good();
+  }
+
+ private:
+  struct Column {
+    std::string name;
+    int32_t bit_width = 0;
+    bool is_float = false;
+    bool is_signed = false;
+    bool is_string = false;
+    int64_t null_count = 0;
+    std::vector<uint8_t> validity;  // empty when every row is valid
+    std::vector<uint8_t> offsets;
+    std::vector<uint8_t> data;
+  };
+
+  void setValidity(Column& column, const std::vector<uint8_t>& valid) const {
+    const auto nulls = static_cast<int64_t>(std::count(valid.begin(), valid.end(), uint8_t{0}));
+    if (valid.empty() || nulls == 0) {
+      return;
+    }
+    column.null_count = nulls;
+    column.validity.assign((row_count_ + 7) / 8, 0);
+    for (size_t row = 0; row < row_count_ && row < valid.size(); ++row) {
+      if (valid[row] != 0) {
+        column.validity[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+      }
+    }
+  }
+
+  uint32_t encodeSchema(detail::FlatBufferBuilder& builder) const {
+    std::vector<uint32_t> fields;
+    for (const auto& column : columns_) {
+      uint8_t type_id = detail::kArrowTypeLargeUtf8;
+      builder.startTable();
+      if (column.is_string) {
+        // Utf8-family type tables have no fields.
+      } else if (column.is_float) {
+        type_id = detail::kArrowTypeFloatingPoint;
+        builder.addScalar(0, static_cast<int16_t>(column.bit_width == 32 ? 1 : 2));
+      } else {
+        type_id = detail::kArrowTypeInt;
+        builder.addScalar(0, column.bit_width);
+        builder.addScalar(1, static_cast<uint8_t>(column.is_signed));
+      }
+      const uint32_t type = builder.endTable();
+      const uint32_t name = builder.createString(column.name);
+      const uint32_t children = builder.createOffsetVector({});
+      builder.startTable();
+      builder.addOffset(0, name);
+      builder.addScalar(1, static_cast<uint8_t>(column.null_count > 0));
+      builder.addScalar(2, type_id);
+      builder.addOffset(3, type);
+      builder.addOffset(5, children);
+      fields.push_back(builder.endTable());
+    }
+
+    std::vector<uint32_t> key_values;
+    for (const auto& [key, value] : metadata_) {
+      const uint32_t key_offset = builder.createString(key);
+      const uint32_t value_offset = builder.createString(value);
+      builder.startTable();
+      builder.addOffset(0, key_offset);
+      builder.addOffset(1, value_offset);
+      key_values.push_back(builder.endTable());
+    }
+
+    const uint32_t field_vector = builder.createOffsetVector(fields);
+    const uint32_t metadata_vector = builder.createOffsetVector(key_values);
+    builder.startTable();
+    builder.addScalar(0, int16_t{0});  // little-endian
+    builder.addOffset(1, field_vector);
+    builder.addOffset(2, metadata_vector);
+    return builder.endTable();
+  }
+
+  template <typename EncodeHeader>
+  static std::vector<uint8_t> encodeMessage(uint8_t header_type,
+                                            int64_t body_length,
+                                            EncodeHeader&& encode_header) {
+    detail::FlatBufferBuilder builder;
+    const uint32_t header = encode_header(builder);
+    builder.startTable();
+    builder.addScalar(0, detail::kArrowMetadataV5);
+    builder.addScalar(1, header_type);
+    builder.addOffset(2, header);
+    builder.addScalar(3, body_length);
+    builder.finish(builder.endTable());
+    return {builder.data(), builder.data() + builder.size()};
+  }
+
+  // Writes an encapsulated message header (continuation marker, padded metadata length,
+  // metadata) and returns the metadata block length recorded in the footer.
+  static int32_t writeMessage(std::ofstream& file,
+                              int64_t& position,
+                              const std::vector<uint8_t>& metadata) {
+    static constexpr std::array<char, 8> kZeros{};
+    const auto padded = static_cast<int32_t>(detail::arrowPadded(metadata.size() + 8) - 8);
+    const uint32_t continuation = 0xFFFFFFFFu;
+    file.write(reinterpret_cast<const char*>(&continuation), sizeof(continuation));
+    file.write(reinterpret_cast<const char*>(&padded), sizeof(padded));
+    file.write(reinterpret_cast<const char*>(metadata.data()),
+               static_cast<std::streamsize>(metadata.size()));
+    file.write(kZeros.data(), static_cast<std::streamsize>(padded - metadata.size()));
+    position += 8 + padded;
+    return 8 + padded;
+  }
+
+  size_t row_count_;
+  std::vector<Column> columns_;
+  std::vector<std::pair<std::string, std::string>> metadata_;
+};
+
+}  // namespace CellEvoX::io
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace CellEvoX::io {
+
+// Byte-oriented LZ77 block codec in the spirit of LZ4, so snapshots need no external
+// compression library. A block is a sequence of
+//   token (literal length << 4 | match length - kMinMatch), [literal length bytes],
+//   literals, offset (uint16 LE), [match length bytes]
+// where a nibble of 15 continues in 255-saturated extension bytes. The final sequence holds
+// literals only and ends the block. Greedy single-probe hash matching over a 64 KiB window:
+// compression is one pass with O(1) work per input byte, decompression is a plain copy loop.
+namespace detail {
+
+constexpr size_t kLzMinMatch = 4;
+constexpr size_t kLzMaxOffset = 65535;
+constexpr int kLzHashBits = 14;
+
+inline uint32_t lzHash(const uint8_t* bytes) {
+  uint32_t word = 0;
+  std::memcpy(&word, bytes, sizeof(word));
+  return (word * 2654435761u) >> (32 - kLzHashBits);
+}
+
+inline void lzWriteLength(std::vector<uint8_t>& out, size_t length) {
+  while (length >= 255) {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+inline void lzWriteSequence(std::vector<uint8_t>& out,
+                            const uint8_t* literals,
+                            size_t literal_length,
+                            size_t match_offset,
+                            size_t match_length) {
+  const size_t match_code = match_length == 0 ? 0 : match_length - kLzMinMatch;
+  out.push_back(static_cast<uint8_t>((std::min<size_t>(literal_length, 15) << 4) |
+                                     std::min<size_t>(match_code, 15)));
+  if (literal_length >= 15) {
+    lzWriteLength(out, literal_length - 15);
+  }
+  out.insert(out.end(), literals, literals + literal_length);
+  if (match_length == 0) {
+    return;
+  }
+  out.push_back(static_cast<uint8_t>(match_offset & 0xFF));
+  out.push_back(static_cast<uint8_t>(match_offset >> 8));
+  if (match_code >= 15) {
+    lzWriteLength(out, match_code - 15);
+  }
+}
+
+inline bool lzReadLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+  uint8_t byte = 0;
+  do {
+    if (in == end) {
+      return false;
+    }
+    byte = *in++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+}  // namespace detail
+
+// O(n). Appends the compressed form of [data, data + size) to `out`.
+inline void compressBlock(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+  std::vector<uint32_t> table(size_t{1} << detail::kLzHashBits, UINT32_MAX);
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (size >= detail::kLzMinMatch && pos + detail::kLzMinMatch <= size) {
+    const uint32_t hash = detail::lzHash(data + pos);
+    const uint32_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(pos);
+    if (candidate == UINT32_MAX || pos - candidate > detail::kLzMaxOffset ||
+        std::memcmp(data + candidate, data + pos, detail::kLzMinMatch) != 0) {
+      ++pos;
+      continue;
+    }
+    size_t length = detail::kLzMinMatch;
+    while (pos + length < size && data[candidate + length] == data[pos + length]) {
+      ++length;
+    }
+    detail::lzWriteSequence(out, data + anchor, pos - anchor, pos - candidate, length);
+    pos += length;
+    anchor = pos;
+  }
+  detail::lzWriteSequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+// O(raw_size). Decodes one block into exactly `raw_size` bytes; false on any malformed,
+// truncated, or oversized input.
+inline bool decompressBlock(const uint8_t* data,
+                            size_t size,
+                            size_t raw_size,
+                            std::vector<uint8_t>& out) {
+  out.clear();
+  out.reserve(raw_size);
+  const uint8_t* in = data;
+  const uint8_t* const end = data + size;
+  while (in < end) {
+    const uint8_t token = *in++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !detail::lzReadLength(in, end, literal_length)) {
+      return false;
+    }
+    if (literal_length > static_cast<size_t>(end - in) ||
+        literal_length > raw_size - out.size()) {
+      return false;
+    }
+    out.insert(out.end(), in, in + literal_length);
+    in += literal_length;
+    if (in == end) {
+      break;
+    }
+
+    if (end - in < 2) {
+      return false;
+    }
+    const size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t match_length = token & 0x0F;
+    if (match_length == 15 && !detail::lzReadLength(in, end, match_length)) {
+      return false;
+    }
+    match_length += detail::kLzMinMatch;
+    if (offset == 0 || offset > out.size() || match_length > raw_size - out.size()) {
+      return false;
+    }
+    // Byte-wise so overlapping matches (offset < length) replicate runs.
+    size_t from = out.size() - offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      out.push_back(out[from + i]);
+    }
+  }
+  return out.size() == raw_size;
+}
+
+}  // namespace CellEvoX::io
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <tbb/concurrent_queue.h>
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace CellEvoX::io {
+
+inline constexpr size_t kCsvRowsPerChunk = 16384;
+
+// Growable text buffer that CSV rows are formatted into. Numbers go through std::to_chars
+// directly into the buffer; floating point is written like std::ostream's default (%g, six
+// significant digits), so switching a writer over does not change its output.
+class CsvBuffer {
+ public:
+  void clear() { size_ = 0; }
+  const char* data() const { return text_.data(); }
+  size_t size() const { return size_; }
+
+  CsvBuffer& put(char c) {
+    *reserve(1) = c;
+    ++size_;
+    return *this;
+  }
+
+  CsvBuffer& put(std::string_view text) {
+    std::copy(text.begin(), text.end(), reserve(text.size()));
+    size_ += text.size();
+    return *this;
+  }
+
+  template <typename T>
+    requires(std::integral<T> && !std::same_as<T, char> && !std::same_as<T, bool>)
+  CsvBuffer& put(T value) {
+    // uint8_t is written as a number, as std::to_string would.
+    char* begin = reserve(kMaxNumberChars);
+    size_ = static_cast<size_t>(std::to_chars(begin, begin + kMaxNumberChars, value).ptr -
+                                text_.data());
+    return *this;
+  }
+
+  template <std::floating_point T>
+  CsvBuffer& put(T value) {
+    char* begin = reserve(kMaxNumberChars);
+    size_ = static_cast<size_t>(
+        std::to_chars(begin, begin + kMaxNumberChars, value, std::chars_format::general, 6).ptr -
+        text_.data());
+    return *this;
+  }
+
+ private:
+  static constexpr size_t kMaxNumberChars = 32;
+
+  // Makes room for `count` more characters and returns where they go.
+  char* reserve(size_t count) {
+    if (text_.size() - size_ < count) {
+      text_.resize(std::max(size_ + count, 2 * text_.size() + 4096));
+    }
+    return text_.data() + size_;
+  }
+
+  std::string text_;
+  size_t size_ = 0;
+};
+
+// Writes `header` followed by rows [0, row_count) to `path`. format_row(buffer, row) appends one
+// complete row, newline included, and is called concurrently for different rows. Rows are
+// formatted in parallel chunks of rows_per_chunk into recycled buffers and written in order with
+// one write per chunk. Returns false when the file cannot be opened or written.
+template <typename FormatRow>
+bool writeCsvFile(const std::filesystem::path& path,
+                  std::string_view header,
+                  size_t row_count,
+                  FormatRow&& format_row,
+                  size_t rows_per_chunk = kCsvRowsPerChunk) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+  file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+  rows_per_chunk = std::max<size_t>(rows_per_chunk, 1);
+  const size_t chunk_count = (row_count + rows_per_chunk - 1) / rows_per_chunk;
+  const size_t tokens = std::min(
+      chunk_count, 2 * static_cast<size_t>(std::max(1, tbb::this_task_arena::max_concurrency())));
+  if (tokens == 0) {
+    return file.good();
+  }
+
+  // One buffer per pipeline token: a buffer goes back to the pool in the write stage, before
+  // its token is released, so the input stage always finds one free.
+  std::vector<CsvBuffer> buffers(tokens);
+  tbb::concurrent_queue<CsvBuffer*> free_buffers;
+  for (auto& buffer : buffers) {
+    free_buffers.push(&buffer);
+  }
+
+  struct Chunk {
+    size_t begin = 0;
+    size_t end = 0;
+    CsvBuffer* buffer = nullptr;
+  };
+  size_t next_chunk = 0;
+  tbb::parallel_pipeline(
+      tokens,
+      tbb::make_filter<void, Chunk>(tbb::filter_mode::serial_in_order,
+                                    [&](tbb::flow_control& control) -> Chunk {
+                                      if (next_chunk == chunk_count) {
+                                        control.stop();
+                                        return {};
+                                      }
+                                      Chunk chunk;
+                                      chunk.begin = next_chunk * rows_per_chunk;
+                                      chunk.end = std::min(row_count, chunk.begin + rows_per_chunk);
+                                      free_buffers.try_pop(chunk.buffer);
+                                      ++next_chunk;
+                                      return chunk;
+                                    }) &
+          tbb::make_filter<Chunk, Chunk>(tbb::filter_mode::parallel,
+                                         [&](Chunk chunk) {
+                                           chunk.buffer->clear();
+                                           for (size_t row = chunk.begin; row < chunk.end; ++row) {
+                                             format_row(*chunk.buffer, row);
+                                           }
+                                           return chunk;
+                                         }) &
+          tbb::make_filter<Chunk, void>(tbb::filter_mode::serial_in_order, [&](Chunk chunk) {
+            file.write(chunk.buffer->data(), static_cast<std::streamsize>(chunk.buffer->size()));
+            free_buffers.push(chunk.buffer);
+          }));
+  file.flush();
+  return file.good();
+}
+
+}  // namespace CellEvoX::io
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace CellEvoX::io {
+
+// Full engine state at a step boundary, written to checkpoints/checkpoint.bin of a run:
+//   header | state bytes
+// The state is engine-specific and written field by field through CheckpointWriter; only the
+// engine that wrote it can read it back. The header identifies that engine and the config
+// values a resumed run must share, and carries an FNV-1a checksum of the state so a torn or
+// corrupted file is rejected instead of resumed from.
+constexpr std::array<char, 8> kEngineCheckpointMagic = {'C', 'E', 'L', 'X', 'C', 'K', 'P', '1'};
+constexpr uint32_t kEngineCheckpointVersion = 2;
+
+#pragma pack(push, 1)
+struct EngineCheckpointHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t sim_type;  // SimulationType of the writing engine
+  uint32_t seed;
+  uint32_t reserved;
+  double tau_step;
+  uint64_t initial_population;
+  uint64_t completed_steps;
+  uint64_t state_size;
+  uint64_t state_checksum;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(EngineCheckpointHeader) == 64,
+              "EngineCheckpointHeader must stay tightly packed");
+
+inline std::string engineCheckpointPath(const std::string& output_path) {
+  return (std::filesystem::path(output_path) / "checkpoints" / "checkpoint.bin").string();
+}
+
+inline uint64_t checkpointChecksum(const uint8_t* data, size_t size) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ data[i]) * 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+// Appends fields in host byte order to an in-memory buffer, like the other binary outputs.
+class CheckpointWriter {
+ public:
+  template <typename T>
+  void put(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoint fields must be trivially copyable");
+    const auto* raw = reinterpret_cast<const uint8_t*>(&value);
+    bytes_.insert(bytes_.end(), raw, raw + sizeof(T));
+  }
+
+  template <typename T>
+  void putVector(const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoint fields must be trivially copyable");
+    put<uint64_t>(values.size());
+    if (!values.empty()) {
+      const auto* raw = reinterpret_cast<const uint8_t*>(values.data());
+      bytes_.insert(bytes_.end(), raw, raw + values.size() * sizeof(T));
+    }
+  }
+
+  void putString(const std::string& value) {
+    put<uint64_t>(value.size());
+    bytes_.insert(bytes_.end(), value.begin(), value.end());
+  }
+
+  // The engine's textual state representation is the only portable one the standard offers.
+  void putRng(const std::mt19937& rng) {
+    std::ostringstream state;
+    state << rng;
+    putString(state.str());
+  }
+
+  std::vector<uint8_t>& bytes() { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+// Reads fields back in the order they were put. The first short read marks the reader failed
+// and every later read fails too, so callers may check ok() once at the end.
+class CheckpointReader {
+ public:
+  CheckpointReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool get(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoint fields must be trivially copyable");
+    if (!take(sizeof(T))) {
+      return false;
+    }
+    std::memcpy(&value, data_ + offset_ - sizeof(T), sizeof(T));
+    return true;
+  }
+
+  template <typename T>
+  bool getVector(std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoint fields must be trivially copyable");
+    uint64_t count = 0;
+    if (!get(count) || count > (size_ - offset_) / sizeof(T)) {
+      failed_ = true;
+      return false;
+    }
+    values.resize(static_cast<size_t>(count));
+    const size_t bytes = values.size() * sizeof(T);
+    if (!take(bytes)) {
+      return false;
+    }
+    if (bytes > 0) {
+      std::memcpy(values.data(), data_ + offset_ - bytes, bytes);
+    }
+    return true;
+  }
+
+  bool getString(std::string& value) {
+    uint64_t size = 0;
+    if (!get(size) || size > size_ - offset_) {
+      failed_ = true;
+      return false;
+    }
+    const auto bytes = static_cast<size_t>(size);
+    value.assign(reinterpret_cast<const char*>(data_ + offset_), bytes);
+    offset_ += bytes;
+    return true;
+  }
+
+  bool getRng(std::mt19937& rng) {
+    std::string text;
+    if (!getString(text)) {
+      return false;
+    }
+    std::istringstream state(text);
+    state >> rng;
+    failed_ = failed_ || state.fail();
+    return !failed_;
+  }
+
+  bool ok() const { return !failed_; }
+  bool atEnd() const { return offset_ == size_; }
+
+ private:
+  bool take(size_t bytes) {
+    if (failed_ || bytes > size_ - offset_) {
+      failed_ = true;
+      return false;
+    }
+    offset_ += bytes;
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool failed_ = false;
+};
+
+struct EngineCheckpoint {
+  EngineCheckpointHeader header{};
+  std::vector<uint8_t> state;
+
+  CheckpointReader reader() const { return CheckpointReader(state.data(), state.size()); }
+};
+
+// Flushes a closed file's data to the storage device. With `directory`, syncs a directory
+// entry instead (POSIX only; Windows cannot open directories this way and reports success).
+inline bool syncToDisk(const std::filesystem::path& path, bool directory = false) {
+#ifdef _WIN32
+  if (directory) {
+    return true;
+  }
+  const int fd = ::_wopen(path.c_str(), _O_RDWR | _O_BINARY);
+  if (fd < 0) {
+    return false;
+  }
+  const bool synced = ::_commit(fd) == 0;
+  ::_close(fd);
+  return synced;
+#else
+  const int fd = ::open(path.c_str(), (directory ? O_RDONLY : O_WRONLY) | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  const bool synced = ::fsync(fd) == 0;
+  ::close(fd);
+  return synced;
+#endif
+}
+
+// O(state). Writes next to `path`, syncs it to disk and renames it over `path`, so the previous
+// checkpoint stays intact until the new one is complete, even across a power loss.
+inline bool writeEngineCheckpoint(const std::filesystem::path& path,
+                                  EngineCheckpointHeader header,
+                                  const std::vector<uint8_t>& state) {
+  std::error_code ec;
+  if (!path.parent_path().empty()) {
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec) {
+      return false;
+    }
+  }
+  std::copy(kEngineCheckpointMagic.begin(), kEngineCheckpointMagic.end(), header.magic);
+  header.version = kEngineCheckpointVersion;
+  header.state_size = state.size();
+  header.state_checksum = checkpointChecksum(state.data(), state.size());
+
+  auto temporary_path = path;
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!state.empty()) {
+      file.write(reinterpret_cast<const char*>(state.data()),
+                 static_cast<std::streamsize>(state.size()));
+    }
+    file.flush();
+    if (!file.good()) {
+      return false;
+    }
+  }
+  if (!syncToDisk(temporary_path)) {
+    return false;
+  }
+  std::filesystem::rename(temporary_path, path, ec);
+  if (ec) {
+    return false;
+  }
+  // Persists the rename itself; some filesystems refuse to sync directories, which is harmless.
+  syncToDisk(path.parent_path().empty() ? std::filesystem::path(".") : path.parent_path(), true);
+  return true;
+}
+
+inline bool readEngineCheckpoint(const std::filesystem::path& path, EngineCheckpoint& checkpoint) {
+  std::ifstream file(path, std::ios::binary);
+  std::error_code ec;
+  const uint64_t file_size = std::filesystem::file_size(path, ec);
+  if (!file.is_open() || ec || file_size < sizeof(EngineCheckpointHeader)) {
+    return false;
+  }
+  auto& header = checkpoint.header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file.good() ||
+      !std::equal(kEngineCheckpointMagic.begin(), kEngineCheckpointMagic.end(), header.magic) ||
+      header.version != kEngineCheckpointVersion ||
+      header.state_size != file_size - sizeof(header)) {
+    return false;
+  }
+  checkpoint.state.resize(static_cast<size_t>(header.state_size));
+  if (!checkpoint.state.empty()) {
+    file.read(reinterpret_cast<char*>(checkpoint.state.data()),
+              static_cast<std::streamsize>(checkpoint.state.size()));
+  }
+  return file.good() &&
+         checkpointChecksum(checkpoint.state.data(), checkpoint.state.size()) ==
+             header.state_checksum;
+}
+
+// Writes checkpoints on a background thread so the simulation only pays for serializing its
+// state. At most one write is in flight: submit() first waits for the previous one.
+class AsyncCheckpointWriter {
+ public:
+  AsyncCheckpointWriter() = default;
+  AsyncCheckpointWriter(const AsyncCheckpointWriter&) = delete;
+  AsyncCheckpointWriter& operator=(const AsyncCheckpointWriter&) = delete;
+  ~AsyncCheckpointWriter() { wait(); }
+
+  // Returns false when the previous write failed.
+  bool submit(std::filesystem::path path,
+              const EngineCheckpointHeader& header,
+              std::vector<uint8_t> state) {
+    const bool previous_ok = wait();
+    pending_ = std::async(std::launch::async,
+                          [path = std::move(path), header, state = std::move(state)]() {
+                            return writeEngineCheckpoint(path, header, state);
+                          });
+    return previous_ok;
+  }
+
+  // Blocks until the write in flight, if any, is on disk; false when it failed.
+  bool wait() {
+    if (!pending_.valid()) {
+      return true;
+    }
+    return pending_.get();
+  }
+
+ private:
+  std::future<bool> pending_;
+};
+
+}  // namespace CellEvoX::io
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CellEvoX::io {
+
+enum class MappedFileAccess {
+  Normal,
+  Sequential,  // one front-to-back pass: aggressive read-ahead, pages dropped behind
+  Random,      // scattered frame reads: no read-ahead
+};
+
+// Read-only view of a whole file: mmap on POSIX, a heap copy elsewhere. Move-only.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      data_ = other.data_;
+      size_ = other.size_;
+      mapped_ = other.mapped_;
+      fallback_ = std::move(other.fallback_);
+      other.data_ = nullptr;
+      other.size_ = 0;
+      other.mapped_ = false;
+    }
+    return *this;
+  }
+  ~MappedFile() { close(); }
+
+  bool open(const std::filesystem::path& path) {
+    close();
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size < 0) {
+      ::close(fd);
+      return false;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+      void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(fd);
+        size_ = 0;
+        return false;
+      }
+      data_ = static_cast<const uint8_t*>(mapping);
+      mapped_ = true;
+    }
+    ::close(fd);  // the mapping keeps the file referenced
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+      return false;
+    }
+    fallback_.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!fallback_.empty()) {
+      file.read(reinterpret_cast<char*>(fallback_.data()),
+                static_cast<std::streamsize>(fallback_.size()));
+      if (!file.good()) {
+        fallback_.clear();
+        return false;
+      }
+    }
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    return true;
+#endif
+  }
+
+  void close() {
+#ifndef _WIN32
+    if (mapped_) {
+      ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    fallback_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+  }
+
+  // Page-cache hint for [offset, offset + length); a no-op without mmap.
+  void advise(MappedFileAccess access, size_t offset = 0, size_t length = SIZE_MAX) const {
+#ifndef _WIN32
+    if (!mapped_ || offset >= size_) {
+      return;
+    }
+    const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t begin = offset - offset % page;
+    const size_t end = length > size_ - offset ? size_ : offset + length;
+    const int advice = access == MappedFileAccess::Sequential ? MADV_SEQUENTIAL
+                       : access == MappedFileAccess::Random   ? MADV_RANDOM
+                                                              : MADV_NORMAL;
+    ::madvise(const_cast<uint8_t*>(data_) + begin, end - begin, advice);
+#else
+    (void)access;
+    (void)offset;
+    (void)length;
+#endif
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool isMapped() const { return mapped_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<uint8_t> fallback_;
+};
+
+}  // namespace CellEvoX::io
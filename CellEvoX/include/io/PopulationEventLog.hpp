@@ -0,0 +1,685 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "io/BlockCompressor.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
+#include "io/PopulationSnapshotIO.hpp"
+
+namespace CellEvoX::io {
+
+// Birth/death event stream that replaces most population snapshots. The log is a sequence of
+// compressed blocks of varint-coded records:
+//   Step        tau, flags, deaths (sorted id deltas), births (id delta, parent delta,
+//               fitness unless inherited, mutations added, payload mutations added)
+//   Generation  the population at this point is snapshot generation N
+// Every keyframe generation is also stored as an ordinary snapshot (file or container frame)
+// and starts a new block, so replaying generation G reads one snapshot and the blocks after it.
+constexpr std::array<char, 8> kPopulationEventLogMagic = {'C', 'E', 'L', 'X', 'E', 'V', 'T', '1'};
+constexpr uint32_t kPopulationEventLogVersion = 1;
+constexpr int32_t kPopulationEventLogNoKeyframe = -1;
+
+#pragma pack(push, 1)
+struct PopulationEventLogFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint8_t spatial_dimensions;
+  uint8_t flags;  // kPopulationSnapshotFlag* payload kind of births and keyframes
+  uint8_t reserved[2];
+};
+
+struct PopulationEventLogBlockHeader {
+  uint32_t raw_size;
+  uint32_t stored_size;
+  int32_t keyframe_generation;  // keyframe the block starts at, or kPopulationEventLogNoKeyframe
+  uint8_t codec;                // PopulationSnapshotBlockCodec
+  uint8_t reserved[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PopulationEventLogFileHeader) == 16,
+              "PopulationEventLogFileHeader must stay tightly packed");
+static_assert(sizeof(PopulationEventLogBlockHeader) == 16,
+              "PopulationEventLogBlockHeader must stay tightly packed");
+
+struct PopulationBirthEvent {
+  uint32_t id;
+  uint32_t parent_id;
+  float fitness;
+  uint16_t mutations_added;  // all new mutations, whether or not they enter the payload
+  uint16_t payload_count;    // new payload mutations, at payload_offset in the step's payload
+  uint32_t payload_offset;
+  bool fitness_inherited;  // daughter without a new mutation: replay copies the parent's
+};
+
+inline std::string populationEventLogPath(const std::string& output_path) {
+  return (std::filesystem::path(output_path) / "population_data" / "population_events.bin")
+      .string();
+}
+
+namespace detail {
+
+enum class PopulationEventTag : uint8_t {
+  Step,
+  Generation,
+};
+
+// Every parent of the step's births died in it and is left out of the death list.
+constexpr uint8_t kPopulationEventStepParentsDivide = 0x1;
+
+constexpr size_t kPopulationEventBlockBytes = size_t{1} << 20;
+
+constexpr uint32_t kNoLoggedPayload = std::numeric_limits<uint32_t>::max();
+
+// Payload mutations one birth added, linked to the nearest ancestor that added any. A cell's
+// full payload is the chain from its node to the root, built only for materialized generations,
+// so replay costs O(payload mutations logged) instead of copying a lineage per birth.
+struct LoggedPayloadNode {
+  uint32_t parent = kNoLoggedPayload;
+  std::vector<PopulationSnapshotDriverMutation> added;
+};
+
+struct LoggedCell {
+  uint32_t parent_id = 0;
+  float fitness = 1.0f;
+  uint32_t mutations_count = 0;
+  uint32_t payload = kNoLoggedPayload;
+};
+
+struct LoggedPopulation {
+  std::map<uint32_t, LoggedCell> cells;
+  std::vector<LoggedPayloadNode> payload_nodes;
+
+  void clear() {
+    cells.clear();
+    payload_nodes.clear();
+  }
+};
+
+}  // namespace detail
+
+// Where a writer stood at a checkpoint: the committed file size and the block still in memory.
+struct PopulationEventLogResumePoint {
+  uint64_t file_size = 0;
+  std::vector<uint8_t> block;
+  int32_t block_keyframe = kPopulationEventLogNoKeyframe;
+};
+
+class PopulationEventLogWriter {
+ public:
+  PopulationEventLogWriter() = default;
+  PopulationEventLogWriter(const PopulationEventLogWriter&) = delete;
+  PopulationEventLogWriter& operator=(const PopulationEventLogWriter&) = delete;
+  ~PopulationEventLogWriter() { close(); }
+
+  bool open(const std::filesystem::path& path,
+            uint8_t spatial_dimensions,
+            MutationPayloadKind payload_kind) {
+    const auto parent_path = path.parent_path();
+    if (!parent_path.empty()) {
+      std::error_code ec;
+      std::filesystem::create_directories(parent_path, ec);
+      if (ec) {
+        return false;
+      }
+    }
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+      return false;
+    }
+    PopulationEventLogFileHeader header{};
+    std::copy(kPopulationEventLogMagic.begin(), kPopulationEventLogMagic.end(), header.magic);
+    header.version = kPopulationEventLogVersion;
+    header.spatial_dimensions = spatial_dimensions;
+    header.flags = payload_kind == MutationPayloadKind::Full
+                       ? kPopulationSnapshotFlagHasFullMutationPayload
+                       : kPopulationSnapshotFlagHasDriverMutationPayload;
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return file_.good();
+  }
+
+  bool isOpen() const { return file_.is_open(); }
+
+  // Flushes the committed blocks so the returned file size is on disk; the open block stays
+  // in memory and is carried by the resume point instead.
+  PopulationEventLogResumePoint resumePoint() {
+    PopulationEventLogResumePoint point;
+    if (file_.is_open()) {
+      file_.flush();
+      point.file_size = static_cast<uint64_t>(file_.tellp());
+    }
+    point.block = block_;
+    point.block_keyframe = block_keyframe_;
+    return point;
+  }
+
+  // Reopens a log written up to `point`, dropping whatever a later run appended, so appending
+  // from here reproduces the uninterrupted log byte for byte.
+  bool resume(const std::filesystem::path& path, const PopulationEventLogResumePoint& point) {
+    std::error_code ec;
+    if (point.file_size < sizeof(PopulationEventLogFileHeader) ||
+        std::filesystem::file_size(path, ec) < point.file_size || ec) {
+      return false;
+    }
+    std::filesystem::resize_file(path, point.file_size, ec);
+    if (ec) {
+      return false;
+    }
+    file_.open(path, std::ios::binary | std::ios::app);
+    block_ = point.block;
+    block_keyframe_ = point.block_keyframe;
+    good_ = file_.is_open();
+    return good_;
+  }
+
+  // O(deaths log deaths + births + payload). Births resolve their parents against the population
+  // before the step, so a parent dividing in this step may also be among the deaths.
+  void appendStep(double tau,
+                  std::vector<uint32_t> deaths,
+                  const std::vector<PopulationBirthEvent>& births,
+                  const std::vector<PopulationSnapshotDriverMutation>& birth_payload) {
+    if (deaths.empty() && births.empty()) {
+      return;
+    }
+    block_.push_back(static_cast<uint8_t>(detail::PopulationEventTag::Step));
+    appendRaw(tau);
+    std::sort(deaths.begin(), deaths.end());
+    // Division replaces the parent, so in a pure division step the parents' deaths are implied.
+    parents_.clear();
+    for (const auto& birth : births) {
+      parents_.push_back(birth.parent_id);
+    }
+    std::sort(parents_.begin(), parents_.end());
+    parents_.erase(std::unique(parents_.begin(), parents_.end()), parents_.end());
+    const bool parents_divide =
+        !births.empty() &&
+        std::includes(deaths.begin(), deaths.end(), parents_.begin(), parents_.end());
+    if (parents_divide) {
+      const auto end = std::set_difference(
+          deaths.begin(), deaths.end(), parents_.begin(), parents_.end(), deaths.begin());
+      deaths.erase(end, deaths.end());
+    }
+    block_.push_back(parents_divide ? detail::kPopulationEventStepParentsDivide : 0);
+    detail::appendVarint(block_, deaths.size());
+    int64_t previous = 0;
+    for (const uint32_t id : deaths) {
+      detail::appendVarint(block_, static_cast<uint64_t>(id - previous));
+      previous = id;
+    }
+
+    // Births arrive grouped by parent, so both deltas are mostly 0 or 1.
+    detail::appendVarint(block_, births.size());
+    previous = 0;
+    int64_t previous_parent = 0;
+    for (const auto& birth : births) {
+      detail::appendVarint(block_, detail::zigzag(static_cast<int64_t>(birth.id) - previous));
+      previous = birth.id;
+      detail::appendVarint(block_, detail::zigzag(birth.parent_id - previous_parent));
+      previous_parent = birth.parent_id;
+      detail::appendVarint(block_,
+                           (static_cast<uint64_t>(birth.mutations_added) << 1) |
+                               (birth.fitness_inherited ? 0u : 1u));
+      if (!birth.fitness_inherited) {
+        appendRaw(birth.fitness);
+      }
+      detail::appendVarint(block_, birth.payload_count);
+      for (uint32_t k = 0; k < birth.payload_count; ++k) {
+        const auto& mutation = birth_payload[birth.payload_offset + k];
+        detail::appendVarint(
+            block_, detail::zigzag(static_cast<int64_t>(mutation.mutation_id) - birth.id));
+        block_.push_back(mutation.mutation_type);
+      }
+    }
+    if (block_.size() >= detail::kPopulationEventBlockBytes) {
+      flushBlock();
+    }
+  }
+
+  // Marks the current population as snapshot `generation`. A keyframe starts a new block; the
+  // caller writes the matching population snapshot file.
+  void appendGeneration(int generation, double tau, bool keyframe) {
+    if (keyframe) {
+      flushBlock();
+      block_keyframe_ = generation;
+    }
+    block_.push_back(static_cast<uint8_t>(detail::PopulationEventTag::Generation));
+    detail::appendVarint(block_, static_cast<uint64_t>(generation));
+    appendRaw(tau);
+  }
+
+  bool close() {
+    if (!file_.is_open()) {
+      return true;
+    }
+    flushBlock();
+    file_.close();
+    return good_;
+  }
+
+ private:
+  template <typename T>
+  void appendRaw(const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    block_.insert(block_.end(), bytes, bytes + sizeof(T));
+  }
+
+  void flushBlock() {
+    if (block_.empty() || !file_.is_open()) {
+      return;
+    }
+    compressed_.clear();
+    compressBlock(block_.data(), block_.size(), compressed_);
+    const bool use_lz = compressed_.size() < block_.size();
+    const auto& stored = use_lz ? compressed_ : block_;
+    PopulationEventLogBlockHeader header{};
+    header.raw_size = static_cast<uint32_t>(block_.size());
+    header.stored_size = static_cast<uint32_t>(stored.size());
+    header.keyframe_generation = block_keyframe_;
+    header.codec = static_cast<uint8_t>(use_lz ? PopulationSnapshotBlockCodec::Lz
+                                               : PopulationSnapshotBlockCodec::Raw);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_.write(reinterpret_cast<const char*>(stored.data()),
+                static_cast<std::streamsize>(stored.size()));
+    good_ = good_ && file_.good();
+    block_.clear();
+    block_keyframe_ = kPopulationEventLogNoKeyframe;
+  }
+
+  std::ofstream file_;
+  std::vector<uint8_t> block_;
+  std::vector<uint8_t> compressed_;
+  std::vector<uint32_t> parents_;
+  int32_t block_keyframe_ = kPopulationEventLogNoKeyframe;
+  bool good_ = true;
+};
+
+// Receives each replayed generation in snapshot form, records sorted by id; return false to
+// stop the replay early.
+using PopulationEventLogVisitor =
+    std::function<bool(int generation,
+                       const PopulationSnapshotFileHeader& header,
+                       const std::vector<PopulationSnapshotRecord>& records,
+                       const std::vector<PopulationSnapshotDriverMutation>& payload)>;
+
+namespace detail {
+
+inline void materializeLoggedPopulation(const LoggedPopulation& population,
+                                        double tau,
+                                        uint8_t spatial_dimensions,
+                                        uint8_t flags,
+                                        PopulationSnapshotFileHeader& header,
+                                        std::vector<PopulationSnapshotRecord>& records,
+                                        std::vector<PopulationSnapshotDriverMutation>& payload) {
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+  records.clear();
+  payload.clear();
+  records.reserve(population.cells.size());
+  std::vector<uint32_t> chain;
+  for (const auto& [id, cell] : population.cells) {
+    chain.clear();
+    for (uint32_t node = cell.payload; node != kNoLoggedPayload;
+         node = population.payload_nodes[node].parent) {
+      chain.push_back(node);
+    }
+    const size_t payload_offset = payload.size();
+    for (auto node = chain.rbegin(); node != chain.rend(); ++node) {
+      const auto& added = population.payload_nodes[*node].added;
+      payload.insert(payload.end(), added.begin(), added.end());
+    }
+    records.push_back({id,
+                       cell.parent_id,
+                       cell.fitness,
+                       kNaN,
+                       kNaN,
+                       kNaN,
+                       static_cast<uint16_t>(std::min<uint32_t>(
+                           cell.mutations_count, std::numeric_limits<uint16_t>::max())),
+                       static_cast<uint16_t>(
+                           std::min<size_t>(payload.size() - payload_offset,
+                                            std::numeric_limits<uint16_t>::max())),
+                       static_cast<uint32_t>(payload_offset),
+                       0,
+                       {0, 0, 0}});
+  }
+  header = makePopulationSnapshotHeader(
+      tau,
+      static_cast<uint32_t>(records.size()),
+      spatial_dimensions,
+      static_cast<uint32_t>(payload.size()),
+      (flags & kPopulationSnapshotFlagHasFullMutationPayload) != 0
+          ? MutationPayloadKind::Full
+          : MutationPayloadKind::DriverOnly);
+}
+
+inline bool loadKeyframe(StoredPopulationSnapshotReader& snapshots,
+                         int generation,
+                         LoggedPopulation& population) {
+  PopulationSnapshotFileHeader header{};
+  std::vector<PopulationSnapshotRecord> records;
+  std::vector<PopulationSnapshotDriverMutation> payload;
+  if (!snapshots.read(generation, header, records, payload)) {
+    return false;
+  }
+  population.clear();
+  for (const auto& record : records) {
+    const size_t begin = record.driver_mutation_offset;
+    const size_t end = begin + record.driver_mutation_count;
+    if (end > payload.size()) {
+      return false;
+    }
+    // Keyframe cells are lineage roots holding their whole payload.
+    uint32_t node = kNoLoggedPayload;
+    if (end > begin) {
+      node = static_cast<uint32_t>(population.payload_nodes.size());
+      population.payload_nodes.push_back(
+          {kNoLoggedPayload,
+           {payload.begin() + static_cast<std::ptrdiff_t>(begin),
+            payload.begin() + static_cast<std::ptrdiff_t>(end)}});
+    }
+    population.cells[record.id] = {
+        record.parent_id, record.fitness, record.mutations_count, node};
+  }
+  return true;
+}
+
+// Applies one decoded block; stops (returning true) once `visit` declines to continue or the
+// replay passes `target_generation`. Only the target is materialized (every generation when
+// the target is negative), so a lookup costs O(population) once rather than per generation.
+inline bool replayEventBlock(const std::vector<uint8_t>& block,
+                             LoggedPopulation& population,
+                             const PopulationEventLogFileHeader& file_header,
+                             int target_generation,
+                             const PopulationEventLogVisitor& visit,
+                             bool& stopped) {
+  ColumnCursor cursor(block);
+  PopulationSnapshotFileHeader header{};
+  std::vector<PopulationSnapshotRecord> records;
+  std::vector<PopulationSnapshotDriverMutation> payload;
+  while (!cursor.exhausted()) {
+    uint8_t tag = 0;
+    double tau = 0.0;
+    cursor.readByte(tag);
+    if (tag == static_cast<uint8_t>(PopulationEventTag::Generation)) {
+      uint64_t generation = 0;
+      if (!cursor.readVarint(generation) || !cursor.readRaw(&tau, sizeof(tau))) {
+        return false;
+      }
+      if (target_generation >= 0 && static_cast<int64_t>(generation) < target_generation) {
+        continue;
+      }
+      if (target_generation >= 0 && static_cast<int64_t>(generation) > target_generation) {
+        stopped = true;
+        return true;
+      }
+      materializeLoggedPopulation(population, tau, file_header.spatial_dimensions, file_header.flags,
+                                  header, records, payload);
+      if (!visit(static_cast<int>(generation), header, records, payload)) {
+        stopped = true;
+        return true;
+      }
+      continue;
+    }
+    uint8_t flags = 0;
+    if (tag != static_cast<uint8_t>(PopulationEventTag::Step) ||
+        !cursor.readRaw(&tau, sizeof(tau)) || !cursor.readByte(flags)) {
+      return false;
+    }
+
+    uint64_t death_count = 0;
+    if (!cursor.readVarint(death_count)) {
+      return false;
+    }
+    std::vector<uint32_t> deaths;
+    deaths.reserve(std::min<uint64_t>(death_count, block.size()));
+    int64_t previous = 0;
+    for (uint64_t i = 0; i < death_count; ++i) {
+      uint64_t delta = 0;
+      if (!cursor.readVarint(delta)) {
+        return false;
+      }
+      previous += static_cast<int64_t>(delta);
+      deaths.push_back(static_cast<uint32_t>(previous));
+    }
+
+    uint64_t birth_count = 0;
+    if (!cursor.readVarint(birth_count)) {
+      return false;
+    }
+    std::vector<std::pair<uint32_t, LoggedCell>> born;
+    born.reserve(std::min<uint64_t>(birth_count, block.size()));
+    previous = 0;
+    int64_t previous_parent = 0;
+    for (uint64_t i = 0; i < birth_count; ++i) {
+      uint64_t id_delta = 0;
+      uint64_t parent_delta = 0;
+      uint64_t added = 0;
+      uint64_t payload_count = 0;
+      if (!cursor.readVarint(id_delta) || !cursor.readVarint(parent_delta) ||
+          !cursor.readVarint(added)) {
+        return false;
+      }
+      previous += unzigzag(id_delta);
+      const auto id = static_cast<uint32_t>(previous);
+      LoggedCell cell;
+      previous_parent += unzigzag(parent_delta);
+      cell.parent_id = static_cast<uint32_t>(previous_parent);
+      // Initial cells have no logged parent and inherit nothing.
+      const auto parent = population.cells.find(cell.parent_id);
+      if (parent != population.cells.end()) {
+        cell.fitness = parent->second.fitness;
+        cell.mutations_count = parent->second.mutations_count;
+        cell.payload = parent->second.payload;
+      }
+      cell.mutations_count += static_cast<uint32_t>(added >> 1);
+      if ((added & 1) != 0 && !cursor.readRaw(&cell.fitness, sizeof(cell.fitness))) {
+        return false;
+      }
+      if (!cursor.readVarint(payload_count)) {
+        return false;
+      }
+      if (payload_count == 0) {
+        born.emplace_back(id, cell);
+        continue;
+      }
+      LoggedPayloadNode node{cell.payload, {}};
+      node.added.reserve(std::min<uint64_t>(payload_count, block.size()));
+      for (uint64_t k = 0; k < payload_count; ++k) {
+        uint64_t mutation_delta = 0;
+        PopulationSnapshotDriverMutation mutation{};
+        if (!cursor.readVarint(mutation_delta) || !cursor.readByte(mutation.mutation_type)) {
+          return false;
+        }
+        mutation.mutation_id = static_cast<uint32_t>(id + unzigzag(mutation_delta));
+        node.added.push_back(mutation);
+      }
+      cell.payload = static_cast<uint32_t>(population.payload_nodes.size());
+      population.payload_nodes.push_back(std::move(node));
+      born.emplace_back(id, cell);
+    }
+    if ((flags & kPopulationEventStepParentsDivide) != 0) {
+      for (const auto& birth : born) {
+        deaths.push_back(birth.second.parent_id);
+      }
+    }
+    for (auto& [id, cell] : born) {
+      population.cells[id] = cell;
+    }
+    for (const uint32_t id : deaths) {
+      population.cells.erase(id);
+    }
+  }
+  return true;
+}
+
+}  // namespace detail
+
+// Replay session over one event log. The block index is read once on open() and the keyframe
+// snapshots stay open, so reconstructing many generations does not rescan the log or reopen the
+// snapshot container per lookup.
+class PopulationEventLogReader {
+ public:
+  bool open(const std::filesystem::path& log_path) {
+    blocks_.clear();
+    keyframes_.reset();
+    file_.close();
+    file_.clear();
+    file_.open(log_path, std::ios::binary);
+    if (!file_.is_open()) {
+      return false;
+    }
+    file_.read(reinterpret_cast<char*>(&file_header_), sizeof(file_header_));
+    if (!file_.good() ||
+        !std::equal(kPopulationEventLogMagic.begin(), kPopulationEventLogMagic.end(),
+                    file_header_.magic) ||
+        file_header_.version != kPopulationEventLogVersion) {
+      return false;
+    }
+
+    // Block headers only: O(blocks) seeks, once per session.
+    std::streamoff offset = static_cast<std::streamoff>(sizeof(file_header_));
+    while (true) {
+      PopulationEventLogBlockHeader header{};
+      file_.seekg(offset);
+      file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+      if (file_.gcount() == 0 && file_.eof()) {
+        break;
+      }
+      if (!file_.good()) {
+        blocks_.clear();
+        return false;
+      }
+      blocks_.push_back({offset, header});
+      offset += static_cast<std::streamoff>(sizeof(header)) + header.stored_size;
+    }
+    file_.clear();
+    keyframes_.emplace(log_path.parent_path());
+    return true;
+  }
+
+  // O(log size + generations x population): every logged generation is materialized in order.
+  bool forEachGeneration(const PopulationEventLogVisitor& visit) { return replay(-1, visit); }
+
+  // Reconstructs one generation from its nearest keyframe: one snapshot read plus the events
+  // logged between the keyframe and `generation`.
+  bool reconstruct(int generation,
+                   PopulationSnapshotFileHeader& header,
+                   std::vector<PopulationSnapshotRecord>& records,
+                   std::vector<PopulationSnapshotDriverMutation>& payload) {
+    bool found = false;
+    const bool ok = replay(
+        generation,
+        [&](int logged_generation,
+            const PopulationSnapshotFileHeader& logged_header,
+            const std::vector<PopulationSnapshotRecord>& logged_records,
+            const std::vector<PopulationSnapshotDriverMutation>& logged_payload) {
+          if (logged_generation == generation) {
+            header = logged_header;
+            records = logged_records;
+            payload = logged_payload;
+            found = true;
+          }
+          return false;
+        });
+    return ok && found;
+  }
+
+ private:
+  struct BlockEntry {
+    std::streamoff offset;
+    PopulationEventLogBlockHeader header;
+  };
+
+  // Replays the log from the newest keyframe at or before `target_generation` (from the first
+  // block when negative or when no keyframe qualifies), calling `visit` for that generation
+  // only, or for every generation when `target_generation` is negative.
+  bool replay(int target_generation, const PopulationEventLogVisitor& visit) {
+    if (!keyframes_) {
+      return false;
+    }
+    detail::LoggedPopulation population;
+    size_t first_block = 0;
+    if (target_generation >= 0) {
+      for (size_t b = blocks_.size(); b-- > 0;) {
+        const int32_t keyframe = blocks_[b].header.keyframe_generation;
+        if (keyframe == kPopulationEventLogNoKeyframe || keyframe > target_generation) {
+          continue;
+        }
+        if (detail::loadKeyframe(*keyframes_, keyframe, population)) {
+          first_block = b;
+          break;
+        }
+        population.clear();
+      }
+    }
+
+    for (size_t b = first_block; b < blocks_.size(); ++b) {
+      const auto& header = blocks_[b].header;
+      stored_.resize(header.stored_size);
+      file_.clear();
+      file_.seekg(blocks_[b].offset + static_cast<std::streamoff>(sizeof(header)));
+      file_.read(reinterpret_cast<char*>(stored_.data()),
+                 static_cast<std::streamsize>(stored_.size()));
+      if (!file_.good()) {
+        return false;
+      }
+      if (header.codec == static_cast<uint8_t>(PopulationSnapshotBlockCodec::Lz)) {
+        if (header.raw_size > static_cast<uint64_t>(header.stored_size) * 256 + 64 ||
+            !decompressBlock(stored_.data(), stored_.size(), header.raw_size, raw_)) {
+          return false;
+        }
+      } else if (header.codec == static_cast<uint8_t>(PopulationSnapshotBlockCodec::Raw) &&
+                 header.raw_size == header.stored_size) {
+        raw_.swap(stored_);
+      } else {
+        return false;
+      }
+      bool stopped = false;
+      if (!detail::replayEventBlock(
+              raw_, population, file_header_, target_generation, visit, stopped)) {
+        return false;
+      }
+      if (stopped) {
+        return true;
+      }
+    }
+    return true;
+  }
+
+  std::ifstream file_;
+  PopulationEventLogFileHeader file_header_{};
+  std::vector<BlockEntry> blocks_;
+  std::optional<StoredPopulationSnapshotReader> keyframes_;
+  std::vector<uint8_t> stored_;
+  std::vector<uint8_t> raw_;
+};
+
+// One-off replay; keep a PopulationEventLogReader open to visit or reconstruct several times.
+inline bool forEachLoggedGeneration(const std::filesystem::path& log_path,
+                                    const PopulationEventLogVisitor& visit) {
+  PopulationEventLogReader reader;
+  return reader.open(log_path) && reader.forEachGeneration(visit);
+}
+
+// One-off lookup; keep a PopulationEventLogReader open to reconstruct several generations.
+inline bool reconstructLoggedGeneration(const std::filesystem::path& log_path,
+                                        int generation,
+                                        PopulationSnapshotFileHeader& header,
+                                        std::vector<PopulationSnapshotRecord>& records,
+                                        std::vector<PopulationSnapshotDriverMutation>& payload) {
+  PopulationEventLogReader reader;
+  return reader.open(log_path) && reader.reconstruct(generation, header, records, payload);
+}
+
+}  // namespace CellEvoX::io
@@ -0,0 +1,513 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "io/PopulationSnapshotIO.hpp"
+
+namespace CellEvoX::io {
+
+// Every generation of a run in one append-only file:
+//   file header | frame* | index entry* | trailer
+// A frame is a frame header followed by one complete v2/v3 snapshot. The index and trailer are
+// rewritten on every close; a container whose trailer is missing or stale (the writer process
+// crashed) is recovered by walking the frame headers, which stop at the first frame that was not
+// fully committed. Frames are flushed to the OS but not fsynced, so this covers process crashes,
+// not power loss or kernel crashes.
+constexpr std::array<char, 8> kPopulationSnapshotContainerMagic = {
+    'C', 'E', 'L', 'X', 'P', 'O', 'P', 'C'};
+constexpr std::array<char, 8> kPopulationSnapshotIndexMagic = {
+    'C', 'E', 'L', 'X', 'I', 'D', 'X', '1'};
+constexpr uint32_t kPopulationSnapshotContainerVersion = 1;
+// Written last, after the frame's size, so a torn frame never looks committed.
+constexpr uint32_t kPopulationSnapshotFrameMagic = 0x4D524643;  // "CFRM"
+
+#pragma pack(push, 1)
+struct PopulationSnapshotContainerHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+struct PopulationSnapshotFrameHeader {
+  uint32_t magic;
+  int32_t generation;
+  uint64_t size;  // snapshot bytes after this header
+  double tau;
+  uint32_t record_count;
+  uint8_t flags;
+  uint8_t spatial_dimensions;
+  uint8_t reserved[2];
+};
+
+struct PopulationSnapshotIndexEntry {
+  int32_t generation;
+  uint32_t record_count;
+  uint64_t offset;  // of the frame header
+  uint64_t size;    // snapshot bytes, excluding the frame header
+  double tau;
+  uint8_t flags;
+  uint8_t spatial_dimensions;
+  uint8_t reserved[6];
+};
+
+struct PopulationSnapshotIndexTrailer {
+  uint64_t index_offset;
+  uint32_t entry_count;
+  uint32_t reserved;
+  char magic[8];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PopulationSnapshotContainerHeader) == 16,
+              "PopulationSnapshotContainerHeader must stay tightly packed");
+static_assert(sizeof(PopulationSnapshotFrameHeader) == 32,
+              "PopulationSnapshotFrameHeader must stay tightly packed");
+static_assert(sizeof(PopulationSnapshotIndexEntry) == 40,
+              "PopulationSnapshotIndexEntry must stay tightly packed");
+static_assert(sizeof(PopulationSnapshotIndexTrailer) == 24,
+              "PopulationSnapshotIndexTrailer must stay tightly packed");
+
+inline std::string populationSnapshotContainerPath(const std::string& output_path) {
+  return (std::filesystem::path(output_path) / "population_data" / "population_snapshots.bin")
+      .string();
+}
+
+namespace detail {
+
+inline bool readContainerHeader(std::istream& file) {
+  PopulationSnapshotContainerHeader header{};
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  return file.good() &&
+         std::equal(kPopulationSnapshotContainerMagic.begin(),
+                    kPopulationSnapshotContainerMagic.end(),
+                    header.magic) &&
+         header.version == kPopulationSnapshotContainerVersion;
+}
+
+// O(entries). Loads the trailing index when it describes exactly this file.
+inline bool readContainerIndex(std::istream& file,
+                               uint64_t file_size,
+                               std::vector<PopulationSnapshotIndexEntry>& entries,
+                               uint64_t& index_offset) {
+  constexpr uint64_t kMinSize =
+      sizeof(PopulationSnapshotContainerHeader) + sizeof(PopulationSnapshotIndexTrailer);
+  if (file_size < kMinSize) {
+    return false;
+  }
+  PopulationSnapshotIndexTrailer trailer{};
+  file.seekg(static_cast<std::streamoff>(file_size - sizeof(trailer)));
+  file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+  if (!file.good() ||
+      !std::equal(kPopulationSnapshotIndexMagic.begin(), kPopulationSnapshotIndexMagic.end(),
+                  trailer.magic) ||
+      trailer.index_offset < sizeof(PopulationSnapshotContainerHeader) ||
+      trailer.index_offset +
+              static_cast<uint64_t>(trailer.entry_count) * sizeof(PopulationSnapshotIndexEntry) +
+              sizeof(trailer) !=
+          file_size) {
+    return false;
+  }
+  entries.resize(trailer.entry_count);
+  file.seekg(static_cast<std::streamoff>(trailer.index_offset));
+  if (!entries.empty()) {
+    file.read(reinterpret_cast<char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(PopulationSnapshotIndexEntry)));
+  }
+  if (!file.good()) {
+    entries.clear();
+    return false;
+  }
+  for (const auto& entry : entries) {
+    if (entry.offset + sizeof(PopulationSnapshotFrameHeader) + entry.size >
+        trailer.index_offset) {
+      entries.clear();
+      return false;
+    }
+  }
+  index_offset = trailer.index_offset;
+  return true;
+}
+
+// O(frames) seeks. Rebuilds the index from the frame headers; `end` receives the offset just
+// past the last committed frame.
+inline void recoverContainerIndex(std::istream& file,
+                                  uint64_t file_size,
+                                  std::vector<PopulationSnapshotIndexEntry>& entries,
+                                  uint64_t& end) {
+  entries.clear();
+  uint64_t offset = sizeof(PopulationSnapshotContainerHeader);
+  while (file_size - offset >= sizeof(PopulationSnapshotFrameHeader)) {
+    PopulationSnapshotFrameHeader frame{};
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(reinterpret_cast<char*>(&frame), sizeof(frame));
+    if (!file.good() || frame.magic != kPopulationSnapshotFrameMagic ||
+        frame.size > file_size - offset - sizeof(frame)) {
+      break;
+    }
+    entries.push_back({frame.generation,
+                       frame.record_count,
+                       offset,
+                       frame.size,
+                       frame.tau,
+                       frame.flags,
+                       frame.spatial_dimensions,
+                       {0, 0, 0, 0, 0, 0}});
+    offset += sizeof(frame) + frame.size;
+  }
+  file.clear();
+  end = offset;
+}
+
+}  // namespace detail
+
+class PopulationSnapshotContainerReader {
+ public:
+  // Reads the trailing index, or rebuilds it from the frames when the writer did not close.
+  bool open(const std::filesystem::path& path) {
+    entries_.clear();
+    recovered_ = false;
+    file_.close();
+    file_.clear();
+    file_.open(path, std::ios::binary);
+    std::error_code ec;
+    const uint64_t file_size = std::filesystem::file_size(path, ec);
+    if (!file_.is_open() || ec || !detail::readContainerHeader(file_)) {
+      return false;
+    }
+    uint64_t index_offset = 0;
+    if (!detail::readContainerIndex(file_, file_size, entries_, index_offset)) {
+      file_.clear();
+      uint64_t end = 0;
+      detail::recoverContainerIndex(file_, file_size, entries_, end);
+      recovered_ = true;
+    }
+    return true;
+  }
+
+  const std::vector<PopulationSnapshotIndexEntry>& entries() const { return entries_; }
+  bool recovered() const { return recovered_; }
+
+  // O(log entries). Entries are in append order, which the engines keep by generation.
+  const PopulationSnapshotIndexEntry* find(int generation) const {
+    const auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), generation,
+        [](const PopulationSnapshotIndexEntry& entry, int value) {
+          return entry.generation < value;
+        });
+    if (it != entries_.end() && it->generation == generation) {
+      return &*it;
+    }
+    const auto linear = std::find_if(entries_.begin(), entries_.end(), [&](const auto& entry) {
+      return entry.generation == generation;
+    });
+    return linear == entries_.end() ? nullptr : &*linear;
+  }
+
+  // One seek and one read of the frame's bytes.
+  bool read(const PopulationSnapshotIndexEntry& entry,
+            PopulationSnapshotFileHeader& header,
+            std::vector<PopulationSnapshotRecord>& records,
+            std::vector<PopulationSnapshotDriverMutation>& driver_mutations) {
+    bytes_.resize(static_cast<size_t>(entry.size));
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(entry.offset + sizeof(PopulationSnapshotFrameHeader)));
+    if (!bytes_.empty()) {
+      file_.read(reinterpret_cast<char*>(bytes_.data()), static_cast<std::streamsize>(entry.size));
+    }
+    if (!file_.good()) {
+      return false;
+    }
+    return parsePopulationSnapshot(bytes_.data(), bytes_.size(), header, records, driver_mutations);
+  }
+
+ private:
+  std::ifstream file_;
+  std::vector<PopulationSnapshotIndexEntry> entries_;
+  std::vector<uint8_t> bytes_;
+  bool recovered_ = false;
+};
+
+class PopulationSnapshotContainerWriter {
+ public:
+  PopulationSnapshotContainerWriter() = default;
+  PopulationSnapshotContainerWriter(const PopulationSnapshotContainerWriter&) = delete;
+  PopulationSnapshotContainerWriter& operator=(const PopulationSnapshotContainerWriter&) = delete;
+  ~PopulationSnapshotContainerWriter() { close(); }
+
+  // Creates the container, or reopens an existing one for appending: its index (read or
+  // recovered) is kept in memory and the file is cut back to the end of the last frame. Frames
+  // after `last_generation` are cut off too, which is how a resumed run drops the generations
+  // written after its checkpoint.
+  bool open(const std::filesystem::path& path,
+            int last_generation = std::numeric_limits<int>::max()) {
+    close();
+    entries_.clear();
+    const auto parent_path = path.parent_path();
+    std::error_code ec;
+    if (!parent_path.empty()) {
+      std::filesystem::create_directories(parent_path, ec);
+      if (ec) {
+        return false;
+      }
+    }
+
+    uint64_t append_offset = 0;
+    const uint64_t existing_size = std::filesystem::exists(path, ec) && !ec
+                                       ? std::filesystem::file_size(path, ec)
+                                       : 0;
+    if (existing_size > 0 && !ec) {
+      std::ifstream existing(path, std::ios::binary);
+      if (!existing.is_open() || !detail::readContainerHeader(existing)) {
+        return false;
+      }
+      if (!detail::readContainerIndex(existing, existing_size, entries_, append_offset)) {
+        existing.clear();
+        detail::recoverContainerIndex(existing, existing_size, entries_, append_offset);
+      }
+      existing.close();
+      const auto kept = std::find_if(entries_.begin(), entries_.end(), [&](const auto& entry) {
+        return entry.generation > last_generation;
+      });
+      if (kept != entries_.end()) {
+        append_offset = kept->offset;
+        entries_.erase(kept, entries_.end());
+      }
+      std::filesystem::resize_file(path, append_offset, ec);
+      if (ec) {
+        return false;
+      }
+      file_.open(path, std::ios::binary | std::ios::in | std::ios::out);
+      file_.seekp(static_cast<std::streamoff>(append_offset));
+      path_ = path;
+    } else {
+      file_.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+      PopulationSnapshotContainerHeader header{};
+      std::copy(kPopulationSnapshotContainerMagic.begin(),
+                kPopulationSnapshotContainerMagic.end(),
+                header.magic);
+      header.version = kPopulationSnapshotContainerVersion;
+      file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      path_ = path;
+    }
+    return file_.is_open() && file_.good();
+  }
+
+  bool isOpen() const { return file_.is_open(); }
+  const std::vector<PopulationSnapshotIndexEntry>& entries() const { return entries_; }
+
+  // Appends one frame and flushes it to the OS. The frame magic is patched in only after the
+  // snapshot bytes and size are written, so a process crash at any point leaves the previous
+  // frames readable. A failed append cuts the partial frame off again, so later frames still
+  // follow the last committed one.
+  bool append(int generation,
+              double tau,
+              uint8_t spatial_dimensions,
+              const std::vector<PopulationSnapshotRecord>& records,
+              const std::vector<PopulationSnapshotDriverMutation>& driver_mutations,
+              MutationPayloadKind payload_kind,
+              const PopulationSnapshotEncoding& encoding) {
+    if (!file_.is_open()) {
+      return false;
+    }
+    const auto frame_offset = static_cast<uint64_t>(file_.tellp());
+    PopulationSnapshotFrameHeader frame{};
+    frame.generation = generation;
+    frame.tau = tau;
+    frame.record_count = static_cast<uint32_t>(records.size());
+    frame.spatial_dimensions = spatial_dimensions;
+    frame.flags = driver_mutations.empty()
+                      ? 0
+                      : (payload_kind == MutationPayloadKind::Full
+                             ? kPopulationSnapshotFlagHasFullMutationPayload
+                             : kPopulationSnapshotFlagHasDriverMutationPayload);
+    file_.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    if (!writePopulationSnapshot(file_, tau, spatial_dimensions, records, driver_mutations,
+                                 payload_kind, encoding)) {
+      discardFrom(frame_offset);
+      return false;
+    }
+    const auto frame_end = static_cast<uint64_t>(file_.tellp());
+    frame.size = frame_end - frame_offset - sizeof(frame);
+    file_.seekp(static_cast<std::streamoff>(frame_offset));
+    file_.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    file_.flush();
+    frame.magic = kPopulationSnapshotFrameMagic;
+    file_.seekp(static_cast<std::streamoff>(frame_offset));
+    file_.write(reinterpret_cast<const char*>(&frame.magic), sizeof(frame.magic));
+    file_.seekp(static_cast<std::streamoff>(frame_end));
+    file_.flush();
+    if (!file_.good()) {
+      discardFrom(frame_offset);
+      return false;
+    }
+    entries_.push_back({frame.generation,
+                        frame.record_count,
+                        frame_offset,
+                        frame.size,
+                        frame.tau,
+                        frame.flags,
+                        frame.spatial_dimensions,
+                        {0, 0, 0, 0, 0, 0}});
+    return true;
+  }
+
+  // Writes the index and trailer. Reopening for append strips them again.
+  bool close() {
+    if (!file_.is_open()) {
+      return true;
+    }
+    PopulationSnapshotIndexTrailer trailer{};
+    trailer.index_offset = static_cast<uint64_t>(file_.tellp());
+    trailer.entry_count = static_cast<uint32_t>(entries_.size());
+    std::copy(kPopulationSnapshotIndexMagic.begin(), kPopulationSnapshotIndexMagic.end(),
+              trailer.magic);
+    if (!entries_.empty()) {
+      file_.write(reinterpret_cast<const char*>(entries_.data()),
+                  static_cast<std::streamsize>(entries_.size() *
+                                               sizeof(PopulationSnapshotIndexEntry)));
+    }
+    file_.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    const bool ok = file_.good();
+    file_.close();
+    return ok;
+  }
+
+ private:
+  // Truncates the file back to `offset`, the start of a frame that failed to append, and
+  // positions the next append there. When that fails too the writer stops accepting frames;
+  // reopening recovers the index from the committed frames.
+  void discardFrom(uint64_t offset) {
+    file_.clear();
+    file_.flush();
+    std::error_code ec;
+    std::filesystem::resize_file(path_, offset, ec);
+    file_.clear();
+    file_.seekp(static_cast<std::streamoff>(offset));
+    if (ec || !file_.good()) {
+      file_.close();
+    }
+  }
+
+  std::fstream file_;
+  std::filesystem::path path_;
+  std::vector<PopulationSnapshotIndexEntry> entries_;
+};
+
+// Where an engine's population snapshots go: one population_generation_N.bin per generation,
+// or frames of population_snapshots.bin. The container is opened on the first write.
+class PopulationSnapshotSink {
+ public:
+  void configure(const std::string& output_path, bool container) {
+    output_path_ = output_path;
+    container_ = container;
+  }
+
+  bool write(int generation,
+             double tau,
+             uint8_t spatial_dimensions,
+             const std::vector<PopulationSnapshotRecord>& records,
+             const std::vector<PopulationSnapshotDriverMutation>& driver_mutations,
+             MutationPayloadKind payload_kind,
+             const PopulationSnapshotEncoding& encoding) {
+    if (!container_) {
+      return writePopulationSnapshot(populationSnapshotPath(output_path_, generation), tau,
+                                     spatial_dimensions, records, driver_mutations,
+                                     payload_kind, encoding);
+    }
+    if (!container_writer_.isOpen() &&
+        !container_writer_.open(populationSnapshotContainerPath(output_path_))) {
+      return false;
+    }
+    return container_writer_.append(generation, tau, spatial_dimensions, records,
+                                    driver_mutations, payload_kind, encoding);
+  }
+
+  // For log messages: the file a generation is written to.
+  std::string describe(int generation) const {
+    return container_ ? populationSnapshotContainerPath(output_path_) + " (generation " +
+                            std::to_string(generation) + ")"
+                      : populationSnapshotPath(output_path_, generation);
+  }
+
+  bool close() { return container_writer_.close(); }
+
+  // Continues a run from a checkpoint taken after generation `last_generation`: later
+  // generations are removed, from the container or as files, and rewritten by the resumed run.
+  bool resume(int last_generation) {
+    const std::filesystem::path container_path = populationSnapshotContainerPath(output_path_);
+    std::error_code ec;
+    if (container_) {
+      return !std::filesystem::exists(container_path, ec) ||
+             container_writer_.open(container_path, last_generation);
+    }
+    const auto population_dir = std::filesystem::path(output_path_) / "population_data";
+    for (const auto& file : listPopulationSnapshotFiles(population_dir)) {
+      if (file.generation > last_generation && !std::filesystem::remove(file.path, ec)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::string output_path_;
+  bool container_ = false;
+  PopulationSnapshotContainerWriter container_writer_;
+};
+
+// Reads generations from whichever layout a run directory's population_data holds. The
+// container is opened, and its index read or recovered, once on the first lookup that needs it,
+// so a session reading many generations pays O(log entries) per lookup rather than O(entries).
+class StoredPopulationSnapshotReader {
+ public:
+  explicit StoredPopulationSnapshotReader(std::filesystem::path population_dir)
+      : population_dir_(std::move(population_dir)) {}
+
+  bool read(int generation,
+            PopulationSnapshotFileHeader& header,
+            std::vector<PopulationSnapshotRecord>& records,
+            std::vector<PopulationSnapshotDriverMutation>& payload) {
+    const auto file_path =
+        population_dir_ / ("population_generation_" + std::to_string(generation) + ".bin");
+    std::error_code ec;
+    if (std::filesystem::exists(file_path, ec) && !ec) {
+      return readPopulationSnapshot(file_path, header, records, payload);
+    }
+    if (!container_tried_) {
+      container_tried_ = true;
+      container_open_ = container_.open(population_dir_ / "population_snapshots.bin");
+    }
+    if (!container_open_) {
+      return false;
+    }
+    const auto* entry = container_.find(generation);
+    return entry != nullptr && container_.read(*entry, header, records, payload);
+  }
+
+ private:
+  std::filesystem::path population_dir_;
+  PopulationSnapshotContainerReader container_;
+  bool container_tried_ = false;
+  bool container_open_ = false;
+};
+
+// One-off lookup; keep a StoredPopulationSnapshotReader for reading several generations.
+inline bool readStoredPopulationSnapshot(const std::filesystem::path& population_dir,
+                                         int generation,
+                                         PopulationSnapshotFileHeader& header,
+                                         std::vector<PopulationSnapshotRecord>& records,
+                                         std::vector<PopulationSnapshotDriverMutation>& payload) {
+  return StoredPopulationSnapshotReader(population_dir).read(generation, header, records, payload);
+}
+
+}  // namespace CellEvoX::io
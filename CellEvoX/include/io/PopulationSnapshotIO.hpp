@@ -2,26 +2,78 @@
 
 #include <algorithm>
 #include <array>
+#include <charconv>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <unordered_map>
 #include <vector>
 
+#include "io/BlockCompressor.hpp"
+#include "io/MappedFile.hpp"
+
 namespace CellEvoX::io {
 
 constexpr std::array<char, 8> kPopulationSnapshotMagic = {'C', 'E', 'L', 'X', 'P', 'O', 'P', '1'};
 constexpr uint32_t kPopulationSnapshotVersion = 2;
 constexpr uint8_t kPopulationSnapshotFlagHasDriverMutationPayload = 0x1;
 constexpr uint8_t kPopulationSnapshotFlagHasFullMutationPayload = 0x2;
+// On-disk version of the columnar layout; readers normalize it to the v2 header and records.
+constexpr uint32_t kPopulationSnapshotColumnarVersion = 3;
+// Power of two, so quantized positions dequantize exactly in float.
+constexpr float kDefaultSnapshotPositionQuantum = 1.0f / 16384.0f;
 
 enum class MutationPayloadKind : uint8_t {
   DriverOnly,
   Full,
 };
 
+struct PopulationSnapshotEncoding {
+  bool columnar = false;  // v3 column blocks instead of v2 fixed-size records
+  float position_quantum = kDefaultSnapshotPositionQuantum;
+};
+
+// v3 column blocks. Integer columns are LEB128 varints, signed ones zigzag-coded deltas:
+//   Ids                   id - previous id
+//   ParentIds             id - parent_id
+//   FitnessDictionary     distinct fitness bit patterns, 4 bytes each
+//   FitnessCodes          dictionary index per record
+//   MutationCounts        mutations_count
+//   PayloadCounts         driver_mutation_count
+//   PayloadOffsets        offset - (previous offset + previous count), zero when contiguous
+//   PositionValid         one byte per record
+//   PositionX/Y/Z         quantized position - previous valid one; absent without valid cells
+//   PayloadMutationIds    mutation_id - previous mutation_id
+//   PayloadMutationTypes  one byte per payload entry
+enum class PopulationSnapshotColumn : uint8_t {
+  Ids,
+  ParentIds,
+  FitnessDictionary,
+  FitnessCodes,
+  MutationCounts,
+  PayloadCounts,
+  PayloadOffsets,
+  PositionValid,
+  PositionX,
+  PositionY,
+  PositionZ,
+  PayloadMutationIds,
+  PayloadMutationTypes,
+  Count,
+};
+
+enum class PopulationSnapshotBlockCodec : uint8_t {
+  Raw,
+  Lz,  // compressBlock()
+};
+
 #pragma pack(push, 1)
 struct PopulationSnapshotFileHeaderV1 {
   char magic[8];
@@ -77,6 +129,27 @@ struct PopulationSnapshotDriverMutation {
   uint8_t mutation_type;
 };
 
+struct PopulationSnapshotFileHeaderV3 {
+  char magic[8];
+  uint32_t version;
+  uint32_t block_count;
+  double tau;
+  uint32_t record_count;
+  uint32_t driver_mutation_count;
+  float position_quantum;
+  uint8_t spatial_dimensions;
+  uint8_t flags;
+  uint8_t reserved[10];
+};
+
+struct PopulationSnapshotColumnBlockHeader {
+  uint8_t column;
+  uint8_t codec;
+  uint8_t reserved[2];
+  uint32_t raw_size;
+  uint32_t stored_size;
+};
+
 struct LegacyPopulationSnapshotRecord3D {
   uint32_t id;
   uint32_t parent_id;
@@ -98,6 +171,10 @@ static_assert(sizeof(PopulationSnapshotRecord) == 36,
               "PopulationSnapshotRecord must stay tightly packed");
 static_assert(sizeof(PopulationSnapshotDriverMutation) == 5,
               "PopulationSnapshotDriverMutation must stay tightly packed");
+static_assert(sizeof(PopulationSnapshotFileHeaderV3) == 48,
+              "PopulationSnapshotFileHeaderV3 must stay tightly packed");
+static_assert(sizeof(PopulationSnapshotColumnBlockHeader) == 12,
+              "PopulationSnapshotColumnBlockHeader must stay tightly packed");
 static_assert(sizeof(LegacyPopulationSnapshotRecord3D) == 25,
               "LegacyPopulationSnapshotRecord3D must stay tightly packed");
 
@@ -107,6 +184,39 @@ inline std::string populationSnapshotPath(const std::string& output_path, int ge
       .string();
 }
 
+struct PopulationSnapshotFile {
+  int generation = 0;
+  std::filesystem::path path;
+};
+
+// The population_generation_<n>.bin files in population_dir, by ascending generation.
+inline std::vector<PopulationSnapshotFile> listPopulationSnapshotFiles(
+    const std::filesystem::path& population_dir) {
+  constexpr std::string_view kPrefix = "population_generation_";
+  constexpr std::string_view kSuffix = ".bin";
+  std::vector<PopulationSnapshotFile> files;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(population_dir, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const std::string name = it->path().filename().string();
+    if (name.size() <= kPrefix.size() + kSuffix.size() || !name.starts_with(kPrefix) ||
+        !name.ends_with(kSuffix) || !it->is_regular_file(ec) || ec) {
+      continue;
+    }
+    const char* digits_begin = name.data() + kPrefix.size();
+    const char* digits_end = name.data() + name.size() - kSuffix.size();
+    int generation = 0;
+    const auto [ptr, parse_error] = std::from_chars(digits_begin, digits_end, generation);
+    if (parse_error == std::errc() && ptr == digits_end && generation >= 0) {
+      files.push_back({generation, it->path()});
+    }
+  }
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.generation < rhs.generation;
+  });
+  return files;
+}
+
 inline PopulationSnapshotFileHeader makePopulationSnapshotHeader(
     double tau,
     uint32_t record_count,
@@ -151,30 +261,428 @@ inline bool hasAnyMutationPayload(const PopulationSnapshotFileHeader& header) {
          header.driver_mutation_count > 0;
 }
 
+namespace detail {
+
+inline void appendVarint(std::vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Bounds-checked cursor over one decoded column; every read fails instead of overrunning.
+class ColumnCursor {
+ public:
+  ColumnCursor() = default;
+  explicit ColumnCursor(const std::vector<uint8_t>& bytes)
+      : in_(bytes.data()), end_(bytes.data() + bytes.size()) {}
+
+  bool readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (in_ == end_) {
+        return false;
+      }
+      const uint8_t byte = *in_++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readByte(uint8_t& value) {
+    if (in_ == end_) {
+      return false;
+    }
+    value = *in_++;
+    return true;
+  }
+
+  bool readRaw(void* value, size_t size) {
+    if (static_cast<size_t>(end_ - in_) < size) {
+      return false;
+    }
+    std::memcpy(value, in_, size);
+    in_ += size;
+    return true;
+  }
+
+  bool readU32(uint32_t& value) { return readRaw(&value, sizeof(value)); }
+
+  bool exhausted() const { return in_ == end_; }
+
+ private:
+  const uint8_t* in_ = nullptr;
+  const uint8_t* end_ = nullptr;
+};
+
+inline bool appendColumnBlock(std::vector<uint8_t>& out,
+                              PopulationSnapshotColumn column,
+                              const std::vector<uint8_t>& raw) {
+  if (raw.size() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  std::vector<uint8_t> compressed;
+  compressBlock(raw.data(), raw.size(), compressed);
+  const bool use_lz = compressed.size() < raw.size();
+  const auto& stored = use_lz ? compressed : raw;
+
+  PopulationSnapshotColumnBlockHeader block{};
+  block.column = static_cast<uint8_t>(column);
+  block.codec = static_cast<uint8_t>(use_lz ? PopulationSnapshotBlockCodec::Lz
+                                            : PopulationSnapshotBlockCodec::Raw);
+  block.raw_size = static_cast<uint32_t>(raw.size());
+  block.stored_size = static_cast<uint32_t>(stored.size());
+  const auto* block_bytes = reinterpret_cast<const uint8_t*>(&block);
+  out.insert(out.end(), block_bytes, block_bytes + sizeof(block));
+  out.insert(out.end(), stored.begin(), stored.end());
+  return true;
+}
+
+inline bool quantizePosition(float value, float quantum, int64_t& quantized) {
+  const double scaled = static_cast<double>(value) / static_cast<double>(quantum);
+  if (!std::isfinite(scaled) || std::abs(scaled) > 0x1p62) {
+    return false;
+  }
+  quantized = std::llround(scaled);
+  return true;
+}
+
+// O(records + payload). Serializes a full v3 file image into `out`.
+inline bool encodeColumnarSnapshot(
+    double tau,
+    uint8_t spatial_dimensions,
+    const std::vector<PopulationSnapshotRecord>& records,
+    const std::vector<PopulationSnapshotDriverMutation>& driver_mutations,
+    MutationPayloadKind payload_kind,
+    float position_quantum,
+    std::vector<uint8_t>& out) {
+  if (!(position_quantum > 0.0f) || !std::isfinite(position_quantum)) {
+    return false;
+  }
+  std::array<std::vector<uint8_t>, static_cast<size_t>(PopulationSnapshotColumn::Count)> columns;
+  const auto column = [&](PopulationSnapshotColumn kind) -> std::vector<uint8_t>& {
+    return columns[static_cast<size_t>(kind)];
+  };
+
+  std::unordered_map<uint32_t, uint32_t> fitness_codes;
+  int64_t previous_id = 0;
+  int64_t expected_offset = 0;
+  std::array<int64_t, 3> previous_position{0, 0, 0};
+  bool any_position = false;
+  for (const auto& record : records) {
+    appendVarint(column(PopulationSnapshotColumn::Ids),
+                 zigzag(static_cast<int64_t>(record.id) - previous_id));
+    previous_id = record.id;
+    appendVarint(column(PopulationSnapshotColumn::ParentIds),
+                 zigzag(static_cast<int64_t>(record.id) - static_cast<int64_t>(record.parent_id)));
+
+    uint32_t fitness_bits = 0;
+    std::memcpy(&fitness_bits, &record.fitness, sizeof(fitness_bits));
+    const auto [code_it, inserted] =
+        fitness_codes.try_emplace(fitness_bits, static_cast<uint32_t>(fitness_codes.size()));
+    if (inserted) {
+      const auto* bits = reinterpret_cast<const uint8_t*>(&fitness_bits);
+      column(PopulationSnapshotColumn::FitnessDictionary).insert(
+          column(PopulationSnapshotColumn::FitnessDictionary).end(), bits, bits + 4);
+    }
+    appendVarint(column(PopulationSnapshotColumn::FitnessCodes), code_it->second);
+
+    appendVarint(column(PopulationSnapshotColumn::MutationCounts), record.mutations_count);
+    appendVarint(column(PopulationSnapshotColumn::PayloadCounts), record.driver_mutation_count);
+    appendVarint(column(PopulationSnapshotColumn::PayloadOffsets),
+                 zigzag(static_cast<int64_t>(record.driver_mutation_offset) - expected_offset));
+    expected_offset =
+        static_cast<int64_t>(record.driver_mutation_offset) + record.driver_mutation_count;
+
+    column(PopulationSnapshotColumn::PositionValid).push_back(record.position_valid);
+    if (record.position_valid == 0) {
+      continue;
+    }
+    any_position = true;
+    const std::array<float, 3> position{record.x, record.y, record.z};
+    for (size_t axis = 0; axis < 3; ++axis) {
+      int64_t quantized = 0;
+      if (!quantizePosition(position[axis], position_quantum, quantized)) {
+        return false;
+      }
+      appendVarint(column(static_cast<PopulationSnapshotColumn>(
+                       static_cast<size_t>(PopulationSnapshotColumn::PositionX) + axis)),
+                   zigzag(quantized - previous_position[axis]));
+      previous_position[axis] = quantized;
+    }
+  }
+
+  int64_t previous_mutation_id = 0;
+  for (const auto& mutation : driver_mutations) {
+    appendVarint(column(PopulationSnapshotColumn::PayloadMutationIds),
+                 zigzag(static_cast<int64_t>(mutation.mutation_id) - previous_mutation_id));
+    previous_mutation_id = mutation.mutation_id;
+    column(PopulationSnapshotColumn::PayloadMutationTypes).push_back(mutation.mutation_type);
+  }
+
+  PopulationSnapshotFileHeaderV3 header{};
+  std::copy(kPopulationSnapshotMagic.begin(), kPopulationSnapshotMagic.end(), header.magic);
+  header.version = kPopulationSnapshotColumnarVersion;
+  header.tau = tau;
+  header.record_count = static_cast<uint32_t>(records.size());
+  header.driver_mutation_count = static_cast<uint32_t>(driver_mutations.size());
+  header.position_quantum = position_quantum;
+  header.spatial_dimensions = spatial_dimensions;
+  header.flags = makePopulationSnapshotHeader(tau,
+                                              header.record_count,
+                                              spatial_dimensions,
+                                              header.driver_mutation_count,
+                                              payload_kind)
+                     .flags;
+
+  out.clear();
+  out.resize(sizeof(header));
+  for (size_t kind = 0; kind < columns.size(); ++kind) {
+    const auto column_kind = static_cast<PopulationSnapshotColumn>(kind);
+    const bool is_position = column_kind == PopulationSnapshotColumn::PositionX ||
+                             column_kind == PopulationSnapshotColumn::PositionY ||
+                             column_kind == PopulationSnapshotColumn::PositionZ;
+    if (is_position && !any_position) {
+      continue;
+    }
+    if (!appendColumnBlock(out, column_kind, columns[kind])) {
+      return false;
+    }
+    ++header.block_count;
+  }
+  std::memcpy(out.data(), &header, sizeof(header));
+  return true;
+}
+
+// O(records + payload). Decodes a v3 file image into the v2 in-memory form. Records without a
+// valid position read back with NaN coordinates.
+inline bool decodeColumnarSnapshot(const uint8_t* data,
+                                   size_t size,
+                                   PopulationSnapshotFileHeader& header,
+                                   std::vector<PopulationSnapshotRecord>& records,
+                                   std::vector<PopulationSnapshotDriverMutation>& driver_mutations) {
+  PopulationSnapshotFileHeaderV3 v3{};
+  if (size < sizeof(v3)) {
+    return false;
+  }
+  std::memcpy(&v3, data, sizeof(v3));
+  if (!(v3.position_quantum > 0.0f) || !std::isfinite(v3.position_quantum)) {
+    return false;
+  }
+
+  constexpr auto kColumnCount = static_cast<size_t>(PopulationSnapshotColumn::Count);
+  std::array<std::vector<uint8_t>, kColumnCount> columns;
+  std::array<bool, kColumnCount> present{};
+  size_t cursor = sizeof(v3);
+  for (uint32_t b = 0; b < v3.block_count; ++b) {
+    PopulationSnapshotColumnBlockHeader block{};
+    if (size - cursor < sizeof(block)) {
+      return false;
+    }
+    std::memcpy(&block, data + cursor, sizeof(block));
+    cursor += sizeof(block);
+    if (size - cursor < block.stored_size) {
+      return false;
+    }
+    const uint8_t* stored = data + cursor;
+    cursor += block.stored_size;
+    if (block.column >= kColumnCount) {
+      continue;  // a column from a newer writer
+    }
+    if (present[block.column]) {
+      return false;
+    }
+    present[block.column] = true;
+    auto& raw = columns[block.column];
+    if (block.codec == static_cast<uint8_t>(PopulationSnapshotBlockCodec::Raw)) {
+      if (block.raw_size != block.stored_size) {
+        return false;
+      }
+      raw.assign(stored, stored + block.stored_size);
+    } else if (block.codec == static_cast<uint8_t>(PopulationSnapshotBlockCodec::Lz)) {
+      // A sequence expands at most ~255x; reject sizes no valid block could claim.
+      if (block.raw_size > static_cast<uint64_t>(block.stored_size) * 256 + 64 ||
+          !decompressBlock(stored, block.stored_size, block.raw_size, raw)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  if (cursor != size) {
+    return false;
+  }
+
+  const auto column = [&](PopulationSnapshotColumn kind) -> const std::vector<uint8_t>& {
+    return columns[static_cast<size_t>(kind)];
+  };
+  for (const auto kind : {PopulationSnapshotColumn::Ids,
+                          PopulationSnapshotColumn::ParentIds,
+                          PopulationSnapshotColumn::FitnessDictionary,
+                          PopulationSnapshotColumn::FitnessCodes,
+                          PopulationSnapshotColumn::MutationCounts,
+                          PopulationSnapshotColumn::PayloadCounts,
+                          PopulationSnapshotColumn::PayloadOffsets,
+                          PopulationSnapshotColumn::PositionValid,
+                          PopulationSnapshotColumn::PayloadMutationIds,
+                          PopulationSnapshotColumn::PayloadMutationTypes}) {
+    if (!present[static_cast<size_t>(kind)]) {
+      return false;
+    }
+  }
+  // Fixed-width columns pin the counts before anything is allocated from the header.
+  if (column(PopulationSnapshotColumn::PositionValid).size() != v3.record_count ||
+      column(PopulationSnapshotColumn::PayloadMutationTypes).size() != v3.driver_mutation_count ||
+      column(PopulationSnapshotColumn::FitnessDictionary).size() % 4 != 0) {
+    return false;
+  }
+
+  ColumnCursor dictionary(column(PopulationSnapshotColumn::FitnessDictionary));
+  std::vector<float> fitness_values(column(PopulationSnapshotColumn::FitnessDictionary).size() / 4);
+  for (float& value : fitness_values) {
+    uint32_t bits = 0;
+    dictionary.readU32(bits);
+    std::memcpy(&value, &bits, sizeof(value));
+  }
+
+  ColumnCursor ids(column(PopulationSnapshotColumn::Ids));
+  ColumnCursor parents(column(PopulationSnapshotColumn::ParentIds));
+  ColumnCursor fitness_codes(column(PopulationSnapshotColumn::FitnessCodes));
+  ColumnCursor mutation_counts(column(PopulationSnapshotColumn::MutationCounts));
+  ColumnCursor payload_counts(column(PopulationSnapshotColumn::PayloadCounts));
+  ColumnCursor payload_offsets(column(PopulationSnapshotColumn::PayloadOffsets));
+  ColumnCursor position_valid(column(PopulationSnapshotColumn::PositionValid));
+  std::array<ColumnCursor, 3> positions;
+  bool any_position = false;
+  for (size_t axis = 0; axis < 3; ++axis) {
+    const size_t kind = static_cast<size_t>(PopulationSnapshotColumn::PositionX) + axis;
+    any_position = any_position || present[kind];
+    positions[axis] = ColumnCursor(columns[kind]);
+  }
+
+  const double quantum = v3.position_quantum;
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+  int64_t previous_id = 0;
+  int64_t expected_offset = 0;
+  std::array<int64_t, 3> previous_position{0, 0, 0};
+  records.resize(v3.record_count);
+  for (auto& record : records) {
+    uint64_t id_delta = 0;
+    uint64_t parent_delta = 0;
+    uint64_t fitness_code = 0;
+    uint64_t mutations_count = 0;
+    uint64_t payload_count = 0;
+    uint64_t offset_delta = 0;
+    if (!ids.readVarint(id_delta) || !parents.readVarint(parent_delta) ||
+        !fitness_codes.readVarint(fitness_code) || fitness_code >= fitness_values.size() ||
+        !mutation_counts.readVarint(mutations_count) ||
+        !payload_counts.readVarint(payload_count) || !payload_offsets.readVarint(offset_delta) ||
+        !position_valid.readByte(record.position_valid)) {
+      return false;
+    }
+    previous_id += unzigzag(id_delta);
+    const int64_t offset = expected_offset + unzigzag(offset_delta);
+    record.id = static_cast<uint32_t>(previous_id);
+    record.parent_id = static_cast<uint32_t>(previous_id - unzigzag(parent_delta));
+    record.fitness = fitness_values[fitness_code];
+    record.mutations_count = static_cast<uint16_t>(mutations_count);
+    record.driver_mutation_count = static_cast<uint16_t>(payload_count);
+    record.driver_mutation_offset = static_cast<uint32_t>(offset);
+    expected_offset = offset + static_cast<int64_t>(payload_count);
+    std::fill(std::begin(record.reserved), std::end(record.reserved), uint8_t{0});
+
+    if (record.position_valid == 0) {
+      record.x = kNaN;
+      record.y = kNaN;
+      record.z = kNaN;
+      continue;
+    }
+    if (!any_position) {
+      return false;
+    }
+    std::array<float, 3> position{};
+    for (size_t axis = 0; axis < 3; ++axis) {
+      uint64_t delta = 0;
+      if (!positions[axis].readVarint(delta)) {
+        return false;
+      }
+      previous_position[axis] += unzigzag(delta);
+      position[axis] =
+          static_cast<float>(static_cast<double>(previous_position[axis]) * quantum);
+    }
+    record.x = position[0];
+    record.y = position[1];
+    record.z = position[2];
+  }
+
+  ColumnCursor mutation_ids(column(PopulationSnapshotColumn::PayloadMutationIds));
+  ColumnCursor mutation_types(column(PopulationSnapshotColumn::PayloadMutationTypes));
+  int64_t previous_mutation_id = 0;
+  driver_mutations.resize(v3.driver_mutation_count);
+  for (auto& mutation : driver_mutations) {
+    uint64_t delta = 0;
+    if (!mutation_ids.readVarint(delta) || !mutation_types.readByte(mutation.mutation_type)) {
+      return false;
+    }
+    previous_mutation_id += unzigzag(delta);
+    mutation.mutation_id = static_cast<uint32_t>(previous_mutation_id);
+  }
+
+  // Trailing bytes in any column mean the counts and the data disagree.
+  for (const auto* cursor_ptr : {&ids, &parents, &fitness_codes, &mutation_counts,
+                                 &payload_counts, &payload_offsets, &position_valid,
+                                 &positions[0], &positions[1], &positions[2],
+                                 &mutation_ids, &mutation_types}) {
+    if (!cursor_ptr->exhausted()) {
+      return false;
+    }
+  }
+
+  header = makePopulationSnapshotHeader(v3.tau, v3.record_count, v3.spatial_dimensions,
+                                        v3.driver_mutation_count);
+  header.flags = v3.driver_mutation_count > 0 ? v3.flags : 0;
+  return true;
+}
+
+}  // namespace detail
+
+// Writes one snapshot in the requested encoding at the stream's current position, so the
+// same bytes can form a standalone file or one frame of a container.
 inline bool writePopulationSnapshot(
-    const std::filesystem::path& path,
+    std::ostream& out,
     double tau,
     uint8_t spatial_dimensions,
     const std::vector<PopulationSnapshotRecord>& records,
     const std::vector<PopulationSnapshotDriverMutation>& driver_mutations = {},
-    MutationPayloadKind payload_kind = MutationPayloadKind::DriverOnly) {
+    MutationPayloadKind payload_kind = MutationPayloadKind::DriverOnly,
+    const PopulationSnapshotEncoding& encoding = {}) {
   if (records.size() > std::numeric_limits<uint32_t>::max() ||
       driver_mutations.size() > std::numeric_limits<uint32_t>::max()) {
     return false;
   }
 
-  const auto parent_path = path.parent_path();
-  if (!parent_path.empty()) {
-    std::error_code ec;
-    std::filesystem::create_directories(parent_path, ec);
-    if (ec) {
+  if (encoding.columnar) {
+    std::vector<uint8_t> columnar_bytes;
+    if (!detail::encodeColumnarSnapshot(tau, spatial_dimensions, records, driver_mutations,
+                                        payload_kind, encoding.position_quantum,
+                                        columnar_bytes)) {
       return false;
     }
-  }
-
-  std::ofstream file(path, std::ios::binary);
-  if (!file.is_open()) {
-    return false;
+    out.write(reinterpret_cast<const char*>(columnar_bytes.data()),
+              static_cast<std::streamsize>(columnar_bytes.size()));
+    return out.good();
   }
 
   const auto header = makePopulationSnapshotHeader(
@@ -184,54 +692,76 @@ inline bool writePopulationSnapshot(
       static_cast<uint32_t>(driver_mutations.size()),
       payload_kind);
 
-  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
   if (!records.empty()) {
-    file.write(reinterpret_cast<const char*>(records.data()),
-               static_cast<std::streamsize>(records.size() * sizeof(PopulationSnapshotRecord)));
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(PopulationSnapshotRecord)));
   }
   if (!driver_mutations.empty()) {
-    file.write(reinterpret_cast<const char*>(driver_mutations.data()),
-               static_cast<std::streamsize>(driver_mutations.size() *
-                                            sizeof(PopulationSnapshotDriverMutation)));
+    out.write(reinterpret_cast<const char*>(driver_mutations.data()),
+              static_cast<std::streamsize>(driver_mutations.size() *
+                                           sizeof(PopulationSnapshotDriverMutation)));
   }
 
-  return file.good();
+  return out.good();
 }
 
-inline bool readPopulationSnapshot(const std::filesystem::path& path,
-                                   PopulationSnapshotFileHeader& header,
-                                   std::vector<PopulationSnapshotRecord>& records,
-                                   std::vector<PopulationSnapshotDriverMutation>& driver_mutations) {
-  records.clear();
-  driver_mutations.clear();
+inline bool writePopulationSnapshot(
+    const std::filesystem::path& path,
+    double tau,
+    uint8_t spatial_dimensions,
+    const std::vector<PopulationSnapshotRecord>& records,
+    const std::vector<PopulationSnapshotDriverMutation>& driver_mutations = {},
+    MutationPayloadKind payload_kind = MutationPayloadKind::DriverOnly,
+    const PopulationSnapshotEncoding& encoding = {}) {
+  const auto parent_path = path.parent_path();
+  if (!parent_path.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(parent_path, ec);
+    if (ec) {
+      return false;
+    }
+  }
 
-  std::ifstream file(path, std::ios::binary);
+  std::ofstream file(path, std::ios::binary);
   if (!file.is_open()) {
     return false;
   }
+  return writePopulationSnapshot(
+      file, tau, spatial_dimensions, records, driver_mutations, payload_kind, encoding);
+}
 
-  file.seekg(0, std::ios::end);
-  const std::streamoff size = file.tellg();
-  if (size < 0) {
-    return false;
-  }
-  file.seekg(0, std::ios::beg);
+// Decodes one snapshot held in memory (a whole file or one container frame) in any
+// supported version: v3 columnar, v2 rows, v1 rows, or the headerless legacy 3D layout.
+inline bool parsePopulationSnapshot(
+    const uint8_t* data,
+    size_t size,
+    PopulationSnapshotFileHeader& header,
+    std::vector<PopulationSnapshotRecord>& records,
+    std::vector<PopulationSnapshotDriverMutation>& driver_mutations) {
+  records.clear();
+  driver_mutations.clear();
 
-  if (size >= static_cast<std::streamoff>(sizeof(PopulationSnapshotFileHeader))) {
+  if (size >= sizeof(PopulationSnapshotFileHeader)) {
     PopulationSnapshotFileHeader candidate{};
-    file.read(reinterpret_cast<char*>(&candidate), sizeof(candidate));
-    if (!file.good()) {
-      return false;
+    std::memcpy(&candidate, data, sizeof(candidate));
+
+    if (isPopulationSnapshotHeader(candidate.magic) &&
+        candidate.version == kPopulationSnapshotColumnarVersion) {
+      if (!detail::decodeColumnarSnapshot(data, size, header, records, driver_mutations)) {
+        records.clear();
+        driver_mutations.clear();
+        return false;
+      }
+      return true;
     }
 
     if (isPopulationSnapshotHeader(candidate.magic) &&
         candidate.version == kPopulationSnapshotVersion) {
       const auto expected_size =
-          static_cast<std::streamoff>(sizeof(PopulationSnapshotFileHeader)) +
-          static_cast<std::streamoff>(candidate.record_count) *
-              static_cast<std::streamoff>(candidate.record_size) +
-          static_cast<std::streamoff>(candidate.driver_mutation_count) *
-              static_cast<std::streamoff>(candidate.mutation_record_size);
+          static_cast<uint64_t>(sizeof(PopulationSnapshotFileHeader)) +
+          static_cast<uint64_t>(candidate.record_count) * candidate.record_size +
+          static_cast<uint64_t>(candidate.driver_mutation_count) * candidate.mutation_record_size;
       if (candidate.record_size != sizeof(PopulationSnapshotRecord) ||
           candidate.mutation_record_size != sizeof(PopulationSnapshotDriverMutation) ||
           expected_size != size) {
@@ -239,44 +769,30 @@ inline bool readPopulationSnapshot(const std::filesystem::path& path,
       }
 
       header = candidate;
+      const uint8_t* cursor = data + sizeof(PopulationSnapshotFileHeader);
       records.resize(candidate.record_count);
       if (!records.empty()) {
-        file.read(reinterpret_cast<char*>(records.data()),
-                  static_cast<std::streamsize>(records.size() * sizeof(PopulationSnapshotRecord)));
-        if (!file.good()) {
-          return false;
-        }
+        std::memcpy(records.data(), cursor, records.size() * sizeof(PopulationSnapshotRecord));
+        cursor += records.size() * sizeof(PopulationSnapshotRecord);
       }
-
       driver_mutations.resize(candidate.driver_mutation_count);
       if (!driver_mutations.empty()) {
-        file.read(reinterpret_cast<char*>(driver_mutations.data()),
-                  static_cast<std::streamsize>(driver_mutations.size() *
-                                               sizeof(PopulationSnapshotDriverMutation)));
-        if (!file.good()) {
-          return false;
-        }
+        std::memcpy(driver_mutations.data(),
+                    cursor,
+                    driver_mutations.size() * sizeof(PopulationSnapshotDriverMutation));
       }
-
       return true;
     }
   }
 
-  if (size >= static_cast<std::streamoff>(sizeof(PopulationSnapshotFileHeaderV1))) {
-    file.clear();
-    file.seekg(0, std::ios::beg);
-
+  if (size >= sizeof(PopulationSnapshotFileHeaderV1)) {
     PopulationSnapshotFileHeaderV1 candidate{};
-    file.read(reinterpret_cast<char*>(&candidate), sizeof(candidate));
-    if (!file.good()) {
-      return false;
-    }
+    std::memcpy(&candidate, data, sizeof(candidate));
 
     if (isPopulationSnapshotHeader(candidate.magic) && candidate.version == 1) {
       const auto expected_size =
-          static_cast<std::streamoff>(sizeof(PopulationSnapshotFileHeaderV1)) +
-          static_cast<std::streamoff>(candidate.record_count) *
-              static_cast<std::streamoff>(candidate.record_size);
+          static_cast<uint64_t>(sizeof(PopulationSnapshotFileHeaderV1)) +
+          static_cast<uint64_t>(candidate.record_count) * candidate.record_size;
       if (candidate.record_size != sizeof(PopulationSnapshotRecordV1) || expected_size != size) {
         return false;
       }
@@ -284,56 +800,40 @@ inline bool readPopulationSnapshot(const std::filesystem::path& path,
       header = makePopulationSnapshotHeader(
           candidate.tau, candidate.record_count, candidate.spatial_dimensions, 0);
       records.resize(candidate.record_count);
-      if (candidate.record_count > 0) {
-        std::vector<PopulationSnapshotRecordV1> legacy_records(candidate.record_count);
-        file.read(reinterpret_cast<char*>(legacy_records.data()),
-                  static_cast<std::streamsize>(legacy_records.size() *
-                                               sizeof(PopulationSnapshotRecordV1)));
-        if (!file.good()) {
-          return false;
-        }
-
-        for (size_t i = 0; i < legacy_records.size(); ++i) {
-          records[i] = {legacy_records[i].id,
-                        legacy_records[i].parent_id,
-                        legacy_records[i].fitness,
-                        legacy_records[i].x,
-                        legacy_records[i].y,
-                        legacy_records[i].z,
-                        legacy_records[i].mutations_count,
-                        0,
-                        0,
-                        legacy_records[i].position_valid,
-                        {0, 0, 0}};
-        }
+      const uint8_t* cursor = data + sizeof(PopulationSnapshotFileHeaderV1);
+      for (size_t i = 0; i < records.size(); ++i) {
+        PopulationSnapshotRecordV1 legacy{};
+        std::memcpy(&legacy, cursor + i * sizeof(legacy), sizeof(legacy));
+        records[i] = {legacy.id,
+                      legacy.parent_id,
+                      legacy.fitness,
+                      legacy.x,
+                      legacy.y,
+                      legacy.z,
+                      legacy.mutations_count,
+                      0,
+                      0,
+                      legacy.position_valid,
+                      {0, 0, 0}};
       }
       return true;
     }
   }
 
-  if (size % static_cast<std::streamoff>(sizeof(LegacyPopulationSnapshotRecord3D)) != 0) {
+  if (size % sizeof(LegacyPopulationSnapshotRecord3D) != 0) {
     return false;
   }
 
-  file.clear();
-  file.seekg(0, std::ios::beg);
-
-  std::vector<LegacyPopulationSnapshotRecord3D> legacy_records(
-      static_cast<size_t>(size / static_cast<std::streamoff>(sizeof(LegacyPopulationSnapshotRecord3D))));
-  if (!legacy_records.empty()) {
-    file.read(reinterpret_cast<char*>(legacy_records.data()), static_cast<std::streamsize>(size));
-    if (!file.good()) {
-      return false;
-    }
-  }
-
+  const size_t legacy_count = size / sizeof(LegacyPopulationSnapshotRecord3D);
   header = makePopulationSnapshotHeader(std::numeric_limits<double>::quiet_NaN(),
-                                        static_cast<uint32_t>(legacy_records.size()),
+                                        static_cast<uint32_t>(legacy_count),
                                         3,
                                         0);
 
-  records.reserve(legacy_records.size());
-  for (const auto& legacy : legacy_records) {
+  records.reserve(legacy_count);
+  for (size_t i = 0; i < legacy_count; ++i) {
+    LegacyPopulationSnapshotRecord3D legacy{};
+    std::memcpy(&legacy, data + i * sizeof(legacy), sizeof(legacy));
     records.push_back({legacy.id,
                        legacy.parent_id,
                        legacy.fitness,
@@ -350,6 +850,23 @@ inline bool readPopulationSnapshot(const std::filesystem::path& path,
   return true;
 }
 
+inline bool readPopulationSnapshot(
+    const std::filesystem::path& path,
+    PopulationSnapshotFileHeader& header,
+    std::vector<PopulationSnapshotRecord>& records,
+    std::vector<PopulationSnapshotDriverMutation>& driver_mutations) {
+  records.clear();
+  driver_mutations.clear();
+
+  // Decoded straight from the page cache; only the output vectors are allocated.
+  MappedFile file;
+  if (!file.open(path)) {
+    return false;
+  }
+  file.advise(MappedFileAccess::Sequential);
+  return parsePopulationSnapshot(file.data(), file.size(), header, records, driver_mutations);
+}
+
 inline bool readPopulationSnapshot(const std::filesystem::path& path,
                                    PopulationSnapshotFileHeader& header,
                                    std::vector<PopulationSnapshotRecord>& records) {
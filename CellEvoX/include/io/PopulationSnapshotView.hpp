@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "io/MappedFile.hpp"
+#include "io/PopulationSnapshotIO.hpp"
+
+namespace CellEvoX::io {
+
+// Read-only snapshot over a memory-mapped file or container frame. The header is validated
+// once on open. Only v2 (snapshot_format "rows", the default) is zero-copy: its records and
+// payload are spans straight into the mapping. v3 columnar, v1 and legacy layouts are decoded
+// into whole rows owned by the view, once per open.
+class PopulationSnapshotView {
+ public:
+  bool open(const std::filesystem::path& path,
+            MappedFileAccess access = MappedFileAccess::Sequential) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+      reset();
+      return false;
+    }
+    const size_t size = file->size();
+    return open(std::move(file), 0, size, access);
+  }
+
+  // Views bytes [offset, offset + size) of a mapping shared with other views, e.g. one frame
+  // of a snapshot container.
+  bool open(std::shared_ptr<const MappedFile> file,
+            size_t offset,
+            size_t size,
+            MappedFileAccess access = MappedFileAccess::Sequential) {
+    reset();
+    if (!file || offset > file->size() || size > file->size() - offset) {
+      return false;
+    }
+    file->advise(access, offset, size);
+    file_ = std::move(file);
+    if (bind(file_->data() + offset, size)) {
+      return true;
+    }
+    reset();
+    return false;
+  }
+
+  const PopulationSnapshotFileHeader& header() const { return header_; }
+  std::span<const PopulationSnapshotRecord> records() const { return records_; }
+  std::span<const PopulationSnapshotDriverMutation> mutations() const { return mutations_; }
+
+  // The record's payload slice, or empty when its offset/count lie outside the payload.
+  std::span<const PopulationSnapshotDriverMutation> mutations(
+      const PopulationSnapshotRecord& record) const {
+    const size_t begin = record.driver_mutation_offset;
+    const size_t count = record.driver_mutation_count;
+    if (begin > mutations_.size() || count > mutations_.size() - begin) {
+      return {};
+    }
+    return mutations_.subspan(begin, count);
+  }
+
+  // True when records() and mutations() point into the mapping, i.e. for v2 snapshots only.
+  bool zeroCopy() const { return zero_copy_; }
+
+ private:
+  void reset() {
+    file_.reset();
+    header_ = {};
+    records_ = {};
+    mutations_ = {};
+    owned_records_.clear();
+    owned_mutations_.clear();
+    zero_copy_ = false;
+  }
+
+  bool bind(const uint8_t* data, size_t size) {
+    if (size >= sizeof(PopulationSnapshotFileHeader)) {
+      PopulationSnapshotFileHeader candidate{};
+      std::memcpy(&candidate, data, sizeof(candidate));
+      if (isPopulationSnapshotHeader(candidate.magic) &&
+          candidate.version == kPopulationSnapshotVersion) {
+        const uint64_t records_bytes =
+            static_cast<uint64_t>(candidate.record_count) * sizeof(PopulationSnapshotRecord);
+        const uint64_t mutations_bytes = static_cast<uint64_t>(candidate.driver_mutation_count) *
+                                         sizeof(PopulationSnapshotDriverMutation);
+        if (candidate.record_size != sizeof(PopulationSnapshotRecord) ||
+            candidate.mutation_record_size != sizeof(PopulationSnapshotDriverMutation) ||
+            sizeof(PopulationSnapshotFileHeader) + records_bytes + mutations_bytes != size) {
+          return false;
+        }
+        // Packed structs have alignment 1, so any byte offset into the mapping is valid.
+        header_ = candidate;
+        const uint8_t* records_begin = data + sizeof(PopulationSnapshotFileHeader);
+        records_ = {reinterpret_cast<const PopulationSnapshotRecord*>(records_begin),
+                    candidate.record_count};
+        mutations_ = {reinterpret_cast<const PopulationSnapshotDriverMutation*>(records_begin +
+                                                                                records_bytes),
+                      candidate.driver_mutation_count};
+        zero_copy_ = true;
+        return true;
+      }
+    }
+
+    if (!parsePopulationSnapshot(data, size, header_, owned_records_, owned_mutations_)) {
+      return false;
+    }
+    records_ = owned_records_;
+    mutations_ = owned_mutations_;
+    return true;
+  }
+
+  std::shared_ptr<const MappedFile> file_;
+  PopulationSnapshotFileHeader header_{};
+  std::span<const PopulationSnapshotRecord> records_;
+  std::span<const PopulationSnapshotDriverMutation> mutations_;
+  std::vector<PopulationSnapshotRecord> owned_records_;
+  std::vector<PopulationSnapshotDriverMutation> owned_mutations_;
+  bool zero_copy_ = false;
+};
+
+}  // namespace CellEvoX::io
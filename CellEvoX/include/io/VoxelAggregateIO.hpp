@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "io/MappedFile.hpp"
+#include "io/PopulationSnapshotIO.hpp"
+
+namespace CellEvoX::io {
+
+// Level-of-detail companion of a 3D population snapshot, written to
+// population_data/voxel_lod/generation_<n>.bin for viewers that cannot afford every cell:
+//   header, clone table, then per resolution a level header and its occupied voxels.
+// Every level covers the same cube: it starts at the minimum cell position and its edge is the
+// largest extent of the positions, split into resolution^3 voxels. A voxel is numbered
+// x + resolution * (y + resolution * z). Clones are driver signatures (sorted driver mutation
+// ids, as in clone_populations.csv); clone 0 is always the ancestor (no drivers), and clone c
+// holds driver ids [clone_offsets[c], clone_offsets[c + 1]) of the driver id table.
+constexpr std::array<char, 8> kVoxelAggregateMagic = {'C', 'E', 'L', 'X', 'V', 'O', 'X', '1'};
+constexpr uint32_t kVoxelAggregateVersion = 1;
+// Keeps voxel numbers within uint32_t.
+constexpr uint32_t kVoxelAggregateMaxResolution = 1024;
+
+#pragma pack(push, 1)
+struct VoxelAggregateFileHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t generation;
+  double tau;
+  uint32_t record_count;
+  uint32_t clone_count;
+  uint32_t clone_driver_count;
+  uint32_t level_count;
+};
+
+struct VoxelAggregateLevelHeader {
+  uint32_t resolution;
+  uint32_t voxel_count;  // occupied voxels that follow, by ascending voxel number
+  float origin[3];
+  float voxel_size;
+};
+
+struct VoxelAggregate {
+  uint32_t voxel;
+  uint32_t cell_count;
+  uint32_t dominant_clone;  // most cells in the voxel; the lower clone index on ties
+  float mean_fitness;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(VoxelAggregateFileHeader) == 40,
+              "VoxelAggregateFileHeader must stay tightly packed");
+static_assert(sizeof(VoxelAggregateLevelHeader) == 24,
+              "VoxelAggregateLevelHeader must stay tightly packed");
+static_assert(sizeof(VoxelAggregate) == 16, "VoxelAggregate must stay tightly packed");
+
+struct VoxelAggregateLevel {
+  uint32_t resolution = 0;
+  std::array<float, 3> origin{};
+  float voxel_size = 0.0f;
+  std::vector<VoxelAggregate> voxels;
+};
+
+struct VoxelAggregateFrame {
+  int generation = 0;
+  double tau = 0.0;
+  uint32_t record_count = 0;  // positioned cells aggregated into every level
+  std::vector<uint32_t> clone_offsets{0};
+  std::vector<uint32_t> clone_driver_ids;
+  std::vector<VoxelAggregateLevel> levels;
+};
+
+inline std::filesystem::path voxelAggregatePath(const std::string& output_path, int generation) {
+  return std::filesystem::path(output_path) / "population_data" / "voxel_lod" /
+         ("generation_" + std::to_string(generation) + ".bin");
+}
+
+// Aggregates the positioned records of one snapshot at each resolution. Payload mutations
+// whose type is set in driver_types form the clone signature, so a driver-only or a full
+// payload gives the same clones.
+inline VoxelAggregateFrame buildVoxelAggregates(
+    int generation,
+    double tau,
+    const std::vector<PopulationSnapshotRecord>& records,
+    const std::vector<PopulationSnapshotDriverMutation>& payload,
+    const std::bitset<256>& driver_types,
+    const std::vector<uint32_t>& resolutions) {
+  VoxelAggregateFrame frame;
+  frame.generation = generation;
+  frame.tau = tau;
+
+  // Clone per positioned record; numbered first-seen, then renumbered in signature order.
+  std::map<std::vector<uint32_t>, uint32_t> clone_by_signature{{{}, 0}};
+  std::vector<uint32_t> record_clone;
+  std::vector<uint32_t> positioned;
+  std::vector<uint32_t> drivers;
+  std::array<float, 3> lower{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                             std::numeric_limits<float>::max()};
+  std::array<float, 3> upper{std::numeric_limits<float>::lowest(),
+                             std::numeric_limits<float>::lowest(),
+                             std::numeric_limits<float>::lowest()};
+  for (uint32_t i = 0; i < records.size(); ++i) {
+    const auto& record = records[i];
+    if (record.position_valid == 0 || !std::isfinite(record.x) || !std::isfinite(record.y) ||
+        !std::isfinite(record.z)) {
+      continue;
+    }
+    drivers.clear();
+    const size_t begin = record.driver_mutation_offset;
+    const size_t end = std::min(payload.size(), begin + record.driver_mutation_count);
+    for (size_t m = begin; m < end; ++m) {
+      if (driver_types.test(payload[m].mutation_type)) {
+        drivers.push_back(payload[m].mutation_id);
+      }
+    }
+    std::sort(drivers.begin(), drivers.end());
+    drivers.erase(std::unique(drivers.begin(), drivers.end()), drivers.end());
+    const auto [it, inserted] =
+        clone_by_signature.try_emplace(drivers, static_cast<uint32_t>(clone_by_signature.size()));
+    record_clone.push_back(it->second);
+    positioned.push_back(i);
+    lower = {std::min(lower[0], record.x), std::min(lower[1], record.y),
+             std::min(lower[2], record.z)};
+    upper = {std::max(upper[0], record.x), std::max(upper[1], record.y),
+             std::max(upper[2], record.z)};
+  }
+  frame.record_count = static_cast<uint32_t>(positioned.size());
+
+  std::vector<uint32_t> renumber(clone_by_signature.size());
+  for (const auto& [signature, first_seen] : clone_by_signature) {
+    renumber[first_seen] = static_cast<uint32_t>(frame.clone_offsets.size() - 1);
+    frame.clone_driver_ids.insert(frame.clone_driver_ids.end(), signature.begin(),
+                                  signature.end());
+    frame.clone_offsets.push_back(static_cast<uint32_t>(frame.clone_driver_ids.size()));
+  }
+  for (auto& clone : record_clone) {
+    clone = renumber[clone];
+  }
+
+  float extent = 0.0f;
+  if (!positioned.empty()) {
+    extent = std::max({upper[0] - lower[0], upper[1] - lower[1], upper[2] - lower[2]});
+  } else {
+    lower = {0.0f, 0.0f, 0.0f};
+  }
+
+  // (voxel << 32 | clone, fitness) per record, sorted so each voxel's clones are contiguous.
+  std::vector<std::pair<uint64_t, float>> keyed(positioned.size());
+  for (const uint32_t resolution : resolutions) {
+    VoxelAggregateLevel level;
+    level.resolution = resolution;
+    level.origin = lower;
+    level.voxel_size = std::max(extent, 1e-3f) / static_cast<float>(resolution);
+    const auto cell = [&](float value, float origin) {
+      const float scaled = std::floor((value - origin) / level.voxel_size);
+      return static_cast<uint64_t>(std::clamp(scaled, 0.0f, static_cast<float>(resolution - 1)));
+    };
+    for (size_t k = 0; k < positioned.size(); ++k) {
+      const auto& record = records[positioned[k]];
+      const uint64_t voxel =
+          cell(record.x, lower[0]) +
+          resolution * (cell(record.y, lower[1]) + resolution * cell(record.z, lower[2]));
+      keyed[k] = {voxel << 32 | record_clone[k], record.fitness};
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    for (size_t begin = 0; begin < keyed.size();) {
+      const uint64_t voxel = keyed[begin].first >> 32;
+      VoxelAggregate aggregate{static_cast<uint32_t>(voxel), 0, 0, 0.0f};
+      uint32_t dominant_cells = 0;
+      double fitness_sum = 0.0;
+      size_t end = begin;
+      while (end < keyed.size() && keyed[end].first >> 32 == voxel) {
+        const uint64_t key = keyed[end].first;
+        uint32_t clone_cells = 0;
+        for (; end < keyed.size() && keyed[end].first == key; ++end) {
+          fitness_sum += keyed[end].second;
+          ++clone_cells;
+        }
+        if (clone_cells > dominant_cells) {
+          dominant_cells = clone_cells;
+          aggregate.dominant_clone = static_cast<uint32_t>(key & 0xffffffffu);
+        }
+        aggregate.cell_count += clone_cells;
+      }
+      aggregate.mean_fitness = static_cast<float>(fitness_sum / aggregate.cell_count);
+      level.voxels.push_back(aggregate);
+      begin = end;
+    }
+    frame.levels.push_back(std::move(level));
+  }
+  return frame;
+}
+
+inline bool writeVoxelAggregates(const std::filesystem::path& path,
+                                 const VoxelAggregateFrame& frame) {
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  if (ec) {
+    return false;
+  }
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  VoxelAggregateFileHeader header{};
+  std::copy(kVoxelAggregateMagic.begin(), kVoxelAggregateMagic.end(), header.magic);
+  header.version = kVoxelAggregateVersion;
+  header.generation = frame.generation;
+  header.tau = frame.tau;
+  header.record_count = frame.record_count;
+  header.clone_count = static_cast<uint32_t>(frame.clone_offsets.size() - 1);
+  header.clone_driver_count = static_cast<uint32_t>(frame.clone_driver_ids.size());
+  header.level_count = static_cast<uint32_t>(frame.levels.size());
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(frame.clone_offsets.data()),
+             static_cast<std::streamsize>(frame.clone_offsets.size() * sizeof(uint32_t)));
+  file.write(reinterpret_cast<const char*>(frame.clone_driver_ids.data()),
+             static_cast<std::streamsize>(frame.clone_driver_ids.size() * sizeof(uint32_t)));
+  for (const auto& level : frame.levels) {
+    const VoxelAggregateLevelHeader level_header{
+        level.resolution,
+        static_cast<uint32_t>(level.voxels.size()),
+        {level.origin[0], level.origin[1], level.origin[2]},
+        level.voxel_size};
+    file.write(reinterpret_cast<const char*>(&level_header), sizeof(level_header));
+    file.write(reinterpret_cast<const char*>(level.voxels.data()),
+               static_cast<std::streamsize>(level.voxels.size() * sizeof(VoxelAggregate)));
+  }
+  return file.good();
+}
+
+// Writes the voxel LOD file of one 3D snapshot when `resolutions` asks for any; true when there
+// is nothing to write. `mutation_types` maps a mutation type id to a type with `is_driver`.
+template <typename MutationTypeMap>
+inline bool writeVoxelAggregatesFor(const std::string& output_path,
+                                    const std::vector<uint32_t>& resolutions,
+                                    int generation,
+                                    double tau,
+                                    const std::vector<PopulationSnapshotRecord>& records,
+                                    const std::vector<PopulationSnapshotDriverMutation>& payload,
+                                    const MutationTypeMap& mutation_types) {
+  if (resolutions.empty()) {
+    return true;
+  }
+  std::bitset<256> driver_types;
+  for (const auto& [type_id, mutation_type] : mutation_types) {
+    driver_types.set(type_id, mutation_type.is_driver);
+  }
+  return writeVoxelAggregates(
+      voxelAggregatePath(output_path, generation),
+      buildVoxelAggregates(generation, tau, records, payload, driver_types, resolutions));
+}
+
+inline bool readVoxelAggregates(const std::filesystem::path& path, VoxelAggregateFrame& frame) {
+  MappedFile file;
+  if (!file.open(path) || file.size() < sizeof(VoxelAggregateFileHeader)) {
+    return false;
+  }
+  const uint8_t* cursor = file.data();
+  const uint8_t* const end = file.data() + file.size();
+  const auto take = [&](void* out, size_t size) {
+    if (static_cast<size_t>(end - cursor) < size) {
+      return false;
+    }
+    std::memcpy(out, cursor, size);
+    cursor += size;
+    return true;
+  };
+
+  VoxelAggregateFileHeader header{};
+  take(&header, sizeof(header));
+  if (!std::equal(kVoxelAggregateMagic.begin(), kVoxelAggregateMagic.end(), header.magic) ||
+      header.version != kVoxelAggregateVersion ||
+      header.clone_count > file.size() / sizeof(uint32_t) ||
+      header.clone_driver_count > file.size() / sizeof(uint32_t)) {
+    return false;
+  }
+  frame = {};
+  frame.generation = header.generation;
+  frame.tau = header.tau;
+  frame.record_count = header.record_count;
+  frame.clone_offsets.resize(size_t{header.clone_count} + 1);
+  frame.clone_driver_ids.resize(header.clone_driver_count);
+  if (!take(frame.clone_offsets.data(), frame.clone_offsets.size() * sizeof(uint32_t)) ||
+      !take(frame.clone_driver_ids.data(), frame.clone_driver_ids.size() * sizeof(uint32_t))) {
+    return false;
+  }
+  for (uint32_t i = 0; i < header.level_count; ++i) {
+    VoxelAggregateLevelHeader level_header{};
+    if (!take(&level_header, sizeof(level_header)) ||
+        level_header.voxel_count > file.size() / sizeof(VoxelAggregate)) {
+      return false;
+    }
+    VoxelAggregateLevel level;
+    level.resolution = level_header.resolution;
+    level.origin = {level_header.origin[0], level_header.origin[1], level_header.origin[2]};
+    level.voxel_size = level_header.voxel_size;
+    level.voxels.resize(level_header.voxel_count);
+    if (!take(level.voxels.data(), level.voxels.size() * sizeof(VoxelAggregate))) {
+      return false;
+    }
+    frame.levels.push_back(std::move(level));
+  }
+  return cursor == end;
+}
+
+}  // namespace CellEvoX::io
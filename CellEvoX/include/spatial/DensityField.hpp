@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spatial/SpatialHashGrid.hpp"
+
+namespace CellEvoX::spatial {
+
+// Crowding estimate from per-voxel occupancy: cell counts of a SpatialHashGrid's voxels are
+// binned into field voxels, box-filtered over a cube of (2w + 1)^3 field voxels that spans the
+// sampling sphere, rescaled from cube to sphere volume and trilinearly interpolated at query
+// points. Building and sampling cost
+// O(voxels + cells) independently of the radius, at the price of a smoothed rather than exact
+// neighbor count.
+class DensityField {
+ public:
+  // O(voxels). `grid` must be rebuilt for the current positions. Field voxels are an integer
+  // multiple of the grid's, about half the radius for large radii.
+  void build(const SpatialHashGrid& grid, float radius);
+
+  // O(1). Estimated number of cells within the build radius of (x, y, z), including any cell at
+  // the point itself.
+  float sample(float x, float y, float z) const;
+
+  // Filter half-width in field voxels and field voxel edge of the last build().
+  int halfWidth() const { return half_width_; }
+  float voxelSize() const { return voxel_size_; }
+
+ private:
+  void boxFilterAxis(const std::vector<float>& source, std::vector<float>& target, int axis) const;
+  float at(int ix, int iy, int iz) const;
+
+  int dim_ = 0;
+  int half_width_ = 0;
+  float voxel_size_ = 1.0f;
+  float sphere_to_box_ = 1.0f;
+  std::vector<float> field_;
+  std::vector<float> scratch_;
+};
+
+}  // namespace CellEvoX::spatial
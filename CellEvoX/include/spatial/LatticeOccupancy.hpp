@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spatial/LiveIdIndex.hpp"
+
+namespace CellEvoX::spatial {
+
+// Cubic lattice of dim^3 voxels holding at most one cell each. Occupancy is a bitmap (one bit
+// per voxel) so free-neighbor scans touch few cache lines; owners of occupied voxels, needed
+// only for pushes, live in a hash sized by the cells rather than the lattice, so memory is one
+// bit per voxel plus O(occupied). Voxels are addressed by ix + iy * dim + iz * dim^2.
+class LatticeOccupancy {
+ public:
+  static constexpr uint32_t kNoOwner = LiveIdIndex::kNotFound;
+  // Largest dim whose voxel indices fit below the uint32_t sentinel.
+  static constexpr int kMaxDim = 1625;
+
+  // The 26 offsets of the Moore neighborhood.
+  static const std::array<std::array<int, 3>, 26> kNeighborOffsets;
+
+  // Lattice edge length for a domain of `domain_size` covered by voxels of `spacing`.
+  static int dimForDomain(float domain_size, float spacing);
+
+  explicit LatticeOccupancy(int dim);
+
+  int dim() const { return dim_; }
+  size_t voxelCount() const { return voxel_count_; }
+  size_t occupiedCount() const { return occupied_count_; }
+
+  uint32_t voxelIndex(int ix, int iy, int iz) const {
+    return static_cast<uint32_t>(ix) + static_cast<uint32_t>(iy) * static_cast<uint32_t>(dim_) +
+           static_cast<uint32_t>(iz) * static_cast<uint32_t>(dim_) * static_cast<uint32_t>(dim_);
+  }
+  std::array<int, 3> coordinates(uint32_t voxel) const {
+    const auto dim = static_cast<uint32_t>(dim_);
+    return {static_cast<int>(voxel % dim),
+            static_cast<int>((voxel / dim) % dim),
+            static_cast<int>(voxel / (dim * dim))};
+  }
+  bool inBounds(int ix, int iy, int iz) const {
+    return ix >= 0 && iy >= 0 && iz >= 0 && ix < dim_ && iy < dim_ && iz < dim_;
+  }
+
+  bool isOccupied(uint32_t voxel) const {
+    return (bits_[voxel >> 6] >> (voxel & 63u)) & 1u;
+  }
+  // Expected O(1).
+  uint32_t ownerOf(uint32_t voxel) const { return owners_.find(voxel); }
+
+  // Amortized O(1); not thread-safe. Claims a free voxel, or hands an occupied one to a new
+  // owner.
+  void occupy(uint32_t voxel, uint32_t id);
+  // Amortized O(1); not thread-safe. No-op for a free voxel.
+  void release(uint32_t voxel);
+
+  // Memory held by the bitmap and the owner hash.
+  size_t memoryBytes() const;
+
+ private:
+  int dim_;
+  size_t voxel_count_ = 0;
+  size_t occupied_count_ = 0;
+  std::vector<uint64_t> bits_;
+  // Voxel -> owner id; voxel indices stay below the index's empty key, see kMaxDim.
+  LiveIdIndex owners_;
+};
+
+}  // namespace CellEvoX::spatial
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace CellEvoX::spatial {
+
+// Cell id -> spatial slot map sized by the live population rather than by the largest id ever
+// issued. Open addressing with linear probing over a power-of-two table kept between 1/8 and
+// 1/2 full; erase() shifts entries back instead of leaving tombstones, so probe chains stay
+// short however many cells have died.
+class LiveIdIndex {
+ public:
+  static constexpr uint32_t kNotFound = std::numeric_limits<uint32_t>::max();
+
+  // Expected O(1). Slot of `id`, or kNotFound.
+  uint32_t find(uint32_t id) const {
+    if (size_ == 0) {
+      return kNotFound;
+    }
+    for (size_t slot = tableSlot(id);; slot = (slot + 1) & mask_) {
+      const Entry& entry = entries_[slot];
+      if (entry.id == id) {
+        return entry.value;
+      }
+      if (entry.id == kEmptyId) {
+        return kNotFound;
+      }
+    }
+  }
+
+  // Expected O(1). Rewrites the slot of an id that is already present; safe to call
+  // concurrently for distinct ids since the table layout does not change.
+  void update(uint32_t id, uint32_t value);
+
+  // Amortized O(1); not thread-safe. Inserts `id` or overwrites its slot.
+  void insert(uint32_t id, uint32_t value);
+
+  // Amortized O(1); not thread-safe. No-op for absent ids.
+  void erase(uint32_t id);
+
+  // O(N). Maps ids[i] -> i for every i, replacing the previous contents.
+  void assign(const std::vector<uint32_t>& ids);
+
+  void clear();
+  void reserve(size_t count);
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return entries_.size(); }
+  size_t memoryBytes() const { return entries_.capacity() * sizeof(Entry); }
+
+ private:
+  // Id max() is never issued as a cell id, matching kInvalidSpatialIndex in the engines.
+  static constexpr uint32_t kEmptyId = std::numeric_limits<uint32_t>::max();
+
+  struct Entry {
+    uint32_t id = kEmptyId;
+    uint32_t value = 0;
+  };
+
+  size_t tableSlot(uint32_t id) const {
+    // Fibonacci hashing spreads consecutive ids, which are born together, across the table.
+    return static_cast<size_t>((static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  void rehash(size_t capacity);
+  void insertNew(uint32_t id, uint32_t value);
+
+  std::vector<Entry> entries_;
+  size_t mask_ = 0;
+  int shift_ = 64;
+  size_t size_ = 0;
+};
+
+}  // namespace CellEvoX::spatial
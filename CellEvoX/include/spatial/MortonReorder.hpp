@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace CellEvoX::io {
+class CheckpointReader;
+class CheckpointWriter;
+}  // namespace CellEvoX::io
+
+namespace CellEvoX::spatial {
+
+// Morton (Z-order) key with 21 bits per axis; voxels close in space get close keys.
+uint64_t mortonKey(uint32_t ix, uint32_t iy, uint32_t iz);
+
+// O(N) locality metric: mean distance between cells stored in consecutive slots.
+double meanConsecutiveDistance(const std::vector<float>& px,
+                               const std::vector<float>& py,
+                               const std::vector<float>& pz);
+
+// Keeps parallel cell arrays sorted along the Morton curve of their voxels, so cells that are
+// neighbors in space are also neighbors in memory. Births appended after a reorder raise the
+// mean consecutive distance; once it exceeds `degradation` times the value measured right
+// after the last reorder, the arrays are sorted again.
+class MortonReorder {
+ public:
+  explicit MortonReorder(float voxel_size);
+
+  // O(N) locality check, plus an O(N log N) reorder when it triggers. Returns true when the
+  // arrays were permuted; callers must then refresh any index keyed by slot.
+  bool maybeReorder(std::vector<uint32_t>& ids,
+                    std::vector<float>& px,
+                    std::vector<float>& py,
+                    std::vector<float>& pz,
+                    float degradation);
+
+  // O(N log N) stable sort by (Morton key, current slot).
+  void reorder(std::vector<uint32_t>& ids,
+               std::vector<float>& px,
+               std::vector<float>& py,
+               std::vector<float>& pz);
+
+  double baselineLocality() const { return baseline_locality_; }
+
+  void saveState(CellEvoX::io::CheckpointWriter& writer) const;
+  bool restoreState(CellEvoX::io::CheckpointReader& reader);
+
+ private:
+  void gather(std::vector<float>& values);
+
+  float voxel_size_;
+  double baseline_locality_ = 0.0;
+  std::vector<std::pair<uint64_t, uint32_t>> keyed_slots_;
+  std::vector<uint32_t> scratch_ids_;
+  std::vector<float> scratch_values_;
+};
+
+}  // namespace CellEvoX::spatial
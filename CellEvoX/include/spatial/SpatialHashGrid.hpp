@@ -1,15 +1,32 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range3d.h>
+#include <tbb/parallel_for.h>
+
+namespace CellEvoX::io {
+class CheckpointReader;
+class CheckpointWriter;
+}  // namespace CellEvoX::io
+
 class SpatialHashGrid {
  public:
-  explicit SpatialHashGrid(float voxel_size, float domain_size);
+  // Covers [0, domain_size)^3. With `grow_with_cells`, rebuild() instead moves the grid origin
+  // and resizes its extent to the bounding box of the cells, so cells may leave [0, domain_size)
+  // and the dense voxel index is sized by the tumor rather than by the domain.
+  explicit SpatialHashGrid(float voxel_size, float domain_size, bool grow_with_cells = false);
+
+  // Lays the grid over the box [lo, hi] instead, one extent per axis, until the next call.
+  // Cells outside the box are clamped into its border voxels. For fixed grids only: a growing
+  // grid refits itself to a cube on every rebuild().
+  void fitToBounds(const std::array<float, 3>& lo, const std::array<float, 3>& hi);
 
   // O(N log N) rebuild based on voxel-hash sorting.
   void rebuild(const std::vector<uint32_t>& ids,
@@ -20,57 +37,313 @@ class SpatialHashGrid {
   // O(1) per query for fixed r / voxel_size.
   template <typename Callback>
   void queryRadius(float x, float y, float z, float r, Callback&& cb) const {
+    forEachCandidateRun(x, y, z, r, [&](size_t begin_idx, size_t end_idx) {
+      for (size_t idx = begin_idx; idx < end_idx; ++idx) {
+        cb(sorted_ids_[idx]);
+      }
+    });
+  }
+
+  // queryRadius() reporting the index each candidate had in the arrays passed to rebuild(), so
+  // callers that index those arrays need no id lookup.
+  template <typename Callback>
+  void querySourceRadius(float x, float y, float z, float r, Callback&& cb) const {
+    forEachCandidateRun(x, y, z, r, [&](size_t begin_idx, size_t end_idx) {
+      for (size_t idx = begin_idx; idx < end_idx; ++idx) {
+        cb(sorted_source_[idx]);
+      }
+    });
+  }
+
+  // Reports the voxel-sorted slots covering the query cube as contiguous [begin, end) runs,
+  // so kernels can stream sortedX/Y/Z directly. Voxels of one x-row are adjacent in the sorted
+  // order, so each row of the stencil is a single run in both the dense and sparse index.
+  template <typename RunCallback>
+  void forEachCandidateRun(float x, float y, float z, float r, RunCallback&& cb) const {
     if (sorted_ids_.empty()) {
       return;
     }
 
-    const int center_ix = clampVoxelIndex(static_cast<int>(std::floor(x / voxel_size_)));
-    const int center_iy = clampVoxelIndex(static_cast<int>(std::floor(y / voxel_size_)));
-    const int center_iz = clampVoxelIndex(static_cast<int>(std::floor(z / voxel_size_)));
+    const int center_ix = clampVoxelIndex(voxelCoordinate(x, 0), 0);
+    const int center_iy = clampVoxelIndex(voxelCoordinate(y, 1), 1);
+    const int center_iz = clampVoxelIndex(voxelCoordinate(z, 2), 2);
     const int span = static_cast<int>(std::ceil(r / voxel_size_));
 
     const int ix_min = std::max(0, center_ix - span);
     const int iy_min = std::max(0, center_iy - span);
     const int iz_min = std::max(0, center_iz - span);
-    const int ix_max = std::min(grid_dim_ - 1, center_ix + span);
-    const int iy_max = std::min(grid_dim_ - 1, center_iy + span);
-    const int iz_max = std::min(grid_dim_ - 1, center_iz + span);
+    const int ix_max = std::min(dims_[0] - 1, center_ix + span);
+    const int iy_max = std::min(dims_[1] - 1, center_iy + span);
+    const int iz_max = std::min(dims_[2] - 1, center_iz + span);
 
     for (int iz = iz_min; iz <= iz_max; ++iz) {
       for (int iy = iy_min; iy <= iy_max; ++iy) {
-        for (int ix = ix_min; ix <= ix_max; ++ix) {
-          const int64_t hash = hashVoxel(ix, iy, iz);
-          std::pair<int32_t, int32_t> voxel_range{0, 0};
-          if (use_dense_ranges_) {
-            voxel_range = dense_voxel_ranges_[static_cast<size_t>(hash)];
-          } else {
-            const auto range_it = voxel_ranges_.find(hash);
-            if (range_it == voxel_ranges_.end()) {
-              continue;
-            }
-            voxel_range = range_it->second;
+        if (use_dense_ranges_) {
+          const int32_t row_begin =
+              dense_voxel_ranges_[static_cast<size_t>(hashVoxel(ix_min, iy, iz))].first;
+          const int32_t row_end =
+              dense_voxel_ranges_[static_cast<size_t>(hashVoxel(ix_max, iy, iz))].second;
+          if (row_begin < row_end) {
+            cb(static_cast<size_t>(row_begin), static_cast<size_t>(row_end));
           }
+          continue;
+        }
 
-          const auto [begin_idx, end_idx] = voxel_range;
-          for (int32_t idx = begin_idx; idx < end_idx; ++idx) {
-            cb(sorted_ids_[static_cast<size_t>(idx)]);
+        int32_t row_begin = -1;
+        int32_t row_end = -1;
+        for (int ix = ix_min; ix <= ix_max; ++ix) {
+          const int32_t occupied = findOccupiedVoxel(hashVoxel(ix, iy, iz));
+          if (occupied >= 0) {
+            const auto [begin_idx, end_idx] = occupied_ranges_[static_cast<size_t>(occupied)];
+            row_begin = row_begin < 0 ? begin_idx : row_begin;
+            row_end = end_idx;
           }
         }
+        if (row_begin >= 0) {
+          cb(static_cast<size_t>(row_begin), static_cast<size_t>(row_end));
+        }
       }
     }
   }
 
+  // Voxel-sorted SoA copies written by rebuild(); slot k holds the cell that rebuild() received
+  // at index sortedSourceIndices()[k].
+  const std::vector<uint32_t>& sortedIds() const { return sorted_ids_; }
+  const std::vector<uint32_t>& sortedSourceIndices() const { return sorted_source_; }
+  const std::vector<float>& sortedX() const { return sorted_x_; }
+  const std::vector<float>& sortedY() const { return sorted_y_; }
+  const std::vector<float>& sortedZ() const { return sorted_z_; }
+
+  // Visits every unordered pair of cells sharing a voxel or lying in adjacent voxels exactly
+  // once: intra-voxel pairs plus the 13 forward offsets of the half-shell stencil. Voxels run
+  // in 18 colors (ix % 3, iy % 3, iz % 2), so voxels processed concurrently never share a cell
+  // and `cb(id_a, id_b)` may update both cells without atomics. Only pairs within one voxel of
+  // each other are reported, so voxel_size must be at least the interaction radius.
+  template <typename PairCallback>
+  void forEachHalfStencilPair(PairCallback&& cb) const {
+    forEachHalfStencilSlotPair(sorted_ids_, cb);
+  }
+
+  // forEachHalfStencilPair() over the indices the cells had in the arrays passed to rebuild().
+  template <typename PairCallback>
+  void forEachHalfStencilSourcePair(PairCallback&& cb) const {
+    forEachHalfStencilSlotPair(sorted_source_, cb);
+  }
+
+  // Visits occupied voxels in ascending hash order as cb(hash, begin, end) over sorted slots.
+  // O(voxels) with dense ranges, O(occupied voxels) with the sparse index.
+  template <typename VoxelCallback>
+  void forEachOccupiedVoxel(VoxelCallback&& cb) const {
+    if (sorted_ids_.empty()) {
+      return;
+    }
+    if (use_dense_ranges_) {
+      for (size_t voxel = 0; voxel < dense_voxel_ranges_.size(); ++voxel) {
+        const auto [begin_idx, end_idx] = dense_voxel_ranges_[voxel];
+        if (begin_idx < end_idx) {
+          cb(static_cast<int64_t>(voxel),
+             static_cast<size_t>(begin_idx),
+             static_cast<size_t>(end_idx));
+        }
+      }
+      return;
+    }
+    for (size_t v = 0; v < occupied_voxels_.size(); ++v) {
+      cb(occupied_voxels_[v],
+         static_cast<size_t>(occupied_ranges_[v].first),
+         static_cast<size_t>(occupied_ranges_[v].second));
+    }
+  }
+
   int64_t hashVoxel(int ix, int iy, int iz) const;
+  // Hash of the voxel containing (x, y, z), clamped to the grid like rebuild() does.
+  int64_t voxelOf(float x, float y, float z) const;
+  float voxelSize() const { return voxel_size_; }
+  // Voxels per axis of a cubic grid; grids laid over a box by fitToBounds() use gridDims().
+  int gridDim() const { return dims_[0]; }
+  const std::array<int, 3>& gridDims() const { return dims_; }
+  // World position of voxel (0, 0, 0)'s lower corner on x, which cubic grids share with y and z;
+  // always a multiple of the voxel size and only non-zero for growing or fitted grids.
+  float origin() const { return static_cast<float>(origin_voxels_[0]) * voxel_size_; }
+
+  // The layout only: a growing grid refits with hysteresis, so its extent depends on history.
+  // The contents are not saved; rebuild() after restoreState() before querying.
+  void saveState(CellEvoX::io::CheckpointWriter& writer) const;
+  bool restoreState(CellEvoX::io::CheckpointReader& reader);
 
  private:
-  int clampVoxelIndex(int value) const;
+  // Forward half of the 26-neighborhood: (dz > 0) or (dz == 0 and dy > 0) or (dz == dy == 0 and
+  // dx > 0). Together with intra-voxel pairs it covers every adjacent voxel pair once.
+  static constexpr std::array<std::array<int, 3>, 13> kForwardStencil{{{1, 0, 0},
+                                                                       {-1, 1, 0},
+                                                                       {0, 1, 0},
+                                                                       {1, 1, 0},
+                                                                       {-1, -1, 1},
+                                                                       {0, -1, 1},
+                                                                       {1, -1, 1},
+                                                                       {-1, 0, 1},
+                                                                       {0, 0, 1},
+                                                                       {1, 0, 1},
+                                                                       {-1, 1, 1},
+                                                                       {0, 1, 1},
+                                                                       {1, 1, 1}}};
+
+  // Shared half-stencil traversal; reports labels[slot] for both cells of every pair.
+  template <typename PairCallback>
+  void forEachHalfStencilSlotPair(const std::vector<uint32_t>& labels, PairCallback& cb) const {
+    if (sorted_ids_.empty()) {
+      return;
+    }
+
+    auto visit_voxel = [&](int ix, int iy, int iz, std::pair<int32_t, int32_t> home) {
+      const auto [home_begin, home_end] = home;
+      for (int32_t a = home_begin; a < home_end; ++a) {
+        for (int32_t b = a + 1; b < home_end; ++b) {
+          cb(labels[static_cast<size_t>(a)], labels[static_cast<size_t>(b)]);
+        }
+      }
+
+      for (const auto& offset : kForwardStencil) {
+        const int nx = ix + offset[0];
+        const int ny = iy + offset[1];
+        const int nz = iz + offset[2];
+        if (nx < 0 || ny < 0 || nx >= dims_[0] || ny >= dims_[1] || nz >= dims_[2]) {
+          continue;
+        }
+        const auto [other_begin, other_end] = voxelRange(hashVoxel(nx, ny, nz));
+        for (int32_t a = home_begin; a < home_end; ++a) {
+          for (int32_t b = other_begin; b < other_end; ++b) {
+            cb(labels[static_cast<size_t>(a)], labels[static_cast<size_t>(b)]);
+          }
+        }
+      }
+    };
+
+    if (use_dense_ranges_) {
+      for (int cz = 0; cz < 2; ++cz) {
+        for (int cy = 0; cy < 3; ++cy) {
+          for (int cx = 0; cx < 3; ++cx) {
+            const int nx = (dims_[0] - cx + 2) / 3;
+            const int ny = (dims_[1] - cy + 2) / 3;
+            const int nz = (dims_[2] - cz + 1) / 2;
+            if (nx <= 0 || ny <= 0 || nz <= 0) {
+              continue;
+            }
+
+            tbb::parallel_for(tbb::blocked_range3d<int>(0, nz, 0, ny, 0, nx),
+                              [&](const tbb::blocked_range3d<int>& range) {
+                                for (int z = range.pages().begin(); z != range.pages().end(); ++z) {
+                                  for (int y = range.rows().begin(); y != range.rows().end(); ++y) {
+                                    for (int x = range.cols().begin(); x != range.cols().end();
+                                         ++x) {
+                                      const int ix = cx + 3 * x;
+                                      const int iy = cy + 3 * y;
+                                      const int iz = cz + 2 * z;
+                                      const auto home = dense_voxel_ranges_[static_cast<size_t>(
+                                          hashVoxel(ix, iy, iz))];
+                                      if (home.first != home.second) {
+                                        visit_voxel(ix, iy, iz, home);
+                                      }
+                                    }
+                                  }
+                                }
+                              });
+          }
+        }
+      }
+      return;
+    }
+
+    // O(occupied voxels) bucketing; occupied voxels are already in ascending hash order.
+    const int64_t dim_x = static_cast<int64_t>(dims_[0]);
+    const int64_t dim_y = static_cast<int64_t>(dims_[1]);
+    std::array<std::vector<size_t>, 18> voxels_by_color;
+    for (size_t v = 0; v < occupied_voxels_.size(); ++v) {
+      const int64_t hash = occupied_voxels_[v];
+      const int64_t ix = hash % dim_x;
+      const int64_t iy = (hash / dim_x) % dim_y;
+      const int64_t iz = hash / (dim_x * dim_y);
+      voxels_by_color[static_cast<size_t>(ix % 3 + 3 * (iy % 3) + 9 * (iz % 2))].push_back(v);
+    }
+
+    for (const auto& voxels : voxels_by_color) {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, voxels.size()),
+                        [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t v = range.begin(); v != range.end(); ++v) {
+                            const int64_t hash = occupied_voxels_[voxels[v]];
+                            visit_voxel(static_cast<int>(hash % dim_x),
+                                        static_cast<int>((hash / dim_x) % dim_y),
+                                        static_cast<int>(hash / (dim_x * dim_y)),
+                                        occupied_ranges_[voxels[v]]);
+                          }
+                        });
+    }
+  }
+
+  std::pair<int32_t, int32_t> voxelRange(int64_t hash) const {
+    if (use_dense_ranges_) {
+      return dense_voxel_ranges_[static_cast<size_t>(hash)];
+    }
+    const int32_t occupied = findOccupiedVoxel(hash);
+    return occupied < 0 ? std::pair<int32_t, int32_t>{0, 0}
+                        : occupied_ranges_[static_cast<size_t>(occupied)];
+  }
+
+  // Linear probing over a power-of-two table sized to twice the occupied voxel count; returns
+  // the index into occupied_voxels_ or -1. Expected O(1) with at most a couple of probes.
+  int32_t findOccupiedVoxel(int64_t hash) const {
+    size_t slot = tableSlot(hash);
+    while (true) {
+      const int32_t occupied = voxel_table_[slot];
+      if (occupied < 0 || occupied_voxels_[static_cast<size_t>(occupied)] == hash) {
+        return occupied;
+      }
+      slot = (slot + 1) & voxel_table_mask_;
+    }
+  }
+
+  size_t tableSlot(int64_t hash) const {
+    // Fibonacci hashing spreads the row-major voxel keys across the table.
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >>
+                               voxel_table_shift_);
+  }
+
+  // Grid-relative voxel index along one axis, before clamping.
+  int voxelCoordinate(float value, int axis) const {
+    return static_cast<int>(std::floor(value / voxel_size_)) -
+           origin_voxels_[static_cast<size_t>(axis)];
+  }
+  int clampVoxelIndex(int value, int axis) const {
+    return std::clamp(value, 0, dims_[static_cast<size_t>(axis)] - 1);
+  }
+  void fitToCells(const std::vector<float>& px,
+                  const std::vector<float>& py,
+                  const std::vector<float>& pz);
+  void resizeSortedArrays(size_t count);
+  void buildSparseVoxelTable();
+  void gatherSortedPositions(const std::vector<float>& px,
+                             const std::vector<float>& py,
+                             const std::vector<float>& pz);
 
   float voxel_size_;
-  int grid_dim_;
+  // Voxels along x, y and z; equal unless fitToBounds() laid the grid over a box.
+  std::array<int, 3> dims_;
+  // Absolute voxel index of the grid's first voxel along x, y and z.
+  std::array<int, 3> origin_voxels_{0, 0, 0};
+  bool grow_with_cells_ = false;
 
   std::vector<uint32_t> sorted_ids_;
-  std::vector<int32_t> cell_voxel_;
+  std::vector<uint32_t> sorted_source_;
+  std::vector<float> sorted_x_;
+  std::vector<float> sorted_y_;
+  std::vector<float> sorted_z_;
+  std::vector<uint64_t> cell_keys_;
+  std::vector<uint64_t> cell_key_scratch_;
   std::vector<std::pair<int32_t, int32_t>> dense_voxel_ranges_;
-  std::unordered_map<int64_t, std::pair<int32_t, int32_t>> voxel_ranges_;
+  std::vector<int64_t> occupied_voxels_;
+  std::vector<std::pair<int32_t, int32_t>> occupied_ranges_;
+  std::vector<int32_t> voxel_table_;
+  size_t voxel_table_mask_ = 0;
+  int voxel_table_shift_ = 64;
   bool use_dense_ranges_ = false;
 };
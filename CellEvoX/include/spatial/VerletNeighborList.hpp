@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "spatial/SpatialHashGrid.hpp"
+
+namespace CellEvoX::io {
+class CheckpointReader;
+class CheckpointWriter;
+}  // namespace CellEvoX::io
+
+// Cached per-cell neighbor lists in CSR form. A list built with cutoff + skin stays valid
+// for the cutoff until some cell has moved more than skin / 2 from its build position.
+// Neighbors are stored as spatial indices into the position arrays passed to build().
+class VerletNeighborList {
+ public:
+  // Marks a slot with no counterpart in the last build in remap().
+  static constexpr uint32_t kNewSlot = std::numeric_limits<uint32_t>::max();
+
+  // `grow_with_cells` is forwarded to the private build grid.
+  VerletNeighborList(float cutoff, float skin, float domain_size, bool grow_with_cells = false);
+
+  // O(N) rebuild through a private grid whose voxel size matches cutoff + skin.
+  void build(const std::vector<float>& px,
+             const std::vector<float>& py,
+             const std::vector<float>& pz);
+
+  // True when the list is missing, sized for another population, or some cell has
+  // drifted past half the skin distance since the last build.
+  bool needsRebuild(const std::vector<float>& px,
+                    const std::vector<float>& py,
+                    const std::vector<float>& pz) const;
+
+  // Carries a valid list over births, deaths and slot permutations: `previous_slots[i]` is
+  // slot i's index at the last build or remap, or kNewSlot for a newborn. Survivors keep their
+  // surviving neighbors and build positions; only newborns are queried, against the build
+  // positions, so the list is the one build() would give for those positions. O(N + pairs).
+  void remap(const std::vector<uint32_t>& previous_slots,
+             const std::vector<float>& px,
+             const std::vector<float>& py,
+             const std::vector<float>& pz);
+
+  void invalidate() { valid_ = false; }
+  bool valid() const { return valid_; }
+
+  size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+  size_t neighborBegin(size_t index) const { return offsets_[index]; }
+  size_t neighborEnd(size_t index) const { return offsets_[index + 1]; }
+  uint32_t neighborAt(size_t slot) const { return neighbors_[slot]; }
+
+  size_t pairCount() const { return neighbors_.size(); }
+  size_t buildCount() const { return build_count_; }
+  size_t remapCount() const { return remap_count_; }
+  size_t memoryBytes() const;
+
+  // The list itself and its build positions, so a restored list is reused exactly as long as
+  // the original would have been.
+  void saveState(CellEvoX::io::CheckpointWriter& writer) const;
+  bool restoreState(CellEvoX::io::CheckpointReader& reader);
+
+ private:
+  float cutoff_;
+  float skin_;
+  SpatialHashGrid build_grid_;
+
+  std::vector<size_t> offsets_;
+  std::vector<uint32_t> neighbors_;
+  std::vector<uint32_t> build_indices_;
+  std::vector<float> reference_x_;
+  std::vector<float> reference_y_;
+  std::vector<float> reference_z_;
+  size_t build_count_ = 0;
+  size_t remap_count_ = 0;
+  bool valid_ = false;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spatial/SpatialHashGrid.hpp"
+
+namespace CellEvoX::io {
+class CheckpointReader;
+class CheckpointWriter;
+}  // namespace CellEvoX::io
+
+namespace CellEvoX::systems {
+
+// Voxel-level active set for the density engine. A voxel of the spatial grid turns dormant
+// once every cell in it sat at the birth-suppression floor, had no event and moved less than
+// the displacement tolerance during one step. Dormant voxels are revisited every
+// `dormant_interval` steps with one aggregated draw covering all skipped steps, and wake
+// immediately when a birth or death happens in them or in any of their 26 neighbors.
+class ActiveSetScheduler {
+ public:
+  // Call after the grid has been rebuilt for the current spatial arrays. Carries voxel state
+  // over from the previous step by hash and decides which cells are due. O(voxels + cells).
+  void beginStep(const SpatialHashGrid& grid, uint64_t step, int dormant_interval);
+
+  // Spatial indices to process this step in ascending order, and for each the number of
+  // steps its draw must cover (1 for active cells).
+  const std::vector<uint32_t>& dueCells() const { return due_cells_; }
+  const std::vector<uint32_t>& dueElapsedSteps() const { return due_elapsed_; }
+
+  // Per spatial index: 1 when the cell sits in a dormant voxel that is not due this step.
+  // endStep() clears the flag for voxels woken by a nearby event.
+  const std::vector<uint8_t>& frozenCells() const { return frozen_cells_; }
+
+  // Thread-safe as long as each spatial index is reported by a single thread.
+  void markBusy(uint32_t spatial_index) { cell_quiescent_[spatial_index] = 0; }
+  void markChanged(uint32_t spatial_index) {
+    cell_quiescent_[spatial_index] = 0;
+    cell_changed_[spatial_index] = 1;
+  }
+
+  // Folds the per-cell reports into voxel state for the next beginStep(). A voxel stays
+  // dormant only while every cell in it stays quiescent, including cells that were skipped.
+  void endStep();
+
+  size_t dormantVoxelCount() const;
+  size_t voxelCount() const { return voxel_keys_.size(); }
+
+  // The voxel states carried between steps; the per-cell arrays are rebuilt by beginStep().
+  void saveState(CellEvoX::io::CheckpointWriter& writer) const;
+  bool restoreState(CellEvoX::io::CheckpointReader& reader);
+
+ private:
+  struct VoxelState {
+    uint64_t last_eval_step = 0;
+    uint8_t dormant = 0;
+  };
+
+  int grid_dim_ = 0;
+  std::vector<int64_t> voxel_keys_;
+  std::vector<VoxelState> voxel_states_;
+  std::vector<uint32_t> voxel_offsets_;
+  std::vector<uint32_t> voxel_cells_;
+
+  std::vector<int64_t> next_keys_;
+  std::vector<VoxelState> next_states_;
+
+  std::vector<uint32_t> cell_elapsed_;
+  std::vector<uint8_t> cell_quiescent_;
+  std::vector<uint8_t> cell_changed_;
+  std::vector<uint8_t> frozen_cells_;
+  std::vector<uint32_t> due_cells_;
+  std::vector<uint32_t> due_elapsed_;
+};
+
+}  // namespace CellEvoX::systems
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "io/EngineCheckpoint.hpp"
+#include "systems/SimulationEngine.hpp"
+
+namespace CellEvoX::systems {
+
+// Engine state pieces shared by every engine's checkpoint. Hash maps are written sorted by id,
+// so a checkpoint does not depend on the map's bucket layout.
+
+inline void saveCell(CellEvoX::io::CheckpointWriter& writer, const Cell& cell) {
+  writer.put(cell.id);
+  writer.put(cell.parent_id);
+  writer.put(cell.fitness);
+  writer.put(cell.death_time);
+  writer.put<uint64_t>(cell.mutations.size());
+  for (const auto& [mutation_id, mutation_type] : cell.mutations) {
+    writer.put(mutation_id);
+    writer.put(mutation_type);
+  }
+}
+
+inline bool restoreCell(CellEvoX::io::CheckpointReader& reader, Cell& cell) {
+  uint64_t mutation_count = 0;
+  if (!reader.get(cell.id) || !reader.get(cell.parent_id) || !reader.get(cell.fitness) ||
+      !reader.get(cell.death_time) || !reader.get(mutation_count)) {
+    return false;
+  }
+  cell.mutations.clear();
+  for (uint64_t k = 0; k < mutation_count; ++k) {
+    std::pair<uint32_t, uint8_t> mutation;
+    if (!reader.get(mutation.first) || !reader.get(mutation.second)) {
+      return false;
+    }
+    cell.mutations.push_back(mutation);
+  }
+  return true;
+}
+
+inline void saveCells(CellEvoX::io::CheckpointWriter& writer, const std::vector<Cell>& cells) {
+  writer.put<uint64_t>(cells.size());
+  for (const auto& cell : cells) {
+    saveCell(writer, cell);
+  }
+}
+
+inline bool restoreCells(CellEvoX::io::CheckpointReader& reader, std::vector<Cell>& cells) {
+  uint64_t count = 0;
+  if (!reader.get(count)) {
+    return false;
+  }
+  cells.clear();
+  for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+    restoreCell(reader, cells.emplace_back());
+  }
+  return reader.ok();
+}
+
+// O(N log N).
+inline void saveCellMap(CellEvoX::io::CheckpointWriter& writer, const CellMap& cells) {
+  std::vector<const Cell*> sorted;
+  sorted.reserve(cells.size());
+  for (const auto& [id, cell] : cells) {
+    sorted.push_back(&cell);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Cell* lhs, const Cell* rhs) {
+    return lhs->id < rhs->id;
+  });
+  writer.put<uint64_t>(sorted.size());
+  for (const Cell* cell : sorted) {
+    saveCell(writer, *cell);
+  }
+}
+
+inline bool restoreCellMap(CellEvoX::io::CheckpointReader& reader, CellMap& cells) {
+  uint64_t count = 0;
+  if (!reader.get(count)) {
+    return false;
+  }
+  cells.clear();
+  cells.rehash(static_cast<size_t>(count));
+  for (uint64_t i = 0; i < count; ++i) {
+    Cell cell;
+    if (!restoreCell(reader, cell)) {
+      return false;
+    }
+    const uint32_t id = cell.id;
+    cells.insert({id, std::move(cell)});
+  }
+  return true;
+}
+
+// O(N log N).
+inline void saveGraveyard(CellEvoX::io::CheckpointWriter& writer, const Graveyard& graveyard) {
+  std::vector<std::pair<uint32_t, std::pair<uint32_t, double>>> sorted(graveyard.begin(),
+                                                                       graveyard.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+  writer.put<uint64_t>(sorted.size());
+  for (const auto& [id, entry] : sorted) {
+    writer.put(id);
+    writer.put(entry.first);
+    writer.put(entry.second);
+  }
+}
+
+inline bool restoreGraveyard(CellEvoX::io::CheckpointReader& reader, Graveyard& graveyard) {
+  uint64_t count = 0;
+  if (!reader.get(count)) {
+    return false;
+  }
+  graveyard.clear();
+  graveyard.rehash(static_cast<size_t>(count));
+  for (uint64_t i = 0; i < count; ++i) {
+    uint32_t id = 0;
+    uint32_t parent_id = 0;
+    double death_time = 0.0;
+    if (!reader.get(id) || !reader.get(parent_id) || !reader.get(death_time)) {
+      return false;
+    }
+    graveyard.insert({id, {parent_id, death_time}});
+  }
+  return true;
+}
+
+inline CellEvoX::io::EngineCheckpointHeader makeCheckpointHeader(const SimulationConfig& config,
+                                                                 uint64_t completed_steps) {
+  CellEvoX::io::EngineCheckpointHeader header{};
+  header.sim_type = static_cast<uint32_t>(config.sim_type);
+  header.seed = config.seed;
+  header.tau_step = config.tau_step;
+  header.initial_population = config.initial_population;
+  header.completed_steps = completed_steps;
+  return header;
+}
+
+// Throws when `checkpoint` was written by another engine or for a run with different
+// dynamics, since resuming it would silently produce a different simulation.
+inline void requireMatchingCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint,
+                                      const SimulationConfig& config) {
+  const auto& header = checkpoint.header;
+  if (header.sim_type != static_cast<uint32_t>(config.sim_type) || header.seed != config.seed ||
+      header.tau_step != config.tau_step ||
+      header.initial_population != config.initial_population) {
+    throw std::runtime_error(
+        "Engine checkpoint does not match the simulation config (sim_type, seed, tau_step or "
+        "initial_population differ)");
+  }
+}
+
+inline void requireCompleteCheckpoint(const CellEvoX::io::CheckpointReader& reader) {
+  if (!reader.ok() || !reader.atEnd()) {
+    throw std::runtime_error("Engine checkpoint state is truncated or malformed");
+  }
+}
+
+// Byte size of a text output after flushing it, recorded in a checkpoint so the resumed run
+// can cut off what the interrupted run appended later.
+inline uint64_t flushedOutputSize(std::ofstream& file) {
+  if (!file.is_open()) {
+    return 0;
+  }
+  file.flush();
+  const auto position = file.tellp();
+  return position < 0 ? 0 : static_cast<uint64_t>(position);
+}
+
+// Reopens `path` for appending after cutting it back to `size` bytes.
+inline bool resumeOutputFile(std::ofstream& file,
+                             const std::filesystem::path& path,
+                             uint64_t size) {
+  std::error_code ec;
+  if (std::filesystem::file_size(path, ec) < size || ec) {
+    return false;
+  }
+  std::filesystem::resize_file(path, size, ec);
+  if (ec) {
+    return false;
+  }
+  file.open(path, std::ios::app);
+  return file.is_open();
+}
+
+}  // namespace CellEvoX::systems
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+
+#include "systems/SimulationEngine.hpp"
+
+namespace CellEvoX::systems {
+
+// Bookkeeping the engines share around their own step(): the run loop with its progress bar
+// and the memory log. The 3D engines, which keep every live cell in the CellMap, also share
+// the population statistics and graveyard pruning.
+
+// Calls `step` up to `steps` times. Stops early on a shutdown request, writing a final
+// checkpoint through `write_checkpoint` when checkpoints are enabled, or once
+// `actual_population` reaches config.max_population_cutoff. Draws a progress bar on stdout.
+void runEngineSteps(uint32_t steps,
+                    const SimulationConfig& config,
+                    const std::atomic<bool>& shutdown_requested,
+                    const size_t& actual_population,
+                    const double& tau,
+                    const std::function<void()>& step,
+                    const std::function<void()>& write_checkpoint);
+
+// Moments of fitness and mutation count over the live cells, summed in id order so the result
+// does not depend on the hash map's bucket layout.
+StatSnapshot computeStatSnapshot(const CellMap& cells, double tau);
+
+// Drops every graveyard entry that is not an ancestor of a living cell.
+void pruneUnreachableGraveyard(const CellMap& cells, Graveyard& graveyard);
+
+// Resident set size of this process in KB, or 0 when it cannot be read.
+size_t residentSetKb();
+
+// Header row of statistics/memory_log.csv.
+inline constexpr const char* kMemoryLogHeader =
+    "Tau,RSS_KB,Cells_Count,Graveyard_Count,Estimated_Cells_KB,Estimated_Graveyard_KB\n";
+
+// Appends one memory_log.csv row; no-op while the file is closed.
+void appendMemoryLogRow(std::ofstream& file,
+                        double tau,
+                        size_t cells_count,
+                        size_t graveyard_count);
+
+}  // namespace CellEvoX::systems
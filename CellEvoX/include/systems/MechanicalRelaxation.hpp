@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "io/EngineCheckpoint.hpp"
+#include "spatial/SpatialHashGrid.hpp"
+#include "spatial/VerletNeighborList.hpp"
+#include "systems/SimulationEngine.hpp"
+
+namespace CellEvoX::systems {
+
+// Overlap-spring relaxation shared by both 3D engines. Owns the ping-pong position buffers
+// and the optional Verlet neighbor list so neither is reallocated between steps.
+class MechanicalRelaxation {
+ public:
+  // Outcome of the last relax() call. Displacements are those of the final substep and are
+  // only measured when config.mech_adaptive is set.
+  struct Stats {
+    int iterations = 0;
+    float max_displacement = 0.0f;
+    float rms_displacement = 0.0f;
+    float dt = 0.0f;
+  };
+
+  MechanicalRelaxation(const SimulationConfig& config, float interaction_radius);
+
+  // Runs config.mech_substeps Jacobi iterations over the active spatial arrays in place and
+  // leaves `grid` rebuilt for the relaxed positions. With config.mech_adaptive it stops early
+  // once the largest per-substep displacement drops below config.mech_tolerance. Cells flagged
+  // in `frozen` (indexed like the spatial arrays) keep their positions but still push their
+  // neighbors. Neighbors are resolved through the grid's source indices, so no id-to-slot
+  // lookup is needed.
+  void relax(const SimulationConfig& config,
+             const std::vector<uint32_t>& cell_ids,
+             std::vector<float>& pos_x,
+             std::vector<float>& pos_y,
+             std::vector<float>& pos_z,
+             SpatialHashGrid& grid,
+             const std::vector<uint8_t>* frozen = nullptr);
+
+  // Localized relax(): only `seeds` (spatial indices, typically the cells born this step), the
+  // cells overlapping them and the cells reached from any cell that moved more than
+  // config.mech_local_threshold take part. Positions are updated in place, so the cost of a
+  // substep follows the disturbed region. `grid` must already be built for the current spatial
+  // arrays; it is rebuilt once, for the relaxed positions, on return (and mid-call only when
+  // the accumulated drift outgrows the query margin).
+  void relaxLocal(const SimulationConfig& config,
+                  const std::vector<uint32_t>& cell_ids,
+                  std::vector<float>& pos_x,
+                  std::vector<float>& pos_y,
+                  std::vector<float>& pos_z,
+                  SpatialHashGrid& grid,
+                  const std::vector<uint32_t>& seeds,
+                  const std::vector<uint8_t>* frozen = nullptr);
+
+  // Spatial indices relaxLocal() was allowed to move during its last call.
+  const std::vector<uint32_t>& touchedCells() const { return local_cells_; }
+
+  // Range relaxed positions are clamped to: the domain walls, or unbounded with
+  // config.spatial_domain_growth.
+  static std::pair<float, float> wallBounds(const SimulationConfig& config);
+
+  // Must be called whenever cells are added, removed or reordered in the spatial arrays,
+  // unless the change is passed to remapNeighborList() instead.
+  void invalidateNeighborList() { neighbor_list_.invalidate(); }
+
+  // Carries a valid neighbor list over births, deaths and reorders; see
+  // VerletNeighborList::remap() for `previous_slots`.
+  void remapNeighborList(const std::vector<uint32_t>& previous_slots,
+                         const std::vector<float>& pos_x,
+                         const std::vector<float>& pos_y,
+                         const std::vector<float>& pos_z) {
+    neighbor_list_.remap(previous_slots, pos_x, pos_y, pos_z);
+  }
+
+  const VerletNeighborList& neighborList() const { return neighbor_list_; }
+  const Stats& lastStats() const { return stats_; }
+
+  // Only the neighbor list outlives a call; the buffers are rebuilt by every relax().
+  void saveState(CellEvoX::io::CheckpointWriter& writer) const { neighbor_list_.saveState(writer); }
+  bool restoreState(CellEvoX::io::CheckpointReader& reader) {
+    return neighbor_list_.restoreState(reader);
+  }
+
+ private:
+  void gridSubstep(const SimulationConfig& config, float dt, const SpatialHashGrid& grid);
+  void verletSubstep(const SimulationConfig& config, float dt);
+  void halfStencilSubstep(const SimulationConfig& config,
+                          float dt,
+                          const SpatialHashGrid& grid);
+  // With config.mech_adaptive_dt, returns the factor this substep's moves must be scaled by to
+  // stay stable and advances `dt` for the next substep; 1 otherwise.
+  float adaptTimeStep(const SimulationConfig& config, float max_displacement_sq, float& dt) const;
+  // Parallel reduction of |write - read| over all cells; returns {max^2, sum of squares}.
+  std::pair<float, double> measureDisplacement() const;
+  // Rescales this substep's moves by `scale`, as if it had run with dt * scale.
+  void scaleDisplacement(float scale);
+
+  bool isFrozen(size_t i) const { return frozen_ != nullptr && (*frozen_)[i] != 0; }
+
+  float interaction_radius_;
+  Stats stats_;
+  const std::vector<uint8_t>* frozen_ = nullptr;
+  VerletNeighborList neighbor_list_;
+  std::vector<float> read_x_;
+  std::vector<float> read_y_;
+  std::vector<float> read_z_;
+  std::vector<float> write_x_;
+  std::vector<float> write_y_;
+  std::vector<float> write_z_;
+  std::vector<float> force_x_;
+  std::vector<float> force_y_;
+  std::vector<float> force_z_;
+  // relaxLocal() state; local_flags_ is all zero between calls.
+  std::vector<uint8_t> local_flags_;
+  std::vector<uint32_t> local_cells_;
+  std::vector<float> local_x_;
+  std::vector<float> local_y_;
+  std::vector<float> local_z_;
+  std::vector<float> local_displacement_sq_;
+};
+
+}  // namespace CellEvoX::systems
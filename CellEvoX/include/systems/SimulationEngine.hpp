@@ -11,6 +11,9 @@
 
 #include "ecs/Cell.hpp"
 #include "ecs/Run.hpp"
+#include "io/EngineCheckpoint.hpp"
+#include "io/PopulationEventLog.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
 
 using CellMap = tbb::concurrent_hash_map<uint32_t, Cell>;
 using Graveyard = tbb::concurrent_hash_map<uint32_t, std::pair<uint32_t, double>>;
@@ -18,7 +21,34 @@ enum class SimulationType {
   STOCHASTIC_TAU_LEAP,
   DETERMINISTIC_RK4,
   SPATIAL_3D_DENSITY,
-  SPATIAL_3D_CAPACITY
+  SPATIAL_3D_CAPACITY,
+  SPATIAL_3D_LATTICE
+};
+
+enum class MechanicsNeighborMode {
+  Grid,        // re-query the spatial hash grid every relaxation substep
+  Verlet,      // reuse cached CSR neighbor lists until cells drift past half the skin
+  HalfStencil  // visit each pair once over a colored half-shell voxel stencil
+};
+
+enum class DensityEstimatorMode {
+  Exact,  // count neighbors within sample_radius through the spatial hash grid
+  Field   // interpolate a box-filtered voxel occupancy field
+};
+
+enum class SpatialReorderMode {
+  None,   // keep cells in the engine's natural slot order
+  Morton  // re-sort spatial arrays along a Z-order curve once locality degrades
+};
+
+enum class SnapshotFormat {
+  Rows,     // v2: fixed 36-byte records
+  Columnar  // v3: delta/dictionary-coded column blocks with built-in compression
+};
+
+enum class PopulationOutputMode {
+  Snapshots,  // one population snapshot file per generation
+  EventLog    // birth/death event log plus periodic keyframe snapshots
 };
 
 struct SimulationConfig {
@@ -31,19 +61,47 @@ struct SimulationConfig {
   uint32_t stat_res = 1;
   uint32_t popul_res = 1;
   int graveyard_pruning_interval = 0;
+  int checkpoint_interval = 0;  // T units between engine checkpoints; 0 = disabled
   size_t max_population_cutoff = 0;  // 0 = disabled; stop when N >= this value
   std::string output_path;
   std::vector<MutationType> mutations;
   bool full_mutation_payload = true;
+  SnapshotFormat snapshot_format = SnapshotFormat::Rows;
+  float snapshot_position_quantum = 1.0f / 16384.0f;  // columnar position resolution
+  PopulationOutputMode population_output = PopulationOutputMode::Snapshots;
+  int event_log_keyframe_interval = 10;  // every Nth generation is also written as a snapshot
+  bool snapshot_container = false;  // all generations in one indexed population_snapshots.bin
+  bool arrow_export = false;  // Arrow IPC (.arrow) copies of the post-run CSV tables
+  std::vector<uint32_t> voxel_lod_resolutions;  // 3D modes: voxel aggregates per snapshot
   int verbosity = 2; // 0: off, 1: minimal, 2: full
   uint32_t phylogeny_num_cells_sampling = 100;
   float spatial_domain_size = 200.0f;
+  bool spatial_domain_growth = false;  // capacity mode: no walls, the grid follows the tumor
   float max_local_density = 8.0f;
   float sample_radius = 3.0f;
+  DensityEstimatorMode density_estimator = DensityEstimatorMode::Exact;
+  bool nutrient_field = false;  // diffusion-limited nutrient coupling in density mode
+  float nutrient_diffusion = 10.0f;
+  float nutrient_consumption = 0.1f;
+  float nutrient_hypoxia_threshold = 0.2f;
+  float nutrient_necrosis_threshold = 0.05f;
+  int nutrient_vcycles = 2;
   float spring_constant = 0.5f;
   float mech_dt = 0.1f;
   int mech_substeps = 5;
   float epsilon = 0.1f;
+  MechanicsNeighborMode mech_neighbor_mode = MechanicsNeighborMode::Grid;
+  float mech_verlet_skin = 0.3f;
+  bool mech_adaptive = false;  // mech_substeps becomes the iteration cap
+  float mech_tolerance = 1e-3f;
+  bool mech_adaptive_dt = false;
+  bool mech_local = false;  // relax only around this step's births
+  float mech_local_threshold = 1e-2f;
+  SpatialReorderMode spatial_reorder = SpatialReorderMode::None;
+  float spatial_reorder_degradation = 2.0f;
+  bool active_set = false;
+  int active_set_dormant_interval = 8;
+  float active_set_displacement_tolerance = 1e-3f;
 };
 
 struct StatSnapshot {
@@ -61,7 +119,10 @@ struct StatSnapshot {
 
 class SimulationEngine {
  public:
-  SimulationEngine(std::shared_ptr<SimulationConfig>);
+  // With `resume`, continues the run that wrote the checkpoint instead of starting a new one.
+  // Throws std::runtime_error when the checkpoint does not belong to this engine and config.
+  SimulationEngine(std::shared_ptr<SimulationConfig>,
+                   const CellEvoX::io::EngineCheckpoint* resume = nullptr);
 
   static std::atomic<bool> shutdown_requested;
   static void signalHandler(int signum);
@@ -69,15 +130,21 @@ class SimulationEngine {
   void step();
   ecs::Run run(uint32_t steps);
   void stop();
+  // Steps taken since tau = 0, including those before a resumed checkpoint.
+  uint64_t completedSteps() const { return completed_steps; }
 
  private:
   void runSteps(uint32_t steps);
+  void writeCheckpoint();
+  void restoreCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint);
   void stochasticStep();
   void stochasticDenseStep();
   void pruneGraveyard();
   // void rk4DeterministicStep(double deltaTime);
   void takeStatSnapshot();
   void takePopulationSnapshot();
+  void logPopulationEvents(std::vector<uint32_t> deaths, uint32_t first_birth_id, size_t birth_count);
+  bool isPayloadMutation(uint8_t mutation_type) const;
   void materializeCellsFromDense();
   void materializeGraveyardFromDense();
   CellMap cells;
@@ -102,10 +169,18 @@ class SimulationEngine {
   int last_population_snapshot_tau = 0;
   int last_memory_log_tau = 0;
   int last_pruning_tau = -1;
+  int population_snapshot_count = 0;
+  int last_checkpoint_tau = 0;
+  uint64_t completed_steps = 0;
+  // A resumed run lacks the generations before its checkpoint, so the post-run analysis reads
+  // every generation back from disk instead.
+  bool keep_population_report = true;
+  CellEvoX::io::PopulationEventLogWriter population_event_log;
+  CellEvoX::io::PopulationSnapshotSink population_snapshot_sink;
   std::shared_ptr<SimulationConfig> config;
   std::mt19937 rng;
   
   std::ofstream memory_log_file;
+  CellEvoX::io::AsyncCheckpointWriter checkpoint_writer;
   void logMemoryUsage();
-  size_t getRSS();
 };
@@ -5,19 +5,31 @@
 #include <fstream>
 #include <map>
 #include <memory>
+#include <optional>
 #include <random>
 #include <vector>
 
 #include <Eigen/Dense>
 
+#include "io/EngineCheckpoint.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
+#include "spatial/DensityField.hpp"
+#include "spatial/LiveIdIndex.hpp"
+#include "spatial/MortonReorder.hpp"
 #include "spatial/SpatialHashGrid.hpp"
+#include "systems/ActiveSetScheduler.hpp"
+#include "systems/MechanicalRelaxation.hpp"
+#include "systems/NutrientField.hpp"
 #include "systems/SimulationEngine.hpp"
 
 class SimulationEngine3D {
  public:
   static constexpr float CELL_RADIUS = 1.0f;
 
-  explicit SimulationEngine3D(std::shared_ptr<SimulationConfig> config);
+  // With `resume`, continues the run that wrote the checkpoint instead of starting a new one.
+  // Throws std::runtime_error when the checkpoint does not belong to this engine and config.
+  explicit SimulationEngine3D(std::shared_ptr<SimulationConfig> config,
+                              const CellEvoX::io::EngineCheckpoint* resume = nullptr);
 
   static std::atomic<bool> shutdown_requested;
   static void signalHandler(int signum);
@@ -25,6 +37,8 @@ class SimulationEngine3D {
   ecs::Run run(uint32_t steps);
   void step();
   void stop();
+  // Steps taken since tau = 0, including those before a resumed checkpoint.
+  uint64_t completedSteps() const { return completed_steps_; }
 
  private:
   struct SpatialState {
@@ -50,17 +64,14 @@ class SimulationEngine3D {
   void rebuildSpatialState();
   void stochasticStep3D();
   void mechanicalRelaxationStep();
-  void takeStatSnapshot();
   void takePopulationSnapshot();
-  void pruneGraveyard();
+  void writeCheckpoint();
+  void restoreCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint);
 
-  Eigen::Vector3f sampleRandomUnitVector(std::mt19937& random_engine) const;
+  // Division axis of cell `id` at step `rng_step`, drawn from its counter-based streams.
+  Eigen::Vector3f sampleDivisionDirection(uint64_t rng_step, uint32_t id) const;
   float clampToDomain(float value) const;
-  void ensurePositionCapacity(uint32_t id);
-  std::mt19937& getThreadLocalRng() const;
 
-  size_t getRSS();
-  void logMemoryUsage();
 
   CellMap cells;
   Graveyard cells_graveyard;
@@ -78,16 +89,48 @@ class SimulationEngine3D {
   int last_population_snapshot_tau = 0;
   int last_memory_log_tau = 0;
   int last_pruning_tau = -1;
+  int last_checkpoint_tau = 0;
+  uint64_t completed_steps_ = 0;
 
   std::shared_ptr<SimulationConfig> config;
+  CellEvoX::io::PopulationSnapshotSink snapshot_sink_;
+  CellEvoX::io::AsyncCheckpointWriter checkpoint_writer_;
+  // Only the initial placement jitter; per-cell events draw from counter-based streams keyed by
+  // (seed, step, cell id), so they do not depend on the worker count or the work split.
   std::mt19937 rng;
 
   SpatialState spatial_state_;
   SpatialHashGrid spatial_grid_;
-  std::vector<float> id_pos_x_;
-  std::vector<float> id_pos_y_;
-  std::vector<float> id_pos_z_;
-  std::vector<uint32_t> id_to_spatial_index_;
+  CellEvoX::spatial::DensityField density_field_;
+  // Only constructed when config->nutrient_field is enabled.
+  std::optional<CellEvoX::systems::NutrientField> nutrient_field_;
+  // Positions live only in spatial_state_; this maps live ids to their slots.
+  CellEvoX::spatial::LiveIdIndex id_to_spatial_index_;
+  // Spatial arrays of the previous rebuild, read while gathering survivors.
+  std::vector<uint32_t> previous_cell_ids_;
+  std::vector<float> previous_pos_x_;
+  std::vector<float> previous_pos_y_;
+  std::vector<float> previous_pos_z_;
+  // Each slot's index in the previous arrays, handed to the neighbor list remap.
+  std::vector<uint32_t> previous_slots_;
+  // Daughter positions of the last step, indexed by id - birth_first_id_.
+  uint32_t birth_first_id_ = 0;
+  std::vector<float> birth_pos_x_;
+  std::vector<float> birth_pos_y_;
+  std::vector<float> birth_pos_z_;
+  uint32_t spatial_ids_end_ = 0;
+  CellEvoX::systems::MechanicalRelaxation mechanics_;
+  CellEvoX::spatial::MortonReorder spatial_reorder_;
+  std::vector<uint32_t> relax_seeds_;
+
+  // Active-set bookkeeping, only sized when config->active_set is enabled.
+  uint64_t step_index_ = 0;
+  CellEvoX::systems::ActiveSetScheduler active_set_;
+  std::vector<uint8_t> moved_;  // per slot, measured by the last relaxation
+  std::vector<uint8_t> relax_frozen_;
+  std::vector<float> relax_start_x_;
+  std::vector<float> relax_start_y_;
+  std::vector<float> relax_start_z_;
 
   std::ofstream memory_log_file;
 };
@@ -10,15 +10,23 @@
 
 #include <Eigen/Dense>
 
+#include "io/EngineCheckpoint.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
+#include "spatial/LiveIdIndex.hpp"
+#include "spatial/MortonReorder.hpp"
 #include "spatial/SpatialHashGrid.hpp"
 #include "systems/CommonPopulationStep.hpp"
+#include "systems/MechanicalRelaxation.hpp"
 #include "systems/SimulationEngine.hpp"
 
 class SimulationEngine3DCapacity {
  public:
   static constexpr float CELL_RADIUS = 1.0f;
 
-  explicit SimulationEngine3DCapacity(std::shared_ptr<SimulationConfig> config);
+  // With `resume`, continues the run that wrote the checkpoint instead of starting a new one.
+  // Throws std::runtime_error when the checkpoint does not belong to this engine and config.
+  explicit SimulationEngine3DCapacity(std::shared_ptr<SimulationConfig> config,
+                                      const CellEvoX::io::EngineCheckpoint* resume = nullptr);
 
   static std::atomic<bool> shutdown_requested;
   static void signalHandler(int signum);
@@ -26,6 +34,8 @@ class SimulationEngine3DCapacity {
   ecs::Run run(uint32_t steps);
   void step();
   void stop();
+  // Steps taken since tau = 0, including those before a resumed checkpoint.
+  uint64_t completedSteps() const { return completed_steps_; }
 
  private:
   struct SpatialState {
@@ -39,19 +49,17 @@ class SimulationEngine3DCapacity {
   void rebuildSpatialState();
   void updateSpatialState(
       const CellEvoX::systems::CommonPopulationStepResult& step_result);
+  void reorderSpatialState();
   void assignBirthPositions(
       const std::vector<CellEvoX::systems::CommonBirthEvent>& births);
   void mechanicalRelaxationStep();
-  void takeStatSnapshot();
   void takePopulationSnapshot();
-  void pruneGraveyard();
+  void writeCheckpoint();
+  void restoreCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint);
 
   Eigen::Vector3f sampleRandomUnitVector(std::mt19937& rng) const;
   float clampToDomain(float value) const;
-  void ensurePositionCapacity(uint32_t id);
 
-  size_t getRSS();
-  void logMemoryUsage();
 
   CellMap cells;
   Graveyard cells_graveyard;
@@ -68,29 +76,34 @@ class SimulationEngine3DCapacity {
   int last_population_snapshot_tau = 0;
   int last_memory_log_tau = 0;
   int last_pruning_tau = -1;
+  int last_checkpoint_tau = 0;
+  uint64_t completed_steps_ = 0;
 
   std::shared_ptr<SimulationConfig> config;
+  CellEvoX::io::PopulationSnapshotSink snapshot_sink_;
+  CellEvoX::io::AsyncCheckpointWriter checkpoint_writer_;
   std::mt19937 event_rng_;
   std::mt19937 spatial_rng_;
 
   SpatialState spatial_state_;
   SpatialHashGrid spatial_grid_;
-  std::vector<float> id_pos_x_;
-  std::vector<float> id_pos_y_;
-  std::vector<float> id_pos_z_;
-  std::vector<uint32_t> id_to_spatial_index_;
+  // Positions live only in spatial_state_; this maps live ids to their slots.
+  CellEvoX::spatial::LiveIdIndex id_to_spatial_index_;
+  // Daughter positions of the current step, indexed like its births.
+  std::vector<float> birth_pos_x_;
+  std::vector<float> birth_pos_y_;
+  std::vector<float> birth_pos_z_;
   std::vector<uint8_t> dead_spatial_flags_;
   std::vector<size_t> survivor_offsets_;
   std::vector<uint32_t> next_cell_ids_;
   std::vector<float> next_pos_x_;
   std::vector<float> next_pos_y_;
   std::vector<float> next_pos_z_;
-  std::vector<float> mech_read_x_;
-  std::vector<float> mech_read_y_;
-  std::vector<float> mech_read_z_;
-  std::vector<float> mech_write_x_;
-  std::vector<float> mech_write_y_;
-  std::vector<float> mech_write_z_;
+  // Each slot's index before the last spatial update, handed to the neighbor list remap.
+  std::vector<uint32_t> previous_slots_;
+  CellEvoX::systems::MechanicalRelaxation mechanics_;
+  std::vector<uint32_t> relax_seeds_;
+  CellEvoX::spatial::MortonReorder spatial_reorder_;
 
   std::ofstream memory_log_file;
 };
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "io/EngineCheckpoint.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
+#include "spatial/LatticeOccupancy.hpp"
+#include "spatial/LiveIdIndex.hpp"
+#include "systems/CommonPopulationStep.hpp"
+#include "systems/SimulationEngine.hpp"
+
+// On-lattice Eden/Moran-style 3D engine: every cell owns one voxel of edge 2 * CELL_RADIUS.
+// Events come from the same common population step as the capacity engine; a dividing parent
+// hands its voxel to the first daughter and the second one takes a random free neighbor voxel
+// or pushes a straight line of cells one voxel outward. There is no mechanics loop.
+class SimulationEngine3DLattice {
+ public:
+  static constexpr float CELL_RADIUS = 1.0f;
+
+  // With `resume`, continues the run that wrote the checkpoint instead of starting a new one.
+  // Throws std::runtime_error when the checkpoint does not belong to this engine and config.
+  explicit SimulationEngine3DLattice(std::shared_ptr<SimulationConfig> config,
+                                     const CellEvoX::io::EngineCheckpoint* resume = nullptr);
+
+  static std::atomic<bool> shutdown_requested;
+  static void signalHandler(int signum);
+
+  ecs::Run run(uint32_t steps);
+  void step();
+  void stop();
+  // Steps taken since tau = 0, including those before a resumed checkpoint.
+  uint64_t completedSteps() const { return completed_steps_; }
+
+ private:
+  void initializePopulationPositions();
+  void applyLatticeEvents(const CellEvoX::systems::CommonPopulationStepResult& step_result);
+  bool placeDaughter(uint32_t parent_voxel, uint32_t id);
+  void discardUnplacedDaughter(uint32_t id);
+  void takePopulationSnapshot();
+  void writeCheckpoint();
+  void restoreCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint);
+
+  float voxelCenter(int index) const;
+
+
+  CellMap cells;
+  Graveyard cells_graveyard;
+  std::map<uint8_t, MutationType> available_mutation_types;
+  std::vector<StatSnapshot> generational_stat_report;
+  std::vector<std::pair<int, CellMap>> generational_popul_report;
+
+  size_t actual_population;
+  size_t total_deaths;
+  double tau;
+  double total_mutation_probability;
+
+  int last_stat_snapshot_tau = 0;
+  int last_population_snapshot_tau = 0;
+  int last_memory_log_tau = 0;
+  int last_pruning_tau = -1;
+  int last_checkpoint_tau = 0;
+  uint64_t completed_steps_ = 0;
+
+  std::shared_ptr<SimulationConfig> config;
+  CellEvoX::io::PopulationSnapshotSink snapshot_sink_;
+  CellEvoX::io::AsyncCheckpointWriter checkpoint_writer_;
+  std::mt19937 event_rng_;
+  std::mt19937 spatial_rng_;
+
+  CellEvoX::spatial::LatticeOccupancy lattice_;
+  // Voxel index per live cell id; sized by the live population, not the largest id.
+  CellEvoX::spatial::LiveIdIndex id_voxel_;
+  std::vector<uint32_t> dividing_parents_;
+
+  std::ofstream memory_log_file;
+};
@@ -2,14 +2,19 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
+#include <vector>
 
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 namespace CellEvoX::parallel_algorithms {
 
 inline constexpr std::ptrdiff_t kParallelSortMinItems = 2048;
+inline constexpr int kRadixDigitBits = 11;
 
 template <typename RandomIt, typename Compare>
 void sortMaybeParallel(RandomIt first, RandomIt last, Compare compare) {
@@ -27,4 +32,68 @@ void sortMaybeParallel(RandomIt first, RandomIt last) {
   sortMaybeParallel(first, last, std::less<>{});
 }
 
+// Stable LSD radix sort of `keys` on bits [first_bit, first_bit + bit_count). Each pass is a
+// blocked digit histogram, a prefix scan in (digit, block) order and a parallel scatter, so
+// the sort costs O(N) per 11-bit digit with O(blocks x 2048) counts. `scratch` is reused.
+inline void radixSortMaybeParallel(std::vector<uint64_t>& keys,
+                                   std::vector<uint64_t>& scratch,
+                                   int first_bit,
+                                   int bit_count) {
+  constexpr size_t kBuckets = size_t{1} << kRadixDigitBits;
+  const size_t count = keys.size();
+  if (count < 2 || bit_count <= 0) {
+    return;
+  }
+  scratch.resize(count);
+  const size_t max_blocks =
+      4 * static_cast<size_t>(std::max(1, tbb::this_task_arena::max_concurrency()));
+  const size_t block_count = std::clamp<size_t>(
+      count / static_cast<size_t>(kParallelSortMinItems), 1, max_blocks);
+  const size_t block_size = (count + block_count - 1) / block_count;
+  std::vector<size_t> offsets(block_count * kBuckets);
+
+  for (int shift = first_bit; shift < first_bit + bit_count; shift += kRadixDigitBits) {
+    const auto digit = [shift](uint64_t key) {
+      return static_cast<size_t>((key >> shift) & (kBuckets - 1));
+    };
+    const auto for_each_block = [&](const auto& body) {
+      tbb::parallel_for(size_t{0}, block_count, [&](size_t block) {
+        body(block, block * block_size, std::min(count, (block + 1) * block_size));
+      });
+    };
+
+    std::fill(offsets.begin(), offsets.end(), size_t{0});
+    for_each_block([&](size_t block, size_t begin, size_t end) {
+      size_t* counts = offsets.data() + block * kBuckets;
+      for (size_t i = begin; i < end; ++i) {
+        ++counts[digit(keys[i])];
+      }
+    });
+
+    // Slot of each (block, digit) run; a pass whose keys all share one digit is skipped.
+    size_t running = 0;
+    bool single_digit = false;
+    for (size_t d = 0; d < kBuckets; ++d) {
+      const size_t digit_begin = running;
+      for (size_t block = 0; block < block_count; ++block) {
+        const size_t n = offsets[block * kBuckets + d];
+        offsets[block * kBuckets + d] = running;
+        running += n;
+      }
+      single_digit = single_digit || running - digit_begin == count;
+    }
+    if (single_digit) {
+      continue;
+    }
+
+    for_each_block([&](size_t block, size_t begin, size_t end) {
+      size_t* next = offsets.data() + block * kBuckets;
+      for (size_t i = begin; i < end; ++i) {
+        scratch[next[digit(keys[i])]++] = keys[i];
+      }
+    });
+    keys.swap(scratch);
+  }
+}
+
 }  // namespace CellEvoX::parallel_algorithms
@@ -22,6 +22,11 @@ class PhaseProfiler {
     return profiler;
   }
 
+  // The value column was added for counters and residuals. A file with any other header is left
+  // untouched; rows go to the first numbered sibling (<name>-1.csv, <name>-2.csv, ...) that is
+  // missing, empty or already uses this header.
+  static constexpr std::string_view kHeader = "phase,duration_ns,value";
+
   void record(std::string_view phase, Clock::duration duration) {
     if (!enabled_) {
       return;
@@ -30,7 +35,17 @@ class PhaseProfiler {
     const auto duration_ns =
         std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
     std::lock_guard<std::mutex> lock(mutex_);
-    output_ << phase << "," << duration_ns << "\n";
+    output_ << phase << "," << duration_ns << ",\n";
+  }
+
+  // Counters and residuals share the file with timings; their duration column stays empty.
+  void recordValue(std::string_view metric, double value) {
+    if (!enabled_) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    output_ << metric << ",," << value << "\n";
   }
 
  private:
@@ -45,13 +60,13 @@ class PhaseProfiler {
       return;
     }
 
-    const std::filesystem::path output_path =
+    const std::filesystem::path requested_output_path =
         (requested_path == "1" || requested_path == "true" || requested_path == "TRUE" ||
          requested_path == "yes" || requested_path == "YES")
             ? std::filesystem::path("cellevox_phase_profile.csv")
             : std::filesystem::path(std::string(requested_path));
 
-    const auto parent_path = output_path.parent_path();
+    const auto parent_path = requested_output_path.parent_path();
     std::error_code ec;
     if (!parent_path.empty()) {
       std::filesystem::create_directories(parent_path, ec);
@@ -60,18 +75,31 @@ class PhaseProfiler {
       }
     }
 
+    std::filesystem::path output_path = requested_output_path;
     bool write_header = true;
-    if (std::filesystem::exists(output_path, ec)) {
-      if (ec) {
-        return;
+    for (int suffix = 1;; ++suffix) {
+      if (!std::filesystem::exists(output_path, ec)) {
+        if (ec) {
+          return;
+        }
+        break;
       }
       const auto output_size = std::filesystem::file_size(output_path, ec);
       if (ec) {
         return;
       }
-      write_header = output_size == 0;
-    } else if (ec) {
-      return;
+      if (output_size == 0) {
+        break;
+      }
+      std::string existing_header;
+      std::getline(std::ifstream(output_path), existing_header);
+      if (existing_header == kHeader) {
+        write_header = false;
+        break;
+      }
+      output_path = parent_path / (requested_output_path.stem().string() + "-" +
+                                   std::to_string(suffix) +
+                                   requested_output_path.extension().string());
     }
 
     output_.open(output_path, std::ios::out | std::ios::app);
@@ -81,7 +109,7 @@ class PhaseProfiler {
 
     enabled_ = true;
     if (write_header) {
-      output_ << "phase,duration_ns\n";
+      output_ << kHeader << "\n";
     }
   }
 
@@ -115,9 +143,12 @@ class ScopedPhase {
 #define CELLEVOX_PROFILE_CONCAT(a, b) CELLEVOX_PROFILE_CONCAT_IMPL(a, b)
 #define CELLEVOX_PROFILE_PHASE(name) \
   const ::CellEvoX::profiling::ScopedPhase CELLEVOX_PROFILE_CONCAT(cellevox_profile_phase_, __LINE__)(name)
+#define CELLEVOX_PROFILE_VALUE(name, value) \
+  ::CellEvoX::profiling::PhaseProfiler::instance().recordValue(name, static_cast<double>(value))
 
 #else
 
 #define CELLEVOX_PROFILE_PHASE(name) ((void)0)
+#define CELLEVOX_PROFILE_VALUE(name, value) ((void)0)
 
 #endif
@@ -1,7 +1,9 @@
 #pragma once
+#include <spdlog/fmt/ranges.h>
 #include <spdlog/spdlog.h>
 
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -12,6 +14,7 @@
 #include <vector>
 
 #include "ecs/Cell.hpp"
+#include "io/VoxelAggregateIO.hpp"
 #include "systems/SimulationEngine.hpp"
 
 namespace utils {
@@ -26,11 +29,70 @@ inline const char* toString(SimulationType type) {
       return "SPATIAL_3D_DENSITY";
     case SimulationType::SPATIAL_3D_CAPACITY:
       return "SPATIAL_3D_CAPACITY";
+    case SimulationType::SPATIAL_3D_LATTICE:
+      return "SPATIAL_3D_LATTICE";
     default:
       return "UNKNOWN";
   }
 }
 
+inline const char* toString(MechanicsNeighborMode mode) {
+  switch (mode) {
+    case MechanicsNeighborMode::Grid:
+      return "grid";
+    case MechanicsNeighborMode::Verlet:
+      return "verlet";
+    case MechanicsNeighborMode::HalfStencil:
+      return "half_stencil";
+    default:
+      return "unknown";
+  }
+}
+
+inline const char* toString(DensityEstimatorMode mode) {
+  switch (mode) {
+    case DensityEstimatorMode::Exact:
+      return "exact";
+    case DensityEstimatorMode::Field:
+      return "field";
+    default:
+      return "unknown";
+  }
+}
+
+inline const char* toString(SpatialReorderMode mode) {
+  switch (mode) {
+    case SpatialReorderMode::None:
+      return "none";
+    case SpatialReorderMode::Morton:
+      return "morton";
+    default:
+      return "unknown";
+  }
+}
+
+inline const char* toString(SnapshotFormat format) {
+  switch (format) {
+    case SnapshotFormat::Rows:
+      return "rows";
+    case SnapshotFormat::Columnar:
+      return "columnar";
+    default:
+      return "unknown";
+  }
+}
+
+inline const char* toString(PopulationOutputMode mode) {
+  switch (mode) {
+    case PopulationOutputMode::Snapshots:
+      return "snapshots";
+    case PopulationOutputMode::EventLog:
+      return "event_log";
+    default:
+      return "unknown";
+  }
+}
+
 inline void requireFinite(double value, const char* field_name) {
   if (!std::isfinite(value)) {
     throw std::runtime_error(std::string("Invalid simulation config: ") + field_name +
@@ -75,9 +137,24 @@ inline void validateConfig(const SimulationConfig& config) {
     throw std::runtime_error(
         "Invalid simulation config: graveyard_pruning_interval must be non-negative");
   }
+  if (config.checkpoint_interval < 0) {
+    throw std::runtime_error(
+        "Invalid simulation config: checkpoint_interval must be non-negative");
+  }
   if (config.output_path.empty()) {
     throw std::runtime_error("Invalid simulation config: output_path must not be empty");
   }
+  requirePositive(config.snapshot_position_quantum, "snapshot_position_quantum");
+  if (config.population_output == PopulationOutputMode::EventLog) {
+    if (config.sim_type != SimulationType::STOCHASTIC_TAU_LEAP) {
+      throw std::runtime_error(
+          "Invalid simulation config: population_output 'event_log' requires stochastic mode");
+    }
+    if (config.event_log_keyframe_interval < 1) {
+      throw std::runtime_error(
+          "Invalid simulation config: event_log_keyframe_interval must be at least 1");
+    }
+  }
 
   if (config.sim_type == SimulationType::SPATIAL_3D_DENSITY ||
       config.sim_type == SimulationType::SPATIAL_3D_CAPACITY) {
@@ -90,6 +167,66 @@ inline void validateConfig(const SimulationConfig& config) {
       throw std::runtime_error("Invalid simulation config: mech_substeps must be positive");
     }
     requireNonNegative(config.epsilon, "epsilon");
+    requireNonNegative(config.mech_verlet_skin, "mech_verlet_skin");
+    requireNonNegative(config.mech_tolerance, "mech_tolerance");
+    requireNonNegative(config.mech_local_threshold, "mech_local_threshold");
+    requirePositive(config.nutrient_diffusion, "nutrient_diffusion");
+    requireNonNegative(config.nutrient_consumption, "nutrient_consumption");
+    if (config.nutrient_hypoxia_threshold < 0.0f || config.nutrient_hypoxia_threshold > 1.0f ||
+        config.nutrient_necrosis_threshold < 0.0f || config.nutrient_necrosis_threshold > 1.0f) {
+      throw std::runtime_error(
+          "Invalid simulation config: nutrient thresholds must be within [0, 1]");
+    }
+    if (config.nutrient_vcycles < 1) {
+      throw std::runtime_error("Invalid simulation config: nutrient_vcycles must be at least 1");
+    }
+    requireFinite(config.spatial_reorder_degradation, "spatial_reorder_degradation");
+    if (config.spatial_reorder_degradation < 1.0f) {
+      throw std::runtime_error(
+          "Invalid simulation config: spatial_reorder_degradation must be at least 1");
+    }
+    if (config.active_set_dormant_interval < 1) {
+      throw std::runtime_error(
+          "Invalid simulation config: active_set_dormant_interval must be at least 1");
+    }
+    requireNonNegative(config.active_set_displacement_tolerance,
+                       "active_set_displacement_tolerance");
+  }
+
+  if (!config.voxel_lod_resolutions.empty()) {
+    if (config.sim_type != SimulationType::SPATIAL_3D_DENSITY &&
+        config.sim_type != SimulationType::SPATIAL_3D_CAPACITY &&
+        config.sim_type != SimulationType::SPATIAL_3D_LATTICE) {
+      throw std::runtime_error(
+          "Invalid simulation config: voxel_lod_resolutions requires a spatial 3D mode");
+    }
+    for (const uint32_t resolution : config.voxel_lod_resolutions) {
+      if (resolution < 1 || resolution > CellEvoX::io::kVoxelAggregateMaxResolution) {
+        throw std::runtime_error(
+            "Invalid simulation config: voxel_lod_resolutions must be within [1, 1024]");
+      }
+    }
+  }
+
+  if (config.spatial_domain_growth && config.sim_type != SimulationType::SPATIAL_3D_CAPACITY) {
+    throw std::runtime_error(
+        "Invalid simulation config: spatial_domain_growth requires spatial_3d_capacity mode");
+  }
+
+  if (config.sim_type == SimulationType::SPATIAL_3D_LATTICE) {
+    requirePositive(config.spatial_domain_size, "spatial_domain_size");
+    // One voxel per cell with edge 2 (twice the lattice engine's cell radius).
+    const double lattice_dim = std::max(1.0, std::floor(config.spatial_domain_size / 2.0));
+    if (lattice_dim > 1625.0) {
+      throw std::runtime_error(
+          "Invalid simulation config: spatial_domain_size must be at most 3251 in "
+          "spatial_3d_lattice mode");
+    }
+    if (static_cast<double>(config.initial_population) > lattice_dim * lattice_dim * lattice_dim) {
+      throw std::runtime_error(
+          "Invalid simulation config: initial_population does not fit the spatial_3d_lattice "
+          "lattice");
+    }
   }
 
   double total_mutation_probability = 0.0;
@@ -130,6 +267,8 @@ inline SimulationConfig fromJson(const nlohmann::json& j) {
         config.sim_type = SimulationType::SPATIAL_3D_DENSITY;
       } else if (simulation_mode == "spatial_3d_capacity") {
         config.sim_type = SimulationType::SPATIAL_3D_CAPACITY;
+      } else if (simulation_mode == "spatial_3d_lattice") {
+        config.sim_type = SimulationType::SPATIAL_3D_LATTICE;
       } else {
         spdlog::warn("Unknown simulation_mode '{}'; defaulting to stochastic tau-leap", simulation_mode);
       }
@@ -154,6 +293,9 @@ inline SimulationConfig fromJson(const nlohmann::json& j) {
     } else {
       config.graveyard_pruning_interval = 0;
     }
+    if (j.contains("checkpoint_interval")) {
+      config.checkpoint_interval = j.at("checkpoint_interval");
+    }
     if (j.contains("max_population_cutoff")) {
       config.max_population_cutoff = j.at("max_population_cutoff");
     } else {
@@ -165,6 +307,43 @@ inline SimulationConfig fromJson(const nlohmann::json& j) {
     } else if (j.contains("snapshot_full_mutation_payload")) {
       config.full_mutation_payload = j.at("snapshot_full_mutation_payload");
     }
+    if (j.contains("snapshot_format")) {
+      const std::string format = j.at("snapshot_format");
+      if (format == "rows") {
+        config.snapshot_format = SnapshotFormat::Rows;
+      } else if (format == "columnar") {
+        config.snapshot_format = SnapshotFormat::Columnar;
+      } else {
+        throw std::runtime_error(
+            "Invalid simulation config: snapshot_format must be 'rows' or 'columnar'");
+      }
+    }
+    if (j.contains("snapshot_position_quantum")) {
+      config.snapshot_position_quantum = j.at("snapshot_position_quantum");
+    }
+    if (j.contains("population_output")) {
+      const std::string output = j.at("population_output");
+      if (output == "snapshots") {
+        config.population_output = PopulationOutputMode::Snapshots;
+      } else if (output == "event_log") {
+        config.population_output = PopulationOutputMode::EventLog;
+      } else {
+        throw std::runtime_error(
+            "Invalid simulation config: population_output must be 'snapshots' or 'event_log'");
+      }
+    }
+    if (j.contains("event_log_keyframe_interval")) {
+      config.event_log_keyframe_interval = j.at("event_log_keyframe_interval");
+    }
+    if (j.contains("snapshot_container")) {
+      config.snapshot_container = j.at("snapshot_container");
+    }
+    if (j.contains("arrow_export")) {
+      config.arrow_export = j.at("arrow_export");
+    }
+    if (j.contains("voxel_lod_resolutions")) {
+      config.voxel_lod_resolutions = j.at("voxel_lod_resolutions").get<std::vector<uint32_t>>();
+    }
     if (j.contains("verbosity")) {
       config.verbosity = j.at("verbosity");
     } else {
@@ -178,6 +357,9 @@ inline SimulationConfig fromJson(const nlohmann::json& j) {
     if (j.contains("spatial_domain_size")) {
       config.spatial_domain_size = j.at("spatial_domain_size");
     }
+    if (j.contains("spatial_domain_growth")) {
+      config.spatial_domain_growth = j.at("spatial_domain_growth");
+    }
     if (j.contains("max_local_density")) {
       config.max_local_density = j.at("max_local_density");
     }
@@ -196,6 +378,89 @@ inline SimulationConfig fromJson(const nlohmann::json& j) {
     if (j.contains("epsilon")) {
       config.epsilon = j.at("epsilon");
     }
+    if (j.contains("mech_neighbor_mode")) {
+      const std::string neighbor_mode = j.at("mech_neighbor_mode");
+      if (neighbor_mode == "grid") {
+        config.mech_neighbor_mode = MechanicsNeighborMode::Grid;
+      } else if (neighbor_mode == "verlet") {
+        config.mech_neighbor_mode = MechanicsNeighborMode::Verlet;
+      } else if (neighbor_mode == "half_stencil") {
+        config.mech_neighbor_mode = MechanicsNeighborMode::HalfStencil;
+      } else {
+        throw std::runtime_error("Invalid simulation config: mech_neighbor_mode must be "
+                                 "'grid', 'verlet' or 'half_stencil'");
+      }
+    }
+    if (j.contains("mech_verlet_skin")) {
+      config.mech_verlet_skin = j.at("mech_verlet_skin");
+    }
+    if (j.contains("mech_adaptive")) {
+      config.mech_adaptive = j.at("mech_adaptive");
+    }
+    if (j.contains("mech_tolerance")) {
+      config.mech_tolerance = j.at("mech_tolerance");
+    }
+    if (j.contains("mech_adaptive_dt")) {
+      config.mech_adaptive_dt = j.at("mech_adaptive_dt");
+    }
+    if (j.contains("mech_local")) {
+      config.mech_local = j.at("mech_local");
+    }
+    if (j.contains("mech_local_threshold")) {
+      config.mech_local_threshold = j.at("mech_local_threshold");
+    }
+    if (j.contains("density_estimator")) {
+      const std::string estimator = j.at("density_estimator");
+      if (estimator == "exact") {
+        config.density_estimator = DensityEstimatorMode::Exact;
+      } else if (estimator == "field") {
+        config.density_estimator = DensityEstimatorMode::Field;
+      } else {
+        throw std::runtime_error(
+            "Invalid simulation config: density_estimator must be 'exact' or 'field'");
+      }
+    }
+    if (j.contains("nutrient_field")) {
+      config.nutrient_field = j.at("nutrient_field");
+    }
+    if (j.contains("nutrient_diffusion")) {
+      config.nutrient_diffusion = j.at("nutrient_diffusion");
+    }
+    if (j.contains("nutrient_consumption")) {
+      config.nutrient_consumption = j.at("nutrient_consumption");
+    }
+    if (j.contains("nutrient_hypoxia_threshold")) {
+      config.nutrient_hypoxia_threshold = j.at("nutrient_hypoxia_threshold");
+    }
+    if (j.contains("nutrient_necrosis_threshold")) {
+      config.nutrient_necrosis_threshold = j.at("nutrient_necrosis_threshold");
+    }
+    if (j.contains("nutrient_vcycles")) {
+      config.nutrient_vcycles = j.at("nutrient_vcycles");
+    }
+    if (j.contains("spatial_reorder")) {
+      const std::string reorder_mode = j.at("spatial_reorder");
+      if (reorder_mode == "none") {
+        config.spatial_reorder = SpatialReorderMode::None;
+      } else if (reorder_mode == "morton") {
+        config.spatial_reorder = SpatialReorderMode::Morton;
+      } else {
+        throw std::runtime_error(
+            "Invalid simulation config: spatial_reorder must be 'none' or 'morton'");
+      }
+    }
+    if (j.contains("spatial_reorder_degradation")) {
+      config.spatial_reorder_degradation = j.at("spatial_reorder_degradation");
+    }
+    if (j.contains("active_set")) {
+      config.active_set = j.at("active_set");
+    }
+    if (j.contains("active_set_dormant_interval")) {
+      config.active_set_dormant_interval = j.at("active_set_dormant_interval");
+    }
+    if (j.contains("active_set_displacement_tolerance")) {
+      config.active_set_displacement_tolerance = j.at("active_set_displacement_tolerance");
+    }
 
     for (const auto& mut : j.at("mutations")) {
       const auto mutation_id = mut.at("id").get<int>();
@@ -231,6 +496,11 @@ inline void printConfig(const SimulationConfig& config) {
   spdlog::info("Statistics resolution: {}", config.stat_res);
   spdlog::info("Population statistics resolution: {}", config.popul_res);
   spdlog::info("Graveyard pruning interval: {}", config.graveyard_pruning_interval);
+  if (config.checkpoint_interval > 0) {
+    spdlog::info("Checkpoint interval: {}", config.checkpoint_interval);
+  } else {
+    spdlog::info("Checkpoint interval: disabled");
+  }
   if (config.max_population_cutoff > 0) {
     spdlog::info("Max population cutoff: {} (simulation stops when N >= this value)",
                  config.max_population_cutoff);
@@ -239,16 +509,73 @@ inline void printConfig(const SimulationConfig& config) {
   }
   spdlog::info("Output path: {}", config.output_path);
   spdlog::info("Full mutation payload snapshots: {}", config.full_mutation_payload);
+  spdlog::info("Snapshot format: {}", toString(config.snapshot_format));
+  if (config.snapshot_format == SnapshotFormat::Columnar) {
+    spdlog::info("Snapshot position quantum: {} (positions are lossy to +/- {})",
+                 config.snapshot_position_quantum,
+                 config.snapshot_position_quantum / 2.0f);
+  }
+  spdlog::info("Snapshot container: {}", config.snapshot_container);
+  spdlog::info("Arrow export: {}", config.arrow_export);
+  if (!config.voxel_lod_resolutions.empty()) {
+    spdlog::info("Voxel LOD resolutions: {}", fmt::join(config.voxel_lod_resolutions, ", "));
+  }
+  spdlog::info("Population output: {}", toString(config.population_output));
+  if (config.population_output == PopulationOutputMode::EventLog) {
+    spdlog::info("Event log keyframe interval: {}", config.event_log_keyframe_interval);
+  }
   spdlog::info("Phylogeny num cells: {}", config.phylogeny_num_cells_sampling);
   if (config.sim_type == SimulationType::SPATIAL_3D_DENSITY ||
       config.sim_type == SimulationType::SPATIAL_3D_CAPACITY) {
     spdlog::info("Spatial domain size: {:.2f}", config.spatial_domain_size);
+    if (config.sim_type == SimulationType::SPATIAL_3D_CAPACITY) {
+      spdlog::info("Spatial domain growth: {}", config.spatial_domain_growth);
+    }
     spdlog::info("Max local density: {:.2f}", config.max_local_density);
     spdlog::info("Sample radius: {:.2f}", config.sample_radius);
+    if (config.sim_type == SimulationType::SPATIAL_3D_DENSITY) {
+      spdlog::info("Density estimator: {}", toString(config.density_estimator));
+      spdlog::info("Nutrient field: {}", config.nutrient_field);
+      if (config.nutrient_field) {
+        spdlog::info("Nutrient diffusion: {:.3f}, consumption: {:.3f}",
+                     config.nutrient_diffusion,
+                     config.nutrient_consumption);
+        spdlog::info("Nutrient hypoxia threshold: {:.3f}, necrosis threshold: {:.3f}",
+                     config.nutrient_hypoxia_threshold,
+                     config.nutrient_necrosis_threshold);
+        spdlog::info("Nutrient V-cycles per step: {}", config.nutrient_vcycles);
+      }
+    }
     spdlog::info("Spring constant: {:.2f}", config.spring_constant);
     spdlog::info("Mechanical dt: {:.3f}", config.mech_dt);
     spdlog::info("Mechanical substeps: {}", config.mech_substeps);
     spdlog::info("Division epsilon: {:.3f}", config.epsilon);
+    spdlog::info("Mechanics neighbor mode: {}", toString(config.mech_neighbor_mode));
+    if (config.mech_neighbor_mode == MechanicsNeighborMode::Verlet) {
+      spdlog::info("Verlet skin: {:.3f}", config.mech_verlet_skin);
+    }
+    spdlog::info("Adaptive mechanics: {}", config.mech_adaptive);
+    if (config.mech_adaptive) {
+      spdlog::info("Mechanics tolerance: {:.4f}", config.mech_tolerance);
+      spdlog::info("Adaptive mechanics dt: {}", config.mech_adaptive_dt);
+    }
+    spdlog::info("Local mechanics: {}", config.mech_local);
+    if (config.mech_local) {
+      spdlog::info("Local mechanics threshold: {:.4f}", config.mech_local_threshold);
+    }
+    spdlog::info("Spatial reorder: {}", toString(config.spatial_reorder));
+    if (config.spatial_reorder != SpatialReorderMode::None) {
+      spdlog::info("Spatial reorder degradation: {:.2f}", config.spatial_reorder_degradation);
+    }
+    spdlog::info("Active set: {}", config.active_set);
+    if (config.active_set) {
+      spdlog::info("Active set dormant interval: {}", config.active_set_dormant_interval);
+      spdlog::info("Active set displacement tolerance: {:.4f}",
+                   config.active_set_displacement_tolerance);
+    }
+  }
+  if (config.sim_type == SimulationType::SPATIAL_3D_LATTICE) {
+    spdlog::info("Spatial domain size: {:.2f}", config.spatial_domain_size);
   }
   spdlog::info("Mutations:");
   for (const auto& mut : config.mutations) {
@@ -10,6 +10,8 @@ import matplotlib.pyplot as plt
 import pandas as pd
 import numpy as np
 
+from snapshot_io import load_clone_populations
+
 
 def parse_mutations(mutations_str):
     if not mutations_str or pd.isna(mutations_str) or mutations_str == '""':
@@ -48,9 +50,7 @@ def get_generation_from_filename(filename):
     return -1
 
 
-def plot_num_clones_over_time(input_dir, output_file, config_file):
-    print(f"Generating clone counts chart from data in: {input_dir}")
-    
+def count_clones_from_population_csvs(input_dir, config_file):
     driver_type_ids = get_driver_mutation_type_ids(config_file)
     print(f"Using driver mutation IDs: {driver_type_ids}")
     
@@ -58,12 +58,12 @@ def plot_num_clones_over_time(input_dir, output_file, config_file):
     pop_dir = os.path.join(input_dir, "population_data")
     if not os.path.exists(pop_dir):
         print(f"Error: population_data directory not found in {input_dir}")
-        return
+        return [], []
         
     pop_files = glob.glob(os.path.join(pop_dir, "population_generation_*.csv"))
     if not pop_files:
         print(f"Error: No population files found in {pop_dir}")
-        return
+        return [], []
         
     pop_files.sort(key=lambda x: get_generation_from_filename(x))
     
@@ -91,7 +91,21 @@ def plot_num_clones_over_time(input_dir, output_file, config_file):
             
         except Exception as e:
             print(f"Error reading {filename}: {e}")
-            
+
+    return generations, clone_counts
+
+
+def plot_num_clones_over_time(input_dir, output_file, config_file):
+    print(f"Generating clone counts chart from data in: {input_dir}")
+
+    # The C++ snapshot scan leaves per-clone sizes behind; fall back to the population CSVs.
+    clone_populations = load_clone_populations(input_dir)
+    if clone_populations is not None:
+        generations = sorted(clone_populations)
+        clone_counts = [len(clone_populations[gen]) for gen in generations]
+    else:
+        generations, clone_counts = count_clones_from_population_csvs(input_dir, config_file)
+
     if not generations:
         print("No valid generation data processed.")
         return
@@ -10,6 +10,8 @@ import matplotlib.pyplot as plt
 import pandas as pd
 import numpy as np
 
+from snapshot_io import load_clone_populations
+
 def parse_mutations(mutations_str):
     if not mutations_str or pd.isna(mutations_str) or mutations_str == '""':
         return []
@@ -47,37 +49,27 @@ def get_generation_from_filename(filename):
         return int(match.group(1))
     return -1
 
-def plot_clone_lifespans(input_dir, output_file, config_file):
-    print(f"Generating clone lifespans chart from data in: {input_dir}")
-    
-    driver_type_ids, pop_res = get_config_options(config_file)
-    print(f"Using driver mutation IDs: {driver_type_ids}, Resolution: {pop_res}")
-    
+def clone_signatures_from_population_csvs(input_dir, driver_type_ids):
     pop_dir = os.path.join(input_dir, "population_data")
     if not os.path.exists(pop_dir):
         print(f"Error: population_data directory not found in {input_dir}")
-        return
+        return {}
         
     pop_files = glob.glob(os.path.join(pop_dir, "population_generation_*.csv"))
     if not pop_files:
         print(f"Error: No population files found in {pop_dir}")
-        return
+        return {}
         
     pop_files.sort(key=lambda x: get_generation_from_filename(x))
     
-    # Store the first and last time a clone signature was seen
-    # Dictionary mapping signature -> {"first": gen_num, "last": gen_num}
-    clone_lifespans = {}
-    
-    last_generation_seen = -1
+    # generation -> set of clone signatures alive in it
+    signatures_by_generation = {}
     
     for filename in pop_files:
         gen = get_generation_from_filename(filename)
         if gen < 0:
             continue
             
-        last_generation_seen = max(last_generation_seen, gen)
-            
         try:
             df = pd.read_csv(filename)
             unique_clones_in_gen = set()
@@ -87,14 +79,40 @@ def plot_clone_lifespans(input_dir, output_file, config_file):
                 signature = get_driver_signature(mutations_list, driver_type_ids)
                 unique_clones_in_gen.add(signature)
                 
-            for signature in unique_clones_in_gen:
-                if signature not in clone_lifespans:
-                    clone_lifespans[signature] = {"first": gen, "last": gen}
-                else:
-                    clone_lifespans[signature]["last"] = gen
+            signatures_by_generation[gen] = unique_clones_in_gen
                     
         except Exception as e:
             print(f"Error reading {filename}: {e}")
+
+    return signatures_by_generation
+
+
+def plot_clone_lifespans(input_dir, output_file, config_file):
+    print(f"Generating clone lifespans chart from data in: {input_dir}")
+    
+    driver_type_ids, pop_res = get_config_options(config_file)
+    print(f"Using driver mutation IDs: {driver_type_ids}, Resolution: {pop_res}")
+
+    # The C++ snapshot scan leaves per-clone sizes behind; fall back to the population CSVs.
+    clone_populations = load_clone_populations(input_dir)
+    if clone_populations is not None:
+        signatures_by_generation = {gen: set(counts) for gen, counts in clone_populations.items()}
+    else:
+        signatures_by_generation = clone_signatures_from_population_csvs(input_dir, driver_type_ids)
+    
+    # Store the first and last time a clone signature was seen
+    # Dictionary mapping signature -> {"first": gen_num, "last": gen_num}
+    clone_lifespans = {}
+    
+    last_generation_seen = -1
+    
+    for gen in sorted(signatures_by_generation):
+        last_generation_seen = max(last_generation_seen, gen)
+        for signature in signatures_by_generation[gen]:
+            if signature not in clone_lifespans:
+                clone_lifespans[signature] = {"first": gen, "last": gen}
+            else:
+                clone_lifespans[signature]["last"] = gen
             
     if not clone_lifespans:
         print("No valid clone data processed.")
@@ -31,6 +31,8 @@ except ImportError:
     print("Error: pyfish not installed. Run: pip install pyfish")
     sys.exit(1)
 
+from snapshot_io import load_clone_populations
+
 
 def parse_mutations(mutations_str: str) -> List[Tuple[int, int]]:
     """
@@ -153,47 +155,45 @@ def build_pyfish_data(output_dir: str) -> Tuple[pd.DataFrame, pd.DataFrame]:
     if not os.path.exists(config_path):
         raise FileNotFoundError(f"config.json not found in {output_dir}")
     
-    driver_type_ids = get_driver_mutation_type_ids(config_path)
-    print(f"Driver mutation type IDs: {driver_type_ids}")
-    
-    # Load all population files
-    populations = load_population_files(output_dir)
-    if not populations:
-        raise ValueError(f"No population_generation_*.csv files found in {output_dir}")
-    
-    print(f"Found {len(populations)} generation files")
-    
+    # Track all clone signatures and their populations per generation
+    # generation -> {signature -> count}; prefer the per-clone summary written by the C++
+    # snapshot scan over re-parsing every population CSV.
+    clone_populations: Dict[int, Dict[str, int]] = load_clone_populations(output_dir) or {}
+    if clone_populations:
+        print(f"Loaded clone populations for {len(clone_populations)} generations")
+    else:
+        driver_type_ids = get_driver_mutation_type_ids(config_path)
+        print(f"Driver mutation type IDs: {driver_type_ids}")
+
+        # Load all population files
+        populations = load_population_files(output_dir)
+        if not populations:
+            raise ValueError(f"No population_generation_*.csv files found in {output_dir}")
+
+        print(f"Found {len(populations)} generation files")
+
+        for generation in sorted(populations.keys()):
+            df = populations[generation]
+            clone_populations[generation] = {}
+
+            for _, row in df.iterrows():
+                mutations = parse_mutations(row.get('Mutations', ''))
+                signature = get_driver_signature(mutations, driver_type_ids)
+                clone_populations[generation][signature] = \
+                    clone_populations[generation].get(signature, 0) + 1
+
     # Handle single generation case (prevents pyfish crash)
-    if len(populations) == 1:
-        single_gen = list(populations.keys())[0]
-        # Create a second time point slightly after to allow plotting
-        # If gen is 0, make it 1. If gen is 100, make it 101.
-        next_gen = single_gen + (1 if single_gen == 0 else single_gen * 0.1)
-        # Round to integer if possible, but float is fine for keys usually, 
-        # but let's stick to int if the original keys are ints (which they are)
+    if len(clone_populations) == 1:
+        single_gen = list(clone_populations.keys())[0]
         next_gen = single_gen + 1
-        
+
         print(f"WARNING: Only one generation data found ({single_gen}). Duplicating as {next_gen} to enable plotting.")
-        populations[next_gen] = populations[single_gen].copy()
-    
-    # Track all clone signatures and their populations per generation
-    clone_populations: Dict[int, Dict[str, int]] = {}  # generation -> {signature -> count}
-    all_signatures: Set[str] = set()
-    
-    # Ensure "ancestor" is always a valid signature so parent lookups never fail
-    all_signatures.add("ancestor")
+        clone_populations[next_gen] = dict(clone_populations[single_gen])
 
-    for generation in sorted(populations.keys()):
-        df = populations[generation]
-        clone_populations[generation] = {}
-        
-        for _, row in df.iterrows():
-            mutations = parse_mutations(row.get('Mutations', ''))
-            signature = get_driver_signature(mutations, driver_type_ids)
-            all_signatures.add(signature)
-            
-            clone_populations[generation][signature] = \
-                clone_populations[generation].get(signature, 0) + 1
+    # Ensure "ancestor" is always a valid signature so parent lookups never fail
+    all_signatures: Set[str] = {"ancestor"}
+    for counts in clone_populations.values():
+        all_signatures.update(counts.keys())
     
     print(f"Found {len(all_signatures)} unique clone signatures")
     
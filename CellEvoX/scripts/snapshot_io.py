@@ -2,6 +2,7 @@
 from __future__ import annotations
 
 import colorsys
+import csv
 import hashlib
 import json
 import math
@@ -11,20 +12,71 @@ from dataclasses import dataclass
 from pathlib import Path
 from typing import Dict, Iterable, Iterator, List, Optional, Sequence, Set, Tuple
 
+import numpy as np
 import pandas as pd
 
+import snapshot_native
+
+try:
+    import pyarrow as pa
+    import pyarrow.ipc as pa_ipc
+except ImportError:  # .arrow exports are optional; every table also exists as CSV
+    pa = None
+    pa_ipc = None
+
 
 ANCESTOR_SIGNATURE = "ancestor"
 SNAPSHOT_MAGIC = b"CELXPOP1"
 SNAPSHOT_VERSION = 2
+SNAPSHOT_COLUMNAR_VERSION = 3
+CONTAINER_MAGIC = b"CELXPOPC"
+CONTAINER_INDEX_MAGIC = b"CELXIDX1"
+CONTAINER_FILENAME = "population_snapshots.bin"
+CLONE_POPULATIONS_FILENAME = "clone_populations.csv"
+VOXEL_LOD_MAGIC = b"CELXVOX1"
+VOXEL_LOD_DIRNAME = "voxel_lod"
 
 _POPULATION_CSV_RE = re.compile(r"population_generation_(\d+)\.csv$")
 _POPULATION_BIN_RE = re.compile(r"population_generation_(\d+)\.bin$")
 _MUTATION_RE = re.compile(r"\((\d+),(\d+)\)")
+_VOXEL_LOD_RE = re.compile(r"generation_(\d+)\.bin$")
 
 _HEADER_STRUCT = struct.Struct("<8sIIdIIBBB13x")
 _RECORD_STRUCT = struct.Struct("<IIffffHHIB3x")
 _DRIVER_MUTATION_STRUCT = struct.Struct("<IB")
+_HEADER_V3_STRUCT = struct.Struct("<8sIIdIIfBB10x")
+_COLUMN_BLOCK_STRUCT = struct.Struct("<BB2xII")
+# Container layout; see PopulationSnapshotContainer.hpp.
+_CONTAINER_HEADER_STRUCT = struct.Struct("<8sII")
+_FRAME_HEADER_STRUCT = struct.Struct("<IiQdIBB2x")
+_INDEX_ENTRY_STRUCT = struct.Struct("<iIQQdBB6x")
+_INDEX_TRAILER_STRUCT = struct.Struct("<QII8s")
+_FRAME_MAGIC = 0x4D524643
+# Voxel LOD layout; see VoxelAggregateIO.hpp.
+_VOXEL_LOD_HEADER_STRUCT = struct.Struct("<8sIidIIII")
+_VOXEL_LOD_LEVEL_STRUCT = struct.Struct("<II4f")
+VOXEL_LOD_DTYPE = np.dtype(
+    [("voxel", "<u4"), ("cell_count", "<u4"), ("dominant_clone", "<u4"), ("mean_fitness", "<f4")]
+)
+
+# Column ids and codecs of the v3 layout; see PopulationSnapshotColumn in PopulationSnapshotIO.hpp.
+(
+    _COL_IDS,
+    _COL_PARENT_IDS,
+    _COL_FITNESS_DICTIONARY,
+    _COL_FITNESS_CODES,
+    _COL_MUTATION_COUNTS,
+    _COL_PAYLOAD_COUNTS,
+    _COL_PAYLOAD_OFFSETS,
+    _COL_POSITION_VALID,
+    _COL_POSITION_X,
+    _COL_POSITION_Y,
+    _COL_POSITION_Z,
+    _COL_PAYLOAD_MUTATION_IDS,
+    _COL_PAYLOAD_MUTATION_TYPES,
+) = range(13)
+_CODEC_RAW = 0
+_CODEC_LZ = 1
 
 
 @dataclass(frozen=True)
@@ -32,6 +84,8 @@ class PopulationFrameSource:
     generation: int
     path: Path
     kind: str
+    offset: int = 0  # container frames: snapshot bytes at [offset, offset + size)
+    size: int = -1
 
 
 @dataclass(frozen=True)
@@ -42,6 +96,40 @@ class SnapshotFrame:
     data: pd.DataFrame
 
 
+@dataclass(frozen=True)
+class VoxelLodLevel:
+    resolution: int
+    origin: np.ndarray  # corner of voxel 0
+    voxel_size: float
+    voxels: np.ndarray  # VOXEL_LOD_DTYPE, occupied voxels by ascending voxel number
+
+    def centers(self) -> np.ndarray:
+        index = self.voxels["voxel"].astype(np.int64)
+        cells = np.stack(
+            [index % self.resolution, (index // self.resolution) % self.resolution, index // self.resolution**2],
+            axis=1,
+        )
+        return self.origin + (cells + 0.5) * self.voxel_size
+
+
+@dataclass(frozen=True)
+class VoxelLodFrame:
+    generation: int
+    tau: float
+    cell_count: int
+    clone_signatures: List[str]  # indexed by VOXEL_LOD_DTYPE dominant_clone; 0 is the ancestor
+    levels: List[VoxelLodLevel]
+
+    def level(self, resolution: Optional[int] = None) -> VoxelLodLevel:
+        """The level with this resolution, or the finest one."""
+        if resolution is None:
+            return max(self.levels, key=lambda level: level.resolution)
+        for level in self.levels:
+            if level.resolution == resolution:
+                return level
+        raise ValueError(f"No {resolution}^3 level in voxel LOD generation {self.generation}")
+
+
 def resolve_run_dir(input_dir: str | Path) -> Path:
     return Path(input_dir).expanduser().resolve()
 
@@ -65,12 +153,38 @@ def load_driver_type_ids(run_dir: str | Path) -> Set[int]:
     return driver_ids
 
 
+def arrow_twin(csv_path: Path) -> Optional[Path]:
+    """The .arrow copy written next to csv_path with arrow_export, if pyarrow can read it."""
+    if pa is None:
+        return None
+    arrow_path = csv_path.with_suffix(".arrow")
+    return arrow_path if arrow_path.is_file() else None
+
+
+def read_arrow_table(path: str | Path) -> Tuple[pd.DataFrame, Dict[str, str]]:
+    """Memory-maps an Arrow IPC file; returns its rows and the schema metadata."""
+    table = pa_ipc.open_file(pa.memory_map(str(path), "r")).read_all()
+    metadata = {
+        key.decode("utf-8"): value.decode("utf-8")
+        for key, value in (table.schema.metadata or {}).items()
+    }
+    return table.to_pandas(), metadata
+
+
+def read_table(csv_path: Path) -> pd.DataFrame:
+    """csv_path's rows, from its .arrow twin when there is one."""
+    arrow_path = arrow_twin(csv_path)
+    if arrow_path is not None:
+        return read_arrow_table(arrow_path)[0]
+    return pd.read_csv(csv_path)
+
+
 def load_statistics(run_dir: str | Path) -> Optional[pd.DataFrame]:
     run_path = resolve_run_dir(run_dir)
     stats_path = run_path / "statistics" / "generational_statistics.csv"
     if not stats_path.exists():
         return None
-    stats = pd.read_csv(stats_path)
+    stats = read_table(stats_path)
     if "Generation" in stats.columns:
         stats = stats.sort_values("Generation").reset_index(drop=True)
     return stats
@@ -81,7 +195,7 @@ def load_phylogeny(run_dir: str | Path) -> Optional[pd.DataFrame]:
     phylogeny_path = run_path / "phylogeny" / "phylogenetic_tree.csv"
     if not phylogeny_path.exists():
         return None
-    phylogeny = pd.read_csv(phylogeny_path)
+    phylogeny = read_table(phylogeny_path)
     if "NodeID" in phylogeny.columns:
         phylogeny = phylogeny.sort_values("NodeID").reset_index(drop=True)
     return phylogeny
@@ -195,6 +309,22 @@ def population_data_dir(run_dir: str | Path) -> Path:
     return candidate if candidate.exists() else run_path
 
 
+def load_clone_populations(run_dir: str | Path) -> Optional[Dict[int, Dict[str, int]]]:
+    """Cells per clone signature per generation, as written by the C++ snapshot scan.
+
+    Returns None when the run has no clone_populations.csv, so callers fall back to parsing the
+    population CSVs.
+    """
+    path = population_data_dir(run_dir) / CLONE_POPULATIONS_FILENAME
+    if not path.exists():
+        return None
+    populations: Dict[int, Dict[str, int]] = {}
+    with path.open("r", encoding="utf-8", newline="") as handle:
+        for row in csv.DictReader(handle):
+            populations.setdefault(int(row["Generation"]), {})[row["Signature"]] = int(row["Cells"])
+    return populations
+
+
 def discover_population_sources(
     run_dir: str | Path,
     prefer_bin: bool = False,
@@ -209,8 +339,13 @@ def discover_population_sources(
 
         csv_match = _POPULATION_CSV_RE.match(path.name)
         if csv_match:
+            arrow_path = arrow_twin(path)
             csv_sources.append(
-                PopulationFrameSource(generation=int(csv_match.group(1)), path=path, kind="csv")
+                PopulationFrameSource(
+                    generation=int(csv_match.group(1)),
+                    path=arrow_path or path,
+                    kind="arrow" if arrow_path else "csv",
+                )
             )
             continue
 
@@ -220,6 +355,13 @@ def discover_population_sources(
                 PopulationFrameSource(generation=int(bin_match.group(1)), path=path, kind="bin")
             )
 
+    container_path = data_dir / CONTAINER_FILENAME
+    if not bin_sources and container_path.is_file():
+        bin_sources = [
+            PopulationFrameSource(generation=generation, path=container_path, kind="bin", offset=offset, size=size)
+            for generation, offset, size in read_container_index(container_path)
+        ]
+
     csv_sources.sort(key=lambda item: item.generation)
     bin_sources.sort(key=lambda item: item.generation)
 
@@ -232,12 +374,119 @@ def discover_population_sources(
     return []
 
 
+def read_container_index(path: str | Path) -> List[Tuple[int, int, int]]:
+    """(generation, snapshot offset, snapshot size) per frame of a snapshot container.
+
+    Uses the trailing index when it matches the file; otherwise walks the frame headers, as the
+    C++ reader does for a container whose writer did not close.
+    """
+    data = Path(path).read_bytes()
+    if len(data) < _CONTAINER_HEADER_STRUCT.size:
+        raise ValueError(f"Incomplete snapshot container header: {path}")
+    magic, version, _ = _CONTAINER_HEADER_STRUCT.unpack_from(data, 0)
+    if magic != CONTAINER_MAGIC or version != 1:
+        raise ValueError(f"Invalid snapshot container header in {path}")
+
+    frame_size = _FRAME_HEADER_STRUCT.size
+    if len(data) >= _CONTAINER_HEADER_STRUCT.size + _INDEX_TRAILER_STRUCT.size:
+        index_offset, entry_count, _, index_magic = _INDEX_TRAILER_STRUCT.unpack_from(
+            data, len(data) - _INDEX_TRAILER_STRUCT.size
+        )
+        if (
+            index_magic == CONTAINER_INDEX_MAGIC
+            and index_offset + entry_count * _INDEX_ENTRY_STRUCT.size + _INDEX_TRAILER_STRUCT.size == len(data)
+        ):
+            entries = []
+            for index in range(entry_count):
+                generation, _, offset, size, _, _, _ = _INDEX_ENTRY_STRUCT.unpack_from(
+                    data, index_offset + index * _INDEX_ENTRY_STRUCT.size
+                )
+                entries.append((generation, offset + frame_size, size))
+            return entries
+
+    entries = []
+    offset = _CONTAINER_HEADER_STRUCT.size
+    while len(data) - offset >= frame_size:
+        frame_magic, generation, size, _, _, _, _ = _FRAME_HEADER_STRUCT.unpack_from(data, offset)
+        if frame_magic != _FRAME_MAGIC or size > len(data) - offset - frame_size:
+            break
+        entries.append((generation, offset + frame_size, size))
+        offset += frame_size + size
+    return entries
+
+
+def discover_voxel_lod_sources(run_dir: str | Path) -> List[Tuple[int, Path]]:
+    """(generation, path) of the run's voxel LOD files, by ascending generation."""
+    lod_dir = population_data_dir(run_dir) / VOXEL_LOD_DIRNAME
+    if not lod_dir.is_dir():
+        return []
+    sources = []
+    for path in lod_dir.iterdir():
+        match = _VOXEL_LOD_RE.match(path.name)
+        if match and path.is_file():
+            sources.append((int(match.group(1)), path))
+    return sorted(sources)
+
+
+def load_voxel_lod(path: str | Path) -> VoxelLodFrame:
+    """Reads a voxel LOD file written by the 3D engines (voxel_lod_resolutions)."""
+    data = Path(path).read_bytes()
+    if len(data) < _VOXEL_LOD_HEADER_STRUCT.size:
+        raise ValueError(f"Incomplete voxel LOD header: {path}")
+    magic, version, generation, tau, cell_count, clone_count, driver_count, level_count = (
+        _VOXEL_LOD_HEADER_STRUCT.unpack_from(data, 0)
+    )
+    if magic != VOXEL_LOD_MAGIC or version != 1:
+        raise ValueError(f"Invalid voxel LOD header in {path}")
+
+    offset = _VOXEL_LOD_HEADER_STRUCT.size
+    try:
+        clone_offsets = np.frombuffer(data, dtype="<u4", count=clone_count + 1, offset=offset)
+        offset += clone_offsets.nbytes
+        driver_ids = np.frombuffer(data, dtype="<u4", count=driver_count, offset=offset).tolist()
+        offset += 4 * driver_count
+        signatures = [
+            driver_signature_from_driver_ids(driver_ids[begin:end])
+            for begin, end in zip(clone_offsets[:-1].tolist(), clone_offsets[1:].tolist())
+        ]
+
+        levels = []
+        for _ in range(level_count):
+            resolution, voxel_count, origin_x, origin_y, origin_z, voxel_size = _VOXEL_LOD_LEVEL_STRUCT.unpack_from(
+                data, offset
+            )
+            offset += _VOXEL_LOD_LEVEL_STRUCT.size
+            voxels = np.frombuffer(data, dtype=VOXEL_LOD_DTYPE, count=voxel_count, offset=offset)
+            offset += voxels.nbytes
+            levels.append(
+                VoxelLodLevel(
+                    resolution=resolution,
+                    origin=np.array([origin_x, origin_y, origin_z], dtype=np.float64),
+                    voxel_size=float(voxel_size),
+                    voxels=voxels,
+                )
+            )
+    except (ValueError, struct.error) as exc:
+        raise ValueError(f"Truncated voxel LOD file {path}: {exc}") from exc
+    if offset != len(data):
+        raise ValueError(f"Trailing bytes in voxel LOD file {path}")
+    return VoxelLodFrame(
+        generation=generation,
+        tau=tau,
+        cell_count=cell_count,
+        clone_signatures=signatures,
+        levels=levels,
+    )
+
+
 def load_population_frame(
     source: PopulationFrameSource,
     driver_type_ids: Set[int],
 ) -> SnapshotFrame:
     if source.kind == "csv":
         return _load_population_csv(source, driver_type_ids)
+    if source.kind == "arrow":
+        return _load_population_arrow(source, driver_type_ids)
     if source.kind == "bin":
         return _load_population_bin(source, driver_type_ids)
     raise ValueError(f"Unsupported population source kind: {source.kind}")
@@ -265,14 +514,20 @@ def build_clone_timecourse(
     run_dir: str | Path,
     prefer_bin: bool = False,
 ) -> Tuple[pd.DataFrame, pd.DataFrame, Optional[pd.DataFrame], Optional[pd.DataFrame]]:
-    driver_type_ids = load_driver_type_ids(run_dir)
     counts_rows: List[pd.Series] = []
     generations: List[int] = []
 
-    for frame in iter_population_frames(run_dir, driver_type_ids=driver_type_ids, prefer_bin=prefer_bin):
-        counts = frame.data["CloneSignature"].value_counts().sort_index()
-        counts_rows.append(counts)
-        generations.append(frame.generation)
+    clone_populations = None if prefer_bin else load_clone_populations(run_dir)
+    if clone_populations is not None:
+        for generation in sorted(clone_populations):
+            counts_rows.append(pd.Series(clone_populations[generation]).sort_index())
+            generations.append(generation)
+    else:
+        driver_type_ids = load_driver_type_ids(run_dir)
+        for frame in iter_population_frames(run_dir, driver_type_ids=driver_type_ids, prefer_bin=prefer_bin):
+            counts = frame.data["CloneSignature"].value_counts().sort_index()
+            counts_rows.append(counts)
+            generations.append(frame.generation)
 
     if not counts_rows:
         raise ValueError(f"No population snapshots found for run: {resolve_run_dir(run_dir)}")
@@ -383,7 +638,21 @@ def pick_top_clones(
 
 
 def _load_population_csv(source: PopulationFrameSource, driver_type_ids: Set[int]) -> SnapshotFrame:
-    df = pd.read_csv(source.path)
+    return _population_frame(source, pd.read_csv(source.path), float(source.generation), driver_type_ids)
+
+
+def _load_population_arrow(source: PopulationFrameSource, driver_type_ids: Set[int]) -> SnapshotFrame:
+    df, metadata = read_arrow_table(source.path)
+    tau = float(metadata.get("tau", source.generation))
+    return _population_frame(source, df, tau, driver_type_ids)
+
+
+def _population_frame(
+    source: PopulationFrameSource,
+    df: pd.DataFrame,
+    tau: float,
+    driver_type_ids: Set[int],
+) -> SnapshotFrame:
     if "PositionValid" not in df.columns:
         df["PositionValid"] = 0
     if "SpatialDimensions" not in df.columns:
@@ -394,36 +663,220 @@ def _load_population_csv(source: PopulationFrameSource, driver_type_ids: Set[int
     spatial_dimensions = int(annotated["SpatialDimensions"].iloc[0]) if not annotated.empty else 0
     return SnapshotFrame(
         generation=source.generation,
-        tau=float(source.generation),
+        tau=tau,
         spatial_dimensions=spatial_dimensions,
         data=annotated,
     )
 
 
+def _lz_decompress(data: bytes, raw_size: int) -> bytes:
+    """Decodes one compressBlock() block (see BlockCompressor.hpp)."""
+    out = bytearray()
+    pos = 0
+    end = len(data)
+
+    def read_length(length: int) -> int:
+        nonlocal pos
+        while True:
+            if pos >= end:
+                raise ValueError("Truncated LZ length")
+            byte = data[pos]
+            pos += 1
+            length += byte
+            if byte != 255:
+                return length
+
+    while pos < end:
+        token = data[pos]
+        pos += 1
+        literal_length = token >> 4
+        if literal_length == 15:
+            literal_length = read_length(literal_length)
+        if pos + literal_length > end:
+            raise ValueError("Truncated LZ literals")
+        out += data[pos : pos + literal_length]
+        pos += literal_length
+        if pos == end:
+            break
+        if pos + 2 > end:
+            raise ValueError("Truncated LZ offset")
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        match_length = token & 0x0F
+        if match_length == 15:
+            match_length = read_length(match_length)
+        match_length += 4
+        if offset == 0 or offset > len(out):
+            raise ValueError("Invalid LZ match offset")
+        start = len(out) - offset
+        if offset >= match_length:
+            out += out[start : start + match_length]
+        else:
+            for index in range(match_length):
+                out.append(out[start + index])
+    if len(out) != raw_size:
+        raise ValueError("LZ block size mismatch")
+    return bytes(out)
+
+
+def _decode_varints(data: bytes) -> List[int]:
+    values: List[int] = []
+    value = 0
+    shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        if byte & 0x80:
+            shift += 7
+        else:
+            values.append(value)
+            value = 0
+            shift = 0
+    if shift:
+        raise ValueError("Truncated varint column")
+    return values
+
+
+def _unzigzag(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
+
+
+def _decode_columnar_snapshot(payload: bytes, path: Path):
+    """Decodes a v3 file image into v2-shaped header fields, record tuples and payload tuples."""
+    (
+        _magic,
+        _version,
+        block_count,
+        tau,
+        record_count,
+        driver_mutation_count,
+        position_quantum,
+        spatial_dimensions,
+        flags,
+    ) = _HEADER_V3_STRUCT.unpack_from(payload, 0)
+
+    columns: Dict[int, bytes] = {}
+    cursor = _HEADER_V3_STRUCT.size
+    for _ in range(block_count):
+        if cursor + _COLUMN_BLOCK_STRUCT.size > len(payload):
+            raise ValueError(f"Truncated column block header in {path}")
+        column, codec, raw_size, stored_size = _COLUMN_BLOCK_STRUCT.unpack_from(payload, cursor)
+        cursor += _COLUMN_BLOCK_STRUCT.size
+        stored = payload[cursor : cursor + stored_size]
+        cursor += stored_size
+        if len(stored) != stored_size:
+            raise ValueError(f"Truncated column block in {path}")
+        if codec == _CODEC_RAW:
+            columns[column] = stored
+        elif codec == _CODEC_LZ:
+            columns[column] = _lz_decompress(stored, raw_size)
+        else:
+            raise ValueError(f"Unknown column codec {codec} in {path}")
+    if cursor != len(payload):
+        raise ValueError(f"Trailing bytes after column blocks in {path}")
+
+    ids = _decode_varints(columns[_COL_IDS])
+    parent_deltas = _decode_varints(columns[_COL_PARENT_IDS])
+    dictionary = columns[_COL_FITNESS_DICTIONARY]
+    fitness_values = struct.unpack(f"<{len(dictionary) // 4}f", dictionary)
+    fitness_codes = _decode_varints(columns[_COL_FITNESS_CODES])
+    mutation_counts = _decode_varints(columns[_COL_MUTATION_COUNTS])
+    payload_counts = _decode_varints(columns[_COL_PAYLOAD_COUNTS])
+    payload_offsets = _decode_varints(columns[_COL_PAYLOAD_OFFSETS])
+    position_valid = columns[_COL_POSITION_VALID]
+    positions = [
+        _decode_varints(columns.get(column, b""))
+        for column in (_COL_POSITION_X, _COL_POSITION_Y, _COL_POSITION_Z)
+    ]
+    if any(
+        len(values) != record_count
+        for values in (ids, parent_deltas, fitness_codes, mutation_counts, payload_counts, payload_offsets, position_valid)
+    ):
+        raise ValueError(f"Column lengths disagree with record count in {path}")
+
+    records = []
+    cell_id = 0
+    expected_offset = 0
+    position_index = 0
+    previous_position = [0, 0, 0]
+    for index in range(record_count):
+        cell_id += _unzigzag(ids[index])
+        offset = expected_offset + _unzigzag(payload_offsets[index])
+        expected_offset = offset + payload_counts[index]
+        coordinates = [math.nan, math.nan, math.nan]
+        if position_valid[index]:
+            for axis in range(3):
+                previous_position[axis] += _unzigzag(positions[axis][position_index])
+                coordinates[axis] = previous_position[axis] * position_quantum
+            position_index += 1
+        records.append(
+            (
+                cell_id,
+                cell_id - _unzigzag(parent_deltas[index]),
+                fitness_values[fitness_codes[index]],
+                coordinates[0],
+                coordinates[1],
+                coordinates[2],
+                mutation_counts[index],
+                payload_counts[index],
+                offset,
+                position_valid[index],
+            )
+        )
+
+    mutation_ids = _decode_varints(columns[_COL_PAYLOAD_MUTATION_IDS])
+    mutation_types = columns[_COL_PAYLOAD_MUTATION_TYPES]
+    if len(mutation_ids) != driver_mutation_count or len(mutation_types) != driver_mutation_count:
+        raise ValueError(f"Mutation payload columns disagree with header in {path}")
+    driver_mutations = []
+    mutation_id = 0
+    for delta, mutation_type in zip(mutation_ids, mutation_types):
+        mutation_id += _unzigzag(delta)
+        driver_mutations.append((mutation_id, mutation_type))
+
+    return tau, spatial_dimensions, flags, records, driver_mutations
+
+
 def _load_population_bin(source: PopulationFrameSource, driver_type_ids: Set[int]) -> SnapshotFrame:
-    with source.path.open("rb") as handle:
-        header_bytes = handle.read(_HEADER_STRUCT.size)
-        if len(header_bytes) != _HEADER_STRUCT.size:
-            raise ValueError(f"Incomplete snapshot header: {source.path}")
+    if snapshot_native.available():
+        return _load_population_bin_native(source, driver_type_ids)
+    if source.size >= 0:
+        with source.path.open("rb") as handle:
+            handle.seek(source.offset)
+            payload = handle.read(source.size)
+    else:
+        payload = source.path.read_bytes()
+    if len(payload) < _HEADER_STRUCT.size:
+        raise ValueError(f"Incomplete snapshot header: {source.path}")
+
+    magic, version, record_size, tau, record_count, driver_mutation_count, spatial_dimensions, mutation_record_size, flags = _HEADER_STRUCT.unpack_from(
+        payload, 0
+    )
 
-        magic, version, record_size, tau, record_count, driver_mutation_count, spatial_dimensions, mutation_record_size, flags = _HEADER_STRUCT.unpack(
-            header_bytes
+    if magic != SNAPSHOT_MAGIC:
+        raise ValueError(f"Invalid snapshot magic in {source.path}")
+    if version == SNAPSHOT_COLUMNAR_VERSION:
+        tau, spatial_dimensions, flags, records, driver_mutations = _decode_columnar_snapshot(
+            payload, source.path
         )
-
-        if magic != SNAPSHOT_MAGIC:
-            raise ValueError(f"Invalid snapshot magic in {source.path}")
-        if version != SNAPSHOT_VERSION:
-            raise ValueError(f"Unsupported snapshot version {version} in {source.path}")
+        driver_mutation_count = len(driver_mutations)
+    elif version == SNAPSHOT_VERSION:
         if record_size != _RECORD_STRUCT.size:
             raise ValueError(f"Unexpected record size {record_size} in {source.path}")
         if mutation_record_size != _DRIVER_MUTATION_STRUCT.size:
             raise ValueError(f"Unexpected mutation record size {mutation_record_size} in {source.path}")
 
-        records = [_RECORD_STRUCT.unpack(handle.read(_RECORD_STRUCT.size)) for _ in range(record_count)]
+        offset = _HEADER_STRUCT.size
+        records = [
+            _RECORD_STRUCT.unpack_from(payload, offset + index * _RECORD_STRUCT.size)
+            for index in range(record_count)
+        ]
+        offset += record_count * _RECORD_STRUCT.size
         driver_mutations = [
-            _DRIVER_MUTATION_STRUCT.unpack(handle.read(_DRIVER_MUTATION_STRUCT.size))
-            for _ in range(driver_mutation_count)
+            _DRIVER_MUTATION_STRUCT.unpack_from(payload, offset + index * _DRIVER_MUTATION_STRUCT.size)
+            for index in range(driver_mutation_count)
         ]
+    else:
+        raise ValueError(f"Unsupported snapshot version {version} in {source.path}")
 
     rows: List[Dict] = []
     has_driver_payload = bool(flags & 0x1) and driver_mutation_count > 0
@@ -477,3 +930,28 @@ def _load_population_bin(source: PopulationFrameSource, driver_type_ids: Set[int
         spatial_dimensions=int(spatial_dimensions),
         data=frame_df,
     )
+
+
+def _load_population_bin_native(source: PopulationFrameSource, driver_type_ids: Set[int]) -> SnapshotFrame:
+    """_load_population_bin through libcellevox_snapshot, which decodes the snapshot in C++ and
+    hands over whole columns instead of per-record tuples."""
+    with snapshot_native.open_snapshot(source.path, source.offset, source.size) as snapshot:
+        slices = snapshot_native.mutation_slices(snapshot)
+        frame_df = snapshot_native.population_dataframe(snapshot, slices)
+        if snapshot.has_mutation_payload and snapshot.full_mutation_payload:
+            signatures = [driver_signature_from_mutations(mutations, driver_type_ids) for mutations in slices]
+        else:
+            signatures = [
+                driver_signature_from_driver_ids([mutation_id for mutation_id, _ in mutations])
+                for mutations in slices
+            ]
+        frame_df["CloneSignature"] = signatures
+        frame_df["CloneLabel"] = [clone_label(signature) for signature in signatures]
+        frame_df["IsAncestor"] = [signature == ANCESTOR_SIGNATURE for signature in signatures]
+        frame_df["CloneColorHex"] = [clone_hex(signature) for signature in signatures]
+        return SnapshotFrame(
+            generation=source.generation,
+            tau=snapshot.tau,
+            spatial_dimensions=snapshot.spatial_dimensions,
+            data=frame_df,
+        )
@@ -0,0 +1,309 @@
+"""ctypes binding for libcellevox_snapshot (CellEvoX/include/capi/cellevox_snapshot.h).
+
+The library reads population snapshots with the same C++ code as the simulator. Columns are
+returned as numpy arrays over the library's memory: for v2 (rows) snapshots that is the
+memory-mapped file itself, zero_copy is True. v3 (columnar) snapshots are decoded into whole rows
+when opened, and zero_copy is False.
+Building an array does no per-row work. The arrays stay valid while they, or the
+NativeSnapshot they came from, are alive.
+
+The library is looked up in $CELLEVOX_SNAPSHOT_LIBRARY, then in the usual build directories,
+then on the system library path. available() is False when it cannot be found, and callers such
+as snapshot_io fall back to their pure-Python readers.
+"""
+from __future__ import annotations
+
+import ctypes
+import ctypes.util
+import os
+import sys
+from pathlib import Path
+from typing import Dict, Iterator, List, Optional, Tuple
+
+import numpy as np
+import pandas as pd
+
+ABI_VERSION = 1
+
+# cellevox_column_id, in order.
+COLUMNS = (
+    "id",
+    "parent_id",
+    "fitness",
+    "x",
+    "y",
+    "z",
+    "mutation_count",
+    "payload_count",
+    "payload_offset",
+    "position_valid",
+    "payload_mutation_id",
+    "payload_mutation_type",
+)
+# cellevox_value_type, in order.
+_VALUE_DTYPES = (np.dtype("<u1"), np.dtype("<u2"), np.dtype("<u4"), np.dtype("<f4"))
+
+
+class _Column(ctypes.Structure):
+    _fields_ = [
+        ("data", ctypes.c_void_p),
+        ("length", ctypes.c_uint64),
+        ("stride", ctypes.c_uint64),
+        ("type", ctypes.c_int32),
+        ("reserved", ctypes.c_int32),
+    ]
+
+
+class _Info(ctypes.Structure):
+    _fields_ = [
+        ("tau", ctypes.c_double),
+        ("record_count", ctypes.c_uint64),
+        ("mutation_count", ctypes.c_uint64),
+        ("format_version", ctypes.c_uint32),
+        ("spatial_dimensions", ctypes.c_uint8),
+        ("has_mutation_payload", ctypes.c_uint8),
+        ("full_mutation_payload", ctypes.c_uint8),
+        ("zero_copy", ctypes.c_uint8),
+    ]
+
+
+def _library_candidates() -> List[Path]:
+    names = {"win32": "cellevox_snapshot.dll", "darwin": "libcellevox_snapshot.dylib"}
+    name = names.get(sys.platform, "libcellevox_snapshot.so")
+    cellevox_dir = Path(__file__).resolve().parent.parent
+    candidates = []
+    env_library = os.environ.get("CELLEVOX_SNAPSHOT_LIBRARY")
+    if env_library:
+        candidates.append(Path(env_library).expanduser())
+    for build_dir in (cellevox_dir / "build", cellevox_dir.parent / "build"):
+        candidates.append(build_dir / "lib" / name)
+        candidates.append(build_dir / "bin" / name)
+    return candidates
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    paths = [str(path) for path in _library_candidates() if path.is_file()]
+    system_library = ctypes.util.find_library("cellevox_snapshot")
+    if system_library:
+        paths.append(system_library)
+    for path in paths:
+        try:
+            library = ctypes.CDLL(path)
+        except OSError:
+            continue
+        if library.cellevox_snapshot_abi_version() != ABI_VERSION:
+            continue
+        _declare(library)
+        return library
+    return None
+
+
+def _declare(library: ctypes.CDLL) -> None:
+    snapshot_p = ctypes.c_void_p
+    run_p = ctypes.c_void_p
+    library.cellevox_last_error.restype = ctypes.c_char_p
+    library.cellevox_snapshot_open.argtypes = [ctypes.c_char_p]
+    library.cellevox_snapshot_open.restype = snapshot_p
+    library.cellevox_snapshot_open_range.argtypes = [ctypes.c_char_p, ctypes.c_uint64, ctypes.c_uint64]
+    library.cellevox_snapshot_open_range.restype = snapshot_p
+    library.cellevox_snapshot_close.argtypes = [snapshot_p]
+    library.cellevox_snapshot_close.restype = None
+    library.cellevox_snapshot_info_get.argtypes = [snapshot_p, ctypes.POINTER(_Info)]
+    library.cellevox_snapshot_info_get.restype = ctypes.c_int
+    library.cellevox_snapshot_column.argtypes = [snapshot_p, ctypes.c_int32, ctypes.POINTER(_Column)]
+    library.cellevox_snapshot_column.restype = ctypes.c_int
+    library.cellevox_run_open.argtypes = [ctypes.c_char_p]
+    library.cellevox_run_open.restype = run_p
+    library.cellevox_run_close.argtypes = [run_p]
+    library.cellevox_run_close.restype = None
+    library.cellevox_run_generation_count.argtypes = [run_p]
+    library.cellevox_run_generation_count.restype = ctypes.c_uint64
+    library.cellevox_run_generation.argtypes = [run_p, ctypes.c_uint64]
+    library.cellevox_run_generation.restype = ctypes.c_int64
+    library.cellevox_run_open_snapshot.argtypes = [run_p, ctypes.c_uint64]
+    library.cellevox_run_open_snapshot.restype = snapshot_p
+
+
+_LIBRARY: Optional[ctypes.CDLL] = None
+_LIBRARY_SEARCHED = False
+
+
+def library() -> Optional[ctypes.CDLL]:
+    global _LIBRARY, _LIBRARY_SEARCHED
+    if not _LIBRARY_SEARCHED:
+        _LIBRARY = _load_library()
+        _LIBRARY_SEARCHED = True
+    return _LIBRARY
+
+
+def available() -> bool:
+    return library() is not None
+
+
+def _error(message: str) -> OSError:
+    detail = library().cellevox_last_error().decode("utf-8", "replace")
+    return OSError(f"{message}: {detail}")
+
+
+class NativeSnapshot:
+    """One open generation. Use as a context manager or call close() when done."""
+
+    def __init__(self, handle: int, generation: Optional[int] = None):
+        self._handle = handle
+        info = _Info()
+        if library().cellevox_snapshot_info_get(handle, ctypes.byref(info)) != 0:
+            error = _error("cellevox_snapshot_info_get failed")
+            self.close()
+            raise error
+        self.generation = generation
+        self.tau = float(info.tau)
+        self.record_count = int(info.record_count)
+        self.mutation_count = int(info.mutation_count)
+        self.format_version = int(info.format_version)
+        self.spatial_dimensions = int(info.spatial_dimensions)
+        self.has_mutation_payload = bool(info.has_mutation_payload)
+        self.full_mutation_payload = bool(info.full_mutation_payload)
+        self.zero_copy = bool(info.zero_copy)
+
+    def column(self, name: str) -> np.ndarray:
+        """Read-only strided view of a column; keeps this snapshot open while it is alive."""
+        if self._handle is None:
+            raise ValueError("snapshot is closed")
+        descriptor = _Column()
+        if library().cellevox_snapshot_column(self._handle, COLUMNS.index(name), ctypes.byref(descriptor)) != 0:
+            raise _error(f"cellevox_snapshot_column({name}) failed")
+        dtype = _VALUE_DTYPES[descriptor.type]
+        if descriptor.length == 0:
+            return np.empty(0, dtype=dtype)
+        span = (descriptor.length - 1) * descriptor.stride + dtype.itemsize
+        buffer = (ctypes.c_ubyte * span).from_address(descriptor.data)
+        buffer._owner = self  # the array's base chain now keeps the handle alive
+        array = np.ndarray(
+            shape=(descriptor.length,),
+            dtype=dtype,
+            buffer=buffer,
+            strides=(descriptor.stride,),
+        )
+        array.flags.writeable = False
+        return array
+
+    def columns(self) -> Dict[str, np.ndarray]:
+        return {name: self.column(name) for name in COLUMNS}
+
+    def close(self) -> None:
+        """Releases the handle now. Arrays from column() must not be used afterwards."""
+        if self._handle is not None:
+            library().cellevox_snapshot_close(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        if library() is not None:
+            self.close()
+
+    def __enter__(self) -> "NativeSnapshot":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+
+def open_snapshot(path: str | Path, offset: int = 0, size: int = -1, generation: Optional[int] = None) -> NativeSnapshot:
+    """Opens a snapshot file, or the frame at [offset, offset + size) of a container."""
+    lib = library()
+    if lib is None:
+        raise OSError("libcellevox_snapshot not found; build the cellevox_snapshot target")
+    encoded = os.fsencode(str(path))
+    handle = lib.cellevox_snapshot_open(encoded) if size < 0 else lib.cellevox_snapshot_open_range(encoded, offset, size)
+    if not handle:
+        raise _error(f"cannot open snapshot {path}")
+    return NativeSnapshot(handle, generation)
+
+
+class NativeRun:
+    """The stored generations of a run (container frames or per-generation files), ascending."""
+
+    def __init__(self, run_dir: str | Path):
+        lib = library()
+        if lib is None:
+            raise OSError("libcellevox_snapshot not found; build the cellevox_snapshot target")
+        self._handle = lib.cellevox_run_open(os.fsencode(str(run_dir)))
+        if not self._handle:
+            raise _error(f"cannot open run {run_dir}")
+        self.run_dir = Path(run_dir)
+        self.generations = [
+            int(lib.cellevox_run_generation(self._handle, index))
+            for index in range(lib.cellevox_run_generation_count(self._handle))
+        ]
+
+    def open(self, generation: int) -> NativeSnapshot:
+        index = self.generations.index(generation)
+        handle = library().cellevox_run_open_snapshot(self._handle, index)
+        if not handle:
+            raise _error(f"cannot open generation {generation} of {self.run_dir}")
+        return NativeSnapshot(handle, generation)
+
+    def __iter__(self) -> Iterator[NativeSnapshot]:
+        for generation in self.generations:
+            yield self.open(generation)
+
+    def close(self) -> None:
+        if self._handle is not None:
+            library().cellevox_run_close(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        if library() is not None:
+            self.close()
+
+    def __enter__(self) -> "NativeRun":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+
+def mutation_slices(snapshot: NativeSnapshot) -> List[List[Tuple[int, int]]]:
+    """Per-record (mutation_id, mutation_type) payload entries."""
+    if not snapshot.has_mutation_payload or snapshot.mutation_count == 0:
+        return [[] for _ in range(snapshot.record_count)]
+    payload = list(
+        zip(
+            snapshot.column("payload_mutation_id").tolist(),
+            snapshot.column("payload_mutation_type").tolist(),
+        )
+    )
+    return [
+        payload[offset : offset + count]
+        for offset, count in zip(
+            snapshot.column("payload_offset").tolist(),
+            snapshot.column("payload_count").tolist(),
+        )
+    ]
+
+
+def population_dataframe(
+    snapshot: NativeSnapshot,
+    slices: Optional[List[List[Tuple[int, int]]]] = None,
+) -> pd.DataFrame:
+    """The snapshot with the population CSV's columns. Numeric columns are converted from the
+    column arrays in bulk; only the Mutations text is built per cell."""
+    if slices is None:
+        slices = mutation_slices(snapshot)
+    valid = snapshot.column("position_valid") != 0
+    return pd.DataFrame(
+        {
+            "CellID": snapshot.column("id").astype(np.int64),
+            "ParentID": snapshot.column("parent_id").astype(np.int64),
+            "Fitness": snapshot.column("fitness").astype(np.float64),
+            "MutationCount": snapshot.column("mutation_count").astype(np.int64),
+            "Mutations": [
+                " ".join(f"({mutation_id},{mutation_type})" for mutation_id, mutation_type in mutations)
+                for mutations in slices
+            ],
+            "X": np.where(valid, snapshot.column("x").astype(np.float64), np.nan),
+            "Y": np.where(valid, snapshot.column("y").astype(np.float64), np.nan),
+            "Z": np.where(valid, snapshot.column("z").astype(np.float64), np.nan),
+            "PositionValid": valid.astype(np.int64),
+            "SpatialDimensions": snapshot.spatial_dimensions,
+        }
+    )
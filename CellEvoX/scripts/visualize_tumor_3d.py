@@ -4,7 +4,7 @@ from __future__ import annotations
 import argparse
 import math
 from pathlib import Path
-from typing import Dict, List, Tuple
+from typing import Dict, List, Optional, Tuple
 
 import matplotlib
 
@@ -15,7 +15,15 @@ import matplotlib.pyplot as plt
 import numpy as np
 from matplotlib.colors import to_rgba_array
 
-from snapshot_io import PopulationFrameSource, discover_population_sources, load_driver_type_ids, load_population_frame
+from snapshot_io import (
+    PopulationFrameSource,
+    clone_hex,
+    discover_population_sources,
+    discover_voxel_lod_sources,
+    load_driver_type_ids,
+    load_population_frame,
+    load_voxel_lod,
+)
 
 
 BACKGROUND = "#090b10"
@@ -58,6 +66,12 @@ def parse_args() -> argparse.Namespace:
         help="Preferred renderer backend. Auto tries PyVista first and falls back to Matplotlib.",
     )
     parser.add_argument("--point-size", type=float, default=5.0, help="Base point size for rendered cells")
+    parser.add_argument(
+        "--lod",
+        default="auto",
+        help="Voxel LOD resolution to render instead of cells: 'auto' (finest level when the run "
+        "wrote voxel_lod files), 'off', or a resolution such as 64",
+    )
     return parser.parse_args()
 
 
@@ -88,6 +102,10 @@ def pick_sources(run_dir: Path, max_frames: int) -> List:
     sources = discover_population_sources(run_dir, prefer_bin=True)
     if not sources:
         raise ValueError(f"No population snapshots found in {run_dir}")
+    return subsample(sources, max_frames)
+
+
+def subsample(sources: List, max_frames: int) -> List:
     if len(sources) <= max_frames:
         return sources
 
@@ -160,6 +178,31 @@ def load_spatial_frames(run_dir: Path, max_frames: int, max_points: int) -> List
     return frames
 
 
+def load_lod_frames(run_dir: Path, max_frames: int, resolution: Optional[int]) -> List[Dict]:
+    """One point per occupied voxel, colored by the voxel's dominant clone."""
+    frames: List[Dict] = []
+    for _, path in subsample(discover_voxel_lod_sources(run_dir), max_frames):
+        lod = load_voxel_lod(path)
+        level = lod.level(resolution)
+        if len(level.voxels) == 0:
+            continue
+        dominant = level.voxels["dominant_clone"]
+        palette = to_rgba_array([clone_hex(signature) for signature in lod.clone_signatures], alpha=0.88)
+        frames.append(
+            {
+                "generation": float(lod.generation),
+                "tau": float(lod.tau),
+                "points": level.centers(),
+                "colors": palette[dominant],
+                "cell_count": int(lod.cell_count),
+                "active_clones": int(len(np.unique(dominant))),  # clones dominant in some voxel
+            }
+        )
+    if not frames:
+        raise ValueError("No voxel LOD frames with occupied voxels were found.")
+    return frames
+
+
 def compute_bounds(frames: List[Dict]) -> Tuple[np.ndarray, float]:
     all_points = np.vstack([frame["points"] for frame in frames if len(frame["points"]) > 0])
     mins = all_points.min(axis=0)
@@ -335,8 +378,14 @@ def render_tumor_replay(
     pulse_frames: int,
     backend: str,
     point_size: float,
+    lod: str = "auto",
 ) -> Path:
-    frames = load_spatial_frames(run_dir, max_frames=max_frames, max_points=max_points)
+    if lod != "off" and discover_voxel_lod_sources(run_dir):
+        frames = load_lod_frames(run_dir, max_frames=max_frames, resolution=None if lod == "auto" else int(lod))
+    elif lod not in {"off", "auto"}:
+        raise ValueError(f"--lod {lod} requested, but {run_dir} has no voxel LOD files")
+    else:
+        frames = load_spatial_frames(run_dir, max_frames=max_frames, max_points=max_points)
 
     if backend in {"auto", "pyvista"}:
         try:
@@ -380,6 +429,7 @@ def main() -> None:
             pulse_frames=max(1, args.pulse_frames),
             backend=args.backend,
             point_size=max(0.1, args.point_size),
+            lod=args.lod,
         )
     except ValueError as exc:
         print(f"Skipping 3D replay: {exc}")
@@ -0,0 +1,296 @@
+#include "capi/cellevox_snapshot.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "io/MappedFile.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
+#include "io/PopulationSnapshotIO.hpp"
+#include "io/PopulationSnapshotView.hpp"
+
+namespace fs = std::filesystem;
+using CellEvoX::io::MappedFile;
+using CellEvoX::io::PopulationSnapshotDriverMutation;
+using CellEvoX::io::PopulationSnapshotRecord;
+using CellEvoX::io::PopulationSnapshotView;
+
+struct cellevox_snapshot {
+  PopulationSnapshotView view;
+  uint32_t format_version = 0;
+};
+
+struct cellevox_run {
+  // Container frames share one mapping; file frames are mapped when opened.
+  struct Frame {
+    int generation = 0;
+    fs::path path;
+    size_t offset = 0;
+    size_t size = 0;
+  };
+  std::shared_ptr<const MappedFile> container;
+  std::vector<Frame> frames;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+int fail(std::string message) {
+  last_error = std::move(message);
+  return 1;
+}
+
+// Runs body, turning exceptions into a failure so none cross the C boundary.
+template <typename Result, typename Body>
+Result guarded(Result on_failure, Body&& body) {
+  try {
+    return body();
+  } catch (const std::bad_alloc&) {
+    fail("out of memory");
+  } catch (const std::exception& e) {
+    fail(e.what());
+  } catch (...) {
+    fail("unknown error");
+  }
+  return on_failure;
+}
+
+cellevox_snapshot* openSnapshot(std::shared_ptr<const MappedFile> file,
+                                size_t offset,
+                                size_t size,
+                                const std::string& description) {
+  auto snapshot = std::make_unique<cellevox_snapshot>();
+  constexpr size_t kMagicSize = sizeof(CellEvoX::io::PopulationSnapshotFileHeader::magic);
+  if (size >= kMagicSize + sizeof(uint32_t) &&
+      CellEvoX::io::isPopulationSnapshotHeader(
+          reinterpret_cast<const char*>(file->data() + offset))) {
+    std::memcpy(&snapshot->format_version, file->data() + offset + kMagicSize, sizeof(uint32_t));
+  }
+  if (!snapshot->view.open(std::move(file), offset, size)) {
+    fail("not a readable population snapshot: " + description);
+    return nullptr;
+  }
+  return snapshot.release();
+}
+
+// A column of `Row` values at byte offset `field_offset`. Rows are packed, so the descriptor
+// carries the row size as its stride and is built from byte pointers.
+template <typename Row>
+cellevox_column stridedColumn(std::span<const Row> rows,
+                              size_t field_offset,
+                              cellevox_value_type type) {
+  cellevox_column column{};
+  column.length = rows.size();
+  column.stride = sizeof(Row);
+  column.type = type;
+  column.data =
+      rows.empty() ? nullptr : reinterpret_cast<const unsigned char*>(rows.data()) + field_offset;
+  return column;
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t cellevox_snapshot_abi_version(void) { return CELLEVOX_SNAPSHOT_ABI_VERSION; }
+
+const char* cellevox_last_error(void) { return last_error.c_str(); }
+
+cellevox_snapshot* cellevox_snapshot_open(const char* path) {
+  return guarded<cellevox_snapshot*>(nullptr, [&]() -> cellevox_snapshot* {
+    if (path == nullptr) {
+      fail("path is NULL");
+      return nullptr;
+    }
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+      fail(std::string("cannot open ") + path);
+      return nullptr;
+    }
+    const size_t size = file->size();
+    return openSnapshot(std::move(file), 0, size, path);
+  });
+}
+
+cellevox_snapshot* cellevox_snapshot_open_range(const char* path, uint64_t offset, uint64_t size) {
+  return guarded<cellevox_snapshot*>(nullptr, [&]() -> cellevox_snapshot* {
+    if (path == nullptr) {
+      fail("path is NULL");
+      return nullptr;
+    }
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+      fail(std::string("cannot open ") + path);
+      return nullptr;
+    }
+    if (offset > file->size() || size > file->size() - offset) {
+      fail(std::string("byte range outside ") + path);
+      return nullptr;
+    }
+    return openSnapshot(std::move(file),
+                        static_cast<size_t>(offset),
+                        static_cast<size_t>(size),
+                        std::string(path) + " at offset " + std::to_string(offset));
+  });
+}
+
+void cellevox_snapshot_close(cellevox_snapshot* snapshot) { delete snapshot; }
+
+int cellevox_snapshot_info_get(const cellevox_snapshot* snapshot, cellevox_snapshot_info* info) {
+  if (snapshot == nullptr || info == nullptr) {
+    return fail("snapshot or info is NULL");
+  }
+  const auto& header = snapshot->view.header();
+  *info = {};
+  info->tau = header.tau;
+  info->record_count = snapshot->view.records().size();
+  info->mutation_count = snapshot->view.mutations().size();
+  info->format_version = snapshot->format_version;
+  info->spatial_dimensions = header.spatial_dimensions;
+  info->has_mutation_payload = CellEvoX::io::hasAnyMutationPayload(header) ? 1 : 0;
+  info->full_mutation_payload = CellEvoX::io::hasFullMutationPayload(header) ? 1 : 0;
+  info->zero_copy = snapshot->view.zeroCopy() ? 1 : 0;
+  return 0;
+}
+
+int cellevox_snapshot_column(const cellevox_snapshot* snapshot,
+                             int32_t column,
+                             cellevox_column* out) {
+  if (snapshot == nullptr || out == nullptr) {
+    return fail("snapshot or out is NULL");
+  }
+  const auto records = snapshot->view.records();
+  const auto mutations = snapshot->view.mutations();
+  using Record = PopulationSnapshotRecord;
+  using Mutation = PopulationSnapshotDriverMutation;
+  switch (column) {
+    case CELLEVOX_COLUMN_ID:
+      *out = stridedColumn(records, offsetof(Record, id), CELLEVOX_TYPE_UINT32);
+      return 0;
+    case CELLEVOX_COLUMN_PARENT_ID:
+      *out = stridedColumn(records, offsetof(Record, parent_id), CELLEVOX_TYPE_UINT32);
+      return 0;
+    case CELLEVOX_COLUMN_FITNESS:
+      *out = stridedColumn(records, offsetof(Record, fitness), CELLEVOX_TYPE_FLOAT32);
+      return 0;
+    case CELLEVOX_COLUMN_X:
+      *out = stridedColumn(records, offsetof(Record, x), CELLEVOX_TYPE_FLOAT32);
+      return 0;
+    case CELLEVOX_COLUMN_Y:
+      *out = stridedColumn(records, offsetof(Record, y), CELLEVOX_TYPE_FLOAT32);
+      return 0;
+    case CELLEVOX_COLUMN_Z:
+      *out = stridedColumn(records, offsetof(Record, z), CELLEVOX_TYPE_FLOAT32);
+      return 0;
+    case CELLEVOX_COLUMN_MUTATION_COUNT:
+      *out = stridedColumn(records, offsetof(Record, mutations_count), CELLEVOX_TYPE_UINT16);
+      return 0;
+    case CELLEVOX_COLUMN_PAYLOAD_COUNT:
+      *out = stridedColumn(records, offsetof(Record, driver_mutation_count), CELLEVOX_TYPE_UINT16);
+      return 0;
+    case CELLEVOX_COLUMN_PAYLOAD_OFFSET:
+      *out = stridedColumn(records, offsetof(Record, driver_mutation_offset), CELLEVOX_TYPE_UINT32);
+      return 0;
+    case CELLEVOX_COLUMN_POSITION_VALID:
+      *out = stridedColumn(records, offsetof(Record, position_valid), CELLEVOX_TYPE_UINT8);
+      return 0;
+    case CELLEVOX_COLUMN_PAYLOAD_MUTATION_ID:
+      *out = stridedColumn(mutations, offsetof(Mutation, mutation_id), CELLEVOX_TYPE_UINT32);
+      return 0;
+    case CELLEVOX_COLUMN_PAYLOAD_MUTATION_TYPE:
+      *out = stridedColumn(mutations, offsetof(Mutation, mutation_type), CELLEVOX_TYPE_UINT8);
+      return 0;
+    default:
+      return fail("unknown column id " + std::to_string(column));
+  }
+}
+
+cellevox_run* cellevox_run_open(const char* directory) {
+  return guarded<cellevox_run*>(nullptr, [&]() -> cellevox_run* {
+    if (directory == nullptr) {
+      fail("directory is NULL");
+      return nullptr;
+    }
+    fs::path population_dir = fs::path(directory) / "population_data";
+    std::error_code ec;
+    if (!fs::is_directory(population_dir, ec)) {
+      population_dir = directory;
+    }
+    if (!fs::is_directory(population_dir, ec)) {
+      fail(std::string("not a directory: ") + directory);
+      return nullptr;
+    }
+
+    auto run = std::make_unique<cellevox_run>();
+    const fs::path container_path = population_dir / "population_snapshots.bin";
+    CellEvoX::io::PopulationSnapshotContainerReader container;
+    if (fs::exists(container_path, ec) && container.open(container_path)) {
+      auto mapping = std::make_shared<MappedFile>();
+      if (!mapping->open(container_path)) {
+        fail("cannot map " + container_path.string());
+        return nullptr;
+      }
+      for (const auto& entry : container.entries()) {
+        const uint64_t payload_offset =
+            entry.offset + sizeof(CellEvoX::io::PopulationSnapshotFrameHeader);
+        run->frames.push_back({entry.generation,
+                               container_path,
+                               static_cast<size_t>(payload_offset),
+                               static_cast<size_t>(entry.size)});
+      }
+      std::stable_sort(
+          run->frames.begin(), run->frames.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.generation < rhs.generation;
+          });
+      run->container = std::move(mapping);
+    } else {
+      for (auto& file : CellEvoX::io::listPopulationSnapshotFiles(population_dir)) {
+        run->frames.push_back({file.generation, std::move(file.path), 0, 0});
+      }
+    }
+    return run.release();
+  });
+}
+
+void cellevox_run_close(cellevox_run* run) { delete run; }
+
+uint64_t cellevox_run_generation_count(const cellevox_run* run) {
+  return run == nullptr ? 0 : run->frames.size();
+}
+
+int64_t cellevox_run_generation(const cellevox_run* run, uint64_t index) {
+  if (run == nullptr || index >= run->frames.size()) {
+    return -1;
+  }
+  return run->frames[index].generation;
+}
+
+cellevox_snapshot* cellevox_run_open_snapshot(const cellevox_run* run, uint64_t index) {
+  return guarded<cellevox_snapshot*>(nullptr, [&]() -> cellevox_snapshot* {
+    if (run == nullptr || index >= run->frames.size()) {
+      fail("generation index out of range");
+      return nullptr;
+    }
+    const auto& frame = run->frames[index];
+    if (run->container) {
+      return openSnapshot(run->container,
+                          frame.offset,
+                          frame.size,
+                          frame.path.string() + " (generation " +
+                              std::to_string(frame.generation) + ")");
+    }
+    return cellevox_snapshot_open(frame.path.string().c_str());
+  });
+}
+
+}  // extern "C"
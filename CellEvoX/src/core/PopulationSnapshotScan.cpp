@@ -0,0 +1,234 @@
+#include "core/PopulationSnapshotScan.hpp"
+
+#include <spdlog/spdlog.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "io/MappedFile.hpp"
+#include "io/PopulationEventLog.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
+#include "io/PopulationSnapshotView.hpp"
+
+namespace CellEvoX::core {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Where one generation's snapshot bytes live: a whole file, or a slice of the shared
+// container mapping.
+struct FrameSource {
+  int generation = 0;
+  fs::path path;
+  size_t offset = 0;
+  size_t size = 0;
+};
+
+std::vector<FrameSource> collectPopulationBinaryFiles(const std::string& output_dir) {
+  std::vector<FrameSource> sources;
+  for (auto& file : io::listPopulationSnapshotFiles(fs::path(output_dir) / "population_data")) {
+    sources.push_back({file.generation, std::move(file.path), 0, 0});
+  }
+  return sources;
+}
+
+// A replayed event-log generation; the replay reuses its buffers, so batched frames own a copy.
+struct OwnedFrame {
+  int generation = 0;
+  io::PopulationSnapshotFileHeader header{};
+  std::vector<io::PopulationSnapshotRecord> records;
+  std::vector<io::PopulationSnapshotDriverMutation> mutations;
+};
+
+void visitAll(std::span<PopulationSnapshotVisitor* const> visitors,
+              const PopulationSnapshotFrame& frame) {
+  for (auto* visitor : visitors) {
+    visitor->visit(frame);
+  }
+}
+
+size_t scanEventLog(const fs::path& log_path,
+                    std::span<PopulationSnapshotVisitor* const> visitors,
+                    size_t batch_size) {
+  std::vector<OwnedFrame> batch;
+  batch.reserve(batch_size);
+  size_t visited = 0;
+  const auto flush = [&] {
+    tbb::parallel_for(size_t{0}, batch.size(), [&](size_t i) {
+      const auto& owned = batch[i];
+      visitAll(visitors, {owned.generation, owned.header, owned.records, owned.mutations});
+    });
+    visited += batch.size();
+    batch.clear();
+  };
+
+  const bool replayed = io::forEachLoggedGeneration(
+      log_path,
+      [&](int generation,
+          const io::PopulationSnapshotFileHeader& header,
+          const std::vector<io::PopulationSnapshotRecord>& records,
+          const std::vector<io::PopulationSnapshotDriverMutation>& payload) {
+        batch.push_back({generation, header, records, payload});
+        if (batch.size() >= batch_size) {
+          flush();
+        }
+        return true;
+      });
+  flush();
+  if (!replayed) {
+    spdlog::error("Failed to replay population event log: {}", log_path.string());
+  }
+  return visited;
+}
+
+size_t scanSnapshotFrames(const std::vector<FrameSource>& sources,
+                          const std::shared_ptr<const io::MappedFile>& container,
+                          std::span<PopulationSnapshotVisitor* const> visitors,
+                          size_t max_frames_in_flight) {
+  std::atomic<size_t> visited{0};
+  size_t next = 0;
+  tbb::parallel_pipeline(
+      max_frames_in_flight,
+      tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order,
+                                     [&](tbb::flow_control& control) -> size_t {
+                                       if (next == sources.size()) {
+                                         control.stop();
+                                         return 0;
+                                       }
+                                       return next++;
+                                     }) &
+          tbb::make_filter<size_t, void>(
+              tbb::filter_mode::parallel, [&](size_t index) {
+                const FrameSource& source = sources[index];
+                io::PopulationSnapshotView view;
+                const bool opened = container
+                                        ? view.open(container, source.offset, source.size)
+                                        : view.open(source.path);
+                if (!opened) {
+                  spdlog::error("Failed to read population snapshot for generation {}",
+                                source.generation);
+                  return;
+                }
+                visitAll(visitors,
+                         {source.generation, view.header(), view.records(), view.mutations()});
+                visited.fetch_add(1, std::memory_order_relaxed);
+              }));
+  return visited.load();
+}
+
+}  // namespace
+
+size_t scanPopulationSnapshots(const std::string& output_dir,
+                               std::span<PopulationSnapshotVisitor* const> visitors,
+                               size_t max_frames_in_flight) {
+  if (max_frames_in_flight == 0) {
+    max_frames_in_flight =
+        2 * static_cast<size_t>(std::max(1, tbb::this_task_arena::max_concurrency()));
+  }
+
+  size_t visited = 0;
+  const fs::path log_path = io::populationEventLogPath(output_dir);
+  const fs::path container_path = io::populationSnapshotContainerPath(output_dir);
+  io::PopulationSnapshotContainerReader container;
+  std::error_code ec;
+  if (fs::exists(log_path, ec) && !ec) {
+    visited = scanEventLog(log_path, visitors, max_frames_in_flight);
+  } else if (container.open(container_path)) {
+    if (container.recovered()) {
+      spdlog::warn("Population snapshot container has no valid index; recovered {} frames",
+                   container.entries().size());
+    }
+    auto mapping = std::make_shared<io::MappedFile>();
+    if (mapping->open(container_path)) {
+      std::vector<FrameSource> sources;
+      sources.reserve(container.entries().size());
+      for (const auto& entry : container.entries()) {
+        sources.push_back({entry.generation,
+                           container_path,
+                           static_cast<size_t>(entry.offset +
+                                               sizeof(io::PopulationSnapshotFrameHeader)),
+                           static_cast<size_t>(entry.size)});
+      }
+      visited = scanSnapshotFrames(sources, mapping, visitors, max_frames_in_flight);
+    } else {
+      spdlog::error("Failed to map population snapshot container: {}", container_path.string());
+    }
+  } else {
+    visited = scanSnapshotFrames(
+        collectPopulationBinaryFiles(output_dir), nullptr, visitors, max_frames_in_flight);
+  }
+
+  for (auto* visitor : visitors) {
+    visitor->finish();
+  }
+  return visited;
+}
+
+size_t scanPopulationReports(const std::vector<std::pair<int, ecs::CellMap>>& reports,
+                             const std::map<uint8_t, MutationType>& mutation_types,
+                             bool full_mutation_payload,
+                             std::span<PopulationSnapshotVisitor* const> visitors) {
+  std::bitset<256> payload_types;
+  for (const auto& [type_id, mutation_type] : mutation_types) {
+    payload_types.set(type_id, mutation_type.is_driver);
+  }
+  if (full_mutation_payload) {
+    payload_types.set();
+  }
+  const auto payload_kind =
+      full_mutation_payload ? io::MutationPayloadKind::Full : io::MutationPayloadKind::DriverOnly;
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+  tbb::parallel_for(size_t{0}, reports.size(), [&](size_t index) {
+    const auto& [generation, cells] = reports[index];
+    std::vector<io::PopulationSnapshotRecord> records;
+    std::vector<io::PopulationSnapshotDriverMutation> payload;
+    records.reserve(cells.size());
+    for (const auto& [cell_id, cell] : cells) {
+      const size_t payload_offset = payload.size();
+      for (const auto& [mutation_id, mutation_type] : cell.mutations) {
+        if (payload_types.test(mutation_type)) {
+          payload.push_back({mutation_id, mutation_type});
+        }
+      }
+      records.push_back(
+          {cell_id,
+           cell.parent_id,
+           cell.fitness,
+           kNaN,
+           kNaN,
+           kNaN,
+           static_cast<uint16_t>(
+               std::min<size_t>(cell.mutations.size(), std::numeric_limits<uint16_t>::max())),
+           static_cast<uint16_t>(std::min<size_t>(payload.size() - payload_offset,
+                                                  std::numeric_limits<uint16_t>::max())),
+           static_cast<uint32_t>(payload_offset),
+           0,
+           {0, 0, 0}});
+    }
+    const auto header =
+        io::makePopulationSnapshotHeader(std::numeric_limits<double>::quiet_NaN(),
+                                         static_cast<uint32_t>(records.size()),
+                                         0,
+                                         static_cast<uint32_t>(payload.size()),
+                                         payload_kind);
+    visitAll(visitors, {generation, header, records, payload});
+  });
+
+  for (auto* visitor : visitors) {
+    visitor->finish();
+  }
+  return reports.size();
+}
+
+}  // namespace CellEvoX::core
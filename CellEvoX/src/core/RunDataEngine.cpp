@@ -1,12 +1,16 @@
 #include "core/RunDataEngine.hpp"
 
 #include <external/matplotlibcpp.h>
+#include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <tbb/concurrent_hash_map.h>
 #include <tbb/concurrent_unordered_set.h>
+#include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
 
 #include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <chrono>
 #include <cmath>
 #include <cstdlib>
@@ -16,13 +20,19 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <optional>
 #include <random>
-#include <regex>
+#include <span>
 #include <sstream>
 #include <string_view>
 #include <system_error>
+#include <type_traits>
 #include <vector>
 
+#include "core/PopulationSnapshotScan.hpp"
+#include "io/ArrowIpcWriter.hpp"
+#include "io/CsvWriter.hpp"
 #include "io/PopulationSnapshotIO.hpp"
 
 namespace {
@@ -32,152 +42,59 @@ namespace fs = std::filesystem;
 constexpr const char* kPopulationCsvHeader =
     "CellID,ParentID,Fitness,MutationCount,Mutations,X,Y,Z,PositionValid,SpatialDimensions\n";
 
-int extractGenerationFromFilename(const fs::path& path) {
-  static const std::regex pattern(R"(population_generation_(\d+)\.(csv|bin))");
-  std::smatch match;
-  const std::string filename = path.filename().string();
-  if (std::regex_match(filename, match, pattern)) {
-    return std::stoi(match[1].str());
+void appendMutation(CellEvoX::io::CsvBuffer& out,
+                    bool first,
+                    uint32_t mutation_id,
+                    uint8_t mutation_type) {
+  if (!first) {
+    out.put(' ');
   }
-  return -1;
+  out.put('(').put(mutation_id).put(',').put(mutation_type).put(')');
 }
 
-std::string formatMutationsForCsv(const Cell& cell) {
-  std::string mutations_str;
-  for (const auto& [mutation_id, mutation_type] : cell.mutations) {
-    mutations_str +=
-        "(" + std::to_string(mutation_id) + "," + std::to_string(mutation_type) + ") ";
-  }
-
-  if (!mutations_str.empty()) {
-    mutations_str.pop_back();
-  }
-
-  return mutations_str;
-}
-
-bool isDriverMutationType(const std::map<uint8_t, MutationType>& mutation_types, uint8_t mutation_type) {
-  const auto it = mutation_types.find(mutation_type);
-  return it != mutation_types.end() && it->second.is_driver;
-}
-
-std::string formatDriverMutationsForCsv(const Cell& cell,
-                                        const std::map<uint8_t, MutationType>& mutation_types) {
-  std::string mutations_str;
-  for (const auto& [mutation_id, mutation_type] : cell.mutations) {
-    if (!isDriverMutationType(mutation_types, mutation_type)) {
-      continue;
-    }
-    mutations_str +=
-        "(" + std::to_string(mutation_id) + "," + std::to_string(mutation_type) + ") ";
-  }
-
-  if (!mutations_str.empty()) {
-    mutations_str.pop_back();
-  }
-
-  return mutations_str;
-}
-
-std::string formatDriverMutationsForCsv(
+// The record's slice of the mutation payload, or empty when it lies outside the payload.
+std::span<const CellEvoX::io::PopulationSnapshotDriverMutation> recordMutationSlice(
     const CellEvoX::io::PopulationSnapshotRecord& record,
-    const std::vector<CellEvoX::io::PopulationSnapshotDriverMutation>& driver_mutations) {
-  if (record.driver_mutation_count == 0) {
-    return "";
-  }
-
+    std::span<const CellEvoX::io::PopulationSnapshotDriverMutation> mutation_payload) {
   const size_t start = record.driver_mutation_offset;
-  const size_t end = start + record.driver_mutation_count;
-  if (start > driver_mutations.size() || end > driver_mutations.size()) {
-    return "";
-  }
-
-  std::string mutations_str;
-  for (size_t i = start; i < end; ++i) {
-    const auto& mutation = driver_mutations[i];
-    mutations_str +=
-        "(" + std::to_string(mutation.mutation_id) + "," + std::to_string(mutation.mutation_type) +
-        ") ";
-  }
-
-  if (!mutations_str.empty()) {
-    mutations_str.pop_back();
+  const size_t count = record.driver_mutation_count;
+  if (start > mutation_payload.size() || count > mutation_payload.size() - start) {
+    return {};
   }
-
-  return mutations_str;
+  return mutation_payload.subspan(start, count);
 }
 
-std::string formatSnapshotMutationsForCsv(
-    const CellEvoX::io::PopulationSnapshotRecord& record,
-    const std::vector<CellEvoX::io::PopulationSnapshotDriverMutation>& mutation_payload) {
-  if (record.driver_mutation_count == 0) {
-    return "";
+void appendSnapshotMutations(
+    CellEvoX::io::CsvBuffer& out,
+    std::span<const CellEvoX::io::PopulationSnapshotDriverMutation> mutations) {
+  for (size_t i = 0; i < mutations.size(); ++i) {
+    appendMutation(out, i == 0, mutations[i].mutation_id, mutations[i].mutation_type);
   }
-
-  const size_t start = record.driver_mutation_offset;
-  const size_t end = start + record.driver_mutation_count;
-  if (start > mutation_payload.size() || end > mutation_payload.size()) {
-    return "";
-  }
-
-  std::string mutations_str;
-  for (size_t i = start; i < end; ++i) {
-    const auto& mutation = mutation_payload[i];
-    mutations_str +=
-        "(" + std::to_string(mutation.mutation_id) + "," + std::to_string(mutation.mutation_type) +
-        ") ";
-  }
-
-  if (!mutations_str.empty()) {
-    mutations_str.pop_back();
-  }
-
-  return mutations_str;
 }
 
-void writePopulationCsvRow(std::ofstream& file,
-                           uint32_t cell_id,
-                           uint32_t parent_id,
-                           float fitness,
-                           uint32_t mutation_count,
-                           const std::string& mutations,
-                           bool position_valid,
-                           float x,
-                           float y,
-                           float z,
-                           uint8_t spatial_dimensions) {
-  file << cell_id << "," << parent_id << "," << fitness << "," << mutation_count << ","
-       << "\"" << mutations << "\",";
+// One population CSV row; append_mutations(out) writes the body of the quoted Mutations field.
+template <typename AppendMutations>
+void appendPopulationCsvRow(CellEvoX::io::CsvBuffer& out,
+                            uint32_t cell_id,
+                            uint32_t parent_id,
+                            float fitness,
+                            uint32_t mutation_count,
+                            AppendMutations&& append_mutations,
+                            bool position_valid,
+                            float x,
+                            float y,
+                            float z,
+                            uint8_t spatial_dimensions) {
+  out.put(cell_id).put(',').put(parent_id).put(',').put(fitness).put(',').put(mutation_count);
+  out.put(",\"");
+  append_mutations(out);
+  out.put("\",");
   if (position_valid) {
-    file << x << "," << y << "," << z;
+    out.put(x).put(',').put(y).put(',').put(z);
   } else {
-    file << ",,";
+    out.put(",,");
   }
-  file << "," << (position_valid ? 1 : 0) << "," << static_cast<int>(spatial_dimensions) << "\n";
-}
-
-std::vector<fs::path> collectPopulationBinaryFiles(const std::string& output_dir) {
-  std::vector<fs::path> files;
-  const fs::path population_dir = fs::path(output_dir) / "population_data";
-  std::error_code ec;
-  if (!fs::exists(population_dir, ec) || ec) {
-    return files;
-  }
-
-  for (fs::directory_iterator it(population_dir, ec), end; !ec && it != end; it.increment(ec)) {
-    const auto& entry = *it;
-    if (!entry.is_regular_file(ec) || ec || entry.path().extension() != ".bin") {
-      continue;
-    }
-    if (extractGenerationFromFilename(entry.path()) >= 0) {
-      files.push_back(entry.path());
-    }
-  }
-
-  std::sort(files.begin(), files.end(), [](const fs::path& lhs, const fs::path& rhs) {
-    return extractGenerationFromFilename(lhs) < extractGenerationFromFilename(rhs);
-  });
-  return files;
+  out.put(',').put(position_valid ? 1 : 0).put(',').put(spatial_dimensions).put('\n');
 }
 
 bool ensureDirectory(const fs::path& path) {
@@ -274,6 +191,426 @@ namespace CellEvoX::core {
 
 namespace plt = matplotlibcpp;
 
+namespace {
+
+using CellEvoX::io::PopulationSnapshotDriverMutation;
+using CellEvoX::io::PopulationSnapshotRecord;
+
+// The run's config.json, for analysis mode where there is no live config; nullopt when it is
+// missing or unreadable.
+std::optional<nlohmann::json> loadRunConfigJson(const std::string& output_dir) {
+  std::ifstream file(fs::path(output_dir) / "config.json");
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  try {
+    return nlohmann::json::parse(file);
+  } catch (const nlohmann::json::exception& e) {
+    spdlog::warn("Could not parse config.json: {}", e.what());
+    return std::nullopt;
+  }
+}
+
+// Driver mutation type ids, from the live config or the run's config.json; nullopt when neither
+// is available.
+std::optional<std::bitset<256>> loadDriverMutationTypes(const SimulationConfig* config,
+                                                        const std::string& output_dir) {
+  std::bitset<256> driver_types;
+  if (config) {
+    for (const auto& mutation : config->mutations) {
+      driver_types.set(mutation.type_id, mutation.is_driver);
+    }
+    return driver_types;
+  }
+
+  const auto json = loadRunConfigJson(output_dir);
+  if (!json || !json->contains("mutations")) {
+    return std::nullopt;
+  }
+  try {
+    for (const auto& mutation : json->at("mutations")) {
+      const int type_id = mutation.value("id", -1);
+      if (type_id >= 0 && type_id < static_cast<int>(driver_types.size()) &&
+          mutation.value("is_driver", false)) {
+        driver_types.set(static_cast<size_t>(type_id));
+      }
+    }
+  } catch (const nlohmann::json::exception& e) {
+    spdlog::warn("Could not read driver mutation types from config.json: {}", e.what());
+    return std::nullopt;
+  }
+  return driver_types;
+}
+
+// arrow_export from the live config or the run's config.json.
+bool arrowExportEnabled(const SimulationConfig* config, const std::string& output_dir) {
+  if (config) {
+    return config->arrow_export;
+  }
+  const auto json = loadRunConfigJson(output_dir);
+  return json && json->value("arrow_export", false);
+}
+
+// One population table gathered column by column for the Arrow export. Columns match the
+// population CSV; Mutations holds the same "(id,type) (id,type)" text, and X/Y/Z are null
+// where the CSV leaves them empty.
+class PopulationArrowColumns {
+ public:
+  explicit PopulationArrowColumns(size_t row_count) {
+    cell_ids_.reserve(row_count);
+    parent_ids_.reserve(row_count);
+    fitness_.reserve(row_count);
+    mutation_counts_.reserve(row_count);
+    mutation_offsets_.reserve(row_count + 1);
+    mutation_offsets_.push_back(0);
+    x_.reserve(row_count);
+    y_.reserve(row_count);
+    z_.reserve(row_count);
+    position_valid_.reserve(row_count);
+    spatial_dimensions_.reserve(row_count);
+  }
+
+  template <typename AppendMutations>
+  void append(uint32_t cell_id,
+              uint32_t parent_id,
+              float fitness,
+              uint32_t mutation_count,
+              AppendMutations&& append_mutations,
+              bool position_valid,
+              float x,
+              float y,
+              float z,
+              uint8_t spatial_dimensions) {
+    cell_ids_.push_back(cell_id);
+    parent_ids_.push_back(parent_id);
+    fitness_.push_back(fitness);
+    mutation_counts_.push_back(mutation_count);
+    append_mutations(mutations_);
+    mutation_offsets_.push_back(static_cast<int64_t>(mutations_.size()));
+    x_.push_back(position_valid ? x : 0.0f);
+    y_.push_back(position_valid ? y : 0.0f);
+    z_.push_back(position_valid ? z : 0.0f);
+    position_valid_.push_back(position_valid ? 1 : 0);
+    spatial_dimensions_.push_back(spatial_dimensions);
+  }
+
+  bool write(const fs::path& path, int generation, std::optional<double> tau) const {
+    CellEvoX::io::ArrowTable table(cell_ids_.size());
+    table.addColumn("CellID", cell_ids_);
+    table.addColumn("ParentID", parent_ids_);
+    table.addColumn("Fitness", fitness_);
+    table.addColumn("MutationCount", mutation_counts_);
+    table.addStringColumn("Mutations",
+                          mutation_offsets_,
+                          std::string_view(mutations_.data(), mutations_.size()));
+    table.addColumn("X", x_, position_valid_);
+    table.addColumn("Y", y_, position_valid_);
+    table.addColumn("Z", z_, position_valid_);
+    table.addColumn("PositionValid", position_valid_);
+    table.addColumn("SpatialDimensions", spatial_dimensions_);
+    table.addMetadata("generation", std::to_string(generation));
+    if (tau) {
+      table.addMetadata("tau", std::to_string(*tau));
+    }
+    return table.write(path);
+  }
+
+ private:
+  std::vector<uint32_t> cell_ids_;
+  std::vector<uint32_t> parent_ids_;
+  std::vector<float> fitness_;
+  std::vector<uint32_t> mutation_counts_;
+  std::vector<int64_t> mutation_offsets_;
+  CellEvoX::io::CsvBuffer mutations_;
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> z_;
+  std::vector<uint8_t> position_valid_;
+  std::vector<uint8_t> spatial_dimensions_;
+};
+
+fs::path populationTablePath(const std::string& output_dir, int generation, const char* extension) {
+  return fs::path(output_dir) / "population_data" /
+         ("population_generation_" + std::to_string(generation) + extension);
+}
+
+void plotMutationWaveHistogram(const std::string& output_dir,
+                               int generation,
+                               const std::map<size_t, size_t>& mutation_counts) {
+  std::vector<size_t> mutation_bins;
+  std::vector<size_t> cell_counts;
+
+  for (const auto& [mutations, count] : mutation_counts) {
+    mutation_bins.push_back(mutations);
+    cell_counts.push_back(count);
+  }
+
+  plt::figure_size(1000, 600);
+  plt::bar(mutation_bins, cell_counts, "green");
+  plt::xlabel("Number of Mutations");
+  plt::ylabel("Number of Cells");
+  plt::title("Mutation Wave: Distribution of Mutation Counts (Generation " +
+             std::to_string(generation) + ")");
+  plt::grid(true);
+  plt::save(output_dir + "mutation_histograms/mutation_wave_histogram_generation_" +
+            std::to_string(generation) + ".png");
+  plt::close();
+}
+
+void plotVafHistogram(const std::string& output_dir,
+                      int generation,
+                      const std::vector<double>& vafs,
+                      bool full_vaf) {
+  int num_bins = std::max(1, static_cast<int>(std::ceil(1 + 3.322 * std::log10(vafs.size()))));
+
+  plt::figure();
+  plt::hist(vafs, num_bins);
+  plt::title(std::string(full_vaf ? "Full VAF Histogram - Generation "
+                                  : "Driver VAF Histogram - Generation ") +
+             std::to_string(generation));
+  plt::xlabel(full_vaf ? "Variant Allele Frequency (VAF)"
+                       : "Driver Variant Allele Frequency (VAF)");
+  plt::ylabel("Frequency");
+  plt::save(output_dir + "vaf_diagrams/vaf_histogram_generation_" + std::to_string(generation) +
+            ".png");
+  plt::close();
+}
+
+// Writes population_data/population_generation_<n>.csv. Each frame goes to its own file, so
+// visits need no synchronization; rows are formatted in parallel chunks within the file.
+class PopulationCsvVisitor final : public PopulationSnapshotVisitor {
+ public:
+  explicit PopulationCsvVisitor(std::string output_dir) : output_dir_(std::move(output_dir)) {}
+
+  void visit(const PopulationSnapshotFrame& frame) override {
+    const fs::path csv_path = populationTablePath(output_dir_, frame.generation, ".csv");
+    const bool written = CellEvoX::io::writeCsvFile(
+        csv_path,
+        kPopulationCsvHeader,
+        frame.records.size(),
+        [&](CellEvoX::io::CsvBuffer& out, size_t row) {
+          const auto& record = frame.records[row];
+          appendPopulationCsvRow(
+              out,
+              record.id,
+              record.parent_id,
+              record.fitness,
+              record.mutations_count,
+              [&](CellEvoX::io::CsvBuffer& field) {
+                appendSnapshotMutations(field, recordMutationSlice(record, frame.mutations));
+              },
+              record.position_valid != 0,
+              record.x,
+              record.y,
+              record.z,
+              frame.header.spatial_dimensions);
+        });
+    if (!written) {
+      spdlog::error("Cannot write file: {}", csv_path.string());
+    }
+  }
+
+  void finish() override {
+    spdlog::info("Population data exported to: {}population_data/", output_dir_);
+  }
+
+ private:
+  std::string output_dir_;
+};
+
+// Writes population_data/population_generation_<n>.arrow, the Arrow IPC twin of the CSV.
+class PopulationArrowVisitor final : public PopulationSnapshotVisitor {
+ public:
+  explicit PopulationArrowVisitor(std::string output_dir) : output_dir_(std::move(output_dir)) {}
+
+  void visit(const PopulationSnapshotFrame& frame) override {
+    PopulationArrowColumns columns(frame.records.size());
+    for (const auto& record : frame.records) {
+      columns.append(
+          record.id,
+          record.parent_id,
+          record.fitness,
+          record.mutations_count,
+          [&](CellEvoX::io::CsvBuffer& field) {
+            appendSnapshotMutations(field, recordMutationSlice(record, frame.mutations));
+          },
+          record.position_valid != 0,
+          record.x,
+          record.y,
+          record.z,
+          frame.header.spatial_dimensions);
+    }
+    const fs::path arrow_path = populationTablePath(output_dir_, frame.generation, ".arrow");
+    // In-memory generations carry no tau.
+    const bool has_tau = std::isfinite(frame.header.tau);
+    if (!columns.write(arrow_path,
+                       frame.generation,
+                       has_tau ? std::optional<double>(frame.header.tau) : std::nullopt)) {
+      spdlog::error("Cannot write file: {}", arrow_path.string());
+    }
+  }
+
+ private:
+  std::string output_dir_;
+};
+
+// Mutation-count histogram per generation; plotted in generation order once the scan is done
+// because matplotlib is not thread-safe.
+class MutationWaveVisitor final : public PopulationSnapshotVisitor {
+ public:
+  explicit MutationWaveVisitor(std::string output_dir) : output_dir_(std::move(output_dir)) {}
+
+  void visit(const PopulationSnapshotFrame& frame) override {
+    std::map<size_t, size_t> mutation_counts;  // <number of mutations, number of cells>
+    for (const auto& record : frame.records) {
+      mutation_counts[record.mutations_count]++;
+    }
+    histograms_.push_back({frame.generation, std::move(mutation_counts)});
+  }
+
+  void finish() override {
+    std::sort(histograms_.begin(), histograms_.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    for (const auto& [generation, mutation_counts] : histograms_) {
+      plotMutationWaveHistogram(output_dir_, generation, mutation_counts);
+    }
+  }
+
+ private:
+  std::string output_dir_;
+  tbb::concurrent_vector<std::pair<int, std::map<size_t, size_t>>> histograms_;
+};
+
+// Variant allele frequencies of the payload mutations per generation.
+class MutationFrequencyVisitor final : public PopulationSnapshotVisitor {
+ public:
+  explicit MutationFrequencyVisitor(std::string output_dir) : output_dir_(std::move(output_dir)) {}
+
+  void visit(const PopulationSnapshotFrame& frame) override {
+    if (!CellEvoX::io::hasAnyMutationPayload(frame.header) || frame.records.empty()) {
+      return;
+    }
+
+    std::map<uint32_t, uint32_t> mutation_counts;
+    for (const auto& record : frame.records) {
+      for (const auto& mutation : recordMutationSlice(record, frame.mutations)) {
+        mutation_counts[mutation.mutation_id]++;
+      }
+    }
+    if (mutation_counts.empty()) {
+      return;
+    }
+
+    Histogram histogram{frame.generation, CellEvoX::io::hasFullMutationPayload(frame.header), {}};
+    histogram.vafs.reserve(mutation_counts.size());
+    const double total_cells = static_cast<double>(frame.records.size());
+    for (const auto& [mutation_id, count] : mutation_counts) {
+      histogram.vafs.push_back(count / total_cells);
+    }
+    histograms_.push_back(std::move(histogram));
+  }
+
+  void finish() override {
+    std::sort(histograms_.begin(), histograms_.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.generation < rhs.generation;
+    });
+    for (const auto& histogram : histograms_) {
+      plotVafHistogram(output_dir_, histogram.generation, histogram.vafs, histogram.full_vaf);
+    }
+  }
+
+ private:
+  struct Histogram {
+    int generation;
+    bool full_vaf;
+    std::vector<double> vafs;
+  };
+
+  std::string output_dir_;
+  tbb::concurrent_vector<Histogram> histograms_;
+};
+
+// Cells per driver-mutation clone per generation, written as
+// population_data/clone_populations.csv (Generation,Signature,Cells). The signature is the
+// sorted driver mutation ids joined by commas, or "ancestor"; the Muller, clone count and clone
+// lifespan scripts read this instead of re-parsing every population CSV.
+class ClonePopulationVisitor final : public PopulationSnapshotVisitor {
+ public:
+  ClonePopulationVisitor(std::string output_dir, std::optional<std::bitset<256>> driver_types)
+      : output_dir_(std::move(output_dir)), driver_types_(driver_types) {}
+
+  void visit(const PopulationSnapshotFrame& frame) override {
+    // Driver-only payloads hold nothing but drivers; full payloads need the driver types.
+    const bool payload_is_drivers = !CellEvoX::io::hasFullMutationPayload(frame.header);
+    if (!payload_is_drivers && !driver_types_) {
+      missing_driver_types_ = true;
+      return;
+    }
+
+    std::map<std::vector<uint32_t>, uint32_t> clones;
+    std::vector<uint32_t> drivers;
+    for (const auto& record : frame.records) {
+      drivers.clear();
+      for (const auto& mutation : recordMutationSlice(record, frame.mutations)) {
+        if (payload_is_drivers || driver_types_->test(mutation.mutation_type)) {
+          drivers.push_back(mutation.mutation_id);
+        }
+      }
+      std::sort(drivers.begin(), drivers.end());
+      drivers.erase(std::unique(drivers.begin(), drivers.end()), drivers.end());
+      clones[drivers]++;
+    }
+    populations_.push_back({frame.generation, std::move(clones)});
+  }
+
+  void finish() override {
+    const fs::path csv_path = fs::path(output_dir_) / "population_data" / "clone_populations.csv";
+    if (missing_driver_types_) {
+      spdlog::warn("No driver mutation types available for full mutation payloads; not writing {}",
+                   csv_path.string());
+      return;
+    }
+    if (populations_.empty()) {
+      return;
+    }
+
+    std::ofstream file(csv_path);
+    if (!file.is_open()) {
+      spdlog::error("Cannot open file: {}", csv_path.string());
+      return;
+    }
+    std::sort(populations_.begin(), populations_.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    file << "Generation,Signature,Cells\n";
+    for (const auto& [generation, clones] : populations_) {
+      for (const auto& [drivers, cells] : clones) {
+        file << generation << ",";
+        if (drivers.empty()) {
+          file << "ancestor";
+        } else {
+          file << "\"";
+          for (size_t i = 0; i < drivers.size(); ++i) {
+            file << (i == 0 ? "" : ",") << drivers[i];
+          }
+          file << "\"";
+        }
+        file << "," << cells << "\n";
+      }
+    }
+    spdlog::info("Clone populations exported to: {}", csv_path.string());
+  }
+
+ private:
+  std::string output_dir_;
+  std::optional<std::bitset<256>> driver_types_;
+  std::atomic<bool> missing_driver_types_{false};
+  tbb::concurrent_vector<std::pair<int, std::map<std::vector<uint32_t>, uint32_t>>> populations_;
+};
+
+}  // namespace
+
 RunDataEngine::RunDataEngine(std::shared_ptr<SimulationConfig> config,
                              std::shared_ptr<ecs::Run> run,
                              const std::string& config_file_path,
@@ -296,6 +633,21 @@ RunDataEngine::RunDataEngine(const std::string& analyze_directory)
   }      
 }
 
+RunDataEngine::RunDataEngine(std::shared_ptr<SimulationConfig> config,
+                             const std::string& run_directory,
+                             double generation_step)
+    : generation_step(generation_step),
+      config(config),
+      run(nullptr),
+      config_file_path("") {
+  output_dir = run_directory;
+  if (!output_dir.empty() && output_dir.back() == '/') {
+    output_dir.pop_back();
+  }
+  config->output_path = output_dir;
+  output_dir += '/';
+}
+
 void RunDataEngine::setRun(std::shared_ptr<ecs::Run> r) {
     this->run = r;
 }
@@ -350,129 +702,163 @@ void RunDataEngine::prepareOutputDir() {
     }
   }
 }
-void RunDataEngine::exportToCSV() {
+void RunDataEngine::exportToCSV(bool include_population_snapshots) {
+  const bool arrow_export = arrowExportEnabled(config.get(), output_dir);
+
   // Export Generational Statistics
   {
-    std::string statFilename = output_dir + "statistics/generational_statistics.csv";
-    std::ofstream file(statFilename);
-    if (!file.is_open()) {
+    const std::string statFilename = output_dir + "statistics/generational_statistics.csv";
+    const auto& stats = run->generational_stat_report;
+    const bool written = CellEvoX::io::writeCsvFile(
+        statFilename,
+        "Generation,TotalLivingCells,MeanFitness,FitnessVariance,FitnessSkewness,"
+        "FitnessKurtosis,MeanMutations,MutationsVariance,MutationsSkewness,MutationsKurtosis\n",
+        stats.size(),
+        [&](CellEvoX::io::CsvBuffer& out, size_t row) {
+          const auto& stat = stats[row];
+          out.put(stat.tau).put(',').put(stat.total_living_cells).put(',');
+          out.put(stat.mean_fitness).put(',').put(stat.fitness_variance).put(',');
+          out.put(stat.fitness_skewness).put(',').put(stat.fitness_kurtosis).put(',');
+          out.put(stat.mean_mutations).put(',').put(stat.mutations_variance).put(',');
+          out.put(stat.mutations_skewness).put(',').put(stat.mutations_kurtosis).put('\n');
+        });
+    if (!written) {
       std::cerr << "Cannot open file: " << statFilename << std::endl;
     } else {
-      // Write header row with all fields
-      file << "Generation,TotalLivingCells,MeanFitness,FitnessVariance,FitnessSkewness,"
-              "FitnessKurtosis,"
-           << "MeanMutations,MutationsVariance,MutationsSkewness,MutationsKurtosis\n";
-
-      // Write data rows
-      for (size_t generation = 0; generation < run->generational_stat_report.size(); ++generation) {
-        const auto& stat = run->generational_stat_report[generation];
-        file << stat.tau << "," << stat.total_living_cells << "," << stat.mean_fitness << ","
-             << stat.fitness_variance << "," << stat.fitness_skewness << ","
-             << stat.fitness_kurtosis << "," << stat.mean_mutations << ","
-             << stat.mutations_variance << "," << stat.mutations_skewness << ","
-             << stat.mutations_kurtosis << "\n";
-      }
-
-      file.close();
       std::cout << "Generational stats exported to: " << statFilename << std::endl;
     }
+
+    if (arrow_export) {
+      const auto column = [&](auto member) {
+        std::vector<std::remove_cvref_t<decltype(stats.front().*member)>> values;
+        values.reserve(stats.size());
+        for (const auto& stat : stats) {
+          values.push_back(stat.*member);
+        }
+        return values;
+      };
+      CellEvoX::io::ArrowTable table(stats.size());
+      table.addColumn("Generation", column(&StatSnapshot::tau));
+      table.addColumn("TotalLivingCells", column(&StatSnapshot::total_living_cells));
+      table.addColumn("MeanFitness", column(&StatSnapshot::mean_fitness));
+      table.addColumn("FitnessVariance", column(&StatSnapshot::fitness_variance));
+      table.addColumn("FitnessSkewness", column(&StatSnapshot::fitness_skewness));
+      table.addColumn("FitnessKurtosis", column(&StatSnapshot::fitness_kurtosis));
+      table.addColumn("MeanMutations", column(&StatSnapshot::mean_mutations));
+      table.addColumn("MutationsVariance", column(&StatSnapshot::mutations_variance));
+      table.addColumn("MutationsSkewness", column(&StatSnapshot::mutations_skewness));
+      table.addColumn("MutationsKurtosis", column(&StatSnapshot::mutations_kurtosis));
+      const std::string arrow_filename = output_dir + "statistics/generational_statistics.arrow";
+      if (!table.write(arrow_filename)) {
+        std::cerr << "Cannot open file: " << arrow_filename << std::endl;
+      }
+    }
   }
 
-  exportPopulationSnapshotsToCSV();
+  if (include_population_snapshots) {
+    exportPopulationSnapshotsToCSV();
+  }
 
   {
-    std::string phylogeneticFilename = output_dir + "phylogeny/phylogenetic_tree.csv";
-    std::ofstream file(phylogeneticFilename);
+    const std::string phylogeneticFilename = output_dir + "phylogeny/phylogenetic_tree.csv";
+    std::vector<const std::pair<const uint32_t, ecs::NodeData>*> nodes;
+    nodes.reserve(run->phylogenetic_tree.size());
+    for (const auto& node : run->phylogenetic_tree) {
+      nodes.push_back(&node);
+    }
 
-    if (!file.is_open()) {
+    const bool written = CellEvoX::io::writeCsvFile(
+        phylogeneticFilename,
+        "NodeID,ParentID,ChildSum,DeathTime\n",
+        nodes.size(),
+        [&](CellEvoX::io::CsvBuffer& out, size_t row) {
+          const auto& [node_id, node_data] = *nodes[row];
+          out.put(node_id).put(',').put(node_data.parent_id).put(',');
+          out.put(node_data.child_sum).put(',').put(node_data.death_time).put('\n');
+        });
+    if (!written) {
       std::cerr << "Cannot open file: " << phylogeneticFilename << std::endl;
-      return;
     }
 
-    file << "NodeID,ParentID,ChildSum,DeathTime\n";
-
-    for (const auto& [node_id, node_data] : run->phylogenetic_tree) {
-      file << node_id << "," << node_data.parent_id << "," << node_data.child_sum << ","
-           << node_data.death_time << "\n";
+    if (arrow_export) {
+      std::vector<uint32_t> node_ids(nodes.size());
+      std::vector<uint32_t> parent_ids(nodes.size());
+      std::vector<uint32_t> child_sums(nodes.size());
+      std::vector<double> death_times(nodes.size());
+      for (size_t i = 0; i < nodes.size(); ++i) {
+        const auto& [node_id, node_data] = *nodes[i];
+        node_ids[i] = node_id;
+        parent_ids[i] = node_data.parent_id;
+        child_sums[i] = node_data.child_sum;
+        death_times[i] = node_data.death_time;
+      }
+      CellEvoX::io::ArrowTable table(nodes.size());
+      table.addColumn("NodeID", node_ids);
+      table.addColumn("ParentID", parent_ids);
+      table.addColumn("ChildSum", child_sums);
+      table.addColumn("DeathTime", death_times);
+      const std::string arrow_filename = output_dir + "phylogeny/phylogenetic_tree.arrow";
+      if (!table.write(arrow_filename)) {
+        std::cerr << "Cannot open file: " << arrow_filename << std::endl;
+      }
     }
-
-    file.close();
   }
 }
 
 void RunDataEngine::exportPopulationSnapshotsToCSV() {
-  if (run && !run->generational_popul_report.empty()) {
-    const bool full_payload = config && config->full_mutation_payload;
-    for (const auto& [generation, cell_map] : run->generational_popul_report) {
-      const std::string populFilename =
-          output_dir + "population_data/population_generation_" + std::to_string(generation) + ".csv";
-      std::ofstream file(populFilename);
-      if (!file.is_open()) {
-        std::cerr << "Cannot open file: " << populFilename << std::endl;
-        continue;
-      }
+  scanPopulation({.csv_export = true,
+                  .mutation_wave = false,
+                  .mutation_frequency = false,
+                  .clone_populations = false});
+}
 
-      file << kPopulationCsvHeader;
-      for (const auto& [cell_id, cell_data] : cell_map) {
-        writePopulationCsvRow(
-            file,
-            cell_id,
-            cell_data.parent_id,
-            cell_data.fitness,
-            static_cast<uint32_t>(
-                std::min<size_t>(cell_data.mutations.size(), std::numeric_limits<uint32_t>::max())),
-            full_payload ? formatMutationsForCsv(cell_data)
-                         : formatDriverMutationsForCsv(cell_data, run->mutation_id_to_type),
-            false,
-            0.0f,
-            0.0f,
-            0.0f,
-            0);
-      }
+void RunDataEngine::analyzePopulationSnapshots(const PopulationAnalyses& analyses) {
+  scanPopulation(analyses);
+}
 
-      std::cout << "Population data exported to: " << populFilename << std::endl;
+void RunDataEngine::scanPopulation(const PopulationAnalyses& analyses) {
+  std::vector<std::unique_ptr<PopulationSnapshotVisitor>> owned_visitors;
+  if (analyses.csv_export) {
+    owned_visitors.push_back(std::make_unique<PopulationCsvVisitor>(output_dir));
+    if (arrowExportEnabled(config.get(), output_dir)) {
+      owned_visitors.push_back(std::make_unique<PopulationArrowVisitor>(output_dir));
     }
+  }
+  if (analyses.mutation_wave) {
+    owned_visitors.push_back(std::make_unique<MutationWaveVisitor>(output_dir));
+  }
+  if (analyses.mutation_frequency) {
+    owned_visitors.push_back(std::make_unique<MutationFrequencyVisitor>(output_dir));
+  }
+  if (analyses.clone_populations) {
+    owned_visitors.push_back(std::make_unique<ClonePopulationVisitor>(
+        output_dir, loadDriverMutationTypes(config.get(), output_dir)));
+  }
+  if (owned_visitors.empty()) {
     return;
   }
 
-  for (const auto& path : collectPopulationBinaryFiles(output_dir)) {
-    CellEvoX::io::PopulationSnapshotFileHeader header{};
-    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
-    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> mutation_payload;
-    if (!CellEvoX::io::readPopulationSnapshot(path, header, records, mutation_payload)) {
-      spdlog::error("Failed to read population snapshot file: {}", path.string());
-      continue;
-    }
-
-    const int generation = extractGenerationFromFilename(path);
-    const std::string csv_filename =
-        (path.parent_path() / ("population_generation_" + std::to_string(generation) + ".csv")).string();
-    std::ofstream file(csv_filename);
-    if (!file.is_open()) {
-      std::cerr << "Cannot open file: " << csv_filename << std::endl;
-      continue;
-    }
-
-    file << kPopulationCsvHeader;
-    for (const auto& record : records) {
-      writePopulationCsvRow(file,
-                            record.id,
-                            record.parent_id,
-                            record.fitness,
-                            record.mutations_count,
-                            CellEvoX::io::hasFullMutationPayload(header)
-                                ? formatSnapshotMutationsForCsv(record, mutation_payload)
-                                : formatDriverMutationsForCsv(record, mutation_payload),
-                            record.position_valid != 0,
-                            record.x,
-                            record.y,
-                            record.z,
-                            header.spatial_dimensions);
-    }
-
-    std::cout << "Population data exported to: " << csv_filename << std::endl;
+  std::vector<PopulationSnapshotVisitor*> visitors;
+  for (const auto& visitor : owned_visitors) {
+    visitors.push_back(visitor.get());
   }
+  if (run && !run->generational_popul_report.empty()) {
+    const size_t generations =
+        scanPopulationReports(run->generational_popul_report,
+                              run->mutation_id_to_type,
+                              config && config->full_mutation_payload,
+                              visitors);
+    spdlog::info("Scanned {} in-memory population generations for {} analyses",
+                 generations,
+                 visitors.size());
+    return;
+  }
+  const size_t generations = scanPopulationSnapshots(output_dir, visitors);
+  spdlog::info("Scanned {} stored population generations for {} analyses",
+               generations,
+               visitors.size());
 }
+
 void RunDataEngine::plotLivingCellsOverGenerations() {
   std::vector<double> generations;
   std::vector<size_t> living_cells;
@@ -606,177 +992,17 @@ void RunDataEngine::plotMutationsStatistics() {
 }
 
 void RunDataEngine::plotMutationWave() {
-  if (run && !run->generational_popul_report.empty()) {
-    for (const auto& [generation, cells] : run->generational_popul_report) {
-      std::map<size_t, size_t> mutation_counts;  // <number of mutations, number of cells>
-
-      for (const auto& cell : cells) {
-        size_t num_mutations = cell.second.mutations.size();
-        mutation_counts[num_mutations]++;
-      }
-
-      std::vector<size_t> mutation_bins;
-      std::vector<size_t> cell_counts;
-
-      for (const auto& [mutations, count] : mutation_counts) {
-        mutation_bins.push_back(mutations);
-        cell_counts.push_back(count);
-      }
-
-      plt::figure_size(1000, 600);
-      plt::bar(mutation_bins, cell_counts, "green");
-      plt::xlabel("Number of Mutations");
-      plt::ylabel("Number of Cells");
-      plt::title("Mutation Wave: Distribution of Mutation Counts (Generation " +
-                 std::to_string(generation) + ")");
-      plt::grid(true);
-      plt::save(output_dir + "mutation_histograms/mutation_wave_histogram_generation_" +
-                std::to_string(generation) + ".png");
-      plt::close();
-    }
-    return;
-  }
-
-  for (const auto& path : collectPopulationBinaryFiles(output_dir)) {
-    CellEvoX::io::PopulationSnapshotFileHeader header{};
-    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
-    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> mutation_payload;
-    if (!CellEvoX::io::readPopulationSnapshot(path, header, records, mutation_payload)) {
-      spdlog::error("Failed to read population snapshot file: {}", path.string());
-      continue;
-    }
-
-    const int generation = extractGenerationFromFilename(path);
-    std::map<size_t, size_t> mutation_counts;  // <number of mutations, number of cells>
-
-    for (const auto& record : records) {
-      mutation_counts[record.mutations_count]++;
-    }
-
-    std::vector<size_t> mutation_bins;
-    std::vector<size_t> cell_counts;
-
-    for (const auto& [mutations, count] : mutation_counts) {
-      mutation_bins.push_back(mutations);
-      cell_counts.push_back(count);
-    }
-
-    plt::figure_size(1000, 600);
-    plt::bar(mutation_bins, cell_counts, "green");
-    plt::xlabel("Number of Mutations");
-    plt::ylabel("Number of Cells");
-    plt::title("Mutation Wave: Distribution of Mutation Counts (Generation " +
-               std::to_string(generation) + ")");
-    plt::grid(true);
-    plt::save(output_dir + "mutation_histograms/mutation_wave_histogram_generation_" +
-              std::to_string(generation) + ".png");
-    plt::close();
-  }
+  scanPopulation({.csv_export = false,
+                  .mutation_wave = true,
+                  .mutation_frequency = false,
+                  .clone_populations = false});
 }
 
 void RunDataEngine::plotMutationFrequency() {
-  if (run && !run->generational_popul_report.empty()) {
-    const bool full_vaf = config && config->full_mutation_payload;
-    for (const auto& [generation, cells] : run->generational_popul_report) {
-      std::map<uint32_t, uint32_t> mutation_counts;
-      uint32_t total_cells = 0;
-
-      for (const auto& item : cells) {
-        const Cell& cell = item.second;
-        ++total_cells;
-
-        for (const auto& mutation : cell.mutations) {
-          if (!full_vaf && !isDriverMutationType(run->mutation_id_to_type, mutation.second)) {
-            continue;
-          }
-          uint32_t mutation_id = mutation.first;
-          mutation_counts[mutation_id]++;
-        }
-      }
-
-      std::vector<double> vafs;
-      for (const auto& [mutation_id, count] : mutation_counts) {
-        double vaf = static_cast<double>(count) / total_cells;
-        vafs.push_back(vaf);
-      }
-
-      if (vafs.empty()) {
-        continue;
-      }
-
-      int num_bins = std::max(1, static_cast<int>(std::ceil(1 + 3.322 * std::log10(vafs.size()))));
-
-      plt::figure();
-      plt::hist(vafs, num_bins);
-      plt::title(std::string(full_vaf ? "Full VAF Histogram - Generation "
-                                      : "Driver VAF Histogram - Generation ") +
-                 std::to_string(generation));
-      plt::xlabel(full_vaf ? "Variant Allele Frequency (VAF)"
-                           : "Driver Variant Allele Frequency (VAF)");
-      plt::ylabel("Frequency");
-      plt::save(output_dir + "vaf_diagrams/vaf_histogram_generation_" + std::to_string(generation) +
-                ".png");
-      plt::close();
-    }
-    return;
-  }
-
-  for (const auto& path : collectPopulationBinaryFiles(output_dir)) {
-    CellEvoX::io::PopulationSnapshotFileHeader header{};
-    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
-    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> mutation_payload;
-    if (!CellEvoX::io::readPopulationSnapshot(path, header, records, mutation_payload)) {
-      spdlog::error("Failed to read population snapshot file: {}", path.string());
-      continue;
-    }
-
-    if (!CellEvoX::io::hasAnyMutationPayload(header)) {
-      continue;
-    }
-    const bool full_vaf = CellEvoX::io::hasFullMutationPayload(header);
-
-    std::map<uint32_t, uint32_t> mutation_counts;
-    const uint32_t total_cells = static_cast<uint32_t>(records.size());
-    if (total_cells == 0) {
-      continue;
-    }
-
-    for (const auto& record : records) {
-      const size_t start = record.driver_mutation_offset;
-      const size_t end = start + record.driver_mutation_count;
-      if (start > mutation_payload.size() || end > mutation_payload.size()) {
-        continue;
-      }
-      for (size_t i = start; i < end; ++i) {
-        mutation_counts[mutation_payload[i].mutation_id]++;
-      }
-    }
-
-    std::vector<double> vafs;
-    for (const auto& [mutation_id, count] : mutation_counts) {
-      double vaf = static_cast<double>(count) / total_cells;
-      vafs.push_back(vaf);
-    }
-
-    if (vafs.empty()) {
-      continue;
-    }
-
-    const int generation = extractGenerationFromFilename(path);
-    int num_bins = std::max(1, static_cast<int>(std::ceil(1 + 3.322 * std::log10(vafs.size()))));
-
-    plt::figure();
-    plt::hist(vafs, num_bins);
-    plt::title(std::string(full_vaf ? "Full VAF Histogram - Generation "
-                                    : "Driver VAF Histogram - Generation ") +
-               std::to_string(generation));
-    plt::xlabel(full_vaf ? "Variant Allele Frequency (VAF)"
-                         : "Driver Variant Allele Frequency (VAF)");
-    plt::ylabel("Frequency");
-    plt::save(output_dir + "vaf_diagrams/vaf_histogram_generation_" + std::to_string(generation) +
-              ".png");
-    plt::close();
-  }
+  scanPopulation({.csv_export = false,
+                  .mutation_wave = false,
+                  .mutation_frequency = true,
+                  .clone_populations = false});
 }
 
 void RunDataEngine::exportPhylogeneticTreeToGEXF(const std::string& filename) {
@@ -16,6 +16,7 @@
 #include "systems/SimulationEngine.hpp"
 #include "systems/SimulationEngine3D.hpp"
 #include "systems/SimulationEngine3DCapacity.hpp"
+#include "systems/SimulationEngine3DLattice.hpp"
 #include "utils/SimulationConfig.hpp"
 
 namespace CellEvoX::core {
@@ -63,10 +64,9 @@ void runFullPostprocessing(RunDataEngine& data_engine) {
   data_engine.plotFitnessStatistics();
   data_engine.plotMutationsStatistics();
   data_engine.plotLivingCellsOverGenerations();
-  data_engine.exportToCSV();
+  data_engine.exportToCSV(/*include_population_snapshots=*/false);
   data_engine.exportPhylogeneticTreeToGEXF("phylogenetic.gexf");
-  data_engine.plotMutationWave();
-  data_engine.plotMutationFrequency();
+  data_engine.analyzePopulationSnapshots();
   data_engine.plotMullerDiagram();
   data_engine.plotClonePhylogenyTree();
   data_engine.plotCloneCounts();
@@ -126,7 +126,10 @@ void Application::initialize() {
       data_engine.plotCloneGrowthAnimation();
       data_engine.plotTumorReplay3D();
     } else if (has_population_bin) {
-      data_engine.exportPopulationSnapshotsToCSV();
+      data_engine.analyzePopulationSnapshots({.csv_export = true,
+                                              .mutation_wave = false,
+                                              .mutation_frequency = false,
+                                              .clone_populations = true});
       spdlog::info(
           "Detected binary population snapshots only; exported companion CSV files with driver mutation payloads when available.");
       data_engine.plotMullerDiagram();
@@ -154,25 +157,48 @@ void Application::initialize() {
     
     // Initialize DataEngine first to prepare output directory
     RunDataEngine data_engine(sim_config, nullptr, config_path, 0.005);
-    
-    if (sim_config->sim_type == SimulationType::SPATIAL_3D_DENSITY) {
-      sim_engine_3d = std::make_unique<SimulationEngine3D>(sim_config);
-      std::signal(SIGINT, SimulationEngine3D::signalHandler);
-      std::signal(SIGTERM, SimulationEngine3D::signalHandler);
-      runs.push_back(std::make_shared<ecs::Run>(sim_engine_3d->run(config.at("steps"))));
-    } else if (sim_config->sim_type == SimulationType::SPATIAL_3D_CAPACITY) {
-      sim_engine_3d_capacity = std::make_unique<SimulationEngine3DCapacity>(sim_config);
-      std::signal(SIGINT, SimulationEngine3DCapacity::signalHandler);
-      std::signal(SIGTERM, SimulationEngine3DCapacity::signalHandler);
-      runs.push_back(std::make_shared<ecs::Run>(sim_engine_3d_capacity->run(config.at("steps"))));
+
+    runSimulation(config.at("steps"), nullptr);
+
+    // Set the run result in data engine
+    data_engine.setRun(runs[0]);
+
+    if (options.postprocess_mode == PostprocessMode::Exports) {
+      runExportsPostprocessing(data_engine);
     } else {
-      sim_engine = std::make_unique<SimulationEngine>(sim_config);
-      std::signal(SIGINT, SimulationEngine::signalHandler);
-      std::signal(SIGTERM, SimulationEngine::signalHandler);
-      runs.push_back(std::make_shared<ecs::Run>(sim_engine->run(config.at("steps"))));
+      runFullPostprocessing(data_engine);
     }
-    
-    // Set the run result in data engine
+  } else if (options.resume_path) {
+    const std::filesystem::path checkpoint_path = *options.resume_path;
+    CellEvoX::io::EngineCheckpoint checkpoint;
+    if (!CellEvoX::io::readEngineCheckpoint(checkpoint_path, checkpoint)) {
+      throw std::runtime_error("Could not read engine checkpoint: " + checkpoint_path.string());
+    }
+
+    // Checkpoints live in <run>/checkpoints/, next to the config copied at the start of the run.
+    const std::filesystem::path run_dir = checkpoint_path.parent_path().parent_path();
+    const std::filesystem::path config_path = run_dir / "config.json";
+    std::ifstream config_file(config_path);
+    if (!config_file.is_open()) {
+      throw std::runtime_error("Could not open config file of resumed run: " +
+                               config_path.string());
+    }
+    nlohmann::json config;
+    config_file >> config;
+    sim_config = std::make_shared<SimulationConfig>(utils::fromJson(config));
+    utils::printConfig(*sim_config);
+
+    RunDataEngine data_engine(sim_config, run_dir.string(), 0.005);
+
+    const uint64_t completed_steps = checkpoint.header.completed_steps;
+    const uint64_t remaining_steps =
+        sim_config->steps > completed_steps ? sim_config->steps - completed_steps : 0;
+    spdlog::info("Resuming run {} after step {} ({} step(s) left)",
+                 run_dir.string(),
+                 completed_steps,
+                 remaining_steps);
+    runSimulation(static_cast<uint32_t>(remaining_steps), &checkpoint);
+
     data_engine.setRun(runs[0]);
 
     if (options.postprocess_mode == PostprocessMode::Exports) {
@@ -181,11 +207,36 @@ void Application::initialize() {
       runFullPostprocessing(data_engine);
     }
   } else {
-    spdlog::error("Neither --config nor --analyze flag was provided. Please provide one.");
+    spdlog::error(
+        "Neither --config, --resume nor --analyze flag was provided. Please provide one.");
   }
   spdlog::info("CellEvoX Application finished run successfully");
 }
 
+void Application::runSimulation(uint32_t steps, const CellEvoX::io::EngineCheckpoint* resume) {
+  if (sim_config->sim_type == SimulationType::SPATIAL_3D_DENSITY) {
+    sim_engine_3d = std::make_unique<SimulationEngine3D>(sim_config, resume);
+    std::signal(SIGINT, SimulationEngine3D::signalHandler);
+    std::signal(SIGTERM, SimulationEngine3D::signalHandler);
+    runs.push_back(std::make_shared<ecs::Run>(sim_engine_3d->run(steps)));
+  } else if (sim_config->sim_type == SimulationType::SPATIAL_3D_CAPACITY) {
+    sim_engine_3d_capacity = std::make_unique<SimulationEngine3DCapacity>(sim_config, resume);
+    std::signal(SIGINT, SimulationEngine3DCapacity::signalHandler);
+    std::signal(SIGTERM, SimulationEngine3DCapacity::signalHandler);
+    runs.push_back(std::make_shared<ecs::Run>(sim_engine_3d_capacity->run(steps)));
+  } else if (sim_config->sim_type == SimulationType::SPATIAL_3D_LATTICE) {
+    sim_engine_3d_lattice = std::make_unique<SimulationEngine3DLattice>(sim_config, resume);
+    std::signal(SIGINT, SimulationEngine3DLattice::signalHandler);
+    std::signal(SIGTERM, SimulationEngine3DLattice::signalHandler);
+    runs.push_back(std::make_shared<ecs::Run>(sim_engine_3d_lattice->run(steps)));
+  } else {
+    sim_engine = std::make_unique<SimulationEngine>(sim_config, resume);
+    std::signal(SIGINT, SimulationEngine::signalHandler);
+    std::signal(SIGTERM, SimulationEngine::signalHandler);
+    runs.push_back(std::make_shared<ecs::Run>(sim_engine->run(steps)));
+  }
+}
+
 void Application::update() { (void)calculateDeltaTime(); }
 
 float Application::calculateDeltaTime() {
@@ -13,6 +13,7 @@ void printUsage(std::ostream& out) {
   out << "Allowed options:\n"
       << "  --help, -h                 produce help message\n"
       << "  --config <path>            path to config file\n"
+      << "  --resume <checkpoint>      continue a run from its checkpoints/checkpoint.bin\n"
       << "  --analyze <path>           path to existing output directory to analyze\n"
       << "  --threads <count>          cap TBB worker parallelism for this process\n"
       << "  --postprocess <mode>       post-run work: full, exports\n";
@@ -74,6 +75,16 @@ int main(int argc, char *argv[]) {
       options.config_path = arg.substr(std::string("--config=").size());
       continue;
     }
+    if (arg == "--resume") {
+      std::string value;
+      if (!readOptionValue(i, argc, argv, arg, value)) return 1;
+      options.resume_path = value;
+      continue;
+    }
+    if (arg.rfind("--resume=", 0) == 0) {
+      options.resume_path = arg.substr(std::string("--resume=").size());
+      continue;
+    }
     if (arg == "--analyze") {
       std::string value;
       if (!readOptionValue(i, argc, argv, arg, value)) return 1;
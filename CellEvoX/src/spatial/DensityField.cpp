@@ -0,0 +1,130 @@
+#include "spatial/DensityField.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace CellEvoX::spatial {
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+// Upper bound on field voxels (64 MB of floats per buffer).
+constexpr int64_t kMaxFieldVoxels = 16'777'216;
+
+}  // namespace
+
+void DensityField::build(const SpatialHashGrid& grid, float radius) {
+  // Field voxels are whole multiples of grid voxels so occupancy bins exactly. Coarsen until
+  // the radius spans about two field voxels, and further if the field would get too large.
+  const int grid_dim = grid.gridDim();
+  int factor = std::max(1, static_cast<int>(radius / (2.0f * grid.voxelSize())));
+  auto field_dim = [&](int f) { return (grid_dim + f - 1) / f; };
+  while (static_cast<int64_t>(field_dim(factor)) * field_dim(factor) * field_dim(factor) >
+         kMaxFieldVoxels) {
+    ++factor;
+  }
+  dim_ = field_dim(factor);
+  voxel_size_ = grid.voxelSize() * static_cast<float>(factor);
+  half_width_ = std::max(1, static_cast<int>(std::lround(radius / voxel_size_)));
+  const float box_edge = static_cast<float>(2 * half_width_ + 1) * voxel_size_;
+  sphere_to_box_ =
+      (4.0f / 3.0f) * kPi * radius * radius * radius / (box_edge * box_edge * box_edge);
+
+  const size_t dim = static_cast<size_t>(dim_);
+  field_.assign(dim * dim * dim, 0.0f);
+  scratch_.resize(field_.size());
+  const int64_t grid_dim64 = grid_dim;
+  const auto factor_size = static_cast<size_t>(factor);
+  grid.forEachOccupiedVoxel([&](int64_t voxel, size_t begin, size_t end) {
+    const auto ix = static_cast<size_t>(voxel % grid_dim64) / factor_size;
+    const auto iy = static_cast<size_t>((voxel / grid_dim64) % grid_dim64) / factor_size;
+    const auto iz = static_cast<size_t>(voxel / (grid_dim64 * grid_dim64)) / factor_size;
+    field_[ix + iy * dim + iz * dim * dim] += static_cast<float>(end - begin);
+  });
+
+  // Separable box filter: three running-sum passes, O(voxels) for any half-width.
+  boxFilterAxis(field_, scratch_, 0);
+  boxFilterAxis(scratch_, field_, 1);
+  boxFilterAxis(field_, scratch_, 2);
+  field_.swap(scratch_);
+}
+
+void DensityField::boxFilterAxis(const std::vector<float>& source,
+                                 std::vector<float>& target,
+                                 int axis) const {
+  const size_t dim = static_cast<size_t>(dim_);
+  const size_t stride = axis == 0 ? 1 : (axis == 1 ? dim : dim * dim);
+  const int half_width = half_width_;
+
+  // One task range per line of voxels along `axis`; lines are indexed by the other two axes.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, dim * dim), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t line = range.begin(); line != range.end(); ++line) {
+          const size_t a = line % dim;
+          const size_t b = line / dim;
+          size_t base = 0;
+          if (axis == 0) {
+            base = a * dim + b * dim * dim;
+          } else if (axis == 1) {
+            base = a + b * dim * dim;
+          } else {
+            base = a + b * dim;
+          }
+
+          // Windows are truncated at the walls, matching a sphere that leaves the domain.
+          double window = 0.0;
+          for (int k = 0; k < std::min(half_width, dim_); ++k) {
+            window += source[base + static_cast<size_t>(k) * stride];
+          }
+          for (int k = 0; k < dim_; ++k) {
+            const int entering = k + half_width;
+            const int leaving = k - half_width - 1;
+            if (entering < dim_) {
+              window += source[base + static_cast<size_t>(entering) * stride];
+            }
+            if (leaving >= 0) {
+              window -= source[base + static_cast<size_t>(leaving) * stride];
+            }
+            target[base + static_cast<size_t>(k) * stride] = static_cast<float>(window);
+          }
+        }
+      });
+}
+
+float DensityField::at(int ix, int iy, int iz) const {
+  ix = std::clamp(ix, 0, dim_ - 1);
+  iy = std::clamp(iy, 0, dim_ - 1);
+  iz = std::clamp(iz, 0, dim_ - 1);
+  const size_t dim = static_cast<size_t>(dim_);
+  return field_[static_cast<size_t>(ix) + static_cast<size_t>(iy) * dim +
+                static_cast<size_t>(iz) * dim * dim];
+}
+
+float DensityField::sample(float x, float y, float z) const {
+  if (field_.empty()) {
+    return 0.0f;
+  }
+  // Field values live at voxel centers.
+  const float u = x / voxel_size_ - 0.5f;
+  const float v = y / voxel_size_ - 0.5f;
+  const float w = z / voxel_size_ - 0.5f;
+  const int ix = static_cast<int>(std::floor(u));
+  const int iy = static_cast<int>(std::floor(v));
+  const int iz = static_cast<int>(std::floor(w));
+  const float fx = u - static_cast<float>(ix);
+  const float fy = v - static_cast<float>(iy);
+  const float fz = w - static_cast<float>(iz);
+
+  const float c00 = at(ix, iy, iz) * (1.0f - fx) + at(ix + 1, iy, iz) * fx;
+  const float c10 = at(ix, iy + 1, iz) * (1.0f - fx) + at(ix + 1, iy + 1, iz) * fx;
+  const float c01 = at(ix, iy, iz + 1) * (1.0f - fx) + at(ix + 1, iy, iz + 1) * fx;
+  const float c11 = at(ix, iy + 1, iz + 1) * (1.0f - fx) + at(ix + 1, iy + 1, iz + 1) * fx;
+  const float c0 = c00 * (1.0f - fy) + c10 * fy;
+  const float c1 = c01 * (1.0f - fy) + c11 * fy;
+  return (c0 * (1.0f - fz) + c1 * fz) * sphere_to_box_;
+}
+
+}  // namespace CellEvoX::spatial
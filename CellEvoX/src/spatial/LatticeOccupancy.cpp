@@ -0,0 +1,59 @@
+#include "spatial/LatticeOccupancy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace CellEvoX::spatial {
+
+const std::array<std::array<int, 3>, 26> LatticeOccupancy::kNeighborOffsets = [] {
+  std::array<std::array<int, 3>, 26> offsets{};
+  size_t next = 0;
+  for (int dz = -1; dz <= 1; ++dz) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        if (dx != 0 || dy != 0 || dz != 0) {
+          offsets[next++] = {dx, dy, dz};
+        }
+      }
+    }
+  }
+  return offsets;
+}();
+
+int LatticeOccupancy::dimForDomain(float domain_size, float spacing) {
+  return std::max(1, static_cast<int>(std::floor(domain_size / spacing)));
+}
+
+LatticeOccupancy::LatticeOccupancy(int dim) : dim_(dim) {
+  if (dim <= 0 || dim > kMaxDim) {
+    throw std::invalid_argument("LatticeOccupancy dimension must be in [1, 1625]");
+  }
+  voxel_count_ = static_cast<size_t>(dim) * static_cast<size_t>(dim) * static_cast<size_t>(dim);
+  bits_.assign((voxel_count_ + 63) / 64, 0);
+}
+
+void LatticeOccupancy::occupy(uint32_t voxel, uint32_t id) {
+  if (!isOccupied(voxel)) {
+    bits_[voxel >> 6] |= uint64_t{1} << (voxel & 63u);
+    ++occupied_count_;
+    owners_.insert(voxel, id);
+    return;
+  }
+  owners_.update(voxel, id);
+}
+
+void LatticeOccupancy::release(uint32_t voxel) {
+  if (!isOccupied(voxel)) {
+    return;
+  }
+  bits_[voxel >> 6] &= ~(uint64_t{1} << (voxel & 63u));
+  owners_.erase(voxel);
+  --occupied_count_;
+}
+
+size_t LatticeOccupancy::memoryBytes() const {
+  return bits_.size() * sizeof(uint64_t) + owners_.memoryBytes();
+}
+
+}  // namespace CellEvoX::spatial
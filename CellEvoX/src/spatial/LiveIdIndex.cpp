@@ -0,0 +1,141 @@
+#include "spatial/LiveIdIndex.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace CellEvoX::spatial {
+
+namespace {
+
+constexpr size_t kMinCapacity = 16;
+
+// Smallest power-of-two table that keeps `count` entries at most half full.
+size_t capacityFor(size_t count) {
+  size_t capacity = kMinCapacity;
+  while (capacity < 2 * count) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+}  // namespace
+
+void LiveIdIndex::update(uint32_t id, uint32_t value) {
+  if (size_ == 0) {
+    return;
+  }
+  for (size_t slot = tableSlot(id);; slot = (slot + 1) & mask_) {
+    Entry& entry = entries_[slot];
+    if (entry.id == id) {
+      entry.value = value;
+      return;
+    }
+    if (entry.id == kEmptyId) {
+      return;
+    }
+  }
+}
+
+void LiveIdIndex::insert(uint32_t id, uint32_t value) {
+  if (2 * (size_ + 1) > entries_.size()) {
+    rehash(std::max(kMinCapacity, 2 * entries_.size()));
+  }
+  for (size_t slot = tableSlot(id);; slot = (slot + 1) & mask_) {
+    Entry& entry = entries_[slot];
+    if (entry.id == id) {
+      entry.value = value;
+      return;
+    }
+    if (entry.id == kEmptyId) {
+      entry = {id, value};
+      ++size_;
+      return;
+    }
+  }
+}
+
+void LiveIdIndex::erase(uint32_t id) {
+  if (size_ == 0) {
+    return;
+  }
+  size_t hole = tableSlot(id);
+  while (entries_[hole].id != id) {
+    if (entries_[hole].id == kEmptyId) {
+      return;
+    }
+    hole = (hole + 1) & mask_;
+  }
+
+  // Backward-shift deletion: pull later entries of the probe chain into the hole unless their
+  // home slot lies cyclically in (hole, next], where moving them would break their lookup.
+  for (size_t next = (hole + 1) & mask_; entries_[next].id != kEmptyId;
+       next = (next + 1) & mask_) {
+    const size_t home = tableSlot(entries_[next].id);
+    const bool stays =
+        hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+    if (!stays) {
+      entries_[hole] = entries_[next];
+      hole = next;
+    }
+  }
+  entries_[hole] = Entry{};
+  --size_;
+
+  // Shrink once the table drops below 1/8 full, so memory follows the live population down.
+  if (entries_.size() > kMinCapacity && 8 * size_ < entries_.size()) {
+    rehash(capacityFor(2 * size_));
+  }
+}
+
+void LiveIdIndex::assign(const std::vector<uint32_t>& ids) {
+  const size_t wanted = capacityFor(ids.size());
+  if (entries_.size() < wanted || entries_.size() > 4 * wanted) {
+    // A fresh vector so a shrinking population also releases the old table.
+    std::vector<Entry>(wanted).swap(entries_);
+    mask_ = wanted - 1;
+    shift_ = 64 - std::countr_zero(wanted);
+  } else {
+    std::fill(entries_.begin(), entries_.end(), Entry{});
+  }
+  size_ = 0;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    insertNew(ids[i], static_cast<uint32_t>(i));
+  }
+}
+
+void LiveIdIndex::clear() {
+  std::fill(entries_.begin(), entries_.end(), Entry{});
+  size_ = 0;
+}
+
+void LiveIdIndex::reserve(size_t count) {
+  const size_t wanted = capacityFor(count);
+  if (wanted > entries_.size()) {
+    rehash(wanted);
+  }
+}
+
+void LiveIdIndex::rehash(size_t capacity) {
+  std::vector<Entry> old_entries(capacity);
+  old_entries.swap(entries_);
+  mask_ = capacity - 1;
+  shift_ = 64 - std::countr_zero(capacity);
+  size_ = 0;
+  for (const Entry& entry : old_entries) {
+    if (entry.id != kEmptyId) {
+      insertNew(entry.id, entry.value);
+    }
+  }
+}
+
+void LiveIdIndex::insertNew(uint32_t id, uint32_t value) {
+  size_t slot = tableSlot(id);
+  while (entries_[slot].id != kEmptyId) {
+    slot = (slot + 1) & mask_;
+  }
+  entries_[slot] = {id, value};
+  ++size_;
+}
+
+}  // namespace CellEvoX::spatial
@@ -0,0 +1,147 @@
+#include "spatial/MortonReorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include "io/EngineCheckpoint.hpp"
+#include "utils/ParallelAlgorithms.hpp"
+
+namespace CellEvoX::spatial {
+
+namespace {
+
+constexpr uint32_t kMortonAxisMax = (1u << 21) - 1;
+// Shifts voxel 0 to the middle of the axis so growing domains keep negative coordinates apart.
+// Voxels below 2^20 only gain the top bit, so their relative order is unchanged.
+constexpr float kMortonAxisBias = static_cast<float>(1u << 20);
+constexpr size_t kLocalityGrainSize = 16384;
+
+// Spreads the low 21 bits of `value` so two zero bits follow each one.
+uint64_t spreadBits(uint32_t value) {
+  uint64_t bits = value & kMortonAxisMax;
+  bits = (bits | (bits << 32)) & 0x1F00000000FFFFULL;
+  bits = (bits | (bits << 16)) & 0x1F0000FF0000FFULL;
+  bits = (bits | (bits << 8)) & 0x100F00F00F00F00FULL;
+  bits = (bits | (bits << 4)) & 0x10C30C30C30C30C3ULL;
+  bits = (bits | (bits << 2)) & 0x1249249249249249ULL;
+  return bits;
+}
+
+uint32_t quantize(float value, float voxel_size) {
+  const float voxel = std::floor(value / voxel_size) + kMortonAxisBias;
+  return static_cast<uint32_t>(std::clamp(voxel, 0.0f, static_cast<float>(kMortonAxisMax)));
+}
+
+}  // namespace
+
+uint64_t mortonKey(uint32_t ix, uint32_t iy, uint32_t iz) {
+  return spreadBits(ix) | (spreadBits(iy) << 1) | (spreadBits(iz) << 2);
+}
+
+double meanConsecutiveDistance(const std::vector<float>& px,
+                               const std::vector<float>& py,
+                               const std::vector<float>& pz) {
+  const size_t count = px.size();
+  if (count < 2) {
+    return 0.0;
+  }
+
+  // Deterministic reduction so the reorder trigger does not depend on the worker count.
+  const double total = tbb::parallel_deterministic_reduce(
+      tbb::blocked_range<size_t>(1, count, kLocalityGrainSize),
+      0.0,
+      [&](const tbb::blocked_range<size_t>& range, double sum) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const float dx = px[i] - px[i - 1];
+          const float dy = py[i] - py[i - 1];
+          const float dz = pz[i] - pz[i - 1];
+          sum += std::sqrt(static_cast<double>(dx * dx + dy * dy + dz * dz));
+        }
+        return sum;
+      },
+      [](double lhs, double rhs) { return lhs + rhs; });
+  return total / static_cast<double>(count - 1);
+}
+
+MortonReorder::MortonReorder(float voxel_size) : voxel_size_(voxel_size) {
+  if (voxel_size_ <= 0.0f) {
+    throw std::invalid_argument("MortonReorder voxel_size must be positive");
+  }
+}
+
+bool MortonReorder::maybeReorder(std::vector<uint32_t>& ids,
+                                 std::vector<float>& px,
+                                 std::vector<float>& py,
+                                 std::vector<float>& pz,
+                                 float degradation) {
+  if (ids.size() < 2) {
+    return false;
+  }
+  const double locality = meanConsecutiveDistance(px, py, pz);
+  if (locality <= static_cast<double>(degradation) * baseline_locality_) {
+    return false;
+  }
+  reorder(ids, px, py, pz);
+  return true;
+}
+
+void MortonReorder::reorder(std::vector<uint32_t>& ids,
+                            std::vector<float>& px,
+                            std::vector<float>& py,
+                            std::vector<float>& pz) {
+  const size_t count = ids.size();
+  if (px.size() != count || py.size() != count || pz.size() != count) {
+    throw std::invalid_argument("MortonReorder::reorder received mismatched array sizes");
+  }
+
+  keyed_slots_.resize(count);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+    for (size_t i = range.begin(); i != range.end(); ++i) {
+      keyed_slots_[i] = {mortonKey(quantize(px[i], voxel_size_),
+                                   quantize(py[i], voxel_size_),
+                                   quantize(pz[i], voxel_size_)),
+                         static_cast<uint32_t>(i)};
+    }
+  });
+  // Slots are unique, so ties within a voxel keep their previous relative order.
+  CellEvoX::parallel_algorithms::sortMaybeParallel(keyed_slots_.begin(), keyed_slots_.end());
+
+  scratch_ids_.resize(count);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+    for (size_t k = range.begin(); k != range.end(); ++k) {
+      scratch_ids_[k] = ids[keyed_slots_[k].second];
+    }
+  });
+  ids.swap(scratch_ids_);
+  gather(px);
+  gather(py);
+  gather(pz);
+
+  baseline_locality_ = meanConsecutiveDistance(px, py, pz);
+}
+
+void MortonReorder::gather(std::vector<float>& values) {
+  scratch_values_.resize(values.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, values.size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t k = range.begin(); k != range.end(); ++k) {
+                        scratch_values_[k] = values[keyed_slots_[k].second];
+                      }
+                    });
+  values.swap(scratch_values_);
+}
+
+void MortonReorder::saveState(CellEvoX::io::CheckpointWriter& writer) const {
+  writer.put(baseline_locality_);
+}
+
+bool MortonReorder::restoreState(CellEvoX::io::CheckpointReader& reader) {
+  return reader.get(baseline_locality_);
+}
+
+}  // namespace CellEvoX::spatial
@@ -1,14 +1,19 @@
 #include "spatial/SpatialHashGrid.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
 #include <tbb/blocked_range.h>
-#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 
+#include "io/EngineCheckpoint.hpp"
 #include "utils/ParallelAlgorithms.hpp"
 
 namespace {
@@ -16,18 +21,34 @@ namespace {
 struct HashedCellEntry {
   int64_t voxel_hash;
   uint32_t cell_id;
+  uint32_t source_index;
 };
 
 constexpr int64_t kMaxDenseVoxelRanges = 1'048'576;
 
+struct VoxelBounds {
+  int lo = std::numeric_limits<int>::max();
+  int hi = std::numeric_limits<int>::min();
+};
+
 }  // namespace
 
-SpatialHashGrid::SpatialHashGrid(float voxel_size, float domain_size)
+SpatialHashGrid::SpatialHashGrid(float voxel_size, float domain_size, bool grow_with_cells)
     : voxel_size_(voxel_size),
-      grid_dim_(std::max(1, static_cast<int>(std::ceil(domain_size / voxel_size)))) {
+      grow_with_cells_(grow_with_cells) {
   if (voxel_size_ <= 0.0f) {
     throw std::invalid_argument("SpatialHashGrid voxel_size must be positive");
   }
+  dims_.fill(std::max(1, static_cast<int>(std::ceil(domain_size / voxel_size))));
+}
+
+void SpatialHashGrid::fitToBounds(const std::array<float, 3>& lo, const std::array<float, 3>& hi) {
+  for (size_t axis = 0; axis < 3; ++axis) {
+    const int first = static_cast<int>(std::floor(lo[axis] / voxel_size_));
+    const int last = static_cast<int>(std::floor(hi[axis] / voxel_size_));
+    origin_voxels_[axis] = first;
+    dims_[axis] = std::max(1, last - first + 1);
+  }
 }
 
 void SpatialHashGrid::rebuild(const std::vector<uint32_t>& ids,
@@ -36,9 +57,14 @@ void SpatialHashGrid::rebuild(const std::vector<uint32_t>& ids,
                               const std::vector<float>& pz) {
   const size_t count = ids.size();
   sorted_ids_.clear();
-  cell_voxel_.clear();
+  sorted_source_.clear();
+  sorted_x_.clear();
+  sorted_y_.clear();
+  sorted_z_.clear();
   dense_voxel_ranges_.clear();
-  voxel_ranges_.clear();
+  occupied_voxels_.clear();
+  occupied_ranges_.clear();
+  voxel_table_.clear();
   use_dense_ranges_ = false;
 
   if (count == 0) {
@@ -48,49 +74,66 @@ void SpatialHashGrid::rebuild(const std::vector<uint32_t>& ids,
   if (px.size() != count || py.size() != count || pz.size() != count) {
     throw std::invalid_argument("SpatialHashGrid::rebuild received mismatched array sizes");
   }
+  if (grow_with_cells_) {
+    fitToCells(px, py, pz);
+  }
 
-  const int64_t dense_voxel_count = static_cast<int64_t>(grid_dim_) * grid_dim_ * grid_dim_;
+  const int64_t dense_voxel_count =
+      static_cast<int64_t>(dims_[0]) * static_cast<int64_t>(dims_[1]) * dims_[2];
   if (dense_voxel_count > 0 && dense_voxel_count <= kMaxDenseVoxelRanges) {
     const size_t voxel_count = static_cast<size_t>(dense_voxel_count);
     use_dense_ranges_ = true;
-    sorted_ids_.resize(count);
-    cell_voxel_.resize(count);
-    dense_voxel_ranges_.assign(voxel_count, {0, 0});
-
-    tbb::enumerable_thread_specific<std::vector<int32_t>> local_counts(
-        [voxel_count] { return std::vector<int32_t>(voxel_count, 0); });
+    resizeSortedArrays(count);
+    cell_keys_.resize(count);
+    dense_voxel_ranges_.resize(voxel_count);
 
+    // Key = (voxel << 32) | source index, built in source order; a stable radix sort on the
+    // voxel bits then orders cells by (voxel, source) in O(N) per 11-bit digit, with no
+    // per-thread voxel histograms.
     tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
-      auto& counts = local_counts.local();
       for (size_t i = range.begin(); i != range.end(); ++i) {
-        const int ix = clampVoxelIndex(static_cast<int>(std::floor(px[i] / voxel_size_)));
-        const int iy = clampVoxelIndex(static_cast<int>(std::floor(py[i] / voxel_size_)));
-        const int iz = clampVoxelIndex(static_cast<int>(std::floor(pz[i] / voxel_size_)));
-        const auto voxel = static_cast<int32_t>(hashVoxel(ix, iy, iz));
-        cell_voxel_[i] = voxel;
-        ++counts[static_cast<size_t>(voxel)];
+        const int ix = clampVoxelIndex(voxelCoordinate(px[i], 0), 0);
+        const int iy = clampVoxelIndex(voxelCoordinate(py[i], 1), 1);
+        const int iz = clampVoxelIndex(voxelCoordinate(pz[i], 2), 2);
+        cell_keys_[i] = (static_cast<uint64_t>(hashVoxel(ix, iy, iz)) << 32) | i;
       }
     });
 
-    std::vector<int32_t> voxel_counts(voxel_count, 0);
-    for (const auto& counts : local_counts) {
-      for (size_t voxel = 0; voxel < voxel_count; ++voxel) {
-        voxel_counts[voxel] += counts[voxel];
-      }
-    }
+    CellEvoX::parallel_algorithms::radixSortMaybeParallel(
+        cell_keys_, cell_key_scratch_, 32, static_cast<int>(std::bit_width(voxel_count - 1)));
 
-    int32_t offset = 0;
-    for (size_t voxel = 0; voxel < voxel_count; ++voxel) {
-      const int32_t begin = offset;
-      offset += voxel_counts[voxel];
-      dense_voxel_ranges_[voxel] = {begin, offset};
-      voxel_counts[voxel] = begin;
-    }
+    // Each voxel boundary in the sorted keys closes the previous voxel, opens the next one and
+    // fills the empty voxels in between, so every range is written exactly once: O(N + voxels).
+    const auto voxel_of = [&](size_t slot) { return static_cast<size_t>(cell_keys_[slot] >> 32); };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, count + 1), [&](const tbb::blocked_range<size_t>& range) {
+      for (size_t slot = range.begin(); slot != range.end(); ++slot) {
+        const size_t prev_voxel = slot == 0 ? 0 : voxel_of(slot - 1);
+        const size_t next_voxel = slot == count ? voxel_count : voxel_of(slot);
+        if (slot > 0 && prev_voxel == next_voxel) {
+          continue;
+        }
+        const auto boundary = static_cast<int32_t>(slot);
+        const size_t first_empty = slot == 0 ? 0 : prev_voxel + 1;
+        for (size_t voxel = first_empty; voxel < next_voxel; ++voxel) {
+          dense_voxel_ranges_[voxel] = {boundary, boundary};
+        }
+        if (slot > 0) {
+          dense_voxel_ranges_[prev_voxel].second = boundary;
+        }
+        if (next_voxel < voxel_count) {
+          dense_voxel_ranges_[next_voxel].first = boundary;
+        }
+      }
+    });
 
-    for (size_t i = 0; i < count; ++i) {
-      const auto voxel = static_cast<size_t>(cell_voxel_[i]);
-      sorted_ids_[static_cast<size_t>(voxel_counts[voxel]++)] = ids[i];
-    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+      for (size_t slot = range.begin(); slot != range.end(); ++slot) {
+        const auto source = static_cast<uint32_t>(cell_keys_[slot]);
+        sorted_ids_[slot] = ids[source];
+        sorted_source_[slot] = source;
+      }
+    });
+    gatherSortedPositions(px, py, pz);
     return;
   }
 
@@ -99,10 +142,10 @@ void SpatialHashGrid::rebuild(const std::vector<uint32_t>& ids,
   // O(N) hash computation over active cells.
   tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
     for (size_t i = range.begin(); i != range.end(); ++i) {
-      const int ix = clampVoxelIndex(static_cast<int>(std::floor(px[i] / voxel_size_)));
-      const int iy = clampVoxelIndex(static_cast<int>(std::floor(py[i] / voxel_size_)));
-      const int iz = clampVoxelIndex(static_cast<int>(std::floor(pz[i] / voxel_size_)));
-      hashed_cells[i] = {hashVoxel(ix, iy, iz), ids[i]};
+      const int ix = clampVoxelIndex(voxelCoordinate(px[i], 0), 0);
+      const int iy = clampVoxelIndex(voxelCoordinate(py[i], 1), 1);
+      const int iz = clampVoxelIndex(voxelCoordinate(pz[i], 2), 2);
+      hashed_cells[i] = {hashVoxel(ix, iy, iz), ids[i], static_cast<uint32_t>(i)};
     }
   });
 
@@ -116,38 +159,144 @@ void SpatialHashGrid::rebuild(const std::vector<uint32_t>& ids,
         return lhs.cell_id < rhs.cell_id;
       });
 
-  sorted_ids_.resize(count);
-  cell_voxel_.resize(count);
-  voxel_ranges_.reserve(count);
+  resizeSortedArrays(count);
 
   tbb::parallel_for(tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
     for (size_t i = range.begin(); i != range.end(); ++i) {
       sorted_ids_[i] = hashed_cells[i].cell_id;
-      cell_voxel_[i] = static_cast<int32_t>(hashed_cells[i].voxel_hash);
+      sorted_source_[i] = hashed_cells[i].source_index;
     }
   });
+  gatherSortedPositions(px, py, pz);
 
   int64_t current_hash = hashed_cells.front().voxel_hash;
   int32_t range_begin = 0;
 
-  // O(N) linear scan over sorted voxel buckets.
+  // O(N) linear scan over sorted voxel buckets; occupied voxels come out in ascending order.
   for (size_t i = 0; i < count; ++i) {
     if (hashed_cells[i].voxel_hash != current_hash) {
-      voxel_ranges_[current_hash] = {range_begin, static_cast<int32_t>(i)};
+      occupied_voxels_.push_back(current_hash);
+      occupied_ranges_.push_back({range_begin, static_cast<int32_t>(i)});
       current_hash = hashed_cells[i].voxel_hash;
       range_begin = static_cast<int32_t>(i);
     }
   }
 
-  voxel_ranges_[current_hash] = {range_begin, static_cast<int32_t>(count)};
+  occupied_voxels_.push_back(current_hash);
+  occupied_ranges_.push_back({range_begin, static_cast<int32_t>(count)});
+  buildSparseVoxelTable();
+}
+
+void SpatialHashGrid::buildSparseVoxelTable() {
+  // O(occupied voxels) memory: load factor stays at or below one half.
+  size_t capacity = 2;
+  int shift = 63;
+  while (capacity < 2 * occupied_voxels_.size()) {
+    capacity <<= 1;
+    --shift;
+  }
+  voxel_table_.assign(capacity, -1);
+  voxel_table_mask_ = capacity - 1;
+  voxel_table_shift_ = shift;
+
+  for (size_t v = 0; v < occupied_voxels_.size(); ++v) {
+    size_t slot = tableSlot(occupied_voxels_[v]);
+    while (voxel_table_[slot] >= 0) {
+      slot = (slot + 1) & voxel_table_mask_;
+    }
+    voxel_table_[slot] = static_cast<int32_t>(v);
+  }
+}
+
+void SpatialHashGrid::resizeSortedArrays(size_t count) {
+  sorted_ids_.resize(count);
+  sorted_source_.resize(count);
+  sorted_x_.resize(count);
+  sorted_y_.resize(count);
+  sorted_z_.resize(count);
+}
+
+void SpatialHashGrid::gatherSortedPositions(const std::vector<float>& px,
+                                            const std::vector<float>& py,
+                                            const std::vector<float>& pz) {
+  // O(N) gather so neighbor kernels stream contiguous per-voxel runs.
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, sorted_source_.size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t slot = range.begin(); slot != range.end(); ++slot) {
+                        const uint32_t source = sorted_source_[slot];
+                        sorted_x_[slot] = px[source];
+                        sorted_y_[slot] = py[source];
+                        sorted_z_[slot] = pz[source];
+                      }
+                    });
 }
 
 int64_t SpatialHashGrid::hashVoxel(int ix, int iy, int iz) const {
-  const int64_t dim = static_cast<int64_t>(grid_dim_);
-  return static_cast<int64_t>(ix) + static_cast<int64_t>(iy) * dim +
-         static_cast<int64_t>(iz) * dim * dim;
+  const int64_t dim_x = static_cast<int64_t>(dims_[0]);
+  const int64_t dim_y = static_cast<int64_t>(dims_[1]);
+  return static_cast<int64_t>(ix) + static_cast<int64_t>(iy) * dim_x +
+         static_cast<int64_t>(iz) * dim_x * dim_y;
 }
 
-int SpatialHashGrid::clampVoxelIndex(int value) const {
-  return std::clamp(value, 0, grid_dim_ - 1);
+int64_t SpatialHashGrid::voxelOf(float x, float y, float z) const {
+  return hashVoxel(clampVoxelIndex(voxelCoordinate(x, 0), 0),
+                   clampVoxelIndex(voxelCoordinate(y, 1), 1),
+                   clampVoxelIndex(voxelCoordinate(z, 2), 2));
+}
+
+void SpatialHashGrid::fitToCells(const std::vector<float>& px,
+                                 const std::vector<float>& py,
+                                 const std::vector<float>& pz) {
+  // O(N) bounding box in absolute voxel indices.
+  const auto bounds = tbb::parallel_reduce(
+      tbb::blocked_range<size_t>(0, px.size()),
+      VoxelBounds{},
+      [&](const tbb::blocked_range<size_t>& range, VoxelBounds local) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          for (const float value : {px[i], py[i], pz[i]}) {
+            const int voxel = static_cast<int>(std::floor(value / voxel_size_));
+            local.lo = std::min(local.lo, voxel);
+            local.hi = std::max(local.hi, voxel);
+          }
+        }
+        return local;
+      },
+      [](VoxelBounds lhs, const VoxelBounds& rhs) {
+        lhs.lo = std::min(lhs.lo, rhs.lo);
+        lhs.hi = std::max(lhs.hi, rhs.hi);
+        return lhs;
+      });
+
+  // Refit only when the cells leave the grid or use less than half of it; the new extent keeps
+  // a 25% margin, so a steadily growing tumor refits O(log size) times.
+  // Growing grids stay cubic, so every axis shares the origin and extent.
+  const int span = bounds.hi - bounds.lo + 1;
+  const bool covered =
+      bounds.lo >= origin_voxels_[0] && bounds.hi < origin_voxels_[0] + dims_[0];
+  if (covered && 2 * span >= dims_[0]) {
+    return;
+  }
+  const int margin = std::max(1, span / 8);
+  origin_voxels_.fill(bounds.lo - margin);
+  dims_.fill(span + 2 * margin);
+}
+
+void SpatialHashGrid::saveState(CellEvoX::io::CheckpointWriter& writer) const {
+  for (size_t axis = 0; axis < 3; ++axis) {
+    writer.put<int32_t>(origin_voxels_[axis]);
+    writer.put<int32_t>(dims_[axis]);
+  }
+}
+
+bool SpatialHashGrid::restoreState(CellEvoX::io::CheckpointReader& reader) {
+  std::array<int32_t, 3> origin_voxels{};
+  std::array<int32_t, 3> dims{};
+  for (size_t axis = 0; axis < 3; ++axis) {
+    if (!reader.get(origin_voxels[axis]) || !reader.get(dims[axis]) || dims[axis] <= 0) {
+      return false;
+    }
+  }
+  origin_voxels_ = origin_voxels;
+  dims_ = dims;
+  return true;
 }
@@ -0,0 +1,301 @@
+#include "spatial/VerletNeighborList.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include "io/EngineCheckpoint.hpp"
+#include "utils/ParallelAlgorithms.hpp"
+
+VerletNeighborList::VerletNeighborList(float cutoff,
+                                       float skin,
+                                       float domain_size,
+                                       bool grow_with_cells)
+    : cutoff_(cutoff),
+      skin_(std::max(skin, 0.0f)),
+      build_grid_(cutoff + std::max(skin, 0.0f), domain_size, grow_with_cells) {}
+
+void VerletNeighborList::build(const std::vector<float>& px,
+                               const std::vector<float>& py,
+                               const std::vector<float>& pz) {
+  const size_t count = px.size();
+  if (py.size() != count || pz.size() != count) {
+    throw std::invalid_argument("VerletNeighborList::build received mismatched array sizes");
+  }
+
+  if (build_indices_.size() != count) {
+    build_indices_.resize(count);
+    std::iota(build_indices_.begin(), build_indices_.end(), uint32_t{0});
+  }
+  build_grid_.rebuild(build_indices_, px, py, pz);
+
+  const float list_radius = cutoff_ + skin_;
+  const float list_radius_sq = list_radius * list_radius;
+  offsets_.assign(count + 1, 0);
+
+  // Two O(N) passes (count, then fill) keep the CSR layout independent of scheduling.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const float xi = px[i];
+          const float yi = py[i];
+          const float zi = pz[i];
+          size_t neighbor_count = 0;
+          build_grid_.queryRadius(xi, yi, zi, list_radius, [&](uint32_t j) {
+            if (j == i) {
+              return;
+            }
+            const float dx = xi - px[j];
+            const float dy = yi - py[j];
+            const float dz = zi - pz[j];
+            if (dx * dx + dy * dy + dz * dz <= list_radius_sq) {
+              ++neighbor_count;
+            }
+          });
+          offsets_[i + 1] = neighbor_count;
+        }
+      });
+
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+  neighbors_.resize(offsets_.back());
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const float xi = px[i];
+          const float yi = py[i];
+          const float zi = pz[i];
+          size_t slot = offsets_[i];
+          build_grid_.queryRadius(xi, yi, zi, list_radius, [&](uint32_t j) {
+            if (j == i) {
+              return;
+            }
+            const float dx = xi - px[j];
+            const float dy = yi - py[j];
+            const float dz = zi - pz[j];
+            if (dx * dx + dy * dy + dz * dz <= list_radius_sq) {
+              neighbors_[slot++] = j;
+            }
+          });
+        }
+      });
+
+  reference_x_ = px;
+  reference_y_ = py;
+  reference_z_ = pz;
+  ++build_count_;
+  valid_ = true;
+}
+
+void VerletNeighborList::remap(const std::vector<uint32_t>& previous_slots,
+                               const std::vector<float>& px,
+                               const std::vector<float>& py,
+                               const std::vector<float>& pz) {
+  const size_t count = previous_slots.size();
+  if (px.size() != count || py.size() != count || pz.size() != count) {
+    throw std::invalid_argument("VerletNeighborList::remap received mismatched array sizes");
+  }
+  if (!valid_) {
+    return;
+  }
+  const size_t old_count = size();
+
+  // Survivors keep their build positions, which is what the drift check measures against;
+  // newborns start at their current positions.
+  std::vector<uint32_t> new_slots(old_count, kNewSlot);
+  std::vector<float> next_x(count);
+  std::vector<float> next_y(count);
+  std::vector<float> next_z(count);
+  std::vector<uint32_t> newborns;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t previous = previous_slots[i];
+    if (previous == kNewSlot) {
+      newborns.push_back(static_cast<uint32_t>(i));
+      next_x[i] = px[i];
+      next_y[i] = py[i];
+      next_z[i] = pz[i];
+      continue;
+    }
+    if (previous >= old_count || new_slots[previous] != kNewSlot) {
+      throw std::invalid_argument("VerletNeighborList::remap received an invalid slot map");
+    }
+    new_slots[previous] = static_cast<uint32_t>(i);
+    next_x[i] = reference_x_[previous];
+    next_y[i] = reference_y_[previous];
+    next_z[i] = reference_z_[previous];
+  }
+
+  // Newborn lists by the same two passes as build(), over the build positions. A pair of
+  // newborns is found from both ends; a survivor learns of its newborn neighbors through
+  // `appended`, sorted so the fill below is independent of scheduling.
+  const float list_radius = cutoff_ + skin_;
+  const float list_radius_sq = list_radius * list_radius;
+  std::vector<size_t> newborn_offsets(newborns.size() + 1, 0);
+  std::vector<uint32_t> newborn_neighbors;
+  std::vector<uint64_t> appended;
+  if (!newborns.empty()) {
+    build_indices_.resize(count);
+    std::iota(build_indices_.begin(), build_indices_.end(), uint32_t{0});
+    build_grid_.rebuild(build_indices_, next_x, next_y, next_z);
+    const auto for_each_neighbor = [&](uint32_t i, const auto& emit) {
+      build_grid_.queryRadius(next_x[i], next_y[i], next_z[i], list_radius, [&](uint32_t j) {
+        const float dx = next_x[i] - next_x[j];
+        const float dy = next_y[i] - next_y[j];
+        const float dz = next_z[i] - next_z[j];
+        if (j != i && dx * dx + dy * dy + dz * dz <= list_radius_sq) {
+          emit(j);
+        }
+      });
+    };
+    tbb::parallel_for(size_t{0}, newborns.size(), [&](size_t b) {
+      size_t neighbor_count = 0;
+      for_each_neighbor(newborns[b], [&](uint32_t) { ++neighbor_count; });
+      newborn_offsets[b + 1] = neighbor_count;
+    });
+    std::partial_sum(newborn_offsets.begin(), newborn_offsets.end(), newborn_offsets.begin());
+    newborn_neighbors.resize(newborn_offsets.back());
+    tbb::parallel_for(size_t{0}, newborns.size(), [&](size_t b) {
+      size_t slot = newborn_offsets[b];
+      for_each_neighbor(newborns[b], [&](uint32_t j) { newborn_neighbors[slot++] = j; });
+    });
+    for (size_t b = 0; b < newborns.size(); ++b) {
+      for (size_t slot = newborn_offsets[b]; slot < newborn_offsets[b + 1]; ++slot) {
+        const uint32_t j = newborn_neighbors[slot];
+        if (previous_slots[j] != kNewSlot) {
+          appended.push_back((static_cast<uint64_t>(j) << 32) | newborns[b]);
+        }
+      }
+    }
+    CellEvoX::parallel_algorithms::sortMaybeParallel(appended.begin(), appended.end());
+  }
+
+  const auto appended_begin = [&](uint32_t i) {
+    return static_cast<size_t>(
+        std::lower_bound(appended.begin(), appended.end(), static_cast<uint64_t>(i) << 32) -
+        appended.begin());
+  };
+  const auto newborn_rank = [&](uint32_t i) {
+    return static_cast<size_t>(std::lower_bound(newborns.begin(), newborns.end(), i) -
+                               newborns.begin());
+  };
+
+  // Two O(N + pairs) passes again: survivors keep their surviving neighbors in list order and
+  // then append newborns; newborns take their fresh lists.
+  std::vector<size_t> next_offsets(count + 1, 0);
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const uint32_t previous = previous_slots[i];
+          if (previous == kNewSlot) {
+            const size_t b = newborn_rank(static_cast<uint32_t>(i));
+            next_offsets[i + 1] = newborn_offsets[b + 1] - newborn_offsets[b];
+            continue;
+          }
+          size_t kept = 0;
+          for (size_t slot = offsets_[previous]; slot < offsets_[previous + 1]; ++slot) {
+            kept += new_slots[neighbors_[slot]] != kNewSlot ? 1 : 0;
+          }
+          const size_t first = appended_begin(static_cast<uint32_t>(i));
+          next_offsets[i + 1] = kept + appended_begin(static_cast<uint32_t>(i) + 1) - first;
+        }
+      });
+  std::partial_sum(next_offsets.begin(), next_offsets.end(), next_offsets.begin());
+
+  std::vector<uint32_t> next_neighbors(next_offsets.back());
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          size_t out = next_offsets[i];
+          const uint32_t previous = previous_slots[i];
+          if (previous == kNewSlot) {
+            const size_t b = newborn_rank(static_cast<uint32_t>(i));
+            std::copy(newborn_neighbors.begin() + static_cast<std::ptrdiff_t>(newborn_offsets[b]),
+                      newborn_neighbors.begin() +
+                          static_cast<std::ptrdiff_t>(newborn_offsets[b + 1]),
+                      next_neighbors.begin() + static_cast<std::ptrdiff_t>(out));
+            continue;
+          }
+          for (size_t slot = offsets_[previous]; slot < offsets_[previous + 1]; ++slot) {
+            const uint32_t moved = new_slots[neighbors_[slot]];
+            if (moved != kNewSlot) {
+              next_neighbors[out++] = moved;
+            }
+          }
+          const size_t last = appended_begin(static_cast<uint32_t>(i) + 1);
+          for (size_t a = appended_begin(static_cast<uint32_t>(i)); a < last; ++a) {
+            next_neighbors[out++] = static_cast<uint32_t>(appended[a]);
+          }
+        }
+      });
+
+  offsets_.swap(next_offsets);
+  neighbors_.swap(next_neighbors);
+  reference_x_.swap(next_x);
+  reference_y_.swap(next_y);
+  reference_z_.swap(next_z);
+  ++remap_count_;
+}
+
+bool VerletNeighborList::needsRebuild(const std::vector<float>& px,
+                                      const std::vector<float>& py,
+                                      const std::vector<float>& pz) const {
+  const size_t count = px.size();
+  if (!valid_ || count != size() || py.size() != count || pz.size() != count) {
+    return true;
+  }
+
+  const float half_skin = 0.5f * skin_;
+  const float max_drift_sq = tbb::parallel_reduce(
+      tbb::blocked_range<size_t>(0, count),
+      0.0f,
+      [&](const tbb::blocked_range<size_t>& range, float running) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const float dx = px[i] - reference_x_[i];
+          const float dy = py[i] - reference_y_[i];
+          const float dz = pz[i] - reference_z_[i];
+          running = std::max(running, dx * dx + dy * dy + dz * dz);
+        }
+        return running;
+      },
+      [](float lhs, float rhs) { return std::max(lhs, rhs); });
+
+  return max_drift_sq > half_skin * half_skin;
+}
+
+size_t VerletNeighborList::memoryBytes() const {
+  return offsets_.capacity() * sizeof(size_t) + neighbors_.capacity() * sizeof(uint32_t) +
+         build_indices_.capacity() * sizeof(uint32_t) +
+         (reference_x_.capacity() + reference_y_.capacity() + reference_z_.capacity()) *
+             sizeof(float);
+}
+
+void VerletNeighborList::saveState(CellEvoX::io::CheckpointWriter& writer) const {
+  build_grid_.saveState(writer);
+  writer.put<uint8_t>(valid_ ? 1 : 0);
+  writer.put<uint64_t>(build_count_);
+  writer.putVector(offsets_);
+  writer.putVector(neighbors_);
+  writer.putVector(reference_x_);
+  writer.putVector(reference_y_);
+  writer.putVector(reference_z_);
+}
+
+bool VerletNeighborList::restoreState(CellEvoX::io::CheckpointReader& reader) {
+  uint8_t valid = 0;
+  uint64_t build_count = 0;
+  if (!build_grid_.restoreState(reader) || !reader.get(valid) || !reader.get(build_count) ||
+      !reader.getVector(offsets_) || !reader.getVector(neighbors_) ||
+      !reader.getVector(reference_x_) || !reader.getVector(reference_y_) ||
+      !reader.getVector(reference_z_)) {
+    return false;
+  }
+  build_count_ = static_cast<size_t>(build_count);
+  valid_ = valid != 0;
+  return !valid_ || (!offsets_.empty() && offsets_.back() == neighbors_.size() &&
+                     reference_x_.size() == size() && reference_y_.size() == size() &&
+                     reference_z_.size() == size());
+}
@@ -0,0 +1,177 @@
+#include "systems/ActiveSetScheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "io/EngineCheckpoint.hpp"
+
+namespace CellEvoX::systems {
+
+void ActiveSetScheduler::beginStep(const SpatialHashGrid& grid,
+                                   uint64_t step,
+                                   int dormant_interval) {
+  const auto& sources = grid.sortedSourceIndices();
+  const size_t count = sources.size();
+  const uint64_t interval = static_cast<uint64_t>(std::max(dormant_interval, 1));
+
+  if (grid.gridDim() != grid_dim_) {
+    // Voxel hashes are only comparable within one grid layout.
+    voxel_keys_.clear();
+    voxel_states_.clear();
+    grid_dim_ = grid.gridDim();
+  }
+
+  next_keys_.clear();
+  next_states_.clear();
+  voxel_offsets_.clear();
+  voxel_cells_.assign(sources.begin(), sources.end());
+  cell_elapsed_.assign(count, 0);
+  frozen_cells_.assign(count, 0);
+  cell_quiescent_.assign(count, 1);
+  cell_changed_.assign(count, 0);
+
+  // Both key lists are ascending, so carrying state over is a linear merge.
+  size_t previous = 0;
+  grid.forEachOccupiedVoxel([&](int64_t hash, size_t begin, size_t end) {
+    while (previous < voxel_keys_.size() && voxel_keys_[previous] < hash) {
+      ++previous;
+    }
+    VoxelState state{step - 1, 0};
+    if (previous < voxel_keys_.size() && voxel_keys_[previous] == hash) {
+      state = voxel_states_[previous];
+    }
+
+    const uint64_t elapsed = step - state.last_eval_step;
+    const bool due = state.dormant == 0 || elapsed >= interval;
+    if (due) {
+      state.last_eval_step = step;
+    }
+    const auto elapsed_steps = static_cast<uint32_t>(
+        std::min<uint64_t>(elapsed, std::numeric_limits<uint32_t>::max()));
+    for (size_t slot = begin; slot < end; ++slot) {
+      const uint32_t source = sources[slot];
+      if (due) {
+        cell_elapsed_[source] = elapsed_steps;
+      } else {
+        frozen_cells_[source] = 1;
+      }
+    }
+
+    next_keys_.push_back(hash);
+    next_states_.push_back(state);
+    voxel_offsets_.push_back(static_cast<uint32_t>(begin));
+  });
+  voxel_offsets_.push_back(static_cast<uint32_t>(count));
+  voxel_keys_.swap(next_keys_);
+  voxel_states_.swap(next_states_);
+
+  due_cells_.clear();
+  due_elapsed_.clear();
+  for (size_t i = 0; i < count; ++i) {
+    if (cell_elapsed_[i] != 0) {
+      due_cells_.push_back(static_cast<uint32_t>(i));
+      due_elapsed_.push_back(cell_elapsed_[i]);
+    }
+  }
+}
+
+void ActiveSetScheduler::endStep() {
+  const size_t voxel_count = voxel_keys_.size();
+  std::vector<uint8_t> voxel_changed(voxel_count, 0);
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, voxel_count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t v = range.begin(); v != range.end(); ++v) {
+          uint8_t quiescent = 1;
+          uint8_t changed = 0;
+          for (uint32_t k = voxel_offsets_[v]; k < voxel_offsets_[v + 1]; ++k) {
+            const uint32_t cell = voxel_cells_[k];
+            quiescent &= cell_quiescent_[cell];
+            changed |= cell_changed_[cell];
+          }
+          voxel_states_[v].dormant = quiescent;
+          voxel_changed[v] = changed;
+        }
+      });
+
+  // O(changed voxels * 27 * log voxels) wake-up of the neighborhoods around events.
+  const int64_t dim = static_cast<int64_t>(grid_dim_);
+  for (size_t v = 0; v < voxel_count; ++v) {
+    if (voxel_changed[v] == 0) {
+      continue;
+    }
+    const int64_t hash = voxel_keys_[v];
+    const int64_t ix = hash % dim;
+    const int64_t iy = (hash / dim) % dim;
+    const int64_t iz = hash / (dim * dim);
+    for (int64_t dz = -1; dz <= 1; ++dz) {
+      for (int64_t dy = -1; dy <= 1; ++dy) {
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+          const int64_t nx = ix + dx;
+          const int64_t ny = iy + dy;
+          const int64_t nz = iz + dz;
+          if (nx < 0 || ny < 0 || nz < 0 || nx >= dim || ny >= dim || nz >= dim) {
+            continue;
+          }
+          const int64_t neighbor = nx + ny * dim + nz * dim * dim;
+          const auto it = std::lower_bound(voxel_keys_.begin(), voxel_keys_.end(), neighbor);
+          if (it != voxel_keys_.end() && *it == neighbor) {
+            voxel_states_[static_cast<size_t>(it - voxel_keys_.begin())].dormant = 0;
+          }
+        }
+      }
+    }
+  }
+
+  // Woken voxels take part in the relaxation that follows this step's events.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, voxel_count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t v = range.begin(); v != range.end(); ++v) {
+          if (voxel_states_[v].dormant != 0) {
+            continue;
+          }
+          for (uint32_t k = voxel_offsets_[v]; k < voxel_offsets_[v + 1]; ++k) {
+            frozen_cells_[voxel_cells_[k]] = 0;
+          }
+        }
+      });
+}
+
+size_t ActiveSetScheduler::dormantVoxelCount() const {
+  return static_cast<size_t>(
+      std::count_if(voxel_states_.begin(), voxel_states_.end(), [](const VoxelState& state) {
+        return state.dormant != 0;
+      }));
+}
+
+void ActiveSetScheduler::saveState(CellEvoX::io::CheckpointWriter& writer) const {
+  writer.put<int32_t>(grid_dim_);
+  writer.putVector(voxel_keys_);
+  writer.put<uint64_t>(voxel_states_.size());
+  for (const auto& state : voxel_states_) {
+    writer.put(state.last_eval_step);
+    writer.put(state.dormant);
+  }
+}
+
+bool ActiveSetScheduler::restoreState(CellEvoX::io::CheckpointReader& reader) {
+  int32_t grid_dim = 0;
+  uint64_t state_count = 0;
+  if (!reader.get(grid_dim) || !reader.getVector(voxel_keys_) || !reader.get(state_count) ||
+      state_count != voxel_keys_.size()) {
+    return false;
+  }
+  grid_dim_ = grid_dim;
+  voxel_states_.resize(voxel_keys_.size());
+  for (auto& state : voxel_states_) {
+    if (!reader.get(state.last_eval_step) || !reader.get(state.dormant)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace CellEvoX::systems
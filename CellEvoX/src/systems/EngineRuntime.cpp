@@ -0,0 +1,265 @@
+#include "systems/EngineRuntime.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+#include "utils/ParallelAlgorithms.hpp"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace CellEvoX::systems {
+
+void runEngineSteps(uint32_t steps,
+                    const SimulationConfig& config,
+                    const std::atomic<bool>& shutdown_requested,
+                    const size_t& actual_population,
+                    const double& tau,
+                    const std::function<void()>& step,
+                    const std::function<void()>& write_checkpoint) {
+  auto last_update_time = std::chrono::steady_clock::now();
+  const char* spinner = "|/-\\";
+  int spinner_index = 0;
+  const int bar_width = 50;
+
+  const auto start_time = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < steps; ++i) {
+    if (shutdown_requested.load()) {
+      spdlog::info("Shutdown requested at step {}/{}", i, steps);
+      std::cout << std::endl;
+      if (config.checkpoint_interval > 0) {
+        write_checkpoint();
+      }
+      break;
+    }
+    if (config.max_population_cutoff > 0 && actual_population >= config.max_population_cutoff) {
+      spdlog::warn("Population cutoff reached: {} >= {} at tau={:.2f}. Stopping.",
+                   actual_population, config.max_population_cutoff, tau);
+      std::cout << std::endl;
+      break;
+    }
+
+    step();
+
+    const auto current_time = std::chrono::steady_clock::now();
+    const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  current_time - last_update_time)
+                                  .count();
+
+    if (elapsed_time >= 100) {
+      const int progress = static_cast<int>((static_cast<double>(i + 1) / steps) * 100.0);
+      const int pos = static_cast<int>((static_cast<double>(i + 1) / steps) * bar_width);
+      const auto total_elapsed =
+          std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
+      const double avg_time_per_step = static_cast<double>(total_elapsed) / (i + 1);
+      const int remaining_steps = steps - (i + 1);
+      const double estimated_remaining_time = remaining_steps * avg_time_per_step / 1000.0;
+
+      std::cout << "\r\033[1;32mProgress: [\033[35m";
+      for (int j = 0; j < bar_width; ++j) {
+        std::cout << (j < pos ? '#' : ' ');
+      }
+      std::cout << "\033[1;32m] " << progress << "% \033[34m" << spinner[spinner_index]
+                << " \033[0m" << remaining_steps << " steps remaining, ~" << std::fixed
+                << std::setprecision(1) << estimated_remaining_time << "s left "
+                << actual_population << " cells" << std::flush;
+
+      spinner_index = (spinner_index + 1) % 4;
+      last_update_time = current_time;
+    }
+  }
+
+  std::cout << "\r\033[1;32mProgress: [";
+  for (int j = 0; j < bar_width; ++j) {
+    std::cout << "#";
+  }
+  std::cout << "] 100% \033[0m" << std::endl;
+}
+
+StatSnapshot computeStatSnapshot(const CellMap& cells, double tau) {
+  const size_t living_cells_count = cells.size();
+  if (living_cells_count == 0) {
+    return {tau, 0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0, 0.0};
+  }
+
+  double total_fitness = 0.0;
+  double total_fitness_squared = 0.0;
+  double total_fitness_cubed = 0.0;
+  double total_fitness_fourth = 0.0;
+
+  double total_mutations = 0.0;
+  double total_mutations_squared = 0.0;
+  double total_mutations_cubed = 0.0;
+  double total_mutations_fourth = 0.0;
+
+  std::vector<uint32_t> sorted_keys;
+  sorted_keys.reserve(living_cells_count);
+  for (const auto& cell : cells) {
+    sorted_keys.push_back(cell.first);
+  }
+  CellEvoX::parallel_algorithms::sortMaybeParallel(sorted_keys.begin(), sorted_keys.end());
+
+  for (uint32_t key : sorted_keys) {
+    CellMap::const_accessor accessor;
+    if (!cells.find(accessor, key)) {
+      continue;
+    }
+
+    const auto& cell = accessor->second;
+    const double fitness = cell.fitness;
+    const double fitness_sq = fitness * fitness;
+    const double fitness_cu = fitness_sq * fitness;
+    const double fitness_qd = fitness_cu * fitness;
+
+    const double mutations = static_cast<double>(cell.mutations.size());
+    const double mutations_sq = mutations * mutations;
+    const double mutations_cu = mutations_sq * mutations;
+    const double mutations_qd = mutations_cu * mutations;
+
+    total_fitness += fitness;
+    total_fitness_squared += fitness_sq;
+    total_fitness_cubed += fitness_cu;
+    total_fitness_fourth += fitness_qd;
+
+    total_mutations += mutations;
+    total_mutations_squared += mutations_sq;
+    total_mutations_cubed += mutations_cu;
+    total_mutations_fourth += mutations_qd;
+  }
+
+  const double mean_fitness = total_fitness / living_cells_count;
+  const double mean_mutations = total_mutations / living_cells_count;
+
+  const double raw_fitness_second = total_fitness_squared / living_cells_count;
+  const double raw_fitness_third = total_fitness_cubed / living_cells_count;
+  const double raw_fitness_fourth = total_fitness_fourth / living_cells_count;
+
+  const double raw_mutations_second = total_mutations_squared / living_cells_count;
+  const double raw_mutations_third = total_mutations_cubed / living_cells_count;
+  const double raw_mutations_fourth = total_mutations_fourth / living_cells_count;
+
+  const double fitness_variance = raw_fitness_second - mean_fitness * mean_fitness;
+  const double mutations_variance = raw_mutations_second - mean_mutations * mean_mutations;
+
+  const double fitness_skewness =
+      raw_fitness_third - 3.0 * mean_fitness * raw_fitness_second +
+      2.0 * std::pow(mean_fitness, 3);
+  const double fitness_kurtosis =
+      raw_fitness_fourth - 4.0 * mean_fitness * raw_fitness_third +
+      6.0 * mean_fitness * mean_fitness * raw_fitness_second -
+      3.0 * std::pow(mean_fitness, 4);
+
+  const double mutations_skewness =
+      raw_mutations_third - 3.0 * mean_mutations * raw_mutations_second +
+      2.0 * std::pow(mean_mutations, 3);
+  const double mutations_kurtosis =
+      raw_mutations_fourth - 4.0 * mean_mutations * raw_mutations_third +
+      6.0 * mean_mutations * mean_mutations * raw_mutations_second -
+      3.0 * std::pow(mean_mutations, 4);
+
+  return {tau,
+          mean_fitness,
+          fitness_variance,
+          mean_mutations,
+          mutations_variance,
+          living_cells_count,
+          fitness_skewness,
+          fitness_kurtosis,
+          mutations_skewness,
+          mutations_kurtosis};
+}
+
+void pruneUnreachableGraveyard(const CellMap& cells, Graveyard& graveyard) {
+  std::unordered_set<uint32_t> living_ids;
+  for (const auto& cell : cells) {
+    living_ids.insert(cell.first);
+  }
+
+  std::unordered_set<uint32_t> reachable_dead_cells;
+  for (uint32_t start_id : living_ids) {
+    CellMap::const_accessor accessor;
+    if (!cells.find(accessor, start_id)) {
+      continue;
+    }
+
+    uint32_t parent_id = accessor->second.parent_id;
+    while (parent_id != 0) {
+      if (reachable_dead_cells.count(parent_id) || living_ids.count(parent_id)) {
+        break;
+      }
+
+      Graveyard::const_accessor grave_accessor;
+      if (graveyard.find(grave_accessor, parent_id)) {
+        reachable_dead_cells.insert(parent_id);
+        parent_id = grave_accessor->second.first;
+        continue;
+      }
+
+      break;
+    }
+  }
+
+  std::vector<uint32_t> to_remove;
+  for (const auto& item : graveyard) {
+    if (reachable_dead_cells.find(item.first) == reachable_dead_cells.end()) {
+      to_remove.push_back(item.first);
+    }
+  }
+
+  for (uint32_t id : to_remove) {
+    graveyard.erase(id);
+  }
+}
+
+size_t residentSetKb() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS_EX counters{};
+  if (GetProcessMemoryInfo(GetCurrentProcess(),
+                           reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
+                           sizeof(counters))) {
+    return static_cast<size_t>(counters.WorkingSetSize / 1024);
+  }
+  return 0;
+#else
+  size_t rss = 0;
+  std::ifstream statm("/proc/self/statm");
+  if (statm.is_open()) {
+    size_t ignored = 0;
+    statm >> ignored >> rss;
+  }
+
+  const long page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
+  return rss * static_cast<size_t>(page_size_kb);
+#endif
+}
+
+void appendMemoryLogRow(std::ofstream& file,
+                        double tau,
+                        size_t cells_count,
+                        size_t graveyard_count) {
+  if (!file.is_open()) {
+    return;
+  }
+
+  // About 48 bytes per graveyard entry: key, parent and death time plus hash map node overhead.
+  const size_t rss_kb = residentSetKb();
+  const size_t estimated_cells_kb = (cells_count * sizeof(Cell)) / 1024;
+  const size_t estimated_graveyard_kb = (graveyard_count * 48) / 1024;
+
+  file << tau << "," << rss_kb << "," << cells_count << "," << graveyard_count << ","
+       << estimated_cells_kb << "," << estimated_graveyard_kb << "\n";
+}
+
+}  // namespace CellEvoX::systems
@@ -0,0 +1,516 @@
+#include "systems/MechanicalRelaxation.hpp"
+
+#include <spdlog/spdlog.h>
+#include <tbb/blocked_range.h>
+#include <tbb/combinable.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "spatial/NeighborKernels.hpp"
+#include "utils/PhaseProfiler.hpp"
+
+namespace CellEvoX::systems {
+
+namespace {
+
+// Explicit Euler on overlap springs stays stable while no cell moves more than this fraction
+// of the interaction radius in one substep.
+constexpr float kMaxStableDisplacementFraction = 0.25f;
+// Per-substep recovery of an adaptively shrunk dt back towards config.mech_dt.
+constexpr float kAdaptiveDtGrowth = 1.25f;
+// relaxLocal() queries the stale grid with a margin of twice the largest accumulated move and
+// rebuilds it once that margin would exceed this fraction of the interaction radius.
+constexpr float kLocalDriftRebuildFraction = 0.25f;
+
+}  // namespace
+
+MechanicalRelaxation::MechanicalRelaxation(const SimulationConfig& config,
+                                           float interaction_radius)
+    : interaction_radius_(interaction_radius),
+      neighbor_list_(interaction_radius,
+                     config.mech_verlet_skin,
+                     config.spatial_domain_size,
+                     config.spatial_domain_growth) {}
+
+std::pair<float, float> MechanicalRelaxation::wallBounds(const SimulationConfig& config) {
+  if (config.spatial_domain_growth) {
+    return {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max()};
+  }
+  return {0.0f, config.spatial_domain_size};
+}
+
+void MechanicalRelaxation::relax(const SimulationConfig& config,
+                                 const std::vector<uint32_t>& cell_ids,
+                                 std::vector<float>& pos_x,
+                                 std::vector<float>& pos_y,
+                                 std::vector<float>& pos_z,
+                                 SpatialHashGrid& grid,
+                                 const std::vector<uint8_t>* frozen) {
+  const size_t count = cell_ids.size();
+  stats_ = Stats{};
+  if (count == 0 || config.mech_substeps <= 0) {
+    return;
+  }
+  frozen_ = frozen != nullptr && frozen->size() == count ? frozen : nullptr;
+
+  read_x_.resize(count);
+  read_y_.resize(count);
+  read_z_.resize(count);
+  write_x_.resize(count);
+  write_y_.resize(count);
+  write_z_.resize(count);
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          read_x_[i] = pos_x[i];
+          read_y_[i] = pos_y[i];
+          read_z_[i] = pos_z[i];
+        }
+      });
+
+  const bool use_verlet = config.mech_neighbor_mode == MechanicsNeighborMode::Verlet;
+  // The colored half-shell stencil only reaches adjacent voxels.
+  const bool use_half_stencil = config.mech_neighbor_mode == MechanicsNeighborMode::HalfStencil &&
+                                grid.voxelSize() >= interaction_radius_;
+  if (use_half_stencil) {
+    force_x_.resize(count);
+    force_y_.resize(count);
+    force_z_.resize(count);
+  }
+
+  const bool adaptive = config.mech_adaptive;
+  const float tolerance_sq = config.mech_tolerance * config.mech_tolerance;
+  float dt = config.mech_dt;
+
+  for (int substep = 0; substep < config.mech_substeps; ++substep) {
+    if (use_verlet) {
+      if (neighbor_list_.needsRebuild(read_x_, read_y_, read_z_)) {
+        CELLEVOX_PROFILE_PHASE("mech_verlet_list_build");
+        neighbor_list_.build(read_x_, read_y_, read_z_);
+        spdlog::debug("Rebuilt Verlet neighbor list: {} cells, {} pairs, {} KB",
+                      count,
+                      neighbor_list_.pairCount(),
+                      neighbor_list_.memoryBytes() / 1024);
+      }
+      verletSubstep(config, dt);
+    } else {
+      {
+        CELLEVOX_PROFILE_PHASE("mech_grid_rebuild");
+        grid.rebuild(cell_ids, read_x_, read_y_, read_z_);
+      }
+      if (use_half_stencil) {
+        halfStencilSubstep(config, dt, grid);
+      } else {
+        gridSubstep(config, dt, grid);
+      }
+    }
+    stats_.iterations = substep + 1;
+    stats_.dt = dt;
+
+    bool converged = false;
+    if (adaptive) {
+      auto [max_sq, sum_sq] = measureDisplacement();
+      const float scale = adaptTimeStep(config, max_sq, dt);
+      if (scale < 1.0f) {
+        scaleDisplacement(scale);
+        max_sq *= scale * scale;
+        sum_sq *= static_cast<double>(scale) * scale;
+        stats_.dt = dt;
+      }
+      stats_.max_displacement = std::sqrt(max_sq);
+      stats_.rms_displacement = static_cast<float>(std::sqrt(sum_sq / static_cast<double>(count)));
+      converged = max_sq < tolerance_sq;
+    }
+
+    read_x_.swap(write_x_);
+    read_y_.swap(write_y_);
+    read_z_.swap(write_z_);
+    if (converged) {
+      break;
+    }
+  }
+
+  CELLEVOX_PROFILE_VALUE("mech_relax_iterations", stats_.iterations);
+  if (adaptive) {
+    CELLEVOX_PROFILE_VALUE("mech_relax_max_displacement", stats_.max_displacement);
+    CELLEVOX_PROFILE_VALUE("mech_relax_rms_displacement", stats_.rms_displacement);
+    CELLEVOX_PROFILE_VALUE("mech_relax_dt", stats_.dt);
+  }
+
+  pos_x.swap(read_x_);
+  pos_y.swap(read_y_);
+  pos_z.swap(read_z_);
+  frozen_ = nullptr;
+
+  CELLEVOX_PROFILE_PHASE("mech_grid_rebuild");
+  grid.rebuild(cell_ids, pos_x, pos_y, pos_z);
+}
+
+void MechanicalRelaxation::relaxLocal(const SimulationConfig& config,
+                                      const std::vector<uint32_t>& cell_ids,
+                                      std::vector<float>& pos_x,
+                                      std::vector<float>& pos_y,
+                                      std::vector<float>& pos_z,
+                                      SpatialHashGrid& grid,
+                                      const std::vector<uint32_t>& seeds,
+                                      const std::vector<uint8_t>* frozen) {
+  const size_t count = cell_ids.size();
+  stats_ = Stats{};
+  local_cells_.clear();
+  if (count == 0 || config.mech_substeps <= 0) {
+    return;
+  }
+  frozen_ = frozen != nullptr && frozen->size() == count ? frozen : nullptr;
+  local_flags_.resize(count, 0);
+
+  const float interaction_radius = interaction_radius_;
+  const float interaction_radius_sq = interaction_radius * interaction_radius;
+  const auto [wall_min, wall_max] = wallBounds(config);
+  const float threshold_sq = config.mech_local_threshold * config.mech_local_threshold;
+  const float tolerance_sq = config.mech_tolerance * config.mech_tolerance;
+  const float drift_limit = kLocalDriftRebuildFraction * interaction_radius;
+  float drift = 0.0f;
+  float dt = config.mech_dt;
+
+  auto activate = [&](uint32_t i) {
+    if (local_flags_[i] == 0 && !isFrozen(i)) {
+      local_flags_[i] = 1;
+      local_cells_.push_back(i);
+    }
+  };
+  // Collects the cells overlapping any of `sources`; the stale grid is padded by 2 * drift.
+  tbb::combinable<std::vector<uint32_t>> reached_per_thread;
+  auto expandFrom = [&](const std::vector<uint32_t>& sources, size_t source_count, auto&& include) {
+    const float query_radius = interaction_radius + 2.0f * drift;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, source_count), [&](const tbb::blocked_range<size_t>& range) {
+          auto& reached = reached_per_thread.local();
+          for (size_t k = range.begin(); k != range.end(); ++k) {
+            if (!include(k)) {
+              continue;
+            }
+            const uint32_t i = sources[k];
+            const float xi = pos_x[i];
+            const float yi = pos_y[i];
+            const float zi = pos_z[i];
+            grid.querySourceRadius(xi, yi, zi, query_radius, [&](uint32_t j) {
+              if (local_flags_[j] != 0) {
+                return;
+              }
+              const float dx = xi - pos_x[j];
+              const float dy = yi - pos_y[j];
+              const float dz = zi - pos_z[j];
+              if (dx * dx + dy * dy + dz * dz < interaction_radius_sq) {
+                reached.push_back(j);
+              }
+            });
+          }
+        });
+    reached_per_thread.combine_each([&](std::vector<uint32_t>& reached) {
+      for (uint32_t j : reached) {
+        activate(j);
+      }
+      reached.clear();
+    });
+  };
+
+  for (uint32_t seed : seeds) {
+    if (seed < count) {
+      activate(seed);
+    }
+  }
+  expandFrom(local_cells_, local_cells_.size(), [](size_t) { return true; });
+
+  for (int substep = 0; substep < config.mech_substeps && !local_cells_.empty(); ++substep) {
+    const size_t active = local_cells_.size();
+    local_x_.resize(active);
+    local_y_.resize(active);
+    local_z_.resize(active);
+    local_displacement_sq_.resize(active);
+    const float query_radius = interaction_radius + 2.0f * drift;
+
+    // O(active cells); every cell still pushes, but only the local set moves.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, active), [&](const tbb::blocked_range<size_t>& range) {
+          for (size_t k = range.begin(); k != range.end(); ++k) {
+            const uint32_t i = local_cells_[k];
+            const float xi = pos_x[i];
+            const float yi = pos_y[i];
+            const float zi = pos_z[i];
+
+            Eigen::Vector3f force = Eigen::Vector3f::Zero();
+            grid.querySourceRadius(xi, yi, zi, query_radius, [&](uint32_t j) {
+              const float dx = xi - pos_x[j];
+              const float dy = yi - pos_y[j];
+              const float dz = zi - pos_z[j];
+              const float dist_sq = dx * dx + dy * dy + dz * dz;
+              if (dist_sq <= 1e-12f || dist_sq >= interaction_radius_sq) {
+                return;
+              }
+
+              const float dist = std::sqrt(dist_sq);
+              const float scale = config.spring_constant * (interaction_radius - dist) / dist;
+              force.x() += scale * dx;
+              force.y() += scale * dy;
+              force.z() += scale * dz;
+            });
+
+            local_x_[k] = std::clamp(xi + force.x() * dt, wall_min, wall_max);
+            local_y_[k] = std::clamp(yi + force.y() * dt, wall_min, wall_max);
+            local_z_[k] = std::clamp(zi + force.z() * dt, wall_min, wall_max);
+            const float mx = local_x_[k] - xi;
+            const float my = local_y_[k] - yi;
+            const float mz = local_z_[k] - zi;
+            local_displacement_sq_[k] = mx * mx + my * my + mz * mz;
+          }
+        });
+
+    float max_sq = 0.0f;
+    double sum_sq = 0.0;
+    for (size_t k = 0; k < active; ++k) {
+      max_sq = std::max(max_sq, local_displacement_sq_[k]);
+      sum_sq += local_displacement_sq_[k];
+    }
+    stats_.iterations = substep + 1;
+    stats_.dt = dt;
+    const float move_scale = config.mech_adaptive ? adaptTimeStep(config, max_sq, dt) : 1.0f;
+    if (move_scale < 1.0f) {
+      max_sq *= move_scale * move_scale;
+      sum_sq *= static_cast<double>(move_scale) * move_scale;
+      stats_.dt = dt;
+    }
+    stats_.max_displacement = std::sqrt(max_sq);
+    stats_.rms_displacement = static_cast<float>(std::sqrt(sum_sq / static_cast<double>(active)));
+
+    // Jacobi update: all forces above were computed from the previous positions.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, active), [&](const tbb::blocked_range<size_t>& range) {
+          for (size_t k = range.begin(); k != range.end(); ++k) {
+            const uint32_t i = local_cells_[k];
+            pos_x[i] += (local_x_[k] - pos_x[i]) * move_scale;
+            pos_y[i] += (local_y_[k] - pos_y[i]) * move_scale;
+            pos_z[i] += (local_z_[k] - pos_z[i]) * move_scale;
+            local_displacement_sq_[k] *= move_scale * move_scale;
+          }
+        });
+
+    drift += stats_.max_displacement;
+    if (drift > drift_limit) {
+      CELLEVOX_PROFILE_PHASE("mech_grid_rebuild");
+      grid.rebuild(cell_ids, pos_x, pos_y, pos_z);
+      drift = 0.0f;
+    }
+
+    if (config.mech_adaptive && max_sq < tolerance_sq) {
+      break;
+    }
+    // Cells that still move push their resting neighbors into the set for the next substep.
+    expandFrom(local_cells_, active, [&](size_t k) {
+      return local_displacement_sq_[k] > threshold_sq;
+    });
+  }
+
+  for (uint32_t i : local_cells_) {
+    local_flags_[i] = 0;
+  }
+  frozen_ = nullptr;
+
+  CELLEVOX_PROFILE_VALUE("mech_relax_iterations", stats_.iterations);
+  CELLEVOX_PROFILE_VALUE("mech_relax_local_cells", local_cells_.size());
+  if (config.mech_adaptive) {
+    CELLEVOX_PROFILE_VALUE("mech_relax_max_displacement", stats_.max_displacement);
+    CELLEVOX_PROFILE_VALUE("mech_relax_rms_displacement", stats_.rms_displacement);
+    CELLEVOX_PROFILE_VALUE("mech_relax_dt", stats_.dt);
+  }
+
+  CELLEVOX_PROFILE_PHASE("mech_grid_rebuild");
+  grid.rebuild(cell_ids, pos_x, pos_y, pos_z);
+}
+
+void MechanicalRelaxation::gridSubstep(const SimulationConfig& config,
+                                       float dt,
+                                       const SpatialHashGrid& grid) {
+  const float interaction_radius = interaction_radius_;
+  const auto [wall_min, wall_max] = wallBounds(config);
+  const auto& sorted_source = grid.sortedSourceIndices();
+  const auto& sorted_x = grid.sortedX();
+  const auto& sorted_y = grid.sortedY();
+  const auto& sorted_z = grid.sortedZ();
+
+  // O(N) over voxel-sorted slots: consecutive cells share their candidate runs in cache.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, sorted_source.size()),
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t slot = range.begin(); slot != range.end(); ++slot) {
+          const size_t i = sorted_source[slot];
+          const float xi = sorted_x[slot];
+          const float yi = sorted_y[slot];
+          const float zi = sorted_z[slot];
+          if (isFrozen(i)) {
+            write_x_[i] = xi;
+            write_y_[i] = yi;
+            write_z_[i] = zi;
+            continue;
+          }
+
+          float force[3] = {0.0f, 0.0f, 0.0f};
+          CellEvoX::spatial::accumulateSpringForce(
+              grid, xi, yi, zi, interaction_radius, config.spring_constant, force);
+
+          write_x_[i] = std::clamp(xi + force[0] * dt, wall_min, wall_max);
+          write_y_[i] = std::clamp(yi + force[1] * dt, wall_min, wall_max);
+          write_z_[i] = std::clamp(zi + force[2] * dt, wall_min, wall_max);
+        }
+      });
+}
+
+void MechanicalRelaxation::verletSubstep(const SimulationConfig& config, float dt) {
+  const size_t count = read_x_.size();
+  const float interaction_radius = interaction_radius_;
+  const float interaction_radius_sq = interaction_radius * interaction_radius;
+  const auto [wall_min, wall_max] = wallBounds(config);
+
+  // O(N) streaming pass over the CSR neighbor slots; no voxel lookups per substep.
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const float xi = read_x_[i];
+          const float yi = read_y_[i];
+          const float zi = read_z_[i];
+          if (isFrozen(i)) {
+            write_x_[i] = xi;
+            write_y_[i] = yi;
+            write_z_[i] = zi;
+            continue;
+          }
+
+          Eigen::Vector3f force = Eigen::Vector3f::Zero();
+          const size_t slot_end = neighbor_list_.neighborEnd(i);
+          for (size_t slot = neighbor_list_.neighborBegin(i); slot < slot_end; ++slot) {
+            const uint32_t j = neighbor_list_.neighborAt(slot);
+            const float dx = xi - read_x_[j];
+            const float dy = yi - read_y_[j];
+            const float dz = zi - read_z_[j];
+            const float dist_sq = dx * dx + dy * dy + dz * dz;
+            if (dist_sq <= 1e-12f || dist_sq >= interaction_radius_sq) {
+              continue;
+            }
+
+            const float dist = std::sqrt(dist_sq);
+            const float scale = config.spring_constant * (interaction_radius - dist) / dist;
+            force.x() += scale * dx;
+            force.y() += scale * dy;
+            force.z() += scale * dz;
+          }
+
+          write_x_[i] = std::clamp(xi + force.x() * dt, wall_min, wall_max);
+          write_y_[i] = std::clamp(yi + force.y() * dt, wall_min, wall_max);
+          write_z_[i] = std::clamp(zi + force.z() * dt, wall_min, wall_max);
+        }
+      });
+}
+
+void MechanicalRelaxation::halfStencilSubstep(const SimulationConfig& config,
+                                              float dt,
+                                              const SpatialHashGrid& grid) {
+  const size_t count = read_x_.size();
+  const float interaction_radius = interaction_radius_;
+  const float interaction_radius_sq = interaction_radius * interaction_radius;
+  const auto [wall_min, wall_max] = wallBounds(config);
+
+  std::fill(force_x_.begin(), force_x_.end(), 0.0f);
+  std::fill(force_y_.begin(), force_y_.end(), 0.0f);
+  std::fill(force_z_.begin(), force_z_.end(), 0.0f);
+
+  // O(N) with one distance/sqrt per interacting pair; the grid's voxel coloring keeps the
+  // equal-and-opposite scatter free of write conflicts.
+  grid.forEachHalfStencilSourcePair([&](uint32_t a, uint32_t b) {
+    const float dx = read_x_[a] - read_x_[b];
+    const float dy = read_y_[a] - read_y_[b];
+    const float dz = read_z_[a] - read_z_[b];
+    const float dist_sq = dx * dx + dy * dy + dz * dz;
+    if (dist_sq <= 1e-12f || dist_sq >= interaction_radius_sq) {
+      return;
+    }
+
+    const float dist = std::sqrt(dist_sq);
+    const float scale = config.spring_constant * (interaction_radius - dist) / dist;
+    force_x_[a] += scale * dx;
+    force_y_[a] += scale * dy;
+    force_z_[a] += scale * dz;
+    force_x_[b] -= scale * dx;
+    force_y_[b] -= scale * dy;
+    force_z_[b] -= scale * dz;
+  });
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, count), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          if (isFrozen(i)) {
+            write_x_[i] = read_x_[i];
+            write_y_[i] = read_y_[i];
+            write_z_[i] = read_z_[i];
+            continue;
+          }
+          write_x_[i] = std::clamp(read_x_[i] + force_x_[i] * dt, wall_min, wall_max);
+          write_y_[i] = std::clamp(read_y_[i] + force_y_[i] * dt, wall_min, wall_max);
+          write_z_[i] = std::clamp(read_z_[i] + force_z_[i] * dt, wall_min, wall_max);
+        }
+      });
+}
+
+float MechanicalRelaxation::adaptTimeStep(const SimulationConfig& config,
+                                          float max_displacement_sq,
+                                          float& dt) const {
+  if (!config.mech_adaptive_dt) {
+    return 1.0f;
+  }
+  const float max_stable_displacement = kMaxStableDisplacementFraction * interaction_radius_;
+  if (max_displacement_sq > max_stable_displacement * max_stable_displacement) {
+    // Moves are linear in dt, so shrinking them afterwards equals rerunning with smaller dt.
+    const float scale = max_stable_displacement / std::sqrt(max_displacement_sq);
+    dt *= scale;
+    return scale;
+  }
+  dt = std::min(dt * kAdaptiveDtGrowth, config.mech_dt);
+  return 1.0f;
+}
+
+std::pair<float, double> MechanicalRelaxation::measureDisplacement() const {
+  using Residual = std::pair<float, double>;
+  return tbb::parallel_reduce(
+      tbb::blocked_range<size_t>(0, read_x_.size()),
+      Residual{0.0f, 0.0},
+      [&](const tbb::blocked_range<size_t>& range, Residual residual) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          const float dx = write_x_[i] - read_x_[i];
+          const float dy = write_y_[i] - read_y_[i];
+          const float dz = write_z_[i] - read_z_[i];
+          const float displacement_sq = dx * dx + dy * dy + dz * dz;
+          residual.first = std::max(residual.first, displacement_sq);
+          residual.second += displacement_sq;
+        }
+        return residual;
+      },
+      [](const Residual& lhs, const Residual& rhs) {
+        return Residual{std::max(lhs.first, rhs.first), lhs.second + rhs.second};
+      });
+}
+
+void MechanicalRelaxation::scaleDisplacement(float scale) {
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, read_x_.size()), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          write_x_[i] = read_x_[i] + (write_x_[i] - read_x_[i]) * scale;
+          write_y_[i] = read_y_[i] + (write_y_[i] - read_y_[i]) * scale;
+          write_z_[i] = read_z_[i] + (write_z_[i] - read_z_[i]) * scale;
+        }
+      });
+}
+
+}  // namespace CellEvoX::systems
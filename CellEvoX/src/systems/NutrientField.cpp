@@ -0,0 +1,298 @@
+#include "systems/NutrientField.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace CellEvoX::systems {
+
+namespace {
+
+// Finest level edge; coarser spatial grids keep their own resolution.
+constexpr int kMaxFineDim = 128;
+constexpr int kCoarsestDim = 2;
+constexpr int kPreSmoothSweeps = 2;
+constexpr int kPostSmoothSweeps = 2;
+constexpr int kCoarsestSweeps = 16;
+constexpr float kWallConcentration = 1.0f;
+
+}  // namespace
+
+NutrientField::NutrientField(const SpatialHashGrid& grid)
+    : grid_dim_(grid.gridDim()), origin_(grid.origin()) {
+  factor_ = std::max(1, (grid_dim_ + kMaxFineDim - 1) / kMaxFineDim);
+  int dim = (grid_dim_ + factor_ - 1) / factor_;
+  float h = grid.voxelSize() * static_cast<float>(factor_);
+  while (true) {
+    Level level;
+    level.dim = dim;
+    level.h = h;
+    const size_t voxels =
+        static_cast<size_t>(dim) * static_cast<size_t>(dim) * static_cast<size_t>(dim);
+    level.u.assign(voxels, levels_.empty() ? kWallConcentration : 0.0f);
+    level.f.assign(voxels, 0.0f);
+    level.lambda.assign(voxels, 0.0f);
+    level.r.assign(voxels, 0.0f);
+    levels_.push_back(std::move(level));
+    if (dim <= kCoarsestDim) {
+      break;
+    }
+    dim = (dim + 1) / 2;
+    h *= 2.0f;
+  }
+}
+
+size_t NutrientField::index(const Level& level, int ix, int iy, int iz) const {
+  const auto dim = static_cast<size_t>(level.dim);
+  return static_cast<size_t>(ix) + static_cast<size_t>(iy) * dim +
+         static_cast<size_t>(iz) * dim * dim;
+}
+
+void NutrientField::update(const SimulationConfig& config, const SpatialHashGrid& grid) {
+  Level& fine = levels_.front();
+  const float volume = fine.h * fine.h * fine.h;
+  const float uptake_per_cell = config.nutrient_consumption / volume;
+  std::fill(fine.lambda.begin(), fine.lambda.end(), 0.0f);
+  const int64_t grid_dim = grid_dim_;
+  const auto factor = static_cast<int64_t>(factor_);
+  grid.forEachOccupiedVoxel([&](int64_t voxel, size_t begin, size_t end) {
+    const int ix = static_cast<int>((voxel % grid_dim) / factor);
+    const int iy = static_cast<int>(((voxel / grid_dim) % grid_dim) / factor);
+    const int iz = static_cast<int>((voxel / (grid_dim * grid_dim)) / factor);
+    fine.lambda[index(fine, ix, iy, iz)] += uptake_per_cell * static_cast<float>(end - begin);
+  });
+  for (size_t depth = 1; depth < levels_.size(); ++depth) {
+    // Coarse uptake is the mean of its children, like the restricted residual.
+    Level& coarse = levels_[depth];
+    restrictMean(levels_[depth - 1], levels_[depth - 1].lambda, coarse, coarse.lambda);
+  }
+
+  // The previous step's field is the initial guess; the tumor moves little between steps.
+  for (int cycle = 0; cycle < config.nutrient_vcycles; ++cycle) {
+    vCycle(0, config.nutrient_diffusion);
+  }
+  last_residual_ = residual(fine, config.nutrient_diffusion, kWallConcentration);
+}
+
+void NutrientField::smooth(Level& level, float diffusion, float boundary, int sweeps) const {
+  const int dim = level.dim;
+  const float coupling = diffusion / (level.h * level.h);
+  const float diagonal = 6.0f * coupling;
+  float* u = level.u.data();
+  const float* f = level.f.data();
+  const float* lambda = level.lambda.data();
+  const size_t row = static_cast<size_t>(dim);
+  const size_t plane = row * row;
+  // Stands in for the neighbor row beyond a y or z wall.
+  const std::vector<float> wall_row(row, boundary);
+
+  for (int sweep = 0; sweep < sweeps; ++sweep) {
+    for (int color = 0; color < 2; ++color) {
+      // Voxels of one color only read the other color, so z-planes update in parallel.
+      tbb::parallel_for(tbb::blocked_range<int>(0, dim), [&](const tbb::blocked_range<int>& range) {
+        for (int iz = range.begin(); iz != range.end(); ++iz) {
+          for (int iy = 0; iy < dim; ++iy) {
+            const size_t base = static_cast<size_t>(iz) * plane + static_cast<size_t>(iy) * row;
+            float* centre = u + base;
+            const float* south = iy > 0 ? centre - row : wall_row.data();
+            const float* north = iy + 1 < dim ? centre + row : wall_row.data();
+            const float* below = iz > 0 ? centre - plane : wall_row.data();
+            const float* above = iz + 1 < dim ? centre + plane : wall_row.data();
+            const float* f_row = f + base;
+            const float* lambda_row = lambda + base;
+            const auto relaxed = [&](size_t ix, float west, float east) {
+              return (f_row[ix] + coupling * (west + east + south[ix] + north[ix] + below[ix] +
+                                              above[ix])) /
+                     (diagonal + lambda_row[ix]);
+            };
+
+            // Only this color's voxels are computed, so no task reads a voxel another task is
+            // writing. The wall voxels are peeled off to keep the stride-2 loop branch-free.
+            size_t ix = static_cast<size_t>((iy + iz + color) & 1);
+            if (ix == 0) {
+              centre[0] = relaxed(0, boundary, row > 1 ? centre[1] : boundary);
+              ix = 2;
+            }
+            for (; ix + 1 < row; ix += 2) {
+              centre[ix] = relaxed(ix, centre[ix - 1], centre[ix + 1]);
+            }
+            if (ix + 1 == row) {
+              centre[ix] = relaxed(ix, centre[ix - 1], boundary);
+            }
+          }
+        }
+      });
+    }
+  }
+}
+
+float NutrientField::residual(Level& level, float diffusion, float boundary) const {
+  const int dim = level.dim;
+  const float coupling = diffusion / (level.h * level.h);
+  const float* u = level.u.data();
+  const size_t row = static_cast<size_t>(dim);
+  const size_t plane = row * row;
+
+  return tbb::parallel_reduce(
+      tbb::blocked_range<int>(0, dim),
+      0.0f,
+      [&](const tbb::blocked_range<int>& range, float max_residual) {
+        for (int iz = range.begin(); iz != range.end(); ++iz) {
+          for (int iy = 0; iy < dim; ++iy) {
+            for (int ix = 0; ix < dim; ++ix) {
+              const size_t i = static_cast<size_t>(iz) * plane + static_cast<size_t>(iy) * row +
+                               static_cast<size_t>(ix);
+              const float west = ix > 0 ? u[i - 1] : boundary;
+              const float east = ix + 1 < dim ? u[i + 1] : boundary;
+              const float south = iy > 0 ? u[i - row] : boundary;
+              const float north = iy + 1 < dim ? u[i + row] : boundary;
+              const float below = iz > 0 ? u[i - plane] : boundary;
+              const float above = iz + 1 < dim ? u[i + plane] : boundary;
+              const float diagonal = 6.0f * coupling + level.lambda[i];
+              const float applied =
+                  diagonal * u[i] - coupling * (west + east + south + north + below + above);
+              level.r[i] = level.f[i] - applied;
+              max_residual = std::max(max_residual, std::abs(level.r[i]) / diagonal);
+            }
+          }
+        }
+        return max_residual;
+      },
+      [](float lhs, float rhs) { return std::max(lhs, rhs); });
+}
+
+void NutrientField::restrictMean(const Level& fine,
+                                 const std::vector<float>& fine_values,
+                                 const Level& coarse,
+                                 std::vector<float>& coarse_values) const {
+  // Mean of the (up to eight) children; edge parents of odd grids have fewer. Every coarse
+  // voxel gathers its own children, so z-planes are independent.
+  tbb::parallel_for(
+      tbb::blocked_range<int>(0, coarse.dim), [&](const tbb::blocked_range<int>& range) {
+        for (int iz = range.begin(); iz != range.end(); ++iz) {
+          const int z_end = std::min(2 * iz + 2, fine.dim);
+          for (int iy = 0; iy < coarse.dim; ++iy) {
+            const int y_end = std::min(2 * iy + 2, fine.dim);
+            for (int ix = 0; ix < coarse.dim; ++ix) {
+              const int x_end = std::min(2 * ix + 2, fine.dim);
+              float sum = 0.0f;
+              for (int fz = 2 * iz; fz < z_end; ++fz) {
+                for (int fy = 2 * iy; fy < y_end; ++fy) {
+                  for (int fx = 2 * ix; fx < x_end; ++fx) {
+                    sum += fine_values[index(fine, fx, fy, fz)];
+                  }
+                }
+              }
+              const int children = (x_end - 2 * ix) * (y_end - 2 * iy) * (z_end - 2 * iz);
+              coarse_values[index(coarse, ix, iy, iz)] = sum / static_cast<float>(children);
+            }
+          }
+        }
+      });
+}
+
+void NutrientField::prolongAndCorrect(const Level& coarse, Level& fine) const {
+  // Piecewise-constant prolongation of the coarse correction.
+  tbb::parallel_for(
+      tbb::blocked_range<int>(0, fine.dim), [&](const tbb::blocked_range<int>& range) {
+        for (int iz = range.begin(); iz != range.end(); ++iz) {
+          for (int iy = 0; iy < fine.dim; ++iy) {
+            for (int ix = 0; ix < fine.dim; ++ix) {
+              fine.u[index(fine, ix, iy, iz)] +=
+                  coarse.u[index(coarse, ix / 2, iy / 2, iz / 2)];
+            }
+          }
+        }
+      });
+}
+
+void NutrientField::vCycle(size_t depth, float diffusion) {
+  Level& level = levels_[depth];
+  // Only the finest level sees the wall concentration; coarse levels solve for a correction
+  // that vanishes on the walls.
+  const float boundary = depth == 0 ? kWallConcentration : 0.0f;
+  if (depth + 1 == levels_.size()) {
+    smooth(level, diffusion, boundary, kCoarsestSweeps);
+    return;
+  }
+
+  smooth(level, diffusion, boundary, kPreSmoothSweeps);
+  residual(level, diffusion, boundary);
+  Level& coarse = levels_[depth + 1];
+  restrictMean(level, level.r, coarse, coarse.f);
+  std::fill(coarse.u.begin(), coarse.u.end(), 0.0f);
+  vCycle(depth + 1, diffusion);
+  prolongAndCorrect(coarse, level);
+  smooth(level, diffusion, boundary, kPostSmoothSweeps);
+
+  if (depth == 0) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, level.u.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                          level.u[i] = std::clamp(level.u[i], 0.0f, kWallConcentration);
+                        }
+                      });
+  }
+}
+
+float NutrientField::concentrationAt(float x, float y, float z) const {
+  const Level& fine = levels_.front();
+  // Position in voxel-centre units, clamped to the outermost centres, split into the lower
+  // corner of the enclosing 2x2x2 block of centres and the weight of its upper corner.
+  std::array<int, 3> lower{};
+  std::array<float, 3> weight{};
+  const std::array<float, 3> position{x, y, z};
+  const float last = static_cast<float>(fine.dim - 1);
+  for (size_t axis = 0; axis < 3; ++axis) {
+    const float centre = std::clamp((position[axis] - origin_) / fine.h - 0.5f, 0.0f, last);
+    lower[axis] = std::min(static_cast<int>(centre), std::max(0, fine.dim - 2));
+    weight[axis] = centre - static_cast<float>(lower[axis]);
+  }
+  const auto upper = [&](size_t axis) { return std::min(lower[axis] + 1, fine.dim - 1); };
+
+  float value = 0.0f;
+  for (int corner = 0; corner < 8; ++corner) {
+    const bool hx = (corner & 1) != 0;
+    const bool hy = (corner & 2) != 0;
+    const bool hz = (corner & 4) != 0;
+    const float w = (hx ? weight[0] : 1.0f - weight[0]) * (hy ? weight[1] : 1.0f - weight[1]) *
+                    (hz ? weight[2] : 1.0f - weight[2]);
+    value += w * fine.u[index(fine,
+                              hx ? upper(0) : lower[0],
+                              hy ? upper(1) : lower[1],
+                              hz ? upper(2) : lower[2])];
+  }
+  return value;
+}
+
+void NutrientField::saveState(CellEvoX::io::CheckpointWriter& writer) const {
+  writer.put<uint64_t>(levels_.size());
+  for (const auto& level : levels_) {
+    writer.putVector(level.u);
+    writer.putVector(level.f);
+  }
+  writer.put(last_residual_);
+}
+
+bool NutrientField::restoreState(CellEvoX::io::CheckpointReader& reader) {
+  uint64_t level_count = 0;
+  if (!reader.get(level_count) || level_count != levels_.size()) {
+    return false;
+  }
+  for (auto& level : levels_) {
+    const size_t size = level.u.size();
+    if (!reader.getVector(level.u) || !reader.getVector(level.f) || level.u.size() != size ||
+        level.f.size() != size) {
+      return false;
+    }
+  }
+  return reader.get(last_residual_);
+}
+
+}  // namespace CellEvoX::systems
@@ -9,12 +9,9 @@
 
 #include <Eigen/Dense>
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 #include <execution>
 #include <filesystem>
-#include <iomanip>
-#include <iostream>
 #include <limits>
 #include <random>
 #include <system_error>
@@ -22,16 +19,9 @@
 
 #include "io/PopulationSnapshotIO.hpp"
 #include "utils/MathUtils.hpp"
-#ifdef _WIN32
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#include <windows.h>
-#include <psapi.h>
-#else
-#include <unistd.h>
-#endif
+#include "systems/CheckpointState.hpp"
 #include "systems/CommonPopulationStep.hpp"
+#include "systems/EngineRuntime.hpp"
 #include "utils/SimulationConfig.hpp"
 #include "utils/PhaseProfiler.hpp"
 
@@ -98,7 +88,8 @@ void SimulationEngine::signalHandler(int signum) {
   shutdown_requested.store(true);
 }
 
-SimulationEngine::SimulationEngine(std::shared_ptr<SimulationConfig> config)
+SimulationEngine::SimulationEngine(std::shared_ptr<SimulationConfig> config,
+                                   const CellEvoX::io::EngineCheckpoint* resume)
     : actual_population(config->initial_population),
       total_deaths(0),
       tau(0.0),
@@ -120,7 +111,7 @@ SimulationEngine::SimulationEngine(std::shared_ptr<SimulationConfig> config)
   dense_cell_slot_by_id.reserve(config->initial_population);
   dense_alive_flags.reserve(config->initial_population);
 
-  for (uint32_t i = 0; i < config->initial_population; ++i) {
+  for (uint32_t i = 0; resume == nullptr && i < config->initial_population; ++i) {
     dense_cells.emplace_back(i);
     dense_alive_cell_ids.push_back(i);
     dense_cell_slot_by_id.push_back(i);
@@ -140,14 +131,34 @@ SimulationEngine::SimulationEngine(std::shared_ptr<SimulationConfig> config)
                         return sum + pair.second.probability;
                       });
 
+  population_snapshot_sink.configure(config->output_path, config->snapshot_container);
+  if (resume != nullptr) {
+    restoreCheckpoint(*resume);
+  } else if (config->population_output == PopulationOutputMode::EventLog) {
+    const auto log_path = CellEvoX::io::populationEventLogPath(config->output_path);
+    if (population_event_log.open(log_path,
+                                  0,
+                                  config->full_mutation_payload
+                                      ? CellEvoX::io::MutationPayloadKind::Full
+                                      : CellEvoX::io::MutationPayloadKind::DriverOnly)) {
+      // The initial population is logged as births so replay needs no other input.
+      logPopulationEvents({}, 0, config->initial_population);
+    } else {
+      spdlog::error("Failed to open population event log: {}", log_path);
+    }
+  }
+
   // These are informational logs; they will be filtered by spdlog's level.
   spdlog::info("=== Simulation Engine Initialized ===");
   spdlog::info("Initial population: {}, Capacity: {}", config->initial_population, config->env_capacity);
   spdlog::info("Tau step: {}, Total mutation probability: {:.6f}", config->tau_step, total_mutation_probability);
 
-  // Initialize memory logging
+  // Initialize memory logging; a resumed run continues the log restoreCheckpoint() reopened.
   const auto memory_log_path =
       std::filesystem::path(config->output_path) / "statistics" / "memory_log.csv";
+  if (resume != nullptr) {
+    return;
+  }
 
   memory_log_file.open(memory_log_path);
   if (!memory_log_file.is_open()) {
@@ -164,7 +175,7 @@ SimulationEngine::SimulationEngine(std::shared_ptr<SimulationConfig> config)
   }
 
   if (memory_log_file.is_open()) {
-      memory_log_file << "Tau,RSS_KB,Cells_Count,Graveyard_Count,Estimated_Cells_KB,Estimated_Graveyard_KB\n";
+      memory_log_file << CellEvoX::systems::kMemoryLogHeader;
   } else {
       spdlog::warn("Failed to open memory log file at: {}", memory_log_path.string());
   }
@@ -184,70 +195,30 @@ void SimulationEngine::step() {
 }
 
 void SimulationEngine::runSteps(uint32_t steps) {
-  auto last_update_time = std::chrono::steady_clock::now();
-  const char* spinner = "|/-\\";
-  int spinner_index = 0;
-  const int bar_width = 50;
-
-  auto start_time = std::chrono::steady_clock::now();
-
-  for (uint32_t i = 0; i < steps; ++i) {
-    if (shutdown_requested.load()) {
-      spdlog::info("Shutdown requested at step {}/{}", i, steps);
-      std::cout << std::endl;
-      break;
-    }
-    if (config->max_population_cutoff > 0 &&
-        actual_population >= config->max_population_cutoff) {
-      spdlog::warn("Population cutoff reached: {} >= {} at tau={:.2f}. Stopping.",
-                   actual_population, config->max_population_cutoff, tau);
-      std::cout << std::endl;
-      break;
-    }
-    step();
-    auto current_time = std::chrono::steady_clock::now();
-    auto elapsed_time =
-        std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_update_time)
-            .count();
-    if (elapsed_time >= 100) {
-      int progress = static_cast<int>((static_cast<double>(i + 1) / steps) * 100);
-      int pos = static_cast<int>((static_cast<double>(i + 1) / steps) * bar_width);
-
-      auto total_elapsed =
-          std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
-      double avg_time_per_step = static_cast<double>(total_elapsed) / (i + 1);
-      int remaining_steps = steps - (i + 1);
-      double estimated_remaining_time = remaining_steps * avg_time_per_step / 1000.0;
-
-      std::cout << "\r\033[1;32mProgress: [\033[35m";
-      for (int j = 0; j < bar_width; ++j) {
-        if (j < pos)
-          std::cout << "#";
-        else
-          std::cout << " ";
-      }
-
-      std::cout << "\033[1;32m] " << progress << "% \033[34m" << spinner[spinner_index]
-                << " \033[0m" << remaining_steps << " steps remaining, ~" << std::fixed
-                << std::setprecision(1) << estimated_remaining_time << "s left "
-                << actual_population << " cells" << std::flush;
-
-      spinner_index = (spinner_index + 1) % 4;
-      last_update_time = current_time;
-    }
-  }
-  std::cout << "\r\033[1;32mProgress: [";
-  for (int j = 0; j < bar_width; ++j) {
-    std::cout << "#";
-  }
-  std::cout << "] 100% \033[0m" << std::endl;
+  CellEvoX::systems::runEngineSteps(steps,
+                                     *config,
+                                     shutdown_requested,
+                                     actual_population,
+                                     tau,
+                                     [this] { step(); },
+                                     [this] { writeCheckpoint(); });
 }
 
 ecs::Run SimulationEngine::run(uint32_t steps) {
   runSteps(steps);
+  if (!checkpoint_writer.wait()) {
+    spdlog::error("Failed to write engine checkpoint: {}",
+                  CellEvoX::io::engineCheckpointPath(config->output_path));
+  }
 
   materializeCellsFromDense();
   materializeGraveyardFromDense();
+  if (!population_event_log.close()) {
+    spdlog::error("Failed to write population event log");
+  }
+  if (!population_snapshot_sink.close()) {
+    spdlog::error("Failed to finalize population snapshot container");
+  }
 
   return ecs::Run(std::move(cells),
                   std::move(available_mutation_types),
@@ -267,6 +238,7 @@ void SimulationEngine::stochasticStep() {
 void SimulationEngine::stochasticDenseStep() {
   CELLEVOX_PROFILE_PHASE("stochastic_step_total");
   tau += config->tau_step;
+  ++completed_steps;
 
   const double tau_step = config->tau_step;
   const size_t Nc = config->env_capacity;
@@ -486,6 +458,18 @@ void SimulationEngine::stochasticDenseStep() {
       dense_free_slots.resize(old_free_slots_size - reusable_count);
     }
 
+    if (population_event_log.isOpen()) {
+      CELLEVOX_PROFILE_PHASE("population_event_log");
+      std::vector<uint32_t> deaths;
+      deaths.reserve(dead_cell_count);
+      for (const auto* buffers : buffer_ptrs) {
+        for (const auto& death : buffers->dead_cells) {
+          deaths.push_back(death.id);
+        }
+      }
+      logPopulationEvents(std::move(deaths), starting_id, sorted_new_cells.size());
+    }
+
     if (dead_cell_count > static_cast<size_t>(max_cell_id) - total_deaths) {
       throw std::overflow_error("Cell death counter exceeds uint32_t cell id space");
     }
@@ -523,6 +507,13 @@ void SimulationEngine::stochasticDenseStep() {
     logMemoryUsage();
     last_memory_log_tau = current_tau;
   }
+
+  if (config->checkpoint_interval > 0 && current_tau % config->checkpoint_interval == 0 &&
+      current_tau != last_checkpoint_tau) {
+    CELLEVOX_PROFILE_PHASE("checkpoint");
+    last_checkpoint_tau = current_tau;
+    writeCheckpoint();
+  }
 }
 
 void SimulationEngine::takeStatSnapshot() {
@@ -620,14 +611,18 @@ void SimulationEngine::takePopulationSnapshot() {
                                 : CellEvoX::io::MutationPayloadKind::DriverOnly;
 
   CellMap cells_copy;
-  cells_copy.rehash(actual_population);
+  if (keep_population_report) {
+    cells_copy.rehash(actual_population);
+  }
   for (uint32_t id : dense_alive_cell_ids) {
     if (id >= dense_alive_flags.size() || dense_alive_flags[id] == 0) {
       continue;
     }
     const auto& cell = dense_cells[dense_cell_slot_by_id[id]];
-    CellMap::accessor accessor;
-    cells_copy.insert(accessor, {cell.id, cell});
+    if (keep_population_report) {
+      CellMap::accessor accessor;
+      cells_copy.insert(accessor, {cell.id, cell});
+    }
 
     if (mutation_payload.size() > std::numeric_limits<uint32_t>::max()) {
       spdlog::error("Population snapshot mutation payload exceeds uint32_t offset space");
@@ -635,9 +630,7 @@ void SimulationEngine::takePopulationSnapshot() {
     }
     const uint32_t mutation_payload_offset = static_cast<uint32_t>(mutation_payload.size());
     for (const auto& [mutation_id, mutation_type] : cell.mutations) {
-      const auto type_it = available_mutation_types.find(mutation_type);
-      if (config->full_mutation_payload ||
-          (type_it != available_mutation_types.end() && type_it->second.is_driver)) {
+      if (isPayloadMutation(mutation_type)) {
         mutation_payload.push_back({mutation_id, mutation_type});
       }
     }
@@ -660,14 +653,67 @@ void SimulationEngine::takePopulationSnapshot() {
          {0, 0, 0}});
   }
 
-  const auto snapshot_path =
-      CellEvoX::io::populationSnapshotPath(config->output_path, tauSnapshotIndex(tau));
-  if (!CellEvoX::io::writePopulationSnapshot(
-          snapshot_path, tau, 0, snapshot_records, mutation_payload, payload_kind)) {
-    spdlog::error("Failed to write population snapshot file: {}", snapshot_path);
+  // With an event log only keyframes need a file; the generations between them are replayed.
+  const bool keyframe = population_snapshot_count++ % config->event_log_keyframe_interval == 0;
+  if (population_event_log.isOpen()) {
+    population_event_log.appendGeneration(tauSnapshotIndex(tau), tau, keyframe);
+  }
+  if (!population_event_log.isOpen() || keyframe) {
+    const int generation = tauSnapshotIndex(tau);
+    const CellEvoX::io::PopulationSnapshotEncoding encoding{
+        config->snapshot_format == SnapshotFormat::Columnar, config->snapshot_position_quantum};
+    if (!population_snapshot_sink.write(
+            generation, tau, 0, snapshot_records, mutation_payload, payload_kind, encoding)) {
+      spdlog::error("Failed to write population snapshot file: {}",
+                    population_snapshot_sink.describe(generation));
+    }
   }
 
-  generational_popul_report.push_back({tauSnapshotIndex(tau), std::move(cells_copy)});
+  if (keep_population_report) {
+    generational_popul_report.push_back({tauSnapshotIndex(tau), std::move(cells_copy)});
+  }
+}
+
+bool SimulationEngine::isPayloadMutation(uint8_t mutation_type) const {
+  if (config->full_mutation_payload) {
+    return true;
+  }
+  const auto type_it = available_mutation_types.find(mutation_type);
+  return type_it != available_mutation_types.end() && type_it->second.is_driver;
+}
+
+// O(deaths log deaths + births). Births are the contiguous ids assigned by this step; each one
+// carries only what it adds to its parent, i.e. the mutations stamped with its own id.
+void SimulationEngine::logPopulationEvents(std::vector<uint32_t> deaths,
+                                           uint32_t first_birth_id,
+                                           size_t birth_count) {
+  std::vector<CellEvoX::io::PopulationBirthEvent> births;
+  std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> birth_payload;
+  births.reserve(birth_count);
+  for (size_t i = 0; i < birth_count; ++i) {
+    const uint32_t id = first_birth_id + static_cast<uint32_t>(i);
+    const auto& cell = dense_cells[dense_cell_slot_by_id[id]];
+    const auto payload_offset = static_cast<uint32_t>(birth_payload.size());
+    uint16_t mutations_added = 0;
+    for (const auto& [mutation_id, mutation_type] : cell.mutations) {
+      if (mutation_id != id) {
+        continue;
+      }
+      ++mutations_added;
+      if (isPayloadMutation(mutation_type)) {
+        birth_payload.push_back({mutation_id, mutation_type});
+      }
+    }
+    const bool initial_cell = id < config->initial_population;
+    births.push_back({id,
+                      cell.parent_id,
+                      cell.fitness,
+                      mutations_added,
+                      static_cast<uint16_t>(birth_payload.size() - payload_offset),
+                      payload_offset,
+                      !initial_cell && mutations_added == 0});
+  }
+  population_event_log.appendStep(tau, std::move(deaths), births, birth_payload);
 }
 
 void SimulationEngine::pruneGraveyard() {
@@ -763,45 +809,128 @@ void SimulationEngine::materializeGraveyardFromDense() {
   dense_pending_graveyard_entries.clear();
 }
 
-size_t SimulationEngine::getRSS() {
-#ifdef _WIN32
-    PROCESS_MEMORY_COUNTERS_EX counters{};
-    if (GetProcessMemoryInfo(GetCurrentProcess(),
-                             reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
-                             sizeof(counters))) {
-        return static_cast<size_t>(counters.WorkingSetSize / 1024);
-    }
-    return 0;
-#else
-    size_t rss = 0;
-    std::ifstream statm("/proc/self/statm");
-    if (statm.is_open()) {
-        size_t ignore;
-        statm >> ignore >> rss; // 2nd value is RSS in pages
+// O(cells + graveyard) on the simulation thread; only the file write is asynchronous.
+void SimulationEngine::writeCheckpoint() {
+  CellEvoX::io::CheckpointWriter writer;
+  CellEvoX::systems::saveCells(writer, dense_cells);
+  writer.putVector(dense_alive_cell_ids);
+  writer.putVector(dense_cell_slot_by_id);
+  writer.putVector(dense_alive_flags);
+  writer.putVector(dense_free_slots);
+  writer.put<uint64_t>(dense_pending_graveyard_entries.size());
+  for (const auto& [id, entry] : dense_pending_graveyard_entries) {
+    writer.put(id);
+    writer.put(entry.first);
+    writer.put(entry.second);
+  }
+  CellEvoX::systems::saveGraveyard(writer, cells_graveyard);
+  writer.putVector(generational_stat_report);
+  writer.put<uint64_t>(actual_population);
+  writer.put<uint64_t>(total_deaths);
+  writer.put(tau);
+  writer.put<int32_t>(last_stat_snapshot_tau);
+  writer.put<int32_t>(last_population_snapshot_tau);
+  writer.put<int32_t>(last_memory_log_tau);
+  writer.put<int32_t>(last_pruning_tau);
+  writer.put<int32_t>(last_checkpoint_tau);
+  writer.put<int32_t>(population_snapshot_count);
+  writer.putRng(rng);
+  writer.put(CellEvoX::systems::flushedOutputSize(memory_log_file));
+  writer.put<uint8_t>(population_event_log.isOpen() ? 1 : 0);
+  if (population_event_log.isOpen()) {
+    const auto log_point = population_event_log.resumePoint();
+    writer.put(log_point.file_size);
+    writer.putVector(log_point.block);
+    writer.put(log_point.block_keyframe);
+  }
+
+  const auto path = CellEvoX::io::engineCheckpointPath(config->output_path);
+  if (!checkpoint_writer.submit(path,
+                                CellEvoX::systems::makeCheckpointHeader(*config, completed_steps),
+                                std::move(writer.bytes()))) {
+    spdlog::error("Failed to write engine checkpoint: {}", path);
+  }
+}
+
+void SimulationEngine::restoreCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint) {
+  CellEvoX::systems::requireMatchingCheckpoint(checkpoint, *config);
+  auto reader = checkpoint.reader();
+  CellEvoX::systems::restoreCells(reader, dense_cells);
+  reader.getVector(dense_alive_cell_ids);
+  reader.getVector(dense_cell_slot_by_id);
+  reader.getVector(dense_alive_flags);
+  reader.getVector(dense_free_slots);
+  uint64_t pending_count = 0;
+  reader.get(pending_count);
+  dense_pending_graveyard_entries.clear();
+  for (uint64_t i = 0; i < pending_count && reader.ok(); ++i) {
+    auto& entry = dense_pending_graveyard_entries.emplace_back();
+    reader.get(entry.first);
+    reader.get(entry.second.first);
+    reader.get(entry.second.second);
+  }
+  CellEvoX::systems::restoreGraveyard(reader, cells_graveyard);
+  reader.getVector(generational_stat_report);
+  uint64_t population = 0;
+  uint64_t deaths = 0;
+  reader.get(population);
+  reader.get(deaths);
+  reader.get(tau);
+  reader.get(last_stat_snapshot_tau);
+  reader.get(last_population_snapshot_tau);
+  reader.get(last_memory_log_tau);
+  reader.get(last_pruning_tau);
+  reader.get(last_checkpoint_tau);
+  reader.get(population_snapshot_count);
+  reader.getRng(rng);
+  uint64_t memory_log_size = 0;
+  reader.get(memory_log_size);
+  uint8_t has_event_log = 0;
+  reader.get(has_event_log);
+  CellEvoX::io::PopulationEventLogResumePoint log_point;
+  if (has_event_log != 0) {
+    reader.get(log_point.file_size);
+    reader.getVector(log_point.block);
+    reader.get(log_point.block_keyframe);
+  }
+  CellEvoX::systems::requireCompleteCheckpoint(reader);
+  if (dense_cell_slot_by_id.size() != dense_alive_flags.size() ||
+      std::any_of(dense_cell_slot_by_id.begin(), dense_cell_slot_by_id.end(),
+                  [&](uint32_t slot) { return slot >= dense_cells.size(); })) {
+    throw std::runtime_error("Engine checkpoint has inconsistent dense cell indices");
+  }
+
+  actual_population = static_cast<size_t>(population);
+  total_deaths = static_cast<size_t>(deaths);
+  completed_steps = checkpoint.header.completed_steps;
+  cells.clear();
+  alive_cell_indices_cache.clear();
+  cells_dirty_from_dense = true;
+  keep_population_report = false;
+
+  // Outputs written after the checkpoint are cut off and written again by this run.
+  if (!population_snapshot_sink.resume(last_population_snapshot_tau)) {
+    spdlog::error("Failed to rewind population snapshots to generation {}",
+                  last_population_snapshot_tau);
+  }
+  if (has_event_log != 0) {
+    const auto log_path = CellEvoX::io::populationEventLogPath(config->output_path);
+    if (!population_event_log.resume(log_path, log_point)) {
+      spdlog::error("Failed to resume population event log: {}", log_path);
     }
-    long page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
-    return rss * page_size_kb;
-#endif
+  }
+  const auto memory_log_path =
+      std::filesystem::path(config->output_path) / "statistics" / "memory_log.csv";
+  if (!CellEvoX::systems::resumeOutputFile(memory_log_file, memory_log_path, memory_log_size)) {
+    spdlog::warn("Failed to resume memory log file at: {}", memory_log_path.string());
+  }
+  spdlog::info("Resumed from checkpoint at tau={:.4f} after {} steps", tau, completed_steps);
 }
 
 void SimulationEngine::logMemoryUsage() {
-    if (!memory_log_file.is_open()) return;
-
-    size_t rss_kb = getRSS();
-    size_t cells_count = actual_population;
-    size_t graveyard_count = cells_graveyard.size() + dense_pending_graveyard_entries.size();
-    
-    // Estimations
-    size_t estimated_cells_kb = (cells_count * sizeof(Cell)) / 1024;
-    // Graveyard value is pair<uint32_t, double> (12 bytes) + key (4 bytes) + overhead (~16-24 bytes node)
-    // bucket overhead etc. TBB map is complex. 
-    // Approx 32-48 bytes per entry?
-    size_t estimated_graveyard_kb = (graveyard_count * 48) / 1024; 
-
-    memory_log_file << tau << "," 
-                    << rss_kb << "," 
-                    << cells_count << "," 
-                    << graveyard_count << ","
-                    << estimated_cells_kb << ","
-                    << estimated_graveyard_kb << "\n";
+  CellEvoX::systems::appendMemoryLogRow(
+      memory_log_file,
+      tau,
+      actual_population,
+      cells_graveyard.size() + dense_pending_graveyard_entries.size());
 }
@@ -4,30 +4,23 @@
 #include <tbb/blocked_range.h>
 #include <tbb/combinable.h>
 #include <tbb/parallel_for.h>
-#include <tbb/task_arena.h>
 
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 #include <filesystem>
-#include <iomanip>
-#include <iostream>
 #include <limits>
+#include <numbers>
 #include <numeric>
 #include <random>
+#include <stdexcept>
 #include <system_error>
-#include <unordered_set>
 
 #include "io/PopulationSnapshotIO.hpp"
-#ifdef _WIN32
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#include <windows.h>
-#include <psapi.h>
-#else
-#include <unistd.h>
-#endif
+#include "io/VoxelAggregateIO.hpp"
+#include "spatial/NeighborKernels.hpp"
+#include "systems/CheckpointState.hpp"
+#include "systems/EngineRuntime.hpp"
+#include "utils/DeterministicRng.hpp"
 
 namespace {
 
@@ -38,9 +31,21 @@ int tauSnapshotIndex(double tau_value) {
 }
 
 constexpr uint32_t kInvalidSpatialIndex = std::numeric_limits<uint32_t>::max();
+// Slots absent before a change are newborns to the neighbor list remap.
+static_assert(kInvalidSpatialIndex == VerletNeighborList::kNewSlot);
 constexpr float kBirthSuppressionFloor = 0.01f;
 constexpr float kDeathRateFloor = 0.01f;
 constexpr float kCrowdingPenaltySplit = 0.5f;
+// Extra death rate of cells whose nutrient concentration is below the necrosis threshold.
+constexpr float kNecrosisDeathRate = 1.0f;
+
+// Counter-based streams per (step, cell id), so draws do not depend on which worker evaluates a
+// cell or how the work is split.
+constexpr uint64_t kDeathStream = 0;
+constexpr uint64_t kBirthStream = 1;
+constexpr uint64_t kMutationStream = 2;
+constexpr uint64_t kDirectionZStream = 3;
+constexpr uint64_t kDirectionAzimuthStream = 4;
 
 }  // namespace
 
@@ -51,7 +56,8 @@ void SimulationEngine3D::signalHandler(int signum) {
   shutdown_requested.store(true);
 }
 
-SimulationEngine3D::SimulationEngine3D(std::shared_ptr<SimulationConfig> config)
+SimulationEngine3D::SimulationEngine3D(std::shared_ptr<SimulationConfig> config,
+                                       const CellEvoX::io::EngineCheckpoint* resume)
     : actual_population(config->initial_population),
       total_deaths(0),
       tau(0.0),
@@ -59,7 +65,11 @@ SimulationEngine3D::SimulationEngine3D(std::shared_ptr<SimulationConfig> config)
       next_cell_id_(static_cast<uint32_t>(config->initial_population)),
       config(std::move(config)),
       rng(this->config->seed),
-      spatial_grid_(2.0f * CELL_RADIUS, this->config->spatial_domain_size) {
+      spatial_grid_(2.0f * CELL_RADIUS, this->config->spatial_domain_size),
+      mechanics_(*this->config, 2.0f * CELL_RADIUS),
+      spatial_reorder_(2.0f * CELL_RADIUS) {
+  snapshot_sink_.configure(this->config->output_path, this->config->snapshot_container);
+
   switch (this->config->verbosity) {
     case 0:
       spdlog::set_level(spdlog::level::off);
@@ -86,7 +96,7 @@ SimulationEngine3D::SimulationEngine3D(std::shared_ptr<SimulationConfig> config)
   }
 
   cells.rehash(this->config->initial_population * 2 + 1);
-  for (uint32_t id = 0; id < this->config->initial_population; ++id) {
+  for (uint32_t id = 0; resume == nullptr && id < this->config->initial_population; ++id) {
     cells.insert({id, Cell(id)});
   }
 
@@ -102,14 +112,17 @@ SimulationEngine3D::SimulationEngine3D(std::shared_ptr<SimulationConfig> config)
                         return sum + mutation.second.probability;
                       });
 
-  initializePopulationPositions();
-  rebuildSpatialState();
+  if (resume != nullptr) {
+    restoreCheckpoint(*resume);
+  } else {
+    initializePopulationPositions();
+    rebuildSpatialState();
 
-  const std::string memory_log_path = this->config->output_path + "/statistics/memory_log.csv";
-  memory_log_file.open(memory_log_path);
-  if (memory_log_file.is_open()) {
-    memory_log_file << "Tau,RSS_KB,Cells_Count,Graveyard_Count,Estimated_Cells_KB,"
-                       "Estimated_Graveyard_KB\n";
+    const std::string memory_log_path = this->config->output_path + "/statistics/memory_log.csv";
+    memory_log_file.open(memory_log_path);
+    if (memory_log_file.is_open()) {
+      memory_log_file << CellEvoX::systems::kMemoryLogHeader;
+    }
   }
 
   spdlog::info("=== Spatial 3D Simulation Engine Initialized ===");
@@ -120,61 +133,21 @@ SimulationEngine3D::SimulationEngine3D(std::shared_ptr<SimulationConfig> config)
 }
 
 ecs::Run SimulationEngine3D::run(uint32_t steps) {
-  auto last_update_time = std::chrono::steady_clock::now();
-  const char* spinner = "|/-\\";
-  int spinner_index = 0;
-  const int bar_width = 50;
-
-  const auto start_time = std::chrono::steady_clock::now();
-  for (uint32_t i = 0; i < steps; ++i) {
-    if (shutdown_requested.load()) {
-      spdlog::info("Shutdown requested at step {}/{}", i, steps);
-      std::cout << std::endl;
-      break;
-    }
-    if (config->max_population_cutoff > 0 &&
-        actual_population >= config->max_population_cutoff) {
-      spdlog::warn("Population cutoff reached: {} >= {} at tau={:.2f}. Stopping.",
-                   actual_population, config->max_population_cutoff, tau);
-      std::cout << std::endl;
-      break;
-    }
+  CellEvoX::systems::runEngineSteps(steps,
+                                     *config,
+                                     shutdown_requested,
+                                     actual_population,
+                                     tau,
+                                     [this] { step(); },
+                                     [this] { writeCheckpoint(); });
 
-    step();
-
-    const auto current_time = std::chrono::steady_clock::now();
-    const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                  current_time - last_update_time)
-                                  .count();
-
-    if (elapsed_time >= 100) {
-      const int progress = static_cast<int>((static_cast<double>(i + 1) / steps) * 100.0);
-      const int pos = static_cast<int>((static_cast<double>(i + 1) / steps) * bar_width);
-      const auto total_elapsed =
-          std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
-      const double avg_time_per_step = static_cast<double>(total_elapsed) / (i + 1);
-      const int remaining_steps = steps - (i + 1);
-      const double estimated_remaining_time = remaining_steps * avg_time_per_step / 1000.0;
-
-      std::cout << "\r\033[1;32mProgress: [\033[35m";
-      for (int j = 0; j < bar_width; ++j) {
-        std::cout << (j < pos ? '#' : ' ');
-      }
-      std::cout << "\033[1;32m] " << progress << "% \033[34m" << spinner[spinner_index]
-                << " \033[0m" << remaining_steps << " steps remaining, ~" << std::fixed
-                << std::setprecision(1) << estimated_remaining_time << "s left " << cells.size()
-                << " cells" << std::flush;
-
-      spinner_index = (spinner_index + 1) % 4;
-      last_update_time = current_time;
-    }
+  if (!checkpoint_writer_.wait()) {
+    spdlog::error("Failed to write engine checkpoint: {}",
+                  CellEvoX::io::engineCheckpointPath(config->output_path));
   }
-
-  std::cout << "\r\033[1;32mProgress: [";
-  for (int j = 0; j < bar_width; ++j) {
-    std::cout << "#";
+  if (!snapshot_sink_.close()) {
+    spdlog::error("Failed to finalize population snapshot container");
   }
-  std::cout << "] 100% \033[0m" << std::endl;
 
   return ecs::Run(std::move(cells),
                   std::move(available_mutation_types),
@@ -194,10 +167,11 @@ void SimulationEngine3D::step() {
 void SimulationEngine3D::stop() { spdlog::info("Spatial 3D simulation stopped"); }
 
 void SimulationEngine3D::initializePopulationPositions() {
-  id_pos_x_.assign(next_cell_id_, 0.0f);
-  id_pos_y_.assign(next_cell_id_, 0.0f);
-  id_pos_z_.assign(next_cell_id_, 0.0f);
-  id_to_spatial_index_.assign(next_cell_id_, kInvalidSpatialIndex);
+  // The initial cells are the first "births": ids 0..N-1 placed through the birth buffers.
+  birth_first_id_ = 0;
+  birth_pos_x_.assign(next_cell_id_, 0.0f);
+  birth_pos_y_.assign(next_cell_id_, 0.0f);
+  birth_pos_z_.assign(next_cell_id_, 0.0f);
 
   const uint32_t initial_population = static_cast<uint32_t>(config->initial_population);
   if (initial_population == 0) {
@@ -215,47 +189,96 @@ void SimulationEngine3D::initializePopulationPositions() {
     const uint32_t iy = (id / cells_per_axis) % cells_per_axis;
     const uint32_t iz = id / (cells_per_axis * cells_per_axis);
 
-    id_pos_x_[id] =
+    birth_pos_x_[id] =
         clampToDomain((static_cast<float>(ix) + 0.5f) * spacing + jitter_dist(rng));
-    id_pos_y_[id] =
+    birth_pos_y_[id] =
         clampToDomain((static_cast<float>(iy) + 0.5f) * spacing + jitter_dist(rng));
-    id_pos_z_[id] =
+    birth_pos_z_[id] =
         clampToDomain((static_cast<float>(iz) + 0.5f) * spacing + jitter_dist(rng));
   }
 }
 
 void SimulationEngine3D::rebuildSpatialState() {
-  for (uint32_t id : spatial_state_.cell_ids) {
-    if (id < id_to_spatial_index_.size()) {
-      id_to_spatial_index_[id] = kInvalidSpatialIndex;
-    }
-  }
-
+  // The previous arrays stay readable through id_to_spatial_index_ until it is reassigned below.
+  previous_cell_ids_.swap(spatial_state_.cell_ids);
+  previous_pos_x_.swap(spatial_state_.pos_x);
+  previous_pos_y_.swap(spatial_state_.pos_y);
+  previous_pos_z_.swap(spatial_state_.pos_z);
   spatial_state_.cell_ids.clear();
   spatial_state_.pos_x.clear();
   spatial_state_.pos_y.clear();
   spatial_state_.pos_z.clear();
 
-  spatial_state_.cell_ids.reserve(cells.size());
-  for (const auto& cell_entry : cells) {
-    spatial_state_.cell_ids.push_back(cell_entry.first);
+  if (config->spatial_reorder == SpatialReorderMode::None) {
+    spatial_state_.cell_ids.clear();
+    spatial_state_.cell_ids.reserve(cells.size());
+    for (const auto& cell_entry : cells) {
+      spatial_state_.cell_ids.push_back(cell_entry.first);
+    }
+    std::sort(spatial_state_.cell_ids.begin(), spatial_state_.cell_ids.end());
+  } else {
+    // Survivors keep their slot order and ids issued since the last rebuild are appended,
+    // so a Morton order only decays with the cells born since the last reorder.
+    spatial_state_.cell_ids.reserve(cells.size());
+    for (uint32_t id : previous_cell_ids_) {
+      if (cells.count(id) != 0) {
+        spatial_state_.cell_ids.push_back(id);
+      }
+    }
+    for (uint32_t id = spatial_ids_end_; id < next_cell_id_; ++id) {
+      if (cells.count(id) != 0) {
+        spatial_state_.cell_ids.push_back(id);
+      }
+    }
   }
-  std::sort(spatial_state_.cell_ids.begin(), spatial_state_.cell_ids.end());
+  spatial_ids_end_ = next_cell_id_;
 
   spatial_state_.pos_x.reserve(spatial_state_.cell_ids.size());
   spatial_state_.pos_y.reserve(spatial_state_.cell_ids.size());
   spatial_state_.pos_z.reserve(spatial_state_.cell_ids.size());
 
-  // O(N) gather from the persistent id-indexed position store.
-  for (size_t i = 0; i < spatial_state_.cell_ids.size(); ++i) {
-    const uint32_t id = spatial_state_.cell_ids[i];
-    ensurePositionCapacity(id);
-    spatial_state_.pos_x.push_back(id_pos_x_[id]);
-    spatial_state_.pos_y.push_back(id_pos_y_[id]);
-    spatial_state_.pos_z.push_back(id_pos_z_[id]);
-    id_to_spatial_index_[id] = static_cast<uint32_t>(i);
+  // O(N) gather: survivors from their previous slot, newborns from the birth buffers.
+  for (const uint32_t id : spatial_state_.cell_ids) {
+    const uint32_t previous = id_to_spatial_index_.find(id);
+    const size_t birth = static_cast<size_t>(id - birth_first_id_);
+    if (previous != kInvalidSpatialIndex) {
+      spatial_state_.pos_x.push_back(previous_pos_x_[previous]);
+      spatial_state_.pos_y.push_back(previous_pos_y_[previous]);
+      spatial_state_.pos_z.push_back(previous_pos_z_[previous]);
+    } else if (id >= birth_first_id_ && birth < birth_pos_x_.size()) {
+      spatial_state_.pos_x.push_back(birth_pos_x_[birth]);
+      spatial_state_.pos_y.push_back(birth_pos_y_[birth]);
+      spatial_state_.pos_z.push_back(birth_pos_z_[birth]);
+    } else {
+      spdlog::error("Cell {} is neither a survivor nor a staged birth", id);
+      throw std::runtime_error("Spatial state is out of sync with cell ids");
+    }
   }
 
+  // A reorder only permutes slots, which the neighbor list remap below follows like any other
+  // change of slot.
+  if (config->spatial_reorder == SpatialReorderMode::Morton) {
+    spatial_reorder_.maybeReorder(spatial_state_.cell_ids,
+                                  spatial_state_.pos_x,
+                                  spatial_state_.pos_y,
+                                  spatial_state_.pos_z,
+                                  config->spatial_reorder_degradation);
+  }
+  if (mechanics_.neighborList().valid()) {
+    // Survivors' previous slots, read before the index is reassigned; births map to none.
+    previous_slots_.resize(spatial_state_.cell_ids.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, previous_slots_.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+          for (size_t i = range.begin(); i != range.end(); ++i) {
+            previous_slots_[i] = id_to_spatial_index_.find(spatial_state_.cell_ids[i]);
+          }
+        });
+    mechanics_.remapNeighborList(
+        previous_slots_, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
+  }
+  id_to_spatial_index_.assign(spatial_state_.cell_ids);
+
   spatial_grid_.rebuild(
       spatial_state_.cell_ids, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
 }
@@ -263,56 +286,78 @@ void SimulationEngine3D::rebuildSpatialState() {
 void SimulationEngine3D::stochasticStep3D() {
   const float tau_step = static_cast<float>(config->tau_step);
   tau += tau_step;
+  ++completed_steps_;
 
   if (spatial_state_.cell_ids.empty()) {
     return;
   }
 
   const float sample_radius = std::max(config->sample_radius, 0.1f);
-  const float sample_radius_sq = sample_radius * sample_radius;
   const float max_local_density = std::max(config->max_local_density, 1.0f);
 
+  const bool use_active_set = config->active_set;
+  if (use_active_set) {
+    active_set_.beginStep(spatial_grid_, ++step_index_, config->active_set_dormant_interval);
+    // Displacements measured by the previous relaxation keep their voxels awake.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, spatial_state_.cell_ids.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                          if (i < moved_.size() && moved_[i] != 0) {
+                            active_set_.markBusy(static_cast<uint32_t>(i));
+                          }
+                        }
+                      });
+  }
+  const size_t work_count =
+      use_active_set ? active_set_.dueCells().size() : spatial_state_.cell_ids.size();
+
+  const bool use_density_field = config->density_estimator == DensityEstimatorMode::Field;
+  if (use_density_field) {
+    density_field_.build(spatial_grid_, sample_radius);
+  }
+  const bool use_nutrients = config->nutrient_field;
+  if (use_nutrients) {
+    if (!nutrient_field_) {
+      nutrient_field_.emplace(spatial_grid_);
+    }
+    nutrient_field_->update(*config, spatial_grid_);
+  }
+  const float hypoxia_threshold = config->nutrient_hypoxia_threshold;
+  const float necrosis_threshold = config->nutrient_necrosis_threshold;
+
   tbb::combinable<std::vector<PendingBirth>> births_per_thread;
   tbb::combinable<std::vector<PendingDeath>> deaths_per_thread;
 
-  // O(N) over active cells; each density query inspects a fixed voxel neighborhood.
+  // O(N) over due cells; each exact density query inspects a fixed voxel neighborhood and each
+  // field query eight field voxels.
   tbb::parallel_for(
-      tbb::blocked_range<size_t>(0, spatial_state_.cell_ids.size()),
+      tbb::blocked_range<size_t>(0, work_count),
       [&](const tbb::blocked_range<size_t>& range) {
         auto& local_births = births_per_thread.local();
         auto& local_deaths = deaths_per_thread.local();
-        std::exponential_distribution<float> exp_dist(1.0f);
-        std::uniform_real_distribution<float> unif_dist(0.0f, 1.0f);
-        std::mt19937& local_rng = getThreadLocalRng();
 
-        for (size_t i = range.begin(); i != range.end(); ++i) {
+        for (size_t k = range.begin(); k != range.end(); ++k) {
+          const size_t i = use_active_set ? active_set_.dueCells()[k] : k;
+          // Cells of a dormant voxel draw once for every step they were skipped.
+          const float step_tau =
+              use_active_set ? tau_step * static_cast<float>(active_set_.dueElapsedSteps()[k])
+                             : tau_step;
           const uint32_t id = spatial_state_.cell_ids[i];
           const float x = spatial_state_.pos_x[i];
           const float y = spatial_state_.pos_y[i];
           const float z = spatial_state_.pos_z[i];
 
-          uint32_t local_density = 0;
-          spatial_grid_.queryRadius(x, y, z, sample_radius, [&](uint32_t neighbor_id) {
-            if (neighbor_id == id) {
-              return;
-            }
-
-            const uint32_t neighbor_index = id_to_spatial_index_[neighbor_id];
-            if (neighbor_index == kInvalidSpatialIndex) {
-              return;
-            }
+          // The cell itself is counted once; the subtraction is done in float so a grid that
+          // does not hold the cell yields zero rather than a wrapped count.
+          const float local_density =
+              use_density_field
+                  ? std::max(0.0f, density_field_.sample(x, y, z) - 1.0f)
+                  : std::max(0.0f,
+                             static_cast<float>(CellEvoX::spatial::countNeighborsWithin(
+                                 spatial_grid_, x, y, z, sample_radius)) -
+                                 1.0f);
 
-            const float dx = spatial_state_.pos_x[neighbor_index] - x;
-            const float dy = spatial_state_.pos_y[neighbor_index] - y;
-            const float dz = spatial_state_.pos_z[neighbor_index] - z;
-            const float dist_sq = dx * dx + dy * dy + dz * dz;
-            if (dist_sq <= sample_radius_sq) {
-              ++local_density;
-            }
-          });
-
-          const float crowding_ratio =
-              static_cast<float>(local_density) / max_local_density;
+          const float crowding_ratio = local_density / max_local_density;
 
           CellMap::const_accessor cell_accessor;
           if (!cells.find(cell_accessor, id)) {
@@ -320,32 +365,59 @@ void SimulationEngine3D::stochasticStep3D() {
           }
           const Cell parent = cell_accessor->second;
 
+          // Hypoxic cells divide proportionally slower and starved cells die off.
+          float nutrient_birth_factor = 1.0f;
+          float necrosis_rate = 0.0f;
+          if (use_nutrients) {
+            const float concentration = nutrient_field_->concentrationAt(x, y, z);
+            if (concentration < hypoxia_threshold) {
+              nutrient_birth_factor = concentration / hypoxia_threshold;
+            }
+            if (concentration < necrosis_threshold) {
+              necrosis_rate = kNecrosisDeathRate;
+            }
+          }
+
           // Split the crowding penalty between death and proliferation so the
           // neutral population stays approximately balanced near local capacity.
           const float death_rate =
-              std::max(kDeathRateFloor, kCrowdingPenaltySplit * crowding_ratio);
-          const float birth_rate =
-              std::max(kBirthSuppressionFloor,
-                       static_cast<float>(parent.fitness) *
-                           (1.0f - kCrowdingPenaltySplit * crowding_ratio));
+              std::max(kDeathRateFloor, kCrowdingPenaltySplit * crowding_ratio) + necrosis_rate;
+          const float unsuppressed_birth_rate =
+              static_cast<float>(parent.fitness) *
+              (1.0f - kCrowdingPenaltySplit * crowding_ratio) * nutrient_birth_factor;
+          const float birth_rate = std::max(kBirthSuppressionFloor, unsuppressed_birth_rate);
+          if (use_active_set && unsuppressed_birth_rate > kBirthSuppressionFloor) {
+            active_set_.markBusy(static_cast<uint32_t>(i));
+          }
 
-          const float death_prob = exp_dist(local_rng) / death_rate;
-          const float birth_prob = exp_dist(local_rng) / birth_rate;
+          const float death_prob = static_cast<float>(CellEvoX::deterministic_rng::exponential01(
+                                       config->seed, completed_steps_, id, kDeathStream)) /
+                                   death_rate;
+          const float birth_prob = static_cast<float>(CellEvoX::deterministic_rng::exponential01(
+                                       config->seed, completed_steps_, id, kBirthStream)) /
+                                   birth_rate;
 
-          if (death_prob < tau_step) {
+          if (death_prob < step_tau) {
             local_deaths.push_back({id, parent.parent_id});
+            if (use_active_set) {
+              active_set_.markChanged(static_cast<uint32_t>(i));
+            }
             continue;
           }
 
-          if (birth_prob >= tau_step) {
+          if (birth_prob >= step_tau) {
             continue;
           }
 
           local_deaths.push_back({id, parent.parent_id});
+          if (use_active_set) {
+            active_set_.markChanged(static_cast<uint32_t>(i));
+          }
 
           // Symmetric placement avoids a persistent center-of-mass drift at division.
           const Eigen::Vector3f offset =
-              sampleRandomUnitVector(local_rng) * (config->epsilon * CELL_RADIUS * 0.5f);
+              sampleDivisionDirection(completed_steps_, id) *
+              (config->epsilon * CELL_RADIUS * 0.5f);
 
           PendingBirth first_daughter{Cell(parent, parent.fitness),
                                       clampToDomain(x - offset.x()),
@@ -356,7 +428,8 @@ void SimulationEngine3D::stochasticStep3D() {
                                        clampToDomain(y + offset.y()),
                                        clampToDomain(z + offset.z())};
 
-          const float mutation_roll = unif_dist(local_rng);
+          const float mutation_roll = static_cast<float>(CellEvoX::deterministic_rng::uniform01(
+              config->seed, completed_steps_, id, kMutationStream));
           if (mutation_roll < static_cast<float>(total_mutation_probability)) {
             float cumulative_probability = 0.0f;
             for (const auto& [mutation_id, mutation] : available_mutation_types) {
@@ -375,6 +448,10 @@ void SimulationEngine3D::stochasticStep3D() {
         }
       });
 
+  if (use_active_set) {
+    active_set_.endStep();
+  }
+
   std::vector<PendingDeath> pending_deaths;
   deaths_per_thread.combine_each(
       [&](const std::vector<PendingDeath>& local_deaths) {
@@ -423,6 +500,11 @@ void SimulationEngine3D::stochasticStep3D() {
     cells.erase(death.id);
   }
 
+  const uint32_t first_birth_id = next_cell_id_;
+  birth_first_id_ = first_birth_id;
+  birth_pos_x_.resize(pending_births.size());
+  birth_pos_y_.resize(pending_births.size());
+  birth_pos_z_.resize(pending_births.size());
   for (auto& birth : pending_births) {
     const uint32_t new_id = next_cell_id_++;
     birth.cell.id = new_id;
@@ -432,10 +514,9 @@ void SimulationEngine3D::stochasticStep3D() {
       }
     }
 
-    ensurePositionCapacity(new_id);
-    id_pos_x_[new_id] = birth.x;
-    id_pos_y_[new_id] = birth.y;
-    id_pos_z_[new_id] = birth.z;
+    birth_pos_x_[new_id - first_birth_id] = birth.x;
+    birth_pos_y_[new_id - first_birth_id] = birth.y;
+    birth_pos_z_[new_id - first_birth_id] = birth.z;
 
     CellMap::accessor accessor;
     if (!cells.insert(accessor, {new_id, std::move(birth.cell)})) {
@@ -447,12 +528,35 @@ void SimulationEngine3D::stochasticStep3D() {
   actual_population = cells.size();
 
   rebuildSpatialState();
+  if (use_active_set) {
+    // Carry the frozen flags over to the rebuilt slot order; newborns are never frozen.
+    const auto& frozen = active_set_.frozenCells();
+    relax_frozen_.assign(spatial_state_.cell_ids.size(), 0);
+    for (size_t i = 0; i < frozen.size() && i < previous_cell_ids_.size(); ++i) {
+      if (frozen[i] == 0) {
+        continue;
+      }
+      const uint32_t slot = id_to_spatial_index_.find(previous_cell_ids_[i]);
+      if (slot != kInvalidSpatialIndex) {
+        relax_frozen_[slot] = frozen[i];
+      }
+    }
+  }
+  if (config->mech_local) {
+    relax_seeds_.clear();
+    for (uint32_t id = first_birth_id; id < next_cell_id_; ++id) {
+      const uint32_t slot = id_to_spatial_index_.find(id);
+      if (slot != kInvalidSpatialIndex) {
+        relax_seeds_.push_back(slot);
+      }
+    }
+  }
   mechanicalRelaxationStep();
 
   const int current_tau = tauSnapshotIndex(tau);
   if (config->stat_res > 0 && current_tau % config->stat_res == 0 &&
       current_tau != last_stat_snapshot_tau) {
-    takeStatSnapshot();
+    generational_stat_report.push_back(CellEvoX::systems::computeStatSnapshot(cells, tau));
     last_stat_snapshot_tau = current_tau;
   }
 
@@ -466,15 +570,22 @@ void SimulationEngine3D::stochasticStep3D() {
       current_tau > 0 &&
       current_tau % config->graveyard_pruning_interval == 0 &&
       current_tau != last_pruning_tau) {
-    pruneGraveyard();
+    CellEvoX::systems::pruneUnreachableGraveyard(cells, cells_graveyard);
     last_pruning_tau = current_tau;
   }
 
   if (config->stat_res > 0 && current_tau % config->stat_res == 0 &&
       current_tau != last_memory_log_tau) {
-    logMemoryUsage();
+    CellEvoX::systems::appendMemoryLogRow(
+        memory_log_file, tau, cells.size(), cells_graveyard.size());
     last_memory_log_tau = current_tau;
   }
+
+  if (config->checkpoint_interval > 0 && current_tau % config->checkpoint_interval == 0 &&
+      current_tau != last_checkpoint_tau) {
+    last_checkpoint_tau = current_tau;
+    writeCheckpoint();
+  }
 }
 
 void SimulationEngine3D::mechanicalRelaxationStep() {
@@ -483,178 +594,47 @@ void SimulationEngine3D::mechanicalRelaxationStep() {
     return;
   }
 
-  const float interaction_radius = 2.0f * CELL_RADIUS;
-  const float interaction_radius_sq = interaction_radius * interaction_radius;
-
-  std::vector<float> read_x = spatial_state_.pos_x;
-  std::vector<float> read_y = spatial_state_.pos_y;
-  std::vector<float> read_z = spatial_state_.pos_z;
-  std::vector<float> write_x = read_x;
-  std::vector<float> write_y = read_y;
-  std::vector<float> write_z = read_z;
-
-  for (int substep = 0; substep < config->mech_substeps; ++substep) {
-    spatial_grid_.rebuild(spatial_state_.cell_ids, read_x, read_y, read_z);
-
-    // O(N) over active cells with constant-radius neighbor lookups.
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, count),
-        [&](const tbb::blocked_range<size_t>& range) {
-          for (size_t i = range.begin(); i != range.end(); ++i) {
-            const float xi = read_x[i];
-            const float yi = read_y[i];
-            const float zi = read_z[i];
-
-            Eigen::Vector3f force = Eigen::Vector3f::Zero();
-            spatial_grid_.queryRadius(xi, yi, zi, interaction_radius, [&](uint32_t neighbor_id) {
-              const uint32_t neighbor_index = id_to_spatial_index_[neighbor_id];
-              if (neighbor_index == kInvalidSpatialIndex || neighbor_index == i) {
-                return;
-              }
-
-              const float dx = xi - read_x[neighbor_index];
-              const float dy = yi - read_y[neighbor_index];
-              const float dz = zi - read_z[neighbor_index];
-              const float dist_sq = dx * dx + dy * dy + dz * dz;
-              if (dist_sq <= 1e-12f || dist_sq >= interaction_radius_sq) {
-                return;
-              }
-
-              const float dist = std::sqrt(dist_sq);
-              const float overlap = interaction_radius - dist;
-              if (overlap <= 0.0f) {
-                return;
-              }
-
-              const float scale = config->spring_constant * overlap / dist;
-              force.x() += scale * dx;
-              force.y() += scale * dy;
-              force.z() += scale * dz;
-            });
-
-            write_x[i] = clampToDomain(xi + force.x() * config->mech_dt);
-            write_y[i] = clampToDomain(yi + force.y() * config->mech_dt);
-            write_z[i] = clampToDomain(zi + force.z() * config->mech_dt);
-          }
-        });
-
-    read_x.swap(write_x);
-    read_y.swap(write_y);
-    read_z.swap(write_z);
+  const std::vector<uint8_t>* frozen = config->active_set ? &relax_frozen_ : nullptr;
+  if (config->active_set) {
+    relax_start_x_ = spatial_state_.pos_x;
+    relax_start_y_ = spatial_state_.pos_y;
+    relax_start_z_ = spatial_state_.pos_z;
+  }
+  if (config->mech_local) {
+    mechanics_.relaxLocal(*config,
+                          spatial_state_.cell_ids,
+                          spatial_state_.pos_x,
+                          spatial_state_.pos_y,
+                          spatial_state_.pos_z,
+                          spatial_grid_,
+                          relax_seeds_,
+                          frozen);
+  } else {
+    mechanics_.relax(*config,
+                     spatial_state_.cell_ids,
+                     spatial_state_.pos_x,
+                     spatial_state_.pos_y,
+                     spatial_state_.pos_z,
+                     spatial_grid_,
+                     frozen);
+  }
+  if (!config->active_set) {
+    return;
   }
 
-  spatial_state_.pos_x = std::move(read_x);
-  spatial_state_.pos_y = std::move(read_y);
-  spatial_state_.pos_z = std::move(read_z);
-
+  const float tolerance_sq =
+      config->active_set_displacement_tolerance * config->active_set_displacement_tolerance;
+  moved_.resize(count);
   tbb::parallel_for(
       tbb::blocked_range<size_t>(0, count),
       [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i != range.end(); ++i) {
-          const uint32_t id = spatial_state_.cell_ids[i];
-          id_pos_x_[id] = spatial_state_.pos_x[i];
-          id_pos_y_[id] = spatial_state_.pos_y[i];
-          id_pos_z_[id] = spatial_state_.pos_z[i];
+          const float dx = spatial_state_.pos_x[i] - relax_start_x_[i];
+          const float dy = spatial_state_.pos_y[i] - relax_start_y_[i];
+          const float dz = spatial_state_.pos_z[i] - relax_start_z_[i];
+          moved_[i] = dx * dx + dy * dy + dz * dz > tolerance_sq ? 1 : 0;
         }
       });
-
-  spatial_grid_.rebuild(
-      spatial_state_.cell_ids, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
-}
-
-void SimulationEngine3D::takeStatSnapshot() {
-  const size_t living_cells_count = cells.size();
-  if (living_cells_count == 0) {
-    generational_stat_report.push_back(
-        {tau, 0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0, 0.0});
-    return;
-  }
-
-  double total_fitness = 0.0;
-  double total_fitness_squared = 0.0;
-  double total_fitness_cubed = 0.0;
-  double total_fitness_fourth = 0.0;
-
-  double total_mutations = 0.0;
-  double total_mutations_squared = 0.0;
-  double total_mutations_cubed = 0.0;
-  double total_mutations_fourth = 0.0;
-
-  std::vector<uint32_t> sorted_keys;
-  sorted_keys.reserve(living_cells_count);
-  for (const auto& cell : cells) {
-    sorted_keys.push_back(cell.first);
-  }
-  std::sort(sorted_keys.begin(), sorted_keys.end());
-
-  for (uint32_t key : sorted_keys) {
-    CellMap::const_accessor accessor;
-    if (!cells.find(accessor, key)) {
-      continue;
-    }
-
-    const auto& cell = accessor->second;
-    const double fitness = cell.fitness;
-    const double fitness_sq = fitness * fitness;
-    const double fitness_cu = fitness_sq * fitness;
-    const double fitness_qd = fitness_cu * fitness;
-
-    const double mutations = static_cast<double>(cell.mutations.size());
-    const double mutations_sq = mutations * mutations;
-    const double mutations_cu = mutations_sq * mutations;
-    const double mutations_qd = mutations_cu * mutations;
-
-    total_fitness += fitness;
-    total_fitness_squared += fitness_sq;
-    total_fitness_cubed += fitness_cu;
-    total_fitness_fourth += fitness_qd;
-
-    total_mutations += mutations;
-    total_mutations_squared += mutations_sq;
-    total_mutations_cubed += mutations_cu;
-    total_mutations_fourth += mutations_qd;
-  }
-
-  const double mean_fitness = total_fitness / living_cells_count;
-  const double mean_mutations = total_mutations / living_cells_count;
-
-  const double raw_fitness_second = total_fitness_squared / living_cells_count;
-  const double raw_fitness_third = total_fitness_cubed / living_cells_count;
-  const double raw_fitness_fourth = total_fitness_fourth / living_cells_count;
-
-  const double raw_mutations_second = total_mutations_squared / living_cells_count;
-  const double raw_mutations_third = total_mutations_cubed / living_cells_count;
-  const double raw_mutations_fourth = total_mutations_fourth / living_cells_count;
-
-  const double fitness_variance = raw_fitness_second - mean_fitness * mean_fitness;
-  const double mutations_variance = raw_mutations_second - mean_mutations * mean_mutations;
-
-  const double fitness_skewness =
-      raw_fitness_third - 3.0 * mean_fitness * raw_fitness_second +
-      2.0 * std::pow(mean_fitness, 3);
-  const double fitness_kurtosis =
-      raw_fitness_fourth - 4.0 * mean_fitness * raw_fitness_third +
-      6.0 * mean_fitness * mean_fitness * raw_fitness_second -
-      3.0 * std::pow(mean_fitness, 4);
-
-  const double mutations_skewness =
-      raw_mutations_third - 3.0 * mean_mutations * raw_mutations_second +
-      2.0 * std::pow(mean_mutations, 3);
-  const double mutations_kurtosis =
-      raw_mutations_fourth - 4.0 * mean_mutations * raw_mutations_third +
-      6.0 * mean_mutations * mean_mutations * raw_mutations_second -
-      3.0 * std::pow(mean_mutations, 4);
-
-  generational_stat_report.push_back({tau,
-                                      mean_fitness,
-                                      fitness_variance,
-                                      mean_mutations,
-                                      mutations_variance,
-                                      living_cells_count,
-                                      fitness_skewness,
-                                      fitness_kurtosis,
-                                      mutations_skewness,
-                                      mutations_kurtosis});
 }
 
 void SimulationEngine3D::takePopulationSnapshot() {
@@ -704,138 +684,143 @@ void SimulationEngine3D::takePopulationSnapshot() {
                         {0, 0, 0}});
   }
 
-  const auto filename =
-      CellEvoX::io::populationSnapshotPath(config->output_path, tauSnapshotIndex(tau));
-  if (!CellEvoX::io::writePopulationSnapshot(filename, tau, 3, snapshot, mutation_payload,
-                                             payload_kind)) {
-    spdlog::error("Failed to write population snapshot file: {}", filename);
-  }
-}
-
-void SimulationEngine3D::pruneGraveyard() {
-  std::unordered_set<uint32_t> living_ids;
-  for (const auto& cell : cells) {
-    living_ids.insert(cell.first);
-  }
-
-  std::unordered_set<uint32_t> reachable_dead_cells;
-  for (uint32_t start_id : living_ids) {
-    CellMap::const_accessor accessor;
-    if (!cells.find(accessor, start_id)) {
-      continue;
-    }
-
-    uint32_t parent_id = accessor->second.parent_id;
-    while (parent_id != 0) {
-      if (reachable_dead_cells.count(parent_id) || living_ids.count(parent_id)) {
-        break;
-      }
-
-      Graveyard::const_accessor grave_accessor;
-      if (cells_graveyard.find(grave_accessor, parent_id)) {
-        reachable_dead_cells.insert(parent_id);
-        parent_id = grave_accessor->second.first;
-        continue;
-      }
-
-      break;
-    }
-  }
-
-  std::vector<uint32_t> to_remove;
-  for (const auto& item : cells_graveyard) {
-    if (reachable_dead_cells.find(item.first) == reachable_dead_cells.end()) {
-      to_remove.push_back(item.first);
-    }
+  const int generation = tauSnapshotIndex(tau);
+  const CellEvoX::io::PopulationSnapshotEncoding encoding{
+      config->snapshot_format == SnapshotFormat::Columnar, config->snapshot_position_quantum};
+  if (!snapshot_sink_.write(generation, tau, 3, snapshot, mutation_payload, payload_kind,
+                            encoding)) {
+    spdlog::error("Failed to write population snapshot file: {}",
+                  snapshot_sink_.describe(generation));
+    return;
   }
-
-  for (uint32_t id : to_remove) {
-    cells_graveyard.erase(id);
+  if (!CellEvoX::io::writeVoxelAggregatesFor(config->output_path, config->voxel_lod_resolutions,
+                                             generation, tau, snapshot, mutation_payload,
+                                             available_mutation_types)) {
+    spdlog::error("Failed to write voxel LOD file: {}",
+                  CellEvoX::io::voxelAggregatePath(config->output_path, generation).string());
   }
 }
 
-Eigen::Vector3f SimulationEngine3D::sampleRandomUnitVector(std::mt19937& random_engine) const {
-  std::normal_distribution<float> normal_dist(0.0f, 1.0f);
-  Eigen::Vector3f direction(normal_dist(random_engine),
-                            normal_dist(random_engine),
-                            normal_dist(random_engine));
-  const float norm = direction.norm();
-  if (norm <= 1e-6f) {
-    return Eigen::Vector3f::UnitX();
-  }
-  return direction / norm;
+Eigen::Vector3f SimulationEngine3D::sampleDivisionDirection(uint64_t rng_step, uint32_t id) const {
+  // Uniform on the sphere: z uniform in [-1, 1] and the azimuth uniform in [0, 2 pi).
+  const double z = 1.0 - 2.0 * CellEvoX::deterministic_rng::uniform01(
+                                   config->seed, rng_step, id, kDirectionZStream);
+  const double azimuth = 2.0 * std::numbers::pi * CellEvoX::deterministic_rng::uniform01(
+                                          config->seed, rng_step, id, kDirectionAzimuthStream);
+  const double radius = std::sqrt(std::max(0.0, 1.0 - z * z));
+  return Eigen::Vector3f(static_cast<float>(radius * std::cos(azimuth)),
+                         static_cast<float>(radius * std::sin(azimuth)),
+                         static_cast<float>(z));
 }
 
 float SimulationEngine3D::clampToDomain(float value) const {
   return std::clamp(value, 0.0f, config->spatial_domain_size);
 }
 
-void SimulationEngine3D::ensurePositionCapacity(uint32_t id) {
-  if (id < id_pos_x_.size()) {
-    return;
+// O(cells + graveyard) on the simulation thread; only the file write is asynchronous. Event
+// draws are keyed by step and cell id, so a resumed run repeats the original one exactly under
+// any thread count.
+void SimulationEngine3D::writeCheckpoint() {
+  CellEvoX::io::CheckpointWriter writer;
+  CellEvoX::systems::saveCellMap(writer, cells);
+  CellEvoX::systems::saveGraveyard(writer, cells_graveyard);
+  writer.putVector(generational_stat_report);
+  writer.put<uint64_t>(actual_population);
+  writer.put<uint64_t>(total_deaths);
+  writer.put(tau);
+  writer.put(next_cell_id_);
+  writer.put<int32_t>(last_stat_snapshot_tau);
+  writer.put<int32_t>(last_population_snapshot_tau);
+  writer.put<int32_t>(last_memory_log_tau);
+  writer.put<int32_t>(last_pruning_tau);
+  writer.put<int32_t>(last_checkpoint_tau);
+  writer.putRng(rng);
+  writer.putVector(spatial_state_.cell_ids);
+  writer.putVector(spatial_state_.pos_x);
+  writer.putVector(spatial_state_.pos_y);
+  writer.putVector(spatial_state_.pos_z);
+  writer.put(spatial_ids_end_);
+  writer.put(step_index_);
+  writer.putVector(moved_);
+  spatial_grid_.saveState(writer);
+  mechanics_.saveState(writer);
+  spatial_reorder_.saveState(writer);
+  active_set_.saveState(writer);
+  writer.put<uint8_t>(nutrient_field_ ? 1 : 0);
+  if (nutrient_field_) {
+    nutrient_field_->saveState(writer);
+  }
+  writer.put(CellEvoX::systems::flushedOutputSize(memory_log_file));
+
+  const auto path = CellEvoX::io::engineCheckpointPath(config->output_path);
+  if (!checkpoint_writer_.submit(
+          path,
+          CellEvoX::systems::makeCheckpointHeader(*config, completed_steps_),
+          std::move(writer.bytes()))) {
+    spdlog::error("Failed to write engine checkpoint: {}", path);
   }
-
-  const size_t new_size = static_cast<size_t>(id) + 1;
-  id_pos_x_.resize(new_size, 0.0f);
-  id_pos_y_.resize(new_size, 0.0f);
-  id_pos_z_.resize(new_size, 0.0f);
-  id_to_spatial_index_.resize(new_size, kInvalidSpatialIndex);
 }
 
-std::mt19937& SimulationEngine3D::getThreadLocalRng() const {
-  struct ThreadRngState {
-    std::mt19937 rng;
-    const SimulationEngine3D* owner = nullptr;
-    int thread_index = std::numeric_limits<int>::min();
-  };
-
-  static thread_local ThreadRngState state;
-
-  const int thread_index = tbb::this_task_arena::current_thread_index();
-  if (state.owner != this || state.thread_index != thread_index) {
-    const uint32_t seed = config->seed ^
-                          (0x9E3779B9u + static_cast<uint32_t>(std::max(thread_index, 0)));
-    state.rng.seed(seed);
-    state.owner = this;
-    state.thread_index = thread_index;
+void SimulationEngine3D::restoreCheckpoint(const CellEvoX::io::EngineCheckpoint& checkpoint) {
+  CellEvoX::systems::requireMatchingCheckpoint(checkpoint, *config);
+  auto reader = checkpoint.reader();
+  CellEvoX::systems::restoreCellMap(reader, cells);
+  CellEvoX::systems::restoreGraveyard(reader, cells_graveyard);
+  reader.getVector(generational_stat_report);
+  uint64_t population = 0;
+  uint64_t deaths = 0;
+  reader.get(population);
+  reader.get(deaths);
+  reader.get(tau);
+  reader.get(next_cell_id_);
+  reader.get(last_stat_snapshot_tau);
+  reader.get(last_population_snapshot_tau);
+  reader.get(last_memory_log_tau);
+  reader.get(last_pruning_tau);
+  reader.get(last_checkpoint_tau);
+  reader.getRng(rng);
+  reader.getVector(spatial_state_.cell_ids);
+  reader.getVector(spatial_state_.pos_x);
+  reader.getVector(spatial_state_.pos_y);
+  reader.getVector(spatial_state_.pos_z);
+  reader.get(spatial_ids_end_);
+  reader.get(step_index_);
+  reader.getVector(moved_);
+  const bool layout_ok = spatial_grid_.restoreState(reader) && mechanics_.restoreState(reader) &&
+                         spatial_reorder_.restoreState(reader) && active_set_.restoreState(reader);
+  uint8_t has_nutrient_field = 0;
+  reader.get(has_nutrient_field);
+  if (has_nutrient_field != 0) {
+    nutrient_field_.emplace(spatial_grid_);
+    if (!nutrient_field_->restoreState(reader)) {
+      throw std::runtime_error("Engine checkpoint nutrient field does not match the grid");
+    }
   }
-
-  return state.rng;
-}
-
-size_t SimulationEngine3D::getRSS() {
-#ifdef _WIN32
-  PROCESS_MEMORY_COUNTERS_EX counters{};
-  if (GetProcessMemoryInfo(GetCurrentProcess(),
-                           reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
-                           sizeof(counters))) {
-    return static_cast<size_t>(counters.WorkingSetSize / 1024);
-  }
-  return 0;
-#else
-  size_t rss = 0;
-  std::ifstream statm("/proc/self/statm");
-  if (statm.is_open()) {
-    size_t ignored = 0;
-    statm >> ignored >> rss;
-  }
-
-  const long page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
-  return rss * static_cast<size_t>(page_size_kb);
-#endif
-}
-
-void SimulationEngine3D::logMemoryUsage() {
-  if (!memory_log_file.is_open()) {
-    return;
+  uint64_t memory_log_size = 0;
+  reader.get(memory_log_size);
+  CellEvoX::systems::requireCompleteCheckpoint(reader);
+  const size_t slot_count = spatial_state_.cell_ids.size();
+  if (!layout_ok || spatial_state_.pos_x.size() != slot_count ||
+      spatial_state_.pos_y.size() != slot_count || spatial_state_.pos_z.size() != slot_count) {
+    throw std::runtime_error("Engine checkpoint has inconsistent spatial state");
   }
 
-  const size_t rss_kb = getRSS();
-  const size_t cells_count = cells.size();
-  const size_t graveyard_count = cells_graveyard.size();
-  const size_t estimated_cells_kb = (cells_count * sizeof(Cell)) / 1024;
-  const size_t estimated_graveyard_kb = (graveyard_count * 48) / 1024;
+  actual_population = static_cast<size_t>(population);
+  total_deaths = static_cast<size_t>(deaths);
+  completed_steps_ = checkpoint.header.completed_steps;
+  // The last rebuild of every step saw the final positions, so rebuilding reproduces it.
+  id_to_spatial_index_.assign(spatial_state_.cell_ids);
+  spatial_grid_.rebuild(
+      spatial_state_.cell_ids, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
 
-  memory_log_file << tau << "," << rss_kb << "," << cells_count << "," << graveyard_count << ","
-                  << estimated_cells_kb << "," << estimated_graveyard_kb << "\n";
+  if (!snapshot_sink_.resume(last_population_snapshot_tau)) {
+    spdlog::error("Failed to rewind population snapshots to generation {}",
+                  last_population_snapshot_tau);
+  }
+  const auto memory_log_path =
+      std::filesystem::path(config->output_path) / "statistics" / "memory_log.csv";
+  if (!CellEvoX::systems::resumeOutputFile(memory_log_file, memory_log_path, memory_log_size)) {
+    spdlog::warn("Failed to resume memory log file at: {}", memory_log_path.string());
+  }
+  spdlog::info("Resumed from checkpoint at tau={:.4f} after {} steps", tau, completed_steps_);
 }
@@ -6,29 +6,20 @@
 #include <tbb/parallel_scan.h>
 
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 #include <filesystem>
-#include <iomanip>
-#include <iostream>
 #include <limits>
 #include <numeric>
+#include <stdexcept>
 #include <system_error>
-#include <unordered_set>
 
 #include "io/PopulationSnapshotIO.hpp"
+#include "io/VoxelAggregateIO.hpp"
+#include "systems/CheckpointState.hpp"
 #include "systems/CommonPopulationStep.hpp"
+#include "systems/EngineRuntime.hpp"
 #include "utils/ParallelAlgorithms.hpp"
 #include "utils/PhaseProfiler.hpp"
-#ifdef _WIN32
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#include <windows.h>
-#include <psapi.h>
-#else
-#include <unistd.h>
-#endif
 
 namespace {
 
@@ -39,6 +30,8 @@ int tauSnapshotIndex(double tau_value) {
 }
 
 constexpr uint32_t kInvalidSpatialIndex = std::numeric_limits<uint32_t>::max();
+// Slots absent before a change are newborns to the neighbor list remap.
+static_assert(kInvalidSpatialIndex == VerletNeighborList::kNewSlot);
 
 struct SurvivorOffsetScan {
   const std::vector<uint8_t>& dead_flags;
@@ -78,7 +71,9 @@ void SimulationEngine3DCapacity::signalHandler(int signum) {
   shutdown_requested.store(true);
 }
 
-SimulationEngine3DCapacity::SimulationEngine3DCapacity(std::shared_ptr<SimulationConfig> config)
+SimulationEngine3DCapacity::SimulationEngine3DCapacity(
+    std::shared_ptr<SimulationConfig> config,
+    const CellEvoX::io::EngineCheckpoint* resume)
     : actual_population(config->initial_population),
       total_deaths(0),
       tau(0.0),
@@ -86,7 +81,13 @@ SimulationEngine3DCapacity::SimulationEngine3DCapacity(std::shared_ptr<Simulatio
       config(std::move(config)),
       event_rng_(this->config->seed),
       spatial_rng_(this->config->seed ^ 0xA5A5A5A5u),
-      spatial_grid_(2.0f * CELL_RADIUS, this->config->spatial_domain_size) {
+      spatial_grid_(2.0f * CELL_RADIUS,
+                    this->config->spatial_domain_size,
+                    this->config->spatial_domain_growth),
+      mechanics_(*this->config, 2.0f * CELL_RADIUS),
+      spatial_reorder_(2.0f * CELL_RADIUS) {
+  snapshot_sink_.configure(this->config->output_path, this->config->snapshot_container);
+
   switch (this->config->verbosity) {
     case 0:
       spdlog::set_level(spdlog::level::off);
@@ -113,7 +114,7 @@ SimulationEngine3DCapacity::SimulationEngine3DCapacity(std::shared_ptr<Simulatio
   }
 
   cells.rehash(this->config->initial_population * 2 + 1);
-  for (uint32_t id = 0; id < this->config->initial_population; ++id) {
+  for (uint32_t id = 0; resume == nullptr && id < this->config->initial_population; ++id) {
     cells.insert({id, Cell(id)});
   }
 
@@ -129,14 +130,17 @@ SimulationEngine3DCapacity::SimulationEngine3DCapacity(std::shared_ptr<Simulatio
                         return sum + mutation.second.probability;
                       });
 
-  initializePopulationPositions();
-  rebuildSpatialState();
+  if (resume != nullptr) {
+    restoreCheckpoint(*resume);
+  } else {
+    initializePopulationPositions();
+    rebuildSpatialState();
 
-  const std::string memory_log_path = this->config->output_path + "/statistics/memory_log.csv";
-  memory_log_file.open(memory_log_path);
-  if (memory_log_file.is_open()) {
-    memory_log_file << "Tau,RSS_KB,Cells_Count,Graveyard_Count,Estimated_Cells_KB,"
-                       "Estimated_Graveyard_KB\n";
+    const std::string memory_log_path = this->config->output_path + "/statistics/memory_log.csv";
+    memory_log_file.open(memory_log_path);
+    if (memory_log_file.is_open()) {
+      memory_log_file << CellEvoX::systems::kMemoryLogHeader;
+    }
   }
 
   spdlog::info("=== Spatial 3D Capacity Simulation Engine Initialized ===");
@@ -148,61 +152,21 @@ SimulationEngine3DCapacity::SimulationEngine3DCapacity(std::shared_ptr<Simulatio
 }
 
 ecs::Run SimulationEngine3DCapacity::run(uint32_t steps) {
-  auto last_update_time = std::chrono::steady_clock::now();
-  const char* spinner = "|/-\\";
-  int spinner_index = 0;
-  const int bar_width = 50;
-
-  const auto start_time = std::chrono::steady_clock::now();
-  for (uint32_t i = 0; i < steps; ++i) {
-    if (shutdown_requested.load()) {
-      spdlog::info("Shutdown requested at step {}/{}", i, steps);
-      std::cout << std::endl;
-      break;
-    }
-    if (config->max_population_cutoff > 0 &&
-        actual_population >= config->max_population_cutoff) {
-      spdlog::warn("Population cutoff reached: {} >= {} at tau={:.2f}. Stopping.",
-                   actual_population, config->max_population_cutoff, tau);
-      std::cout << std::endl;
-      break;
-    }
-
-    step();
-
-    const auto current_time = std::chrono::steady_clock::now();
-    const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                  current_time - last_update_time)
-                                  .count();
-
-    if (elapsed_time >= 100) {
-      const int progress = static_cast<int>((static_cast<double>(i + 1) / steps) * 100.0);
-      const int pos = static_cast<int>((static_cast<double>(i + 1) / steps) * bar_width);
-      const auto total_elapsed =
-          std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time).count();
-      const double avg_time_per_step = static_cast<double>(total_elapsed) / (i + 1);
-      const int remaining_steps = steps - (i + 1);
-      const double estimated_remaining_time = remaining_steps * avg_time_per_step / 1000.0;
-
-      std::cout << "\r\033[1;32mProgress: [\033[35m";
-      for (int j = 0; j < bar_width; ++j) {
-        std::cout << (j < pos ? '#' : ' ');
-      }
-      std::cout << "\033[1;32m] " << progress << "% \033[34m" << spinner[spinner_index]
-                << " \033[0m" << remaining_steps << " steps remaining, ~" << std::fixed
-                << std::setprecision(1) << estimated_remaining_time << "s left " << cells.size()
-                << " cells" << std::flush;
+  CellEvoX::systems::runEngineSteps(steps,
+                                     *config,
+                                     shutdown_requested,
+                                     actual_population,
+                                     tau,
+                                     [this] { step(); },
+                                     [this] { writeCheckpoint(); });
 
-      spinner_index = (spinner_index + 1) % 4;
-      last_update_time = current_time;
-    }
+  if (!checkpoint_writer_.wait()) {
+    spdlog::error("Failed to write engine checkpoint: {}",
+                  CellEvoX::io::engineCheckpointPath(config->output_path));
   }
-
-  std::cout << "\r\033[1;32mProgress: [";
-  for (int j = 0; j < bar_width; ++j) {
-    std::cout << "#";
+  if (!snapshot_sink_.close()) {
+    spdlog::error("Failed to finalize population snapshot container");
   }
-  std::cout << "] 100% \033[0m" << std::endl;
 
   return ecs::Run(std::move(cells),
                   std::move(available_mutation_types),
@@ -216,6 +180,7 @@ ecs::Run SimulationEngine3DCapacity::run(uint32_t steps) {
 void SimulationEngine3DCapacity::step() {
   CELLEVOX_PROFILE_PHASE("3d_capacity_step_total");
   tau += config->tau_step;
+  ++completed_steps_;
 
   CellEvoX::systems::CommonPopulationStepResult step_result;
   {
@@ -239,6 +204,16 @@ void SimulationEngine3DCapacity::step() {
     CELLEVOX_PROFILE_PHASE("3d_capacity_update_spatial_state");
     updateSpatialState(step_result);
   }
+  if (config->spatial_reorder == SpatialReorderMode::Morton) {
+    CELLEVOX_PROFILE_PHASE("3d_capacity_spatial_reorder");
+    reorderSpatialState();
+  }
+  if (config->mech_local) {
+    relax_seeds_.clear();
+    for (const auto& birth : step_result.births) {
+      relax_seeds_.push_back(id_to_spatial_index_.find(birth.id));
+    }
+  }
   {
     CELLEVOX_PROFILE_PHASE("3d_capacity_mechanical_relaxation");
     mechanicalRelaxationStep();
@@ -248,7 +223,7 @@ void SimulationEngine3DCapacity::step() {
   if (config->stat_res > 0 && current_tau % config->stat_res == 0 &&
       current_tau != last_stat_snapshot_tau) {
     CELLEVOX_PROFILE_PHASE("3d_capacity_stat_snapshot");
-    takeStatSnapshot();
+    generational_stat_report.push_back(CellEvoX::systems::computeStatSnapshot(cells, tau));
     last_stat_snapshot_tau = current_tau;
   }
 
@@ -264,16 +239,24 @@ void SimulationEngine3DCapacity::step() {
       current_tau % config->graveyard_pruning_interval == 0 &&
       current_tau != last_pruning_tau) {
     CELLEVOX_PROFILE_PHASE("3d_capacity_graveyard_pruning");
-    pruneGraveyard();
+    CellEvoX::systems::pruneUnreachableGraveyard(cells, cells_graveyard);
     last_pruning_tau = current_tau;
   }
 
   if (config->stat_res > 0 && current_tau % config->stat_res == 0 &&
       current_tau != last_memory_log_tau) {
     CELLEVOX_PROFILE_PHASE("3d_capacity_memory_log");
-    logMemoryUsage();
+    CellEvoX::systems::appendMemoryLogRow(
+        memory_log_file, tau, cells.size(), cells_graveyard.size());
     last_memory_log_tau = current_tau;
   }
+
+  if (config->checkpoint_interval > 0 && current_tau % config->checkpoint_interval == 0 &&
+      current_tau != last_checkpoint_tau) {
+    CELLEVOX_PROFILE_PHASE("3d_capacity_checkpoint");
+    last_checkpoint_tau = current_tau;
+    writeCheckpoint();
+  }
 }
 
 void SimulationEngine3DCapacity::stop() {
@@ -281,10 +264,10 @@ void SimulationEngine3DCapacity::stop() {
 }
 
 void SimulationEngine3DCapacity::initializePopulationPositions() {
-  id_pos_x_.assign(config->initial_population, 0.0f);
-  id_pos_y_.assign(config->initial_population, 0.0f);
-  id_pos_z_.assign(config->initial_population, 0.0f);
-  id_to_spatial_index_.assign(config->initial_population, kInvalidSpatialIndex);
+  // The initial cells are ids 0..N-1, so they use the birth buffers indexed by id.
+  birth_pos_x_.assign(config->initial_population, 0.0f);
+  birth_pos_y_.assign(config->initial_population, 0.0f);
+  birth_pos_z_.assign(config->initial_population, 0.0f);
 
   const uint32_t initial_population = static_cast<uint32_t>(config->initial_population);
   if (initial_population == 0) {
@@ -301,27 +284,16 @@ void SimulationEngine3DCapacity::initializePopulationPositions() {
     const uint32_t iy = (id / cells_per_axis) % cells_per_axis;
     const uint32_t iz = id / (cells_per_axis * cells_per_axis);
 
-    id_pos_x_[id] =
+    birth_pos_x_[id] =
         clampToDomain((static_cast<float>(ix) + 0.5f) * spacing + jitter_dist(spatial_rng_));
-    id_pos_y_[id] =
+    birth_pos_y_[id] =
         clampToDomain((static_cast<float>(iy) + 0.5f) * spacing + jitter_dist(spatial_rng_));
-    id_pos_z_[id] =
+    birth_pos_z_[id] =
         clampToDomain((static_cast<float>(iz) + 0.5f) * spacing + jitter_dist(spatial_rng_));
   }
 }
 
 void SimulationEngine3DCapacity::rebuildSpatialState() {
-  tbb::parallel_for(
-      tbb::blocked_range<size_t>(0, spatial_state_.cell_ids.size()),
-      [&](const tbb::blocked_range<size_t>& range) {
-        for (size_t i = range.begin(); i != range.end(); ++i) {
-          const uint32_t id = spatial_state_.cell_ids[i];
-          if (id < id_to_spatial_index_.size()) {
-            id_to_spatial_index_[id] = kInvalidSpatialIndex;
-          }
-        }
-      });
-
   spatial_state_.cell_ids.clear();
   spatial_state_.cell_ids.reserve(cells.size());
   for (const auto& cell_entry : cells) {
@@ -335,21 +307,21 @@ void SimulationEngine3DCapacity::rebuildSpatialState() {
   spatial_state_.pos_y.resize(count);
   spatial_state_.pos_z.resize(count);
 
-  if (count > 0) {
-    ensurePositionCapacity(spatial_state_.cell_ids.back());
-  }
-
   tbb::parallel_for(
       tbb::blocked_range<size_t>(0, count),
       [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i != range.end(); ++i) {
           const uint32_t id = spatial_state_.cell_ids[i];
-          spatial_state_.pos_x[i] = id_pos_x_[id];
-          spatial_state_.pos_y[i] = id_pos_y_[id];
-          spatial_state_.pos_z[i] = id_pos_z_[id];
-          id_to_spatial_index_[id] = static_cast<uint32_t>(i);
+          if (id >= birth_pos_x_.size()) {
+            spdlog::error("Cell {} has no initial position", id);
+            throw std::runtime_error("Spatial state is out of sync with cell ids");
+          }
+          spatial_state_.pos_x[i] = birth_pos_x_[id];
+          spatial_state_.pos_y[i] = birth_pos_y_[id];
+          spatial_state_.pos_z[i] = birth_pos_z_[id];
         }
       });
+  id_to_spatial_index_.assign(spatial_state_.cell_ids);
 
   spatial_grid_.rebuild(
       spatial_state_.cell_ids, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
@@ -362,32 +334,41 @@ void SimulationEngine3DCapacity::updateSpatialState(
   if (births.empty() && deaths.empty()) {
     return;
   }
+  // Survivors' previous slots for the neighbor list remap; births map to none.
+  const bool remap_neighbors = mechanics_.neighborList().valid();
 
   if (deaths.empty()) {
     const size_t old_count = spatial_state_.cell_ids.size();
     const size_t new_count = old_count + births.size();
+    if (remap_neighbors) {
+      previous_slots_.resize(new_count);
+      std::iota(previous_slots_.begin(), previous_slots_.begin() + old_count, uint32_t{0});
+      std::fill(previous_slots_.begin() + old_count, previous_slots_.end(), kInvalidSpatialIndex);
+    }
     spatial_state_.cell_ids.resize(new_count);
     spatial_state_.pos_x.resize(new_count);
     spatial_state_.pos_y.resize(new_count);
     spatial_state_.pos_z.resize(new_count);
 
-    if (!births.empty()) {
-      ensurePositionCapacity(births.back().id);
-    }
-
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, births.size()),
         [&](const tbb::blocked_range<size_t>& range) {
           for (size_t i = range.begin(); i != range.end(); ++i) {
-            const uint32_t id = births[i].id;
             const size_t target = old_count + i;
-            spatial_state_.cell_ids[target] = id;
-            spatial_state_.pos_x[target] = id_pos_x_[id];
-            spatial_state_.pos_y[target] = id_pos_y_[id];
-            spatial_state_.pos_z[target] = id_pos_z_[id];
-            id_to_spatial_index_[id] = static_cast<uint32_t>(target);
+            spatial_state_.cell_ids[target] = births[i].id;
+            spatial_state_.pos_x[target] = birth_pos_x_[i];
+            spatial_state_.pos_y[target] = birth_pos_y_[i];
+            spatial_state_.pos_z[target] = birth_pos_z_[i];
           }
         });
+    id_to_spatial_index_.reserve(new_count);
+    for (size_t i = 0; i < births.size(); ++i) {
+      id_to_spatial_index_.insert(births[i].id, static_cast<uint32_t>(old_count + i));
+    }
+    if (remap_neighbors) {
+      mechanics_.remapNeighborList(
+          previous_slots_, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
+    }
     return;
   }
 
@@ -399,17 +380,15 @@ void SimulationEngine3DCapacity::updateSpatialState(
       tbb::blocked_range<size_t>(0, deaths.size()),
       [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i != range.end(); ++i) {
-          const uint32_t id = deaths[i].id;
-          if (id >= id_to_spatial_index_.size()) {
-            continue;
-          }
-          const uint32_t spatial_index = id_to_spatial_index_[id];
+          const uint32_t spatial_index = id_to_spatial_index_.find(deaths[i].id);
           if (spatial_index != kInvalidSpatialIndex && spatial_index < old_count) {
             dead_spatial_flags_[spatial_index] = 1;
           }
-          id_to_spatial_index_[id] = kInvalidSpatialIndex;
         }
       });
+  for (const auto& death : deaths) {
+    id_to_spatial_index_.erase(death.id);
+  }
 
   SurvivorOffsetScan offset_scan(dead_spatial_flags_, survivor_offsets_);
   tbb::parallel_scan(tbb::blocked_range<size_t>(0, old_count), offset_scan);
@@ -420,6 +399,9 @@ void SimulationEngine3DCapacity::updateSpatialState(
   next_pos_x_.resize(new_count);
   next_pos_y_.resize(new_count);
   next_pos_z_.resize(new_count);
+  if (remap_neighbors) {
+    previous_slots_.assign(new_count, kInvalidSpatialIndex);
+  }
 
   tbb::parallel_for(
       tbb::blocked_range<size_t>(0, old_count),
@@ -434,58 +416,94 @@ void SimulationEngine3DCapacity::updateSpatialState(
           next_pos_x_[target] = spatial_state_.pos_x[i];
           next_pos_y_[target] = spatial_state_.pos_y[i];
           next_pos_z_[target] = spatial_state_.pos_z[i];
-          id_to_spatial_index_[id] = static_cast<uint32_t>(target);
+          id_to_spatial_index_.update(id, static_cast<uint32_t>(target));
+          if (remap_neighbors) {
+            previous_slots_[target] = static_cast<uint32_t>(i);
+          }
         }
       });
 
-  if (!births.empty()) {
-    ensurePositionCapacity(births.back().id);
-  }
   tbb::parallel_for(
       tbb::blocked_range<size_t>(0, births.size()),
       [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i != range.end(); ++i) {
-          const uint32_t id = births[i].id;
           const size_t target = survivor_count + i;
-          next_cell_ids_[target] = id;
-          next_pos_x_[target] = id_pos_x_[id];
-          next_pos_y_[target] = id_pos_y_[id];
-          next_pos_z_[target] = id_pos_z_[id];
-          id_to_spatial_index_[id] = static_cast<uint32_t>(target);
+          next_cell_ids_[target] = births[i].id;
+          next_pos_x_[target] = birth_pos_x_[i];
+          next_pos_y_[target] = birth_pos_y_[i];
+          next_pos_z_[target] = birth_pos_z_[i];
         }
       });
+  id_to_spatial_index_.reserve(new_count);
+  for (size_t i = 0; i < births.size(); ++i) {
+    id_to_spatial_index_.insert(births[i].id, static_cast<uint32_t>(survivor_count + i));
+  }
 
   spatial_state_.cell_ids.swap(next_cell_ids_);
   spatial_state_.pos_x.swap(next_pos_x_);
   spatial_state_.pos_y.swap(next_pos_y_);
   spatial_state_.pos_z.swap(next_pos_z_);
+  if (remap_neighbors) {
+    mechanics_.remapNeighborList(
+        previous_slots_, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
+  }
+}
+
+void SimulationEngine3DCapacity::reorderSpatialState() {
+  // Survivors keep their slots and births are appended, so locality only decays with births.
+  if (!spatial_reorder_.maybeReorder(spatial_state_.cell_ids,
+                                     spatial_state_.pos_x,
+                                     spatial_state_.pos_y,
+                                     spatial_state_.pos_z,
+                                     config->spatial_reorder_degradation)) {
+    return;
+  }
+
+  // The reorder is a slot permutation, read from the index before it is refreshed.
+  const bool remap_neighbors = mechanics_.neighborList().valid();
+  previous_slots_.resize(spatial_state_.cell_ids.size());
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, spatial_state_.cell_ids.size()),
+      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+          previous_slots_[i] = id_to_spatial_index_.find(spatial_state_.cell_ids[i]);
+          id_to_spatial_index_.update(spatial_state_.cell_ids[i], static_cast<uint32_t>(i));
+        }
+      });
+  if (remap_neighbors) {
+    mechanics_.remapNeighborList(
+        previous_slots_, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
+  }
 }
 
 void SimulationEngine3DCapacity::assignBirthPositions(
     const std::vector<CellEvoX::systems::CommonBirthEvent>& births) {
+  // Parents are still in the spatial arrays: births are applied to them afterwards.
+  birth_pos_x_.resize(births.size());
+  birth_pos_y_.resize(births.size());
+  birth_pos_z_.resize(births.size());
   size_t index = 0;
   while (index < births.size()) {
     const uint32_t parent_id = births[index].parent_id;
-    ensurePositionCapacity(parent_id);
-
-    const float parent_x = id_pos_x_[parent_id];
-    const float parent_y = id_pos_y_[parent_id];
-    const float parent_z = id_pos_z_[parent_id];
+    const uint32_t parent_index = id_to_spatial_index_.find(parent_id);
+    if (parent_index == kInvalidSpatialIndex) {
+      spdlog::error("Parent {} of a birth is missing from the spatial state", parent_id);
+      throw std::runtime_error("Spatial state is out of sync with cell ids");
+    }
+    const float parent_x = spatial_state_.pos_x[parent_index];
+    const float parent_y = spatial_state_.pos_y[parent_index];
+    const float parent_z = spatial_state_.pos_z[parent_index];
     const Eigen::Vector3f offset =
         sampleRandomUnitVector(spatial_rng_) * (config->epsilon * CELL_RADIUS * 0.5f);
 
-    const uint32_t first_id = births[index].id;
-    ensurePositionCapacity(first_id);
-    id_pos_x_[first_id] = clampToDomain(parent_x - offset.x());
-    id_pos_y_[first_id] = clampToDomain(parent_y - offset.y());
-    id_pos_z_[first_id] = clampToDomain(parent_z - offset.z());
+    birth_pos_x_[index] = clampToDomain(parent_x - offset.x());
+    birth_pos_y_[index] = clampToDomain(parent_y - offset.y());
+    birth_pos_z_[index] = clampToDomain(parent_z - offset.z());
 
     if (index + 1 < births.size() && births[index + 1].parent_id == parent_id) {
-      const uint32_t second_id = births[index + 1].id;
-      ensurePositionCapacity(second_id);
-      id_pos_x_[second_id] = clampToDomain(parent_x + offset.x());
-      id_pos_y_[second_id] = clampToDomain(parent_y + offset.y());
-      id_pos_z_[second_id] = clampToDomain(parent_z + offset.z());
+      birth_pos_x_[index + 1] = clampToDomain(parent_x + offset.x());
+      birth_pos_y_[index + 1] = clampToDomain(parent_y + offset.y());
+      birth_pos_z_[index + 1] = clampToDomain(parent_z + offset.z());
       index += 2;
     } else {
       ++index;
@@ -499,186 +517,26 @@ void SimulationEngine3DCapacity::mechanicalRelaxationStep() {
     return;
   }
 
-  const float interaction_radius = 2.0f * CELL_RADIUS;
-  const float interaction_radius_sq = interaction_radius * interaction_radius;
-
-  mech_read_x_.resize(count);
-  mech_read_y_.resize(count);
-  mech_read_z_.resize(count);
-  mech_write_x_.resize(count);
-  mech_write_y_.resize(count);
-  mech_write_z_.resize(count);
-  tbb::parallel_for(
-      tbb::blocked_range<size_t>(0, count),
-      [&](const tbb::blocked_range<size_t>& range) {
-        for (size_t i = range.begin(); i != range.end(); ++i) {
-          mech_read_x_[i] = spatial_state_.pos_x[i];
-          mech_read_y_[i] = spatial_state_.pos_y[i];
-          mech_read_z_[i] = spatial_state_.pos_z[i];
-        }
-      });
-
-  for (int substep = 0; substep < config->mech_substeps; ++substep) {
-    spatial_grid_.rebuild(spatial_state_.cell_ids, mech_read_x_, mech_read_y_, mech_read_z_);
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, count),
-        [&](const tbb::blocked_range<size_t>& range) {
-          for (size_t i = range.begin(); i != range.end(); ++i) {
-            const float xi = mech_read_x_[i];
-            const float yi = mech_read_y_[i];
-            const float zi = mech_read_z_[i];
-
-            Eigen::Vector3f force = Eigen::Vector3f::Zero();
-            spatial_grid_.queryRadius(xi, yi, zi, interaction_radius, [&](uint32_t neighbor_id) {
-              const uint32_t neighbor_index = id_to_spatial_index_[neighbor_id];
-              if (neighbor_index == kInvalidSpatialIndex || neighbor_index == i) {
-                return;
-              }
-
-              const float dx = xi - mech_read_x_[neighbor_index];
-              const float dy = yi - mech_read_y_[neighbor_index];
-              const float dz = zi - mech_read_z_[neighbor_index];
-              const float dist_sq = dx * dx + dy * dy + dz * dz;
-              if (dist_sq <= 1e-12f || dist_sq >= interaction_radius_sq) {
-                return;
-              }
-
-              const float dist = std::sqrt(dist_sq);
-              const float overlap = interaction_radius - dist;
-              if (overlap <= 0.0f) {
-                return;
-              }
-
-              const float scale = config->spring_constant * overlap / dist;
-              force.x() += scale * dx;
-              force.y() += scale * dy;
-              force.z() += scale * dz;
-            });
-
-            mech_write_x_[i] = clampToDomain(xi + force.x() * config->mech_dt);
-            mech_write_y_[i] = clampToDomain(yi + force.y() * config->mech_dt);
-            mech_write_z_[i] = clampToDomain(zi + force.z() * config->mech_dt);
-          }
-        });
-
-    mech_read_x_.swap(mech_write_x_);
-    mech_read_y_.swap(mech_write_y_);
-    mech_read_z_.swap(mech_write_z_);
-  }
-
-  spatial_state_.pos_x.swap(mech_read_x_);
-  spatial_state_.pos_y.swap(mech_read_y_);
-  spatial_state_.pos_z.swap(mech_read_z_);
-
-  tbb::parallel_for(
-      tbb::blocked_range<size_t>(0, count),
-      [&](const tbb::blocked_range<size_t>& range) {
-        for (size_t i = range.begin(); i != range.end(); ++i) {
-          const uint32_t id = spatial_state_.cell_ids[i];
-          id_pos_x_[id] = spatial_state_.pos_x[i];
-          id_pos_y_[id] = spatial_state_.pos_y[i];
-          id_pos_z_[id] = spatial_state_.pos_z[i];
-        }
-      });
-
-  spatial_grid_.rebuild(
-      spatial_state_.cell_ids, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
-}
-
-void SimulationEngine3DCapacity::takeStatSnapshot() {
-  const size_t living_cells_count = cells.size();
-  if (living_cells_count == 0) {
-    generational_stat_report.push_back(
-        {tau, 0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0, 0.0});
+  if (config->mech_local) {
+    // Births and deaths since the last relaxation changed the spatial arrays.
+    spatial_grid_.rebuild(
+        spatial_state_.cell_ids, spatial_state_.pos_x, spatial_state_.pos_y, spatial_state_.pos_z);
+    mechanics_.relaxLocal(*config,
+                          spatial_state_.cell_ids,
+                          spatial_state_.pos_x,
+                          spatial_state_.pos_y,
+                          spatial_state_.pos_z,
+                          spatial_grid_,
+                          relax_seeds_);
     return;
   }
 
-  double total_fitness = 0.0;
-  double total_fitness_squared = 0.0;
-  double total_fitness_cubed = 0.0;
-  double total_fitness_fourth = 0.0;
-
-  double total_mutations = 0.0;
-  double total_mutations_squared = 0.0;
-  double total_mutations_cubed = 0.0;
-  double total_mutations_fourth = 0.0;
-
-  std::vector<uint32_t> sorted_keys;
-  sorted_keys.reserve(living_cells_count);
-  for (const auto& cell : cells) {
-    sorted_keys.push_back(cell.first);
-  }
-  CellEvoX::parallel_algorithms::sortMaybeParallel(sorted_keys.begin(), sorted_keys.end());
-
-  for (uint32_t key : sorted_keys) {
-    CellMap::const_accessor accessor;
-    if (!cells.find(accessor, key)) {
-      continue;
-    }
-
-    const auto& cell = accessor->second;
-    const double fitness = cell.fitness;
-    const double fitness_sq = fitness * fitness;
-    const double fitness_cu = fitness_sq * fitness;
-    const double fitness_qd = fitness_cu * fitness;
-
-    const double mutations = static_cast<double>(cell.mutations.size());
-    const double mutations_sq = mutations * mutations;
-    const double mutations_cu = mutations_sq * mutations;
-    const double mutations_qd = mutations_cu * mutations;
-
-    total_fitness += fitness;
-    total_fitness_squared += fitness_sq;
-    total_fitness_cubed += fitness_cu;
-    total_fitness_fourth += fitness_qd;
-
-    total_mutations += mutations;
-    total_mutations_squared += mutations_sq;
-    total_mutations_cubed += mutations_cu;
-    total_mutations_fourth += mutations_qd;
-  }
-
-  const double mean_fitness = total_fitness / living_cells_count;
-  const double mean_mutations = total_mutations / living_cells_count;
-
-  const double raw_fitness_second = total_fitness_squared / living_cells_count;
-  const double raw_fitness_third = total_fitness_cubed / living_cells_count;
-  const double raw_fitness_fourth = total_fitness_fourth / living_cells_count;
-
-  const double raw_mutations_second = total_mutations_squared / living_cells_count;
-  const double raw_mutations_third = total_mutations_cubed / living_cells_count;
-  const double raw_mutations_fourth = total_mutations_fourth / living_cells_count;
-
-  const double fitness_variance = raw_fitness_second - mean_fitness * mean_fitness;
-  const double mutations_variance = raw_mutations_second - mean_mutations * mean_mutations;
-
-  const double fitness_skewness =
-      raw_fitness_third - 3.0 * mean_fitness * raw_fitness_second +
-      2.0 * std::pow(mean_fitness, 3);
-  const double fitness_kurtosis =
-      raw_fitness_fourth - 4.0 * mean_fitness * raw_fitness_third +
-      6.0 * mean_fitness * mean_fitness * raw_fitness_second -
-      3.0 * std::pow(mean_fitness, 4);
-
-  const double mutations_skewness =
-      raw_mutations_third - 3.0 * mean_mutations * raw_mutations_second +
-      2.0 * std::pow(mean_mutations, 3);
-  const double mutations_kurtosis =
-      raw_mutations_fourth - 4.0 * mean_mutations * raw_mutations_third +
-      6.0 * mean_mutations * mean_mutations * raw_mutations_second -
-      3.0 * std::pow(mean_mutations, 4);
-
-  generational_stat_report.push_back({tau,
-                                      mean_fitness,
-                                      fitness_variance,
-                                      mean_mutations,
-                                      mutations_variance,
-                                      living_cells_count,
-                                      fitness_skewness,
-                                      fitness_kurtosis,
-                                      mutations_skewness,
-                                      mutations_kurtosis});
+  mechanics_.relax(*config,
+                   spatial_state_.cell_ids,
+                   spatial_state_.pos_x,
+                   spatial_state_.pos_y,
+                   spatial_state_.pos_z,
+                   spatial_grid_);
 }
 
 void SimulationEngine3DCapacity::takePopulationSnapshot() {
@@ -727,53 +585,20 @@ void SimulationEngine3DCapacity::takePopulationSnapshot() {
                         {0, 0, 0}});
   }
 
-  const auto filename =
-      CellEvoX::io::populationSnapshotPath(config->output_path, tauSnapshotIndex(tau));
-  if (!CellEvoX::io::writePopulationSnapshot(filename, tau, 3, snapshot, mutation_payload,
-                                             payload_kind)) {
-    spdlog::error("Failed to write population snapshot file: {}", filename);
-  }
-}
-
-void SimulationEngine3DCapacity::pruneGraveyard() {
-  std::unordered_set<uint32_t> living_ids;
-  for (const auto& cell : cells) {
-    living_ids.insert(cell.first);
-  }
-
-  std::unordered_set<uint32_t> reachable_dead_cells;
-  for (uint32_t start_id : living_ids) {
-    CellMap::const_accessor accessor;
-    if (!cells.find(accessor, start_id)) {
-      continue;
-    }
-
-    uint32_t parent_id = accessor->second.parent_id;
-    while (parent_id != 0) {
-      if (reachable_dead_cells.count(parent_id) || living_ids.count(parent_id)) {
-        break;
-      }
-
-      Graveyard::const_accessor grave_accessor;
-      if (cells_graveyard.find(grave_accessor, parent_id)) {
-        reachable_dead_cells.insert(parent_id);
-        parent_id = grave_accessor->second.first;
-        continue;
-      }
-
-      break;
-    }
-  }
-
-  std::vector<uint32_t> to_remove;
-  for (const auto& item : cells_graveyard) {
-    if (reachable_dead_cells.find(item.first) == reachable_dead_cells.end()) {
-      to_remove.push_back(item.first);
-    }
+  const int generation = tauSnapshotIndex(tau);
+  const CellEvoX::io::PopulationSnapshotEncoding encoding{
+      config->snapshot_format == SnapshotFormat::Columnar, config->snapshot_position_quantum};
+  if (!snapshot_sink_.write(generation, tau, 3, snapshot, mutation_payload, payload_kind,
+                            encoding)) {
+    spdlog::error("Failed to write population snapshot file: {}",
+                  snapshot_sink_.describe(generation));
+    return;
   }
-
-  for (uint32_t id : to_remove) {
-    cells_graveyard.erase(id);
+  if (!CellEvoX::io::writeVoxelAggregatesFor(config->output_path, config->voxel_lod_resolutions,
+                                             generation, tau, snapshot, mutation_payload,
+                                             available_mutation_types)) {
+    spdlog::error("Failed to write voxel LOD file: {}",
+                  CellEvoX::io::voxelAggregatePath(config->output_path, generation).string());
   }
 }
 
@@ -788,54 +613,96 @@ Eigen::Vector3f SimulationEngine3DCapacity::sampleRandomUnitVector(std::mt19937&
 }
 
 float SimulationEngine3DCapacity::clampToDomain(float value) const {
+  // A growing domain has no walls; spatial_domain_size only shapes the initial lattice.
+  if (config->spatial_domain_growth) {
+    return value;
+  }
   return std::clamp(value, 0.0f, config->spatial_domain_size);
 }
 
-void SimulationEngine3DCapacity::ensurePositionCapacity(uint32_t id) {
-  if (id < id_pos_x_.size()) {
-    return;
+// O(cells + graveyard) on the simulation thread; only the file write is asynchronous.
+void SimulationEngine3DCapacity::writeCheckpoint() {
+  CellEvoX::io::CheckpointWriter writer;
+  CellEvoX::systems::saveCellMap(writer, cells);
+  CellEvoX::systems::saveGraveyard(writer, cells_graveyard);
+  writer.putVector(generational_stat_report);
+  writer.put<uint64_t>(actual_population);
+  writer.put<uint64_t>(total_deaths);
+  writer.put(tau);
+  writer.put<int32_t>(last_stat_snapshot_tau);
+  writer.put<int32_t>(last_population_snapshot_tau);
+  writer.put<int32_t>(last_memory_log_tau);
+  writer.put<int32_t>(last_pruning_tau);
+  writer.put<int32_t>(last_checkpoint_tau);
+  writer.putRng(event_rng_);
+  writer.putRng(spatial_rng_);
+  writer.putVector(spatial_state_.cell_ids);
+  writer.putVector(spatial_state_.pos_x);
+  writer.putVector(spatial_state_.pos_y);
+  writer.putVector(spatial_state_.pos_z);
+  spatial_grid_.saveState(writer);
+  mechanics_.saveState(writer);
+  spatial_reorder_.saveState(writer);
+  writer.put(CellEvoX::systems::flushedOutputSize(memory_log_file));
+
+  const auto path = CellEvoX::io::engineCheckpointPath(config->output_path);
+  if (!checkpoint_writer_.submit(
+          path,
+          CellEvoX::systems::makeCheckpointHeader(*config, completed_steps_),
+          std::move(writer.bytes()))) {
+    spdlog::error("Failed to write engine checkpoint: {}", path);
   }
-
-  const size_t new_size = static_cast<size_t>(id) + 1;
-  id_pos_x_.resize(new_size, 0.0f);
-  id_pos_y_.resize(new_size, 0.0f);
-  id_pos_z_.resize(new_size, 0.0f);
-  id_to_spatial_index_.resize(new_size, kInvalidSpatialIndex);
-}
-
-size_t SimulationEngine3DCapacity::getRSS() {
-#ifdef _WIN32
-  PROCESS_MEMORY_COUNTERS_EX counters{};
-  if (GetProcessMemoryInfo(GetCurrentProcess(),
-                           reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
-                           sizeof(counters))) {
-    return static_cast<size_t>(counters.WorkingSetSize / 1024);
-  }
-  return 0;
-#else
-  size_t rss = 0;
-  std::ifstream statm("/proc/self/statm");
-  if (statm.is_open()) {
-    size_t ignored = 0;
-    statm >> ignored >> rss;
-  }
-
-  const long page_size_kb = sysconf(_SC_PAGESIZE) / 1024;
-  return rss * static_cast<size_t>(page_size_kb);
-#endif
 }
 
-void SimulationEngine3DCapacity::logMemoryUsage() {
-  if (!memory_log_file.is_open()) {
-    return;
-  }
-
-  const size_t rss_kb = getRSS();
-  const size_t cells_count = cells.size();
-  const size_t graveyard_count = cells_graveyard.size();
-  const size_t estimated_cells_kb = (cells_count * sizeof(Cell)) / 1024;
-  const size_t estimated_graveyard_kb = (graveyard_count * 48) / 1024;
-
-  memory_log_file << tau << "," << rss_kb << "," << cells_count << "," << graveyard_count << ","
-                  << estimated_cells_kb << "," << estimated_graveyard_kb << "\n";
+void SimulationEngine3DCapacity::restoreCheckpoint(
+    const CellEvoX::io::EngineCheckpoint& checkpoint) {
+  CellEvoX::systems::requireMatchingCheckpoint(checkpoint, *config);
+  auto reader = checkpoint.reader();
+  CellEvoX::systems::restoreCellMap(reader, cells);
+  CellEvoX::systems::restoreGraveyard(reader, cells_graveyard);
+  reader.getVector(generational_stat_report);
+  uint64_t population = 0;
+  uint64_t deaths = 0;
+  reader.get(population);
+  reader.get(deaths);
+  reader.get(tau);
+  reader.get(last_stat_snapshot_tau);
+  reader.get(last_population_snapshot_tau);
+  reader.get(last_memory_log_tau);
+  reader.get(last_pruning_tau);
+  reader.get(last_checkpoint_tau);
+  reader.getRng(event_rng_);
+  reader.getRng(spatial_rng_);
+  reader.getVector(spatial_state_.cell_ids);
+  reader.getVector(spatial_state_.pos_x);
+  reader.getVector(spatial_state_.pos_y);
+  reader.getVector(spatial_state_.pos_z);
+  const bool layout_ok = spatial_grid_.restoreState(reader) && mechanics_.restoreState(reader) &&
+                         spatial_reorder_.restoreState(reader);
+  uint64_t memory_log_size = 0;
+  reader.get(memory_log_size);
+  CellEvoX::systems::requireCompleteCheckpoint(reader);
+  const size_t slot_count = spatial_state_.cell_ids.size();
+  if (!layout_ok || spatial_state_.pos_x.size() != slot_count ||
+      spatial_state_.pos_y.size() != slot_count || spatial_state_.pos_z.size() != slot_count) {
+    throw std::runtime_error("Engine checkpoint has inconsistent spatial state");
+  }
+
+  actual_population = static_cast<size_t>(population);
+  total_deaths = static_cast<size_t>(deaths);
+  completed_steps_ = checkpoint.header.completed_steps;
+  // Relaxation rebuilds the grid before reading it, so only its layout is restored: a
+  // rebuild here could refit a growing grid differently from the uninterrupted run.
+  id_to_spatial_index_.assign(spatial_state_.cell_ids);
+
+  if (!snapshot_sink_.resume(last_population_snapshot_tau)) {
+    spdlog::error("Failed to rewind population snapshots to generation {}",
+                  last_population_snapshot_tau);
+  }
+  const auto memory_log_path =
+      std::filesystem::path(config->output_path) / "statistics" / "memory_log.csv";
+  if (!CellEvoX::systems::resumeOutputFile(memory_log_file, memory_log_path, memory_log_size)) {
+    spdlog::warn("Failed to resume memory log file at: {}", memory_log_path.string());
+  }
+  spdlog::info("Resumed from checkpoint at tau={:.4f} after {} steps", tau, completed_steps_);
 }
@@ -0,0 +1,558 @@
+#include "systems/SimulationEngine3DLattice.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <system_error>
+
+#include "io/PopulationSnapshotIO.hpp"
+#include "io/VoxelAggregateIO.hpp"
+#include "systems/CheckpointState.hpp"
+#include "systems/CommonPopulationStep.hpp"
+#include "systems/EngineRuntime.hpp"
+#include "utils/ParallelAlgorithms.hpp"
+#include "utils/PhaseProfiler.hpp"
+
+namespace {
+
+constexpr double kTauSnapshotEpsilon = 1e-9;
+
+int tauSnapshotIndex(double tau_value) {
+  return static_cast<int>(std::floor(tau_value + kTauSnapshotEpsilon));
+}
+
+constexpr uint32_t kNoVoxel = CellEvoX::spatial::LiveIdIndex::kNotFound;
+
+}  // namespace
+
+std::atomic<bool> SimulationEngine3DLattice::shutdown_requested{false};
+
+void SimulationEngine3DLattice::signalHandler(int signum) {
+  spdlog::warn("\nReceived interrupt signal ({}). Gracefully shutting down...", signum);
+  shutdown_requested.store(true);
+}
+
+SimulationEngine3DLattice::SimulationEngine3DLattice(
+    std::shared_ptr<SimulationConfig> config,
+    const CellEvoX::io::EngineCheckpoint* resume)
+    : actual_population(config->initial_population),
+      total_deaths(0),
+      tau(0.0),
+      total_mutation_probability(0.0),
+      config(std::move(config)),
+      event_rng_(this->config->seed),
+      spatial_rng_(this->config->seed ^ 0xA5A5A5A5u),
+      lattice_(CellEvoX::spatial::LatticeOccupancy::dimForDomain(
+          this->config->spatial_domain_size, 2.0f * CELL_RADIUS)) {
+  snapshot_sink_.configure(this->config->output_path, this->config->snapshot_container);
+
+  switch (this->config->verbosity) {
+    case 0:
+      spdlog::set_level(spdlog::level::off);
+      break;
+    case 1:
+      spdlog::set_level(spdlog::level::warn);
+      break;
+    default:
+      spdlog::set_level(spdlog::level::info);
+      break;
+  }
+
+  std::error_code create_dir_error;
+  std::filesystem::create_directories(
+      std::filesystem::path(this->config->output_path) / "statistics", create_dir_error);
+  if (create_dir_error) {
+    spdlog::warn("Failed to create statistics directory: {}", create_dir_error.message());
+  }
+  create_dir_error.clear();
+  std::filesystem::create_directories(
+      std::filesystem::path(this->config->output_path) / "population_data", create_dir_error);
+  if (create_dir_error) {
+    spdlog::warn("Failed to create population_data directory: {}", create_dir_error.message());
+  }
+
+  cells.rehash(this->config->initial_population * 2 + 1);
+  for (uint32_t id = 0; resume == nullptr && id < this->config->initial_population; ++id) {
+    cells.insert({id, Cell(id)});
+  }
+
+  for (const auto& mutation : this->config->mutations) {
+    available_mutation_types[mutation.type_id] = mutation;
+  }
+
+  total_mutation_probability =
+      std::accumulate(available_mutation_types.begin(),
+                      available_mutation_types.end(),
+                      0.0,
+                      [](double sum, const std::pair<const uint8_t, MutationType>& mutation) {
+                        return sum + mutation.second.probability;
+                      });
+
+  if (resume != nullptr) {
+    restoreCheckpoint(*resume);
+  } else {
+    initializePopulationPositions();
+
+    const std::string memory_log_path = this->config->output_path + "/statistics/memory_log.csv";
+    memory_log_file.open(memory_log_path);
+    if (memory_log_file.is_open()) {
+      memory_log_file << CellEvoX::systems::kMemoryLogHeader;
+    }
+  }
+
+  spdlog::info("=== Spatial 3D Lattice Simulation Engine Initialized ===");
+  spdlog::info("Initial population: {}, Capacity: {}, Lattice: {}^3 voxels ({} KB), Tau step: {:.3f}",
+               this->config->initial_population,
+               this->config->env_capacity,
+               lattice_.dim(),
+               lattice_.memoryBytes() / 1024,
+               this->config->tau_step);
+}
+
+ecs::Run SimulationEngine3DLattice::run(uint32_t steps) {
+  CellEvoX::systems::runEngineSteps(steps,
+                                     *config,
+                                     shutdown_requested,
+                                     actual_population,
+                                     tau,
+                                     [this] { step(); },
+                                     [this] { writeCheckpoint(); });
+
+  if (!checkpoint_writer_.wait()) {
+    spdlog::error("Failed to write engine checkpoint: {}",
+                  CellEvoX::io::engineCheckpointPath(config->output_path));
+  }
+  if (!snapshot_sink_.close()) {
+    spdlog::error("Failed to finalize population snapshot container");
+  }
+
+  return ecs::Run(std::move(cells),
+                  std::move(available_mutation_types),
+                  std::move(cells_graveyard),
+                  std::move(generational_stat_report),
+                  std::move(generational_popul_report),
+                  total_deaths,
+                  tau);
+}
+
+void SimulationEngine3DLattice::step() {
+  CELLEVOX_PROFILE_PHASE("3d_lattice_step_total");
+  tau += config->tau_step;
+  ++completed_steps_;
+
+  CellEvoX::systems::CommonPopulationStepResult step_result;
+  {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_common_population_step");
+    step_result = CellEvoX::systems::applyCommonPopulationStep(cells,
+                                                               cells_graveyard,
+                                                               *config,
+                                                               available_mutation_types,
+                                                               total_mutation_probability,
+                                                               actual_population,
+                                                               total_deaths,
+                                                               tau,
+                                                               event_rng_);
+  }
+  {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_apply_events");
+    applyLatticeEvents(step_result);
+  }
+
+  const int current_tau = tauSnapshotIndex(tau);
+  if (config->stat_res > 0 && current_tau % config->stat_res == 0 &&
+      current_tau != last_stat_snapshot_tau) {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_stat_snapshot");
+    generational_stat_report.push_back(CellEvoX::systems::computeStatSnapshot(cells, tau));
+    last_stat_snapshot_tau = current_tau;
+  }
+
+  if (config->popul_res > 0 && current_tau % config->popul_res == 0 &&
+      current_tau != last_population_snapshot_tau) {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_population_snapshot");
+    takePopulationSnapshot();
+    last_population_snapshot_tau = current_tau;
+  }
+
+  if (config->graveyard_pruning_interval > 0 &&
+      current_tau > 0 &&
+      current_tau % config->graveyard_pruning_interval == 0 &&
+      current_tau != last_pruning_tau) {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_graveyard_pruning");
+    CellEvoX::systems::pruneUnreachableGraveyard(cells, cells_graveyard);
+    last_pruning_tau = current_tau;
+  }
+
+  if (config->stat_res > 0 && current_tau % config->stat_res == 0 &&
+      current_tau != last_memory_log_tau) {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_memory_log");
+    CellEvoX::systems::appendMemoryLogRow(
+        memory_log_file, tau, cells.size(), cells_graveyard.size());
+    last_memory_log_tau = current_tau;
+  }
+
+  if (config->checkpoint_interval > 0 && current_tau % config->checkpoint_interval == 0 &&
+      current_tau != last_checkpoint_tau) {
+    CELLEVOX_PROFILE_PHASE("3d_lattice_checkpoint");
+    last_checkpoint_tau = current_tau;
+    writeCheckpoint();
+  }
+}
+
+void SimulationEngine3DLattice::stop() {
+  spdlog::info("Spatial 3D lattice simulation stopped");
+}
+
+void SimulationEngine3DLattice::initializePopulationPositions() {
+  const uint32_t initial_population = static_cast<uint32_t>(config->initial_population);
+  id_voxel_.clear();
+  id_voxel_.reserve(initial_population);
+  if (initial_population == 0) {
+    return;
+  }
+
+  // A solid cube of cells centered in the lattice seeds the Eden-like growth.
+  const int dim = lattice_.dim();
+  const int cells_per_axis = std::min(
+      dim, std::max(1, static_cast<int>(std::ceil(std::cbrt(initial_population)))));
+  const int origin = (dim - cells_per_axis) / 2;
+  const auto per_axis = static_cast<uint32_t>(cells_per_axis);
+  for (uint32_t id = 0; id < initial_population; ++id) {
+    const uint32_t layer = id / (per_axis * per_axis);
+    const int ix = origin + static_cast<int>(id % per_axis);
+    const int iy = origin + static_cast<int>((id / per_axis) % per_axis);
+    // Populations beyond a full cube spill into the next layers; validateConfig() ensures the
+    // lattice has room for every initial cell.
+    const int iz = (origin + static_cast<int>(layer)) % dim;
+    const uint32_t voxel = lattice_.voxelIndex(ix, iy, iz);
+    lattice_.occupy(voxel, id);
+    id_voxel_.insert(id, voxel);
+  }
+}
+
+void SimulationEngine3DLattice::applyLatticeEvents(
+    const CellEvoX::systems::CommonPopulationStepResult& step_result) {
+  const auto& births = step_result.births;
+  const auto& deaths = step_result.deaths;
+
+  // Births arrive grouped by ascending parent id and deaths sorted by id, so dividing parents
+  // can be told apart from plain deaths with one merge.
+  dividing_parents_.clear();
+  for (const auto& birth : births) {
+    if (dividing_parents_.empty() || dividing_parents_.back() != birth.parent_id) {
+      dividing_parents_.push_back(birth.parent_id);
+    }
+  }
+
+  // Free the voxels of plain deaths first so daughters placed below can use them.
+  size_t parent_cursor = 0;
+  for (const auto& death : deaths) {
+    while (parent_cursor < dividing_parents_.size() &&
+           dividing_parents_[parent_cursor] < death.id) {
+      ++parent_cursor;
+    }
+    if (parent_cursor < dividing_parents_.size() &&
+        dividing_parents_[parent_cursor] == death.id) {
+      continue;
+    }
+    const uint32_t voxel = id_voxel_.find(death.id);
+    if (voxel != kNoVoxel) {
+      lattice_.release(voxel);
+      id_voxel_.erase(death.id);
+    }
+  }
+
+  // O(births) plus the push distance of daughters born inside the tumor. Sequential so the
+  // spatial RNG stream, and with it the final layout, does not depend on thread scheduling.
+  size_t index = 0;
+  while (index < births.size()) {
+    const uint32_t parent_id = births[index].parent_id;
+    const uint32_t parent_voxel = id_voxel_.find(parent_id);
+    size_t group_end = index + 1;
+    while (group_end < births.size() && births[group_end].parent_id == parent_id) {
+      ++group_end;
+    }
+
+    if (parent_voxel == kNoVoxel) {
+      spdlog::error("Dividing cell {} has no lattice voxel", parent_id);
+      for (size_t k = index; k < group_end; ++k) {
+        discardUnplacedDaughter(births[k].id);
+      }
+      index = group_end;
+      continue;
+    }
+
+    id_voxel_.erase(parent_id);
+    const uint32_t first_id = births[index].id;
+    lattice_.occupy(parent_voxel, first_id);
+    id_voxel_.insert(first_id, parent_voxel);
+    for (size_t k = index + 1; k < group_end; ++k) {
+      if (!placeDaughter(parent_voxel, births[k].id)) {
+        discardUnplacedDaughter(births[k].id);
+      }
+    }
+    index = group_end;
+  }
+}
+
+bool SimulationEngine3DLattice::placeDaughter(uint32_t parent_voxel, uint32_t id) {
+  using CellEvoX::spatial::LatticeOccupancy;
+  const auto [px, py, pz] = lattice_.coordinates(parent_voxel);
+
+  // Random free neighbor voxel, chosen by reservoir sampling over the Moore neighborhood.
+  uint32_t chosen = kNoVoxel;
+  uint32_t free_seen = 0;
+  for (const auto& offset : LatticeOccupancy::kNeighborOffsets) {
+    const int nx = px + offset[0];
+    const int ny = py + offset[1];
+    const int nz = pz + offset[2];
+    if (!lattice_.inBounds(nx, ny, nz)) {
+      continue;
+    }
+    const uint32_t voxel = lattice_.voxelIndex(nx, ny, nz);
+    if (lattice_.isOccupied(voxel)) {
+      continue;
+    }
+    ++free_seen;
+    if (std::uniform_int_distribution<uint32_t>(0, free_seen - 1)(spatial_rng_) == 0) {
+      chosen = voxel;
+    }
+  }
+  if (chosen != kNoVoxel) {
+    lattice_.occupy(chosen, id);
+    id_voxel_.insert(id, chosen);
+    return true;
+  }
+
+  // Fully surrounded: march all 26 rays in lockstep and push the cells on the first ray that
+  // reaches a free voxel one step outward. O(26 * push distance); the random starting ray
+  // breaks ties between equally short rays.
+  const size_t ray_count = LatticeOccupancy::kNeighborOffsets.size();
+  const size_t first_ray =
+      std::uniform_int_distribution<size_t>(0, ray_count - 1)(spatial_rng_);
+  for (int distance = 2; distance <= lattice_.dim(); ++distance) {
+    bool any_ray_in_bounds = false;
+    for (size_t r = 0; r < ray_count; ++r) {
+      const auto& offset = LatticeOccupancy::kNeighborOffsets[(first_ray + r) % ray_count];
+      const int ex = px + offset[0] * distance;
+      const int ey = py + offset[1] * distance;
+      const int ez = pz + offset[2] * distance;
+      if (!lattice_.inBounds(ex, ey, ez)) {
+        continue;
+      }
+      any_ray_in_bounds = true;
+      if (lattice_.isOccupied(lattice_.voxelIndex(ex, ey, ez))) {
+        continue;
+      }
+
+      for (int k = distance - 1; k >= 1; --k) {
+        const uint32_t from = lattice_.voxelIndex(
+            px + offset[0] * k, py + offset[1] * k, pz + offset[2] * k);
+        const uint32_t to = lattice_.voxelIndex(
+            px + offset[0] * (k + 1), py + offset[1] * (k + 1), pz + offset[2] * (k + 1));
+        const uint32_t moved_id = lattice_.ownerOf(from);
+        lattice_.occupy(to, moved_id);
+        id_voxel_.update(moved_id, to);
+      }
+      const uint32_t target = lattice_.voxelIndex(px + offset[0], py + offset[1], pz + offset[2]);
+      lattice_.occupy(target, id);
+      id_voxel_.insert(id, target);
+      return true;
+    }
+    if (!any_ray_in_bounds) {
+      break;
+    }
+  }
+  return false;
+}
+
+void SimulationEngine3DLattice::discardUnplacedDaughter(uint32_t id) {
+  // The lattice is saturated along every ray; the daughter dies at birth. Counting it as a
+  // death keeps the next id (population + deaths) unique.
+  CellMap::const_accessor accessor;
+  if (!cells.find(accessor, id)) {
+    return;
+  }
+  cells_graveyard.insert({id, {accessor->second.parent_id, tau}});
+  accessor.release();
+  cells.erase(id);
+  ++total_deaths;
+  --actual_population;
+}
+
+void SimulationEngine3DLattice::takePopulationSnapshot() {
+  std::vector<uint32_t> sorted_ids;
+  sorted_ids.reserve(cells.size());
+  for (const auto& cell : cells) {
+    sorted_ids.push_back(cell.first);
+  }
+  CellEvoX::parallel_algorithms::sortMaybeParallel(sorted_ids.begin(), sorted_ids.end());
+
+  std::vector<CellEvoX::io::PopulationSnapshotRecord> snapshot;
+  std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> mutation_payload;
+  snapshot.reserve(sorted_ids.size());
+  const auto payload_kind = config->full_mutation_payload
+                                ? CellEvoX::io::MutationPayloadKind::Full
+                                : CellEvoX::io::MutationPayloadKind::DriverOnly;
+
+  for (const uint32_t id : sorted_ids) {
+    CellMap::const_accessor accessor;
+    const uint32_t voxel = id_voxel_.find(id);
+    if (voxel == kNoVoxel || !cells.find(accessor, id)) {
+      continue;
+    }
+
+    if (mutation_payload.size() > std::numeric_limits<uint32_t>::max()) {
+      spdlog::error("Population snapshot mutation payload exceeds uint32_t offset space");
+      return;
+    }
+    const uint32_t mutation_payload_offset = static_cast<uint32_t>(mutation_payload.size());
+    for (const auto& [mutation_id, mutation_type] : accessor->second.mutations) {
+      const auto type_it = available_mutation_types.find(mutation_type);
+      if (config->full_mutation_payload ||
+          (type_it != available_mutation_types.end() && type_it->second.is_driver)) {
+        mutation_payload.push_back({mutation_id, mutation_type});
+      }
+    }
+    const auto mutation_payload_count =
+        static_cast<uint16_t>(std::min<size_t>(mutation_payload.size() - mutation_payload_offset,
+                                               std::numeric_limits<uint16_t>::max()));
+
+    // Voxel centers: odd integers in domain units for the 2 * CELL_RADIUS lattice spacing.
+    const auto [ix, iy, iz] = lattice_.coordinates(voxel);
+    snapshot.push_back({id,
+                        accessor->second.parent_id,
+                        accessor->second.fitness,
+                        voxelCenter(ix),
+                        voxelCenter(iy),
+                        voxelCenter(iz),
+                        static_cast<uint16_t>(std::min<size_t>(
+                            accessor->second.mutations.size(),
+                            std::numeric_limits<uint16_t>::max())),
+                        mutation_payload_count,
+                        mutation_payload_offset,
+                        1,
+                        {0, 0, 0}});
+  }
+
+  const int generation = tauSnapshotIndex(tau);
+  const CellEvoX::io::PopulationSnapshotEncoding encoding{
+      config->snapshot_format == SnapshotFormat::Columnar, config->snapshot_position_quantum};
+  if (!snapshot_sink_.write(generation, tau, 3, snapshot, mutation_payload, payload_kind,
+                            encoding)) {
+    spdlog::error("Failed to write population snapshot file: {}",
+                  snapshot_sink_.describe(generation));
+    return;
+  }
+  if (!CellEvoX::io::writeVoxelAggregatesFor(config->output_path, config->voxel_lod_resolutions,
+                                             generation, tau, snapshot, mutation_payload,
+                                             available_mutation_types)) {
+    spdlog::error("Failed to write voxel LOD file: {}",
+                  CellEvoX::io::voxelAggregatePath(config->output_path, generation).string());
+  }
+}
+
+float SimulationEngine3DLattice::voxelCenter(int index) const {
+  return (static_cast<float>(index) + 0.5f) * 2.0f * CELL_RADIUS;
+}
+
+// O(cells log cells + graveyard) on the simulation thread; only the file write is asynchronous.
+// The lattice is stored as the voxel of every live cell and rebuilt from it.
+void SimulationEngine3DLattice::writeCheckpoint() {
+  CellEvoX::io::CheckpointWriter writer;
+  CellEvoX::systems::saveCellMap(writer, cells);
+  CellEvoX::systems::saveGraveyard(writer, cells_graveyard);
+  writer.putVector(generational_stat_report);
+  writer.put<uint64_t>(actual_population);
+  writer.put<uint64_t>(total_deaths);
+  writer.put(tau);
+  writer.put<int32_t>(last_stat_snapshot_tau);
+  writer.put<int32_t>(last_population_snapshot_tau);
+  writer.put<int32_t>(last_memory_log_tau);
+  writer.put<int32_t>(last_pruning_tau);
+  writer.put<int32_t>(last_checkpoint_tau);
+  writer.putRng(event_rng_);
+  writer.putRng(spatial_rng_);
+  std::vector<uint32_t> ids;
+  ids.reserve(cells.size());
+  for (const auto& cell_entry : cells) {
+    ids.push_back(cell_entry.first);
+  }
+  std::sort(ids.begin(), ids.end());
+  std::vector<uint32_t> voxels(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    voxels[i] = id_voxel_.find(ids[i]);
+  }
+  writer.putVector(ids);
+  writer.putVector(voxels);
+  writer.put(CellEvoX::systems::flushedOutputSize(memory_log_file));
+
+  const auto path = CellEvoX::io::engineCheckpointPath(config->output_path);
+  if (!checkpoint_writer_.submit(
+          path,
+          CellEvoX::systems::makeCheckpointHeader(*config, completed_steps_),
+          std::move(writer.bytes()))) {
+    spdlog::error("Failed to write engine checkpoint: {}", path);
+  }
+}
+
+void SimulationEngine3DLattice::restoreCheckpoint(
+    const CellEvoX::io::EngineCheckpoint& checkpoint) {
+  CellEvoX::systems::requireMatchingCheckpoint(checkpoint, *config);
+  auto reader = checkpoint.reader();
+  CellEvoX::systems::restoreCellMap(reader, cells);
+  CellEvoX::systems::restoreGraveyard(reader, cells_graveyard);
+  reader.getVector(generational_stat_report);
+  uint64_t population = 0;
+  uint64_t deaths = 0;
+  reader.get(population);
+  reader.get(deaths);
+  reader.get(tau);
+  reader.get(last_stat_snapshot_tau);
+  reader.get(last_population_snapshot_tau);
+  reader.get(last_memory_log_tau);
+  reader.get(last_pruning_tau);
+  reader.get(last_checkpoint_tau);
+  reader.getRng(event_rng_);
+  reader.getRng(spatial_rng_);
+  std::vector<uint32_t> ids;
+  std::vector<uint32_t> voxels;
+  reader.getVector(ids);
+  reader.getVector(voxels);
+  uint64_t memory_log_size = 0;
+  reader.get(memory_log_size);
+  CellEvoX::systems::requireCompleteCheckpoint(reader);
+  if (voxels.size() != ids.size()) {
+    throw std::runtime_error("Engine checkpoint has inconsistent lattice state");
+  }
+
+  actual_population = static_cast<size_t>(population);
+  total_deaths = static_cast<size_t>(deaths);
+  completed_steps_ = checkpoint.header.completed_steps;
+  id_voxel_.clear();
+  id_voxel_.reserve(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (voxels[i] == CellEvoX::spatial::LiveIdIndex::kNotFound) {
+      continue;
+    }
+    if (voxels[i] >= lattice_.voxelCount() || lattice_.isOccupied(voxels[i])) {
+      throw std::runtime_error("Engine checkpoint places cells outside or on top of each other");
+    }
+    lattice_.occupy(voxels[i], ids[i]);
+    id_voxel_.insert(ids[i], voxels[i]);
+  }
+
+  if (!snapshot_sink_.resume(last_population_snapshot_tau)) {
+    spdlog::error("Failed to rewind population snapshots to generation {}",
+                  last_population_snapshot_tau);
+  }
+  const auto memory_log_path =
+      std::filesystem::path(config->output_path) / "statistics" / "memory_log.csv";
+  if (!CellEvoX::systems::resumeOutputFile(memory_log_file, memory_log_path, memory_log_size)) {
+    spdlog::warn("Failed to resume memory log file at: {}", memory_log_path.string());
+  }
+  spdlog::info("Resumed from checkpoint at tau={:.4f} after {} steps", tau, completed_steps_);
+}
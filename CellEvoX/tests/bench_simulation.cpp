@@ -2,17 +2,31 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/benchmark/catch_benchmark_all.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <random>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
 #include "io/PopulationSnapshotIO.hpp"
+#include "spatial/MortonReorder.hpp"
+#include "spatial/NeighborKernels.hpp"
+#include "spatial/SpatialHashGrid.hpp"
 #include "systems/CommonPopulationStep.hpp"
+#include "systems/MechanicalRelaxation.hpp"
+#include "systems/NutrientField.hpp"
 #include "systems/SimulationEngine.hpp"
 #include "systems/SimulationEngine3D.hpp"
 #include "utils/SimulationConfig.hpp"
@@ -356,6 +370,278 @@ TEST_CASE("Simulation: 2D vs 3D Time Comparison", "[benchmark][timing-comparison
     };
 }
 
+TEST_CASE("Spatial mechanics neighbor modes", "[benchmark][mechanics][perf-mechanics]") {
+    std::filesystem::create_directories(benchmarkTempPath("test_bench_sim_3d") / "statistics");
+
+    // Dense packing so the relaxation kernel dominates the step.
+    const std::vector<MechanicsNeighborMode> modes{
+        MechanicsNeighborMode::Grid, MechanicsNeighborMode::Verlet, MechanicsNeighborMode::HalfStencil};
+    for (const auto mode : modes) {
+        BENCHMARK(std::string("3D run() N=50000 x2 steps substeps=8 [") + utils::toString(mode) + "]") {
+            auto cfg = makeSpatial3DConfig(50000, 40.0f, 8.0f, 8);
+            cfg->mech_neighbor_mode = mode;
+            SimulationEngine3D eng(cfg);
+            return eng.run(2);
+        };
+    }
+}
+
+TEST_CASE("Spatial neighbor queries before and after Morton reordering", "[benchmark][mechanics][perf-reorder]") {
+    // Birth-order arrays place spatial neighbors far apart in memory; model that with a
+    // uniformly random cloud and compare against the same cells after a Morton reorder. Each
+    // ordering gets its own grid built from its own arrays, and both runs query the same cells
+    // (every kQueryStride-th id), each in its ordering's storage order.
+    constexpr size_t kCells = 2000000;
+    constexpr uint32_t kQueryStride = 8;
+    constexpr float kDomain = 200.0f;
+    std::mt19937 rng(91);
+    std::uniform_real_distribution<float> coord(0.0f, kDomain);
+    std::vector<uint32_t> ids(kCells);
+    std::vector<float> px(kCells);
+    std::vector<float> py(kCells);
+    std::vector<float> pz(kCells);
+    for (size_t i = 0; i < kCells; ++i) {
+        ids[i] = static_cast<uint32_t>(i);
+        px[i] = coord(rng);
+        py[i] = coord(rng);
+        pz[i] = coord(rng);
+    }
+
+    auto morton_ids = ids;
+    auto morton_x = px;
+    auto morton_y = py;
+    auto morton_z = pz;
+    CellEvoX::spatial::MortonReorder reorder(2.0f);
+    reorder.reorder(morton_ids, morton_x, morton_y, morton_z);
+    REQUIRE(reorder.baselineLocality() < CellEvoX::spatial::meanConsecutiveDistance(px, py, pz));
+
+    const auto query_slots = [&](const std::vector<uint32_t>& slot_ids) {
+        std::vector<uint32_t> slots;
+        for (size_t slot = 0; slot < slot_ids.size(); ++slot) {
+            if (slot_ids[slot] % kQueryStride == 0) {
+                slots.push_back(static_cast<uint32_t>(slot));
+            }
+        }
+        return slots;
+    };
+    const auto birth_slots = query_slots(ids);
+    const auto morton_slots = query_slots(morton_ids);
+    REQUIRE(birth_slots.size() == morton_slots.size());
+
+    SpatialHashGrid birth_grid(2.0f, kDomain);
+    birth_grid.rebuild(ids, px, py, pz);
+    SpatialHashGrid morton_grid(2.0f, kDomain);
+    morton_grid.rebuild(morton_ids, morton_x, morton_y, morton_z);
+
+    const auto query_all = [&](const SpatialHashGrid& grid,
+                               const std::vector<uint32_t>& slots,
+                               const std::vector<float>& qx,
+                               const std::vector<float>& qy,
+                               const std::vector<float>& qz) {
+        // Same access pattern as the density sampling loop in stochasticStep3D.
+        return tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, slots.size()),
+            uint64_t{0},
+            [&](const tbb::blocked_range<size_t>& range, uint64_t neighbors) {
+                for (size_t k = range.begin(); k != range.end(); ++k) {
+                    const uint32_t i = slots[k];
+                    neighbors +=
+                        CellEvoX::spatial::countNeighborsWithin(grid, qx[i], qy[i], qz[i], 3.0f);
+                }
+                return neighbors;
+            },
+            std::plus<>{});
+    };
+    // Same cells, so the same neighbor total; only the memory order differs.
+    REQUIRE(query_all(birth_grid, birth_slots, px, py, pz) ==
+            query_all(morton_grid, morton_slots, morton_x, morton_y, morton_z));
+
+    BENCHMARK("neighbor queries N=2000000 x250000 r=3 [birth order]") {
+        return query_all(birth_grid, birth_slots, px, py, pz);
+    };
+
+    BENCHMARK("neighbor queries N=2000000 x250000 r=3 [morton order]") {
+        return query_all(morton_grid, morton_slots, morton_x, morton_y, morton_z);
+    };
+}
+
+TEST_CASE("Spatial neighbor kernels over sorted SoA copies", "[benchmark][mechanics][perf-kernels]") {
+    constexpr size_t kCells = 250000;
+    constexpr size_t kQueries = 50000;
+    constexpr float kDomain = 126.0f;  // about 0.125 cells per unit volume
+    constexpr float kRadius = 3.0f;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(0.0f, kDomain);
+    std::vector<uint32_t> ids(kCells);
+    std::vector<float> px(kCells);
+    std::vector<float> py(kCells);
+    std::vector<float> pz(kCells);
+    for (size_t i = 0; i < kCells; ++i) {
+        ids[i] = static_cast<uint32_t>(i);
+        px[i] = coord(rng);
+        py[i] = coord(rng);
+        pz[i] = coord(rng);
+    }
+    SpatialHashGrid grid(2.0f, kDomain);
+    grid.rebuild(ids, px, py, pz);
+
+    // The per-candidate id lookup into the unsorted arrays that the SoA kernels replaced.
+    const auto count_by_id = [&](size_t i) {
+        uint32_t count = 0;
+        grid.queryRadius(px[i], py[i], pz[i], kRadius, [&](uint32_t id) {
+            const float dx = px[id] - px[i];
+            const float dy = py[id] - py[i];
+            const float dz = pz[id] - pz[i];
+            count += dx * dx + dy * dy + dz * dz <= kRadius * kRadius ? 1u : 0u;
+        });
+        return count;
+    };
+    const auto count_soa = [&](size_t i) {
+        return CellEvoX::spatial::countNeighborsWithin(grid, px[i], py[i], pz[i], kRadius);
+    };
+    const auto sum_queries = [&](const auto& count) {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kQueries; ++i) {
+            total += count(i);
+        }
+        return total;
+    };
+    REQUIRE(sum_queries(count_by_id) == sum_queries(count_soa));
+
+    BENCHMARK("density count N=250000 x50000 r=3 [id lookup]") {
+        return sum_queries(count_by_id);
+    };
+
+    BENCHMARK("density count N=250000 x50000 r=3 [soa kernel]") {
+        return sum_queries(count_soa);
+    };
+}
+
+TEST_CASE("Dense spatial grid rebuild against the counting sort", "[benchmark][mechanics][perf-rebuild]") {
+    constexpr size_t kCells = 1000000;
+    constexpr float kDomain = 200.0f;  // 100^3 voxels of size 2, the dense-range limit
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coord(0.0f, kDomain);
+    std::vector<uint32_t> ids(kCells);
+    std::vector<float> px(kCells);
+    std::vector<float> py(kCells);
+    std::vector<float> pz(kCells);
+    for (size_t i = 0; i < kCells; ++i) {
+        ids[i] = static_cast<uint32_t>(i);
+        px[i] = coord(rng);
+        py[i] = coord(rng);
+        pz[i] = coord(rng);
+    }
+    SpatialHashGrid grid(2.0f, kDomain);
+    const auto dims = grid.gridDims();
+    const size_t voxel_count = static_cast<size_t>(dims[0]) * dims[1] * dims[2];
+    const auto voxel_of = [&](size_t i) {
+        const auto axis = [&](float value, int dim) {
+            return std::clamp(static_cast<int>(std::floor(value / 2.0f)), 0, dim - 1);
+        };
+        return static_cast<size_t>(axis(px[i], dims[0])) +
+               static_cast<size_t>(axis(py[i], dims[1])) * dims[0] +
+               static_cast<size_t>(axis(pz[i], dims[2])) * dims[0] * dims[1];
+    };
+
+    // The baseline dense path: per-thread voxel histograms, a serial scan and a serial scatter,
+    // extended with the voxel ranges and sorted positions rebuild() also produces.
+    std::vector<uint32_t> cell_voxel(kCells);
+    std::vector<uint32_t> counting_sorted(kCells);
+    std::vector<std::pair<int32_t, int32_t>> counting_ranges(voxel_count);
+    std::vector<float> sorted_x(kCells);
+    std::vector<float> sorted_y(kCells);
+    std::vector<float> sorted_z(kCells);
+    const auto counting_sort = [&] {
+        tbb::enumerable_thread_specific<std::vector<int32_t>> local_counts(
+            [voxel_count] { return std::vector<int32_t>(voxel_count, 0); });
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, kCells), [&](const tbb::blocked_range<size_t>& range) {
+            auto& counts = local_counts.local();
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                cell_voxel[i] = static_cast<uint32_t>(voxel_of(i));
+                ++counts[cell_voxel[i]];
+            }
+        });
+        std::vector<int32_t> offsets(voxel_count, 0);
+        for (const auto& counts : local_counts) {
+            for (size_t voxel = 0; voxel < voxel_count; ++voxel) {
+                offsets[voxel] += counts[voxel];
+            }
+        }
+        int32_t running = 0;
+        for (size_t voxel = 0; voxel < voxel_count; ++voxel) {
+            const int32_t begin = running;
+            running += offsets[voxel];
+            counting_ranges[voxel] = {begin, running};
+            offsets[voxel] = begin;
+        }
+        for (size_t i = 0; i < kCells; ++i) {
+            const auto slot = static_cast<size_t>(offsets[cell_voxel[i]]++);
+            counting_sorted[slot] = ids[i];
+            sorted_x[slot] = px[i];
+            sorted_y[slot] = py[i];
+            sorted_z[slot] = pz[i];
+        }
+        return counting_sorted.front();
+    };
+
+    counting_sort();
+    grid.rebuild(ids, px, py, pz);
+    REQUIRE(grid.sortedIds() == counting_sorted);
+    REQUIRE(grid.sortedX() == sorted_x);
+
+    BENCHMARK("dense rebuild N=1000000 voxels=100^3 [counting sort]") {
+        return counting_sort();
+    };
+
+    BENCHMARK("dense rebuild N=1000000 voxels=100^3 [radix rebuild]") {
+        grid.rebuild(ids, px, py, pz);
+        return grid.sortedIds().front();
+    };
+}
+
+TEST_CASE("Nutrient V-cycle versus mechanical relaxation", "[benchmark][nutrient][perf-nutrient]") {
+    // One cell per fine field voxel on average, so both solvers see the same N. The field's
+    // fine level is aligned with the 64^3 hash grid used by the relaxation.
+    constexpr size_t kCells = 262144;
+    constexpr float kDomain = 128.0f;
+    SimulationConfig config;
+    config.spatial_domain_size = kDomain;
+    config.nutrient_vcycles = 1;
+    config.mech_substeps = 1;
+    config.mech_dt = 0.05f;
+    config.spring_constant = 0.2f;
+
+    std::mt19937 rng(53);
+    std::uniform_real_distribution<float> coord(0.0f, kDomain);
+    std::vector<uint32_t> ids(kCells);
+    std::vector<float> px(kCells);
+    std::vector<float> py(kCells);
+    std::vector<float> pz(kCells);
+    for (size_t i = 0; i < kCells; ++i) {
+        ids[i] = static_cast<uint32_t>(i);
+        px[i] = coord(rng);
+        py[i] = coord(rng);
+        pz[i] = coord(rng);
+    }
+    SpatialHashGrid grid(2.0f, kDomain);
+    grid.rebuild(ids, px, py, pz);
+
+    CellEvoX::systems::NutrientField field(grid);
+    REQUIRE(static_cast<size_t>(field.dim()) * field.dim() * field.dim() == kCells);
+    CellEvoX::systems::MechanicalRelaxation mechanics(config, 2.0f);
+
+    BENCHMARK("nutrient update N=262144 voxels=64^3 x1 V-cycle") {
+        field.update(config, grid);
+        return field.lastResidual();
+    };
+
+    BENCHMARK("mechanical relaxation N=262144 x1 substep [grid]") {
+        mechanics.relax(config, ids, px, py, pz, grid);
+        return mechanics.lastStats().iterations;
+    };
+}
+
 TEST_CASE("Population snapshot serialization tradeoff", "[benchmark][snapshot-serialization][perf-snapshot]") {
     const auto non_spatial_input = makeSyntheticSnapshotInput(2000000, 4, false);
     const auto spatial_input = makeSyntheticSnapshotInput(2000000, 4, true);
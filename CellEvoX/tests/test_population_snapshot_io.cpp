@@ -2,13 +2,23 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <algorithm>
+#include <bitset>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <random>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include "capi/cellevox_snapshot.h"
+#include "io/EngineCheckpoint.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
 #include "io/PopulationSnapshotIO.hpp"
+#include "io/PopulationSnapshotView.hpp"
+#include "io/VoxelAggregateIO.hpp"
 
 namespace {
 
@@ -186,3 +196,620 @@ TEST_CASE("PopulationSnapshotIO rejects unknown snapshot sizes", "[PopulationSna
     std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
     REQUIRE_FALSE(CellEvoX::io::readPopulationSnapshot(snapshot_path, header, records));
 }
+
+TEST_CASE("BlockCompressor round-trips and rejects corrupt blocks", "[PopulationSnapshotIO][Columnar]") {
+    std::mt19937 rng(5);
+    std::vector<uint8_t> noise(3000);
+    for (auto& byte : noise) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    std::vector<uint8_t> runs;
+    for (int i = 0; i < 70000; ++i) {
+        runs.push_back(static_cast<uint8_t>((i / 300) % 3));
+    }
+
+    for (const auto& input : {std::vector<uint8_t>{}, std::vector<uint8_t>{7, 7}, noise, runs}) {
+        std::vector<uint8_t> compressed;
+        CellEvoX::io::compressBlock(input.data(), input.size(), compressed);
+        std::vector<uint8_t> restored;
+        REQUIRE(CellEvoX::io::decompressBlock(
+            compressed.data(), compressed.size(), input.size(), restored));
+        REQUIRE(restored == input);
+    }
+
+    std::vector<uint8_t> compressed;
+    CellEvoX::io::compressBlock(runs.data(), runs.size(), compressed);
+    REQUIRE(compressed.size() * 50 < runs.size());
+    std::vector<uint8_t> restored;
+    REQUIRE_FALSE(CellEvoX::io::decompressBlock(
+        compressed.data(), compressed.size(), runs.size() - 1, restored));
+    REQUIRE_FALSE(CellEvoX::io::decompressBlock(
+        compressed.data(), compressed.size() / 2, runs.size(), restored));
+}
+
+TEST_CASE("PopulationSnapshotIO round-trips columnar V3 snapshots", "[PopulationSnapshotIO][Columnar]") {
+    constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+    const float fitness_levels[] = {1.0f, 1.1f, 1.21f};
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> coordinate(-20.0f, 180.0f);
+
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records_3d;
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records_2d;
+    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> payload;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        const uint32_t id = 3 * i + (i % 2);
+        const auto offset = static_cast<uint32_t>(payload.size());
+        const uint16_t payload_count = static_cast<uint16_t>(i % 3);
+        for (uint16_t k = 0; k < payload_count; ++k) {
+            payload.push_back({id / 4 + k, static_cast<uint8_t>(1 + k)});
+        }
+        const float fitness = fitness_levels[i % 3];
+        records_3d.push_back({id, id / 2, fitness, coordinate(rng), coordinate(rng),
+                              coordinate(rng), static_cast<uint16_t>(i % 9), payload_count,
+                              offset, static_cast<uint8_t>(i % 50 != 0), {0, 0, 0}});
+        records_2d.push_back({id, id / 2, fitness, kNaN, kNaN, kNaN,
+                              static_cast<uint16_t>(i % 9), payload_count, offset, 0, {0, 0, 0}});
+    }
+    // A non-contiguous payload offset still round-trips.
+    records_3d[10].driver_mutation_offset = 3;
+
+    const CellEvoX::io::PopulationSnapshotEncoding columnar{true};
+    const auto path_3d = testTempPath("columnar_population_snapshot_3d.bin");
+    const auto path_rows = testTempPath("rows_population_snapshot_3d.bin");
+    const auto path_2d = testTempPath("columnar_population_snapshot_2d.bin");
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        path_3d, 7.5, 3, records_3d, payload, CellEvoX::io::MutationPayloadKind::Full, columnar));
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        path_rows, 7.5, 3, records_3d, payload, CellEvoX::io::MutationPayloadKind::Full));
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        path_2d, 2.0, 0, records_2d, {}, CellEvoX::io::MutationPayloadKind::DriverOnly, columnar));
+
+    {
+        std::ifstream file(path_3d, std::ios::binary);
+        CellEvoX::io::PopulationSnapshotFileHeaderV3 on_disk{};
+        file.read(reinterpret_cast<char*>(&on_disk), sizeof(on_disk));
+        REQUIRE(on_disk.version == CellEvoX::io::kPopulationSnapshotColumnarVersion);
+    }
+    REQUIRE(std::filesystem::file_size(path_3d) * 2 < std::filesystem::file_size(path_rows));
+    REQUIRE(std::filesystem::file_size(path_2d) * 5 < std::filesystem::file_size(path_rows));
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> loaded;
+    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> loaded_payload;
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(path_3d, header, loaded, loaded_payload));
+    REQUIRE(header.version == CellEvoX::io::kPopulationSnapshotVersion);
+    REQUIRE(header.tau == Catch::Approx(7.5));
+    REQUIRE(header.spatial_dimensions == 3);
+    REQUIRE(CellEvoX::io::hasFullMutationPayload(header));
+    REQUIRE(loaded.size() == records_3d.size());
+    REQUIRE(loaded_payload.size() == payload.size());
+    const float tolerance = CellEvoX::io::kDefaultSnapshotPositionQuantum;
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        const auto& expected = records_3d[i];
+        REQUIRE(loaded[i].id == expected.id);
+        REQUIRE(loaded[i].parent_id == expected.parent_id);
+        REQUIRE(loaded[i].fitness == expected.fitness);
+        REQUIRE(loaded[i].mutations_count == expected.mutations_count);
+        REQUIRE(loaded[i].driver_mutation_count == expected.driver_mutation_count);
+        REQUIRE(loaded[i].driver_mutation_offset == expected.driver_mutation_offset);
+        REQUIRE(loaded[i].position_valid == expected.position_valid);
+        if (expected.position_valid != 0) {
+            REQUIRE(std::abs(loaded[i].x - expected.x) <= tolerance);
+            REQUIRE(std::abs(loaded[i].y - expected.y) <= tolerance);
+            REQUIRE(std::abs(loaded[i].z - expected.z) <= tolerance);
+        } else {
+            REQUIRE(std::isnan(loaded[i].x));
+        }
+    }
+    for (size_t i = 0; i < payload.size(); ++i) {
+        REQUIRE(loaded_payload[i].mutation_id == payload[i].mutation_id);
+        REQUIRE(loaded_payload[i].mutation_type == payload[i].mutation_type);
+    }
+
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(path_2d, header, loaded, loaded_payload));
+    REQUIRE(header.spatial_dimensions == 0);
+    REQUIRE_FALSE(CellEvoX::io::hasAnyMutationPayload(header));
+    REQUIRE(loaded.size() == records_2d.size());
+    REQUIRE(loaded_payload.empty());
+    REQUIRE(loaded[4999].id == records_2d[4999].id);
+    REQUIRE(std::isnan(loaded[4999].z));
+}
+
+TEST_CASE("PopulationSnapshotIO rejects corrupt V3 snapshots", "[PopulationSnapshotIO][Columnar]") {
+    const std::vector<CellEvoX::io::PopulationSnapshotRecord> records = {
+        {1, 0, 1.0f, 1.0f, 2.0f, 3.0f, 3, 0, 0, 1, {0, 0, 0}},
+        {2, 1, 1.1f, 4.0f, 5.0f, 6.0f, 2, 0, 0, 1, {0, 0, 0}}
+    };
+    const auto snapshot_path = testTempPath("corrupt_population_snapshot_v3.bin");
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        snapshot_path, 1.0, 3, records, {}, CellEvoX::io::MutationPayloadKind::DriverOnly,
+        CellEvoX::io::PopulationSnapshotEncoding{true}));
+    std::vector<char> bytes(std::filesystem::file_size(snapshot_path));
+    {
+        std::ifstream file(snapshot_path, std::ios::binary);
+        file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> loaded;
+    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> mutations;
+    {
+        std::ofstream file(snapshot_path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 1));
+    }
+    REQUIRE_FALSE(CellEvoX::io::readPopulationSnapshot(snapshot_path, header, loaded, mutations));
+    REQUIRE(loaded.empty());
+
+    // A record count that disagrees with the columns.
+    auto inflated = bytes;
+    CellEvoX::io::PopulationSnapshotFileHeaderV3 v3{};
+    std::memcpy(&v3, inflated.data(), sizeof(v3));
+    v3.record_count = 3;
+    std::memcpy(inflated.data(), &v3, sizeof(v3));
+    {
+        std::ofstream file(snapshot_path, std::ios::binary | std::ios::trunc);
+        file.write(inflated.data(), static_cast<std::streamsize>(inflated.size()));
+    }
+    REQUIRE_FALSE(CellEvoX::io::readPopulationSnapshot(snapshot_path, header, loaded, mutations));
+
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> unquantizable = records;
+    unquantizable[0].x = std::numeric_limits<float>::infinity();
+    REQUIRE_FALSE(CellEvoX::io::writePopulationSnapshot(
+        snapshot_path, 1.0, 3, unquantizable, {}, CellEvoX::io::MutationPayloadKind::DriverOnly,
+        CellEvoX::io::PopulationSnapshotEncoding{true}));
+}
+
+TEST_CASE("PopulationSnapshotContainer indexes, appends and recovers generations", "[PopulationSnapshotIO][Container]") {
+    using CellEvoX::io::PopulationSnapshotDriverMutation;
+    using CellEvoX::io::PopulationSnapshotRecord;
+    const auto container_path = testTempPath("container_test") / "population_snapshots.bin";
+    std::filesystem::remove_all(container_path.parent_path());
+
+    const auto make_records = [](int generation) {
+        std::vector<PopulationSnapshotRecord> records;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(10 + generation); ++i) {
+            records.push_back({100u * generation + i, i, 1.0f + 0.01f * i, 0.5f * i, 1.0f, 2.0f,
+                               static_cast<uint16_t>(i % 3), i % 2 == 0 ? uint16_t{1} : uint16_t{0},
+                               i / 2, 1, {0, 0, 0}});
+        }
+        return records;
+    };
+    const auto make_payload = [](const std::vector<PopulationSnapshotRecord>& records) {
+        std::vector<PopulationSnapshotDriverMutation> payload;
+        for (const auto& record : records) {
+            if (record.driver_mutation_count > 0) {
+                payload.push_back({record.id, 2});
+            }
+        }
+        return payload;
+    };
+    const auto append = [&](CellEvoX::io::PopulationSnapshotContainerWriter& writer, int generation) {
+        const auto records = make_records(generation);
+        const CellEvoX::io::PopulationSnapshotEncoding encoding{generation % 2 == 0, 1.0f / 64.0f};
+        REQUIRE(writer.append(generation, generation + 0.25, 3, records, make_payload(records),
+                              CellEvoX::io::MutationPayloadKind::Full, encoding));
+    };
+    const auto check = [&](CellEvoX::io::PopulationSnapshotContainerReader& reader, int generation) {
+        const auto* entry = reader.find(generation);
+        REQUIRE(entry != nullptr);
+        CellEvoX::io::PopulationSnapshotFileHeader header{};
+        std::vector<PopulationSnapshotRecord> records;
+        std::vector<PopulationSnapshotDriverMutation> payload;
+        REQUIRE(reader.read(*entry, header, records, payload));
+        const auto expected = make_records(generation);
+        REQUIRE(header.tau == Catch::Approx(generation + 0.25));
+        REQUIRE(entry->record_count == expected.size());
+        REQUIRE(records.size() == expected.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            REQUIRE(records[i].id == expected[i].id);
+            REQUIRE(records[i].x == expected[i].x);
+        }
+        REQUIRE(payload.size() == make_payload(expected).size());
+    };
+
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(container_path));
+        for (int generation = 1; generation <= 3; ++generation) {
+            append(writer, generation);
+        }
+        REQUIRE(writer.close());
+    }
+    CellEvoX::io::PopulationSnapshotContainerReader reader;
+    REQUIRE(reader.open(container_path));
+    REQUIRE_FALSE(reader.recovered());
+    REQUIRE(reader.entries().size() == 3);
+    check(reader, 3);
+    check(reader, 1);
+    REQUIRE(reader.find(4) == nullptr);
+
+    // Reopening appends after the existing frames and rewrites the index.
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(container_path));
+        REQUIRE(writer.entries().size() == 3);
+        append(writer, 4);
+        append(writer, 5);
+    }
+    REQUIRE(reader.open(container_path));
+    REQUIRE_FALSE(reader.recovered());
+    REQUIRE(reader.entries().size() == 5);
+    check(reader, 2);
+    check(reader, 5);
+
+    // A crash mid-append leaves no index and a torn last frame; the frames before it survive.
+    const auto full_size = std::filesystem::file_size(container_path);
+    const auto torn_size = reader.find(5)->offset + sizeof(CellEvoX::io::PopulationSnapshotFrameHeader) + 7;
+    REQUIRE(torn_size < full_size);
+    std::filesystem::resize_file(container_path, torn_size);
+    REQUIRE(reader.open(container_path));
+    REQUIRE(reader.recovered());
+    REQUIRE(reader.entries().size() == 4);
+    check(reader, 4);
+
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(container_path));
+        REQUIRE(writer.entries().size() == 4);
+        append(writer, 5);
+    }
+    REQUIRE(reader.open(container_path));
+    REQUIRE_FALSE(reader.recovered());
+    REQUIRE(reader.entries().size() == 5);
+    check(reader, 5);
+
+    // A failed append leaves no partial frame behind, so frames appended after it are found
+    // even when the index is lost and the frames have to be recovered.
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(container_path));
+        const auto records = make_records(6);
+        REQUIRE_FALSE(writer.append(6, 6.25, 3, records, make_payload(records),
+                                    CellEvoX::io::MutationPayloadKind::Full,
+                                    CellEvoX::io::PopulationSnapshotEncoding{true, 0.0f}));
+        REQUIRE(writer.entries().size() == 5);
+        append(writer, 7);
+        REQUIRE(reader.open(container_path));
+        REQUIRE(reader.recovered());
+        REQUIRE(reader.entries().size() == 6);
+        REQUIRE(reader.find(6) == nullptr);
+        check(reader, 7);
+    }
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<PopulationSnapshotRecord> records;
+    std::vector<PopulationSnapshotDriverMutation> payload;
+    REQUIRE(CellEvoX::io::readStoredPopulationSnapshot(container_path.parent_path(), 4, header, records, payload));
+    REQUIRE(records.size() == make_records(4).size());
+    REQUIRE_FALSE(CellEvoX::io::readStoredPopulationSnapshot(container_path.parent_path(), 9, header, records, payload));
+
+    // A session keeps one container open across lookups.
+    CellEvoX::io::StoredPopulationSnapshotReader stored(container_path.parent_path());
+    for (int generation : {1, 2, 3, 4, 5, 7}) {
+        REQUIRE(stored.read(generation, header, records, payload));
+        REQUIRE(records.size() == make_records(generation).size());
+    }
+    REQUIRE_FALSE(stored.read(6, header, records, payload));
+}
+
+TEST_CASE("PopulationSnapshotView maps V2 snapshots without copying", "[PopulationSnapshotIO][View]") {
+    using CellEvoX::io::PopulationSnapshotDriverMutation;
+    using CellEvoX::io::PopulationSnapshotRecord;
+    const auto rows_path = testTempPath("view_population_snapshot_v2.bin");
+    const auto columnar_path = testTempPath("view_population_snapshot_v3.bin");
+    std::filesystem::create_directories(rows_path.parent_path());
+
+    std::vector<PopulationSnapshotRecord> records;
+    std::vector<PopulationSnapshotDriverMutation> payload;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const auto offset = static_cast<uint32_t>(payload.size());
+        const uint16_t count = static_cast<uint16_t>(i % 3);
+        for (uint16_t k = 0; k < count; ++k) {
+            payload.push_back({i * 10 + k, static_cast<uint8_t>(k + 1)});
+        }
+        records.push_back({i + 1, i, 1.0f + 0.5f * (i % 4), 0.25f * i, 1.0f, 2.0f,
+                           static_cast<uint16_t>(i % 5), count, offset, 1, {0, 0, 0}});
+    }
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        rows_path, 3.5, 3, records, payload, CellEvoX::io::MutationPayloadKind::Full));
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        columnar_path, 3.5, 3, records, payload, CellEvoX::io::MutationPayloadKind::Full,
+        CellEvoX::io::PopulationSnapshotEncoding{true, 1.0f / 64.0f}));
+
+    const auto check = [&](const CellEvoX::io::PopulationSnapshotView& view) {
+        REQUIRE(view.header().tau == Catch::Approx(3.5));
+        REQUIRE(view.records().size() == records.size());
+        REQUIRE(view.mutations().size() == payload.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            const auto& record = view.records()[i];
+            REQUIRE(record.id == records[i].id);
+            REQUIRE(record.fitness == records[i].fitness);
+            const auto slice = view.mutations(record);
+            REQUIRE(slice.size() == records[i].driver_mutation_count);
+            for (size_t k = 0; k < slice.size(); ++k) {
+                REQUIRE(slice[k].mutation_id == payload[records[i].driver_mutation_offset + k].mutation_id);
+            }
+        }
+    };
+
+    CellEvoX::io::PopulationSnapshotView view;
+    REQUIRE(view.open(rows_path));
+    REQUIRE(view.zeroCopy());
+    check(view);
+
+    REQUIRE(view.open(columnar_path));
+    REQUIRE_FALSE(view.zeroCopy());
+    check(view);
+
+    // Out-of-range payload slices come back empty instead of reading past the mapping.
+    auto stray = records.front();
+    stray.driver_mutation_offset = static_cast<uint32_t>(payload.size());
+    stray.driver_mutation_count = 1;
+    REQUIRE(view.mutations(stray).empty());
+
+    // A single mapping can back views of several frames.
+    const auto container_path = testTempPath("view_container") / "population_snapshots.bin";
+    std::filesystem::remove_all(container_path.parent_path());
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(container_path));
+        REQUIRE(writer.append(1, 3.5, 3, records, payload, CellEvoX::io::MutationPayloadKind::Full,
+                              CellEvoX::io::PopulationSnapshotEncoding{}));
+        REQUIRE(writer.append(2, 3.5, 3, records, payload, CellEvoX::io::MutationPayloadKind::Full,
+                              CellEvoX::io::PopulationSnapshotEncoding{true, 1.0f / 64.0f}));
+    }
+    CellEvoX::io::PopulationSnapshotContainerReader reader;
+    REQUIRE(reader.open(container_path));
+    auto mapping = std::make_shared<CellEvoX::io::MappedFile>();
+    REQUIRE(mapping->open(container_path));
+    for (const auto& entry : reader.entries()) {
+        REQUIRE(view.open(mapping, entry.offset + sizeof(CellEvoX::io::PopulationSnapshotFrameHeader),
+                          entry.size));
+        REQUIRE(view.zeroCopy() == (entry.generation == 1));
+        check(view);
+    }
+
+    // Truncated V2 data is rejected rather than mapped short.
+    std::filesystem::resize_file(rows_path, std::filesystem::file_size(rows_path) - 3);
+    REQUIRE_FALSE(view.open(rows_path));
+    REQUIRE(view.records().empty());
+}
+
+TEST_CASE("cellevox_snapshot C ABI exposes strided columns and run generations", "[PopulationSnapshotIO][CApi]") {
+    using CellEvoX::io::PopulationSnapshotDriverMutation;
+    using CellEvoX::io::PopulationSnapshotRecord;
+    const auto run_dir = testTempPath("capi_run");
+    std::filesystem::remove_all(run_dir);
+    std::filesystem::create_directories(run_dir / "population_data");
+
+    std::vector<PopulationSnapshotRecord> records;
+    std::vector<PopulationSnapshotDriverMutation> payload;
+    for (uint32_t i = 0; i < 40; ++i) {
+        const auto offset = static_cast<uint32_t>(payload.size());
+        const uint16_t count = static_cast<uint16_t>(i % 2);
+        if (count > 0) {
+            payload.push_back({1000 + i, 7});
+        }
+        records.push_back({i + 1, i, 1.0f + 0.25f * (i % 4), 0.5f * i, 1.0f, 2.0f,
+                           static_cast<uint16_t>(i % 5), count, offset, 1, {0, 0, 0}});
+    }
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(run_dir.string(), 20), 20.0, 3, records, payload,
+        CellEvoX::io::MutationPayloadKind::Full));
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(run_dir.string(), 5), 5.0, 3, records, payload,
+        CellEvoX::io::MutationPayloadKind::Full, CellEvoX::io::PopulationSnapshotEncoding{true, 1.0f / 64.0f}));
+
+    const auto values = [](const cellevox_column& column, auto tag) {
+        std::vector<decltype(tag)> out(column.length);
+        const auto* bytes = static_cast<const unsigned char*>(column.data);
+        for (size_t i = 0; i < out.size(); ++i) {
+            std::memcpy(&out[i], bytes + i * column.stride, sizeof(tag));
+        }
+        return out;
+    };
+    const auto check = [&](cellevox_snapshot* snapshot, uint32_t format_version, double tau) {
+        REQUIRE(snapshot != nullptr);
+        cellevox_snapshot_info info{};
+        REQUIRE(cellevox_snapshot_info_get(snapshot, &info) == 0);
+        REQUIRE(info.format_version == format_version);
+        REQUIRE(info.zero_copy == (format_version == 2 ? 1 : 0));
+        REQUIRE(info.tau == Catch::Approx(tau));
+        REQUIRE(info.record_count == records.size());
+        REQUIRE(info.mutation_count == payload.size());
+        REQUIRE(info.full_mutation_payload == 1);
+
+        cellevox_column column{};
+        REQUIRE(cellevox_snapshot_column(snapshot, CELLEVOX_COLUMN_FITNESS, &column) == 0);
+        REQUIRE(column.type == CELLEVOX_TYPE_FLOAT32);
+        REQUIRE(column.stride == sizeof(PopulationSnapshotRecord));
+        const auto fitness = values(column, float{});
+        REQUIRE(cellevox_snapshot_column(snapshot, CELLEVOX_COLUMN_PAYLOAD_OFFSET, &column) == 0);
+        const auto offsets = values(column, uint32_t{});
+        REQUIRE(cellevox_snapshot_column(snapshot, CELLEVOX_COLUMN_PAYLOAD_MUTATION_ID, &column) == 0);
+        REQUIRE(column.stride == sizeof(PopulationSnapshotDriverMutation));
+        const auto mutation_ids = values(column, uint32_t{});
+        for (size_t i = 0; i < records.size(); ++i) {
+            REQUIRE(fitness[i] == records[i].fitness);
+            REQUIRE(offsets[i] == records[i].driver_mutation_offset);
+        }
+        for (size_t i = 0; i < payload.size(); ++i) {
+            REQUIRE(mutation_ids[i] == payload[i].mutation_id);
+        }
+        REQUIRE(cellevox_snapshot_column(snapshot, CELLEVOX_COLUMN_COUNT, &column) != 0);
+        REQUIRE(std::string_view(cellevox_last_error()).find("column") != std::string_view::npos);
+        cellevox_snapshot_close(snapshot);
+    };
+
+    REQUIRE(cellevox_snapshot_abi_version() == CELLEVOX_SNAPSHOT_ABI_VERSION);
+    check(cellevox_snapshot_open(CellEvoX::io::populationSnapshotPath(run_dir.string(), 20).c_str()), 2, 20.0);
+    REQUIRE(cellevox_snapshot_open((run_dir / "missing.bin").string().c_str()) == nullptr);
+    REQUIRE(std::string_view(cellevox_last_error()).find("missing.bin") != std::string_view::npos);
+
+    cellevox_run* run = cellevox_run_open(run_dir.string().c_str());
+    REQUIRE(run != nullptr);
+    REQUIRE(cellevox_run_generation_count(run) == 2);
+    REQUIRE(cellevox_run_generation(run, 0) == 5);
+    REQUIRE(cellevox_run_generation(run, 1) == 20);
+    REQUIRE(cellevox_run_generation(run, 2) == -1);
+    cellevox_snapshot* columnar = cellevox_run_open_snapshot(run, 0);
+    cellevox_run_close(run);
+    check(columnar, 3, 5.0);
+
+    // Container frames are served from the run's shared mapping.
+    const auto container_dir = testTempPath("capi_container_run");
+    std::filesystem::remove_all(container_dir);
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(std::filesystem::path(
+            CellEvoX::io::populationSnapshotContainerPath(container_dir.string()))));
+        REQUIRE(writer.append(7, 7.0, 3, records, payload, CellEvoX::io::MutationPayloadKind::Full,
+                              CellEvoX::io::PopulationSnapshotEncoding{}));
+        REQUIRE(writer.close());
+    }
+    run = cellevox_run_open(container_dir.string().c_str());
+    REQUIRE(run != nullptr);
+    REQUIRE(cellevox_run_generation_count(run) == 1);
+    REQUIRE(cellevox_run_generation(run, 0) == 7);
+    check(cellevox_run_open_snapshot(run, 0), 2, 7.0);
+    cellevox_run_close(run);
+
+    CellEvoX::io::PopulationSnapshotContainerReader reader;
+    const auto container_path = CellEvoX::io::populationSnapshotContainerPath(container_dir.string());
+    REQUIRE(reader.open(container_path));
+    const auto& entry = reader.entries().front();
+    check(cellevox_snapshot_open_range(container_path.c_str(),
+                                       entry.offset + sizeof(CellEvoX::io::PopulationSnapshotFrameHeader),
+                                       entry.size),
+          2, 7.0);
+    REQUIRE(cellevox_snapshot_open_range(container_path.c_str(), entry.offset, 1u << 30) == nullptr);
+}
+
+TEST_CASE("VoxelAggregateIO aggregates cells per voxel with their dominant clone", "[PopulationSnapshotIO][VoxelLod]") {
+    using CellEvoX::io::PopulationSnapshotRecord;
+    // Payload: 0:(7,driver) 1:(3,passenger) 2:(9,driver) 3:(7,driver).
+    const std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> payload = {
+        {7, 1}, {3, 2}, {9, 1}, {7, 1}};
+    std::bitset<256> driver_types;
+    driver_types.set(1);
+    const std::vector<PopulationSnapshotRecord> records = {
+        {1, 0, 1.0f, 0.0f, 0.0f, 0.0f, 0, 0, 0, 1, {0, 0, 0}},   // ancestor
+        {2, 1, 2.0f, 0.5f, 0.5f, 0.5f, 2, 2, 0, 1, {0, 0, 0}},   // clone {7}, passenger ignored
+        {3, 2, 3.0f, 1.0f, 0.2f, 0.2f, 1, 1, 3, 1, {0, 0, 0}},   // clone {7}
+        {4, 2, 4.0f, 4.0f, 4.0f, 4.0f, 2, 2, 2, 1, {0, 0, 0}},   // clone {7,9}, other corner
+        {5, 0, 9.0f, 2.0f, 2.0f, 2.0f, 0, 0, 0, 0, {0, 0, 0}}};  // no position: left out
+
+    const auto frame = CellEvoX::io::buildVoxelAggregates(12, 1.5, records, payload, driver_types, {1, 2});
+    REQUIRE(frame.record_count == 4);
+    REQUIRE(frame.clone_offsets == std::vector<uint32_t>{0, 0, 1, 3});
+    REQUIRE(frame.clone_driver_ids == std::vector<uint32_t>{7, 7, 9});
+    REQUIRE(frame.levels.size() == 2);
+
+    const auto& coarse = frame.levels[0];
+    REQUIRE(coarse.resolution == 1);
+    REQUIRE(coarse.voxel_size == Catch::Approx(4.0f));
+    REQUIRE(coarse.voxels.size() == 1);
+    REQUIRE(coarse.voxels[0].cell_count == 4);
+    REQUIRE(coarse.voxels[0].dominant_clone == 1);
+    REQUIRE(coarse.voxels[0].mean_fitness == Catch::Approx(2.5f));
+
+    const auto& fine = frame.levels[1];
+    REQUIRE(fine.voxel_size == Catch::Approx(2.0f));
+    REQUIRE(fine.voxels.size() == 2);
+    REQUIRE(fine.voxels[0].voxel == 0);
+    REQUIRE(fine.voxels[0].cell_count == 3);
+    REQUIRE(fine.voxels[0].dominant_clone == 1);
+    REQUIRE(fine.voxels[0].mean_fitness == Catch::Approx(2.0f));
+    REQUIRE(fine.voxels[1].voxel == 7);  // (1, 1, 1): the maximum lands in the last voxel
+    REQUIRE(fine.voxels[1].dominant_clone == 2);
+
+    const auto path = testTempPath("voxel_lod") / "generation_12.bin";
+    std::filesystem::remove_all(path.parent_path());
+    REQUIRE(CellEvoX::io::writeVoxelAggregates(path, frame));
+    REQUIRE(std::filesystem::file_size(path) ==
+            sizeof(CellEvoX::io::VoxelAggregateFileHeader) + 4 * sizeof(uint32_t) +
+                3 * sizeof(uint32_t) + 2 * sizeof(CellEvoX::io::VoxelAggregateLevelHeader) +
+                3 * sizeof(CellEvoX::io::VoxelAggregate));
+
+    CellEvoX::io::VoxelAggregateFrame loaded;
+    REQUIRE(CellEvoX::io::readVoxelAggregates(path, loaded));
+    REQUIRE(loaded.generation == 12);
+    REQUIRE(loaded.tau == Catch::Approx(1.5));
+    REQUIRE(loaded.clone_offsets == frame.clone_offsets);
+    REQUIRE(loaded.clone_driver_ids == frame.clone_driver_ids);
+    REQUIRE(loaded.levels.size() == 2);
+    REQUIRE(loaded.levels[1].origin == fine.origin);
+    REQUIRE(loaded.levels[1].voxels.size() == 2);
+    REQUIRE(std::memcmp(loaded.levels[1].voxels.data(), fine.voxels.data(),
+                        fine.voxels.size() * sizeof(CellEvoX::io::VoxelAggregate)) == 0);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    REQUIRE_FALSE(CellEvoX::io::readVoxelAggregates(path, loaded));
+}
+
+TEST_CASE("EngineCheckpoint round-trips engine state and rejects corrupt files", "[PopulationSnapshotIO][Checkpoint]") {
+    std::mt19937 rng(99);
+    rng.discard(1234);
+
+    CellEvoX::io::CheckpointWriter writer;
+    writer.put<uint32_t>(7);
+    writer.put(2.5);
+    writer.putVector(std::vector<float>{1.0f, -2.0f, 3.5f});
+    writer.putString("tumor");
+    writer.putRng(rng);
+
+    CellEvoX::io::EngineCheckpointHeader header{};
+    header.sim_type = 2;
+    header.seed = 99;
+    header.tau_step = 0.05;
+    header.initial_population = 100;
+    header.completed_steps = 40;
+
+    const auto path = std::filesystem::path(CellEvoX::io::engineCheckpointPath(
+        testTempPath("engine_checkpoint").string()));
+    std::filesystem::remove_all(testTempPath("engine_checkpoint"));
+    {
+        CellEvoX::io::AsyncCheckpointWriter async_writer;
+        REQUIRE(async_writer.submit(path, header, writer.bytes()));
+        REQUIRE(async_writer.wait());
+    }
+    REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+    CellEvoX::io::EngineCheckpoint checkpoint;
+    REQUIRE(CellEvoX::io::readEngineCheckpoint(path, checkpoint));
+    REQUIRE(checkpoint.header.seed == 99);
+    REQUIRE(checkpoint.header.completed_steps == 40);
+
+    auto reader = checkpoint.reader();
+    uint32_t count = 0;
+    double tau = 0.0;
+    std::vector<float> values;
+    std::string label;
+    std::mt19937 restored_rng;
+    REQUIRE(reader.get(count));
+    REQUIRE(reader.get(tau));
+    REQUIRE(reader.getVector(values));
+    REQUIRE(reader.getString(label));
+    REQUIRE(reader.getRng(restored_rng));
+    REQUIRE(reader.atEnd());
+    REQUIRE(count == 7);
+    REQUIRE(tau == 2.5);
+    REQUIRE(values == std::vector<float>{1.0f, -2.0f, 3.5f});
+    REQUIRE(label == "tumor");
+    REQUIRE(restored_rng == rng);
+
+    // A short read fails the reader for good.
+    REQUIRE_FALSE(reader.get(count));
+    REQUIRE_FALSE(reader.ok());
+
+    // Flip one state byte: the checksum no longer matches.
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(CellEvoX::io::EngineCheckpointHeader) + 2);
+        file.put('\x5A');
+    }
+    REQUIRE_FALSE(CellEvoX::io::readEngineCheckpoint(path, checkpoint));
+
+    std::filesystem::resize_file(path, sizeof(CellEvoX::io::EngineCheckpointHeader) - 1);
+    REQUIRE_FALSE(CellEvoX::io::readEngineCheckpoint(path, checkpoint));
+}
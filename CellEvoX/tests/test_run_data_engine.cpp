@@ -1,15 +1,26 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <tbb/concurrent_vector.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "core/PopulationSnapshotScan.hpp"
 #include "core/RunDataEngine.hpp"
+#include "io/ArrowIpcWriter.hpp"
+#include "io/CsvWriter.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
 #include "systems/SimulationEngine.hpp"
 
 namespace {
@@ -29,6 +40,26 @@ std::vector<std::string> readLines(const std::filesystem::path& path) {
     return lines;
 }
 
+// Records which generations a scan visited and how many cells each had.
+class RecordingVisitor final : public CellEvoX::core::PopulationSnapshotVisitor {
+ public:
+    void visit(const CellEvoX::core::PopulationSnapshotFrame& frame) override {
+        visited.push_back({frame.generation, frame.records.size()});
+    }
+    void finish() override { ++finish_calls; }
+
+    tbb::concurrent_vector<std::pair<int, size_t>> visited;
+    std::atomic<int> finish_calls{0};
+};
+
+std::vector<CellEvoX::io::PopulationSnapshotRecord> makeScanRecords(int generation) {
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(generation + 2); ++i) {
+        records.push_back({i + 1, 0, 1.0f, 0.0f, 0.0f, 0.0f, 0, 0, 0, 0, {0, 0, 0}});
+    }
+    return records;
+}
+
 }  // namespace
 
 TEST_CASE("RunDataEngine exports generational stats and phylogeny CSV files", "[RunDataEngine]") {
@@ -81,3 +112,264 @@ TEST_CASE("RunDataEngine exports generational stats and phylogeny CSV files", "[
     REQUIRE(std::find(tree_lines.begin(), tree_lines.end(), "0,0,1,0") != tree_lines.end());
     REQUIRE(std::find(tree_lines.begin(), tree_lines.end(), "1,0,1,0") != tree_lines.end());
 }
+
+TEST_CASE("PopulationSnapshotScan visits every stored generation once", "[RunDataEngine][PopulationSnapshotScan]") {
+    const auto run_dir = testTempPath("test_population_snapshot_scan");
+    const auto population_dir = run_dir / "population_data";
+    std::filesystem::remove_all(run_dir);
+    std::filesystem::create_directories(population_dir);
+
+    const auto check = [&](size_t max_frames_in_flight) {
+        RecordingVisitor first;
+        RecordingVisitor second;
+        CellEvoX::core::PopulationSnapshotVisitor* visitors[] = {&first, &second};
+        REQUIRE(CellEvoX::core::scanPopulationSnapshots(
+                    run_dir.string(), visitors, max_frames_in_flight) == 8);
+        for (auto* visitor : {&first, &second}) {
+            REQUIRE(visitor->finish_calls == 1);
+            std::vector<std::pair<int, size_t>> visited(visitor->visited.begin(), visitor->visited.end());
+            std::sort(visited.begin(), visited.end());
+            REQUIRE(visited.size() == 8);
+            for (int generation = 0; generation < 8; ++generation) {
+                REQUIRE(visited[generation].first == generation);
+                REQUIRE(visited[generation].second == makeScanRecords(generation).size());
+            }
+        }
+    };
+
+    for (int generation = 0; generation < 8; ++generation) {
+        REQUIRE(CellEvoX::io::writePopulationSnapshot(
+            population_dir / ("population_generation_" + std::to_string(generation) + ".bin"),
+            generation, 0, makeScanRecords(generation), {},
+            CellEvoX::io::MutationPayloadKind::DriverOnly,
+            CellEvoX::io::PopulationSnapshotEncoding{generation % 2 == 0}));
+    }
+    check(2);
+    check(0);
+
+    std::filesystem::remove_all(population_dir);
+    {
+        CellEvoX::io::PopulationSnapshotContainerWriter writer;
+        REQUIRE(writer.open(CellEvoX::io::populationSnapshotContainerPath(run_dir.string())));
+        for (int generation = 0; generation < 8; ++generation) {
+            REQUIRE(writer.append(generation, generation, 0, makeScanRecords(generation), {},
+                                  CellEvoX::io::MutationPayloadKind::DriverOnly,
+                                  CellEvoX::io::PopulationSnapshotEncoding{generation % 2 == 1}));
+        }
+    }
+    check(3);
+}
+
+TEST_CASE("RunDataEngine derives CSVs and clone populations from one snapshot scan", "[RunDataEngine][PopulationSnapshotScan]") {
+    const auto run_dir = testTempPath("test_run_data_engine_clone_populations");
+    const auto population_dir = run_dir / "population_data";
+    std::filesystem::remove_all(run_dir);
+    std::filesystem::create_directories(population_dir);
+    {
+        std::ofstream config(run_dir / "config.json");
+        config << R"({"mutations": [{"id": 1, "is_driver": true}, {"id": 3, "is_driver": false}]})";
+    }
+
+    // Two driver clones {5} and {5,9} plus the ancestor; passenger type 3 never splits a clone.
+    const std::vector<CellEvoX::io::PopulationSnapshotRecord> records = {
+        {1, 0, 1.0f, 0.0f, 0.0f, 0.0f, 0, 0, 0, 0, {0, 0, 0}},
+        {2, 0, 1.0f, 0.0f, 0.0f, 0.0f, 1, 1, 0, 0, {0, 0, 0}},
+        {3, 0, 1.1f, 0.0f, 0.0f, 0.0f, 1, 1, 1, 0, {0, 0, 0}},
+        {4, 0, 1.1f, 0.0f, 0.0f, 0.0f, 2, 2, 2, 0, {0, 0, 0}},
+        {5, 0, 1.2f, 0.0f, 0.0f, 0.0f, 3, 3, 4, 0, {0, 0, 0}},
+    };
+    const std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> payload = {
+        {7, 3}, {5, 1}, {5, 1}, {8, 3}, {9, 1}, {5, 1}, {6, 3},
+    };
+    REQUIRE(CellEvoX::io::writePopulationSnapshot(
+        population_dir / "population_generation_4.bin", 4.0, 0, records, payload,
+        CellEvoX::io::MutationPayloadKind::Full));
+
+    CellEvoX::core::RunDataEngine engine(run_dir.string());
+    engine.analyzePopulationSnapshots({.csv_export = true,
+                                       .mutation_wave = false,
+                                       .mutation_frequency = false,
+                                       .clone_populations = true});
+
+    const auto csv_lines = readLines(population_dir / "population_generation_4.csv");
+    REQUIRE(csv_lines.size() == records.size() + 1);
+    REQUIRE(csv_lines[5].find("\"(9,1) (5,1) (6,3)\"") != std::string::npos);
+
+    const auto clone_lines = readLines(population_dir / "clone_populations.csv");
+    REQUIRE(clone_lines == std::vector<std::string>{
+        "Generation,Signature,Cells",
+        "4,ancestor,2",
+        "4,\"5\",2",
+        "4,\"5,9\",1",
+    });
+}
+
+TEST_CASE("RunDataEngine feeds in-memory generations to the same analyses", "[RunDataEngine][PopulationSnapshotScan]") {
+    const auto base_output_path = testTempPath("test_run_data_engine_in_memory_scan");
+    std::filesystem::remove_all(base_output_path);
+
+    const auto make_cell = [](uint32_t id, std::vector<std::pair<uint32_t, uint8_t>> mutations) {
+        Cell cell(id);
+        cell.mutations = std::move(mutations);
+        return cell;
+    };
+    CellMap generation;
+    REQUIRE(generation.insert({1, make_cell(1, {})}));
+    REQUIRE(generation.insert({2, make_cell(2, {{7, 3}, {5, 1}})}));
+    REQUIRE(generation.insert({3, make_cell(3, {{5, 1}, {8, 3}, {9, 1}})}));
+    std::vector<std::pair<int, CellMap>> reports;
+    reports.emplace_back(4, std::move(generation));
+
+    std::map<uint8_t, MutationType> mutation_types = {
+        {1, {0.1f, 0.1f, 1, true}},
+        {3, {0.0f, 0.1f, 3, false}},
+    };
+    auto run = std::make_shared<ecs::Run>(
+        CellMap{}, mutation_types, Graveyard{}, std::vector<StatSnapshot>{}, std::move(reports), 0, 1.0);
+
+    auto config = std::make_shared<SimulationConfig>();
+    config->output_path = base_output_path.string();
+    config->verbosity = 0;
+    config->mutations = {{0.1f, 0.1f, 1, true}, {0.0f, 0.1f, 3, false}};
+
+    CellEvoX::core::RunDataEngine data_engine(config, run, "");
+    data_engine.analyzePopulationSnapshots({.csv_export = true,
+                                            .mutation_wave = false,
+                                            .mutation_frequency = false,
+                                            .clone_populations = true});
+
+    const auto population_dir = std::filesystem::path(config->output_path) / "population_data";
+    const auto csv_lines = readLines(population_dir / "population_generation_4.csv");
+    REQUIRE(csv_lines.size() == 4);
+    REQUIRE(std::find(csv_lines.begin(), csv_lines.end(), "3,0,1,3,\"(5,1) (8,3) (9,1)\",,,,0,0") !=
+            csv_lines.end());
+
+    const auto clone_lines = readLines(population_dir / "clone_populations.csv");
+    REQUIRE(clone_lines == std::vector<std::string>{
+        "Generation,Signature,Cells",
+        "4,ancestor,1",
+        "4,\"5\",1",
+        "4,\"5,9\",1",
+    });
+}
+
+TEST_CASE("CsvWriter matches ostream formatting and keeps row order across chunks", "[RunDataEngine][CsvWriter]") {
+    const std::vector<double> values = {0.0, -0.0, 1.0, 0.5, 1.1, -2.25, 1.0 / 3.0, 123456.0, 1234567.0,
+                                        1e-5, 6.02214076e23, 1e300, -1e-300,
+                                        std::numeric_limits<double>::quiet_NaN(),
+                                        std::numeric_limits<double>::infinity()};
+    std::ostringstream expected;
+    expected << "Row,Double,Float,Unsigned,Small\n";
+    for (size_t row = 0; row < 100; ++row) {
+        const double value = values[row % values.size()] * (row < 50 ? 1.0 : -3.0);
+        expected << row << "," << value << "," << static_cast<float>(value) << ","
+                 << static_cast<uint64_t>(row) * 4000000000ull << ","
+                 << static_cast<int>(static_cast<uint8_t>(row)) << "\n";
+    }
+
+    const auto csv_path = testTempPath("csv_writer_chunks.csv");
+    std::filesystem::create_directories(csv_path.parent_path());
+    REQUIRE(CellEvoX::io::writeCsvFile(
+        csv_path,
+        "Row,Double,Float,Unsigned,Small\n",
+        100,
+        [&](CellEvoX::io::CsvBuffer& out, size_t row) {
+            const double value = values[row % values.size()] * (row < 50 ? 1.0 : -3.0);
+            out.put(row).put(',').put(value).put(',').put(static_cast<float>(value)).put(',');
+            out.put(static_cast<uint64_t>(row) * 4000000000ull).put(',');
+            out.put(static_cast<uint8_t>(row)).put('\n');
+        },
+        7));
+
+    std::ifstream file(csv_path, std::ios::binary);
+    std::ostringstream written;
+    written << file.rdbuf();
+    REQUIRE(written.str() == expected.str());
+
+    REQUIRE(CellEvoX::io::writeCsvFile(csv_path, "Empty\n", 0, [](CellEvoX::io::CsvBuffer&, size_t) {}));
+    REQUIRE(readLines(csv_path) == std::vector<std::string>{"Empty"});
+    REQUIRE_FALSE(CellEvoX::io::writeCsvFile(
+        testTempPath("missing_dir") / "nested" / "out.csv", "", 1, [](CellEvoX::io::CsvBuffer&, size_t) {}));
+}
+
+TEST_CASE("ArrowTable writes an Arrow IPC file with 8-byte aligned column buffers", "[RunDataEngine][ArrowIpc]") {
+    const std::vector<uint32_t> ids = {0xA1A1A1A1u, 0xB2B2B2B2u, 0xC3C3C3C3u};
+    const std::vector<double> values = {0.25, -1.5, 1e300};
+    CellEvoX::io::ArrowTable table(ids.size());
+    table.addColumn("ID", ids);
+    table.addColumn("Value", values, std::vector<uint8_t>{1, 0, 1});
+    table.addStringColumn("Text", std::vector<int64_t>{0, 2, 2, 5}, "abcde");
+    table.addMetadata("generation", "7");
+
+    const auto arrow_path = testTempPath("arrow_writer.arrow");
+    std::filesystem::create_directories(arrow_path.parent_path());
+    REQUIRE(table.write(arrow_path));
+
+    std::ifstream file(arrow_path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE(bytes.compare(0, 8, std::string("ARROW1\0\0", 8)) == 0);
+    REQUIRE(bytes.compare(bytes.size() - 6, 6, "ARROW1") == 0);
+
+    int32_t footer_size = 0;
+    std::memcpy(&footer_size, bytes.data() + bytes.size() - 10, sizeof(footer_size));
+    REQUIRE(footer_size > 0);
+    REQUIRE(static_cast<size_t>(footer_size) + 18 < bytes.size());
+
+    // The schema message follows the magic: continuation marker, then metadata padded so the
+    // next message starts 8-byte aligned.
+    uint32_t continuation = 0;
+    int32_t metadata_size = 0;
+    std::memcpy(&continuation, bytes.data() + 8, sizeof(continuation));
+    std::memcpy(&metadata_size, bytes.data() + 12, sizeof(metadata_size));
+    REQUIRE(continuation == 0xFFFFFFFFu);
+    REQUIRE((8 + metadata_size) % 8 == 0);
+    REQUIRE(bytes.find("generation") != std::string::npos);
+
+    const auto find_aligned = [&](const void* data, size_t size) {
+        const size_t position = bytes.find(std::string(static_cast<const char*>(data), size));
+        REQUIRE(position != std::string::npos);
+        return position % 8;
+    };
+    REQUIRE(find_aligned(ids.data(), ids.size() * sizeof(uint32_t)) == 0);
+    REQUIRE(find_aligned(values.data(), values.size() * sizeof(double)) == 0);
+    REQUIRE(find_aligned("abcde", 5) == 0);
+}
+
+TEST_CASE("RunDataEngine writes Arrow copies of its tables only with arrow_export", "[RunDataEngine][ArrowIpc]") {
+    const auto base_output_path = testTempPath("test_run_data_engine_arrow_export");
+    std::filesystem::remove_all(base_output_path);
+
+    for (const bool arrow_export : {false, true}) {
+        CellMap cells;
+        REQUIRE(cells.insert({1, Cell(1)}));
+        CellMap population;
+        REQUIRE(population.insert({1, Cell(1)}));
+        std::vector<std::pair<int, CellMap>> population_report;
+        population_report.emplace_back(3, std::move(population));
+        auto run = std::make_shared<ecs::Run>(
+            std::move(cells),
+            std::map<uint8_t, MutationType>{},
+            Graveyard{},
+            std::vector<StatSnapshot>{{0.5, 1.1, 0.2, 2.0, 0.5, 10, 0.01, 0.02, 0.03, 0.04}},
+            std::move(population_report),
+            0,
+            1.0);
+
+        auto config = std::make_shared<SimulationConfig>();
+        config->output_path = (base_output_path / (arrow_export ? "on" : "off")).string();
+        config->verbosity = 0;
+        config->arrow_export = arrow_export;
+
+        CellEvoX::core::RunDataEngine data_engine(config, run, "");
+        data_engine.exportToCSV();
+
+        const auto output_path = std::filesystem::path(config->output_path);
+        for (const auto* table : {"statistics/generational_statistics",
+                                  "phylogeny/phylogenetic_tree",
+                                  "population_data/population_generation_3"}) {
+            INFO(table);
+            REQUIRE(std::filesystem::exists(output_path / (std::string(table) + ".csv")));
+            REQUIRE(std::filesystem::exists(output_path / (std::string(table) + ".arrow")) == arrow_export);
+        }
+    }
+}
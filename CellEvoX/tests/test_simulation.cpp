@@ -6,22 +6,30 @@
 #include <fstream>
 #include <cstdlib>
 #include <map>
+#include <set>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <cmath>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <string_view>
+#include <tuple>
 #include <tbb/global_control.h>
 #include "core/RunDataEngine.hpp"
+#include "io/PopulationEventLog.hpp"
+#include "io/PopulationSnapshotContainer.hpp"
 #include "io/PopulationSnapshotIO.hpp"
+#include "io/PopulationSnapshotView.hpp"
+#include "io/VoxelAggregateIO.hpp"
 #include "utils/SimulationConfig.hpp"
 #include "spatial/SpatialHashGrid.hpp"
 #include "systems/CommonPopulationStep.hpp"
 #include "systems/SimulationEngine.hpp"
 #include "systems/SimulationEngine3D.hpp"
 #include "systems/SimulationEngine3DCapacity.hpp"
+#include "systems/SimulationEngine3DLattice.hpp"
 #include "ecs/Cell.hpp"
 
 // Namespace using removed
@@ -69,8 +77,23 @@ TEST_CASE("SimulationConfig parses correctly from default JSON", "[SimulationCon
     REQUIRE(config.popul_res == 5);
     REQUIRE(config.output_path == "./output/");
     REQUIRE(config.full_mutation_payload);
+    REQUIRE(config.snapshot_format == SnapshotFormat::Rows);
     REQUIRE(config.mutations.size() == 2);
     REQUIRE(config.mutations[1].is_driver == true);
+
+    j["snapshot_format"] = "columnar";
+    REQUIRE(utils::fromJson(j).snapshot_format == SnapshotFormat::Columnar);
+
+    REQUIRE(config.population_output == PopulationOutputMode::Snapshots);
+    j["population_output"] = "event_log";
+    j["event_log_keyframe_interval"] = 4;
+    const auto event_log_config = utils::fromJson(j);
+    REQUIRE(event_log_config.population_output == PopulationOutputMode::EventLog);
+    REQUIRE(event_log_config.event_log_keyframe_interval == 4);
+
+    REQUIRE_FALSE(config.snapshot_container);
+    j["snapshot_container"] = true;
+    REQUIRE(utils::fromJson(j).snapshot_container);
 }
 
 TEST_CASE("SimulationConfig rejects unsafe values", "[SimulationConfig][Correctness]") {
@@ -103,6 +126,27 @@ TEST_CASE("SimulationConfig rejects unsafe values", "[SimulationConfig][Correctn
     invalid = j;
     invalid["mutations"][0]["effect"] = -1.0;
     REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["snapshot_format"] = "parquet";
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["snapshot_position_quantum"] = 0.0;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["population_output"] = "journal";
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["population_output"] = "event_log";
+    invalid["event_log_keyframe_interval"] = 0;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["voxel_lod_resolutions"] = {16};  // stochastic mode has no positions
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
 }
 
 TEST_CASE("SimulationConfig parses spatial 3D mode", "[SimulationConfig][Spatial3D]") {
@@ -849,6 +893,40 @@ TEST_CASE("SimulationEngine writes driver-only mutation payload snapshots in 2D"
     }));
 }
 
+TEST_CASE("PopulationSnapshotView reads default-config snapshots zero-copy", "[SimulationEngine][PopulationSnapshotIO][View]") {
+    auto write_snapshot = [](const std::string& name, std::optional<SnapshotFormat> format) {
+        auto config = std::make_shared<SimulationConfig>();
+        config->sim_type = SimulationType::STOCHASTIC_TAU_LEAP;
+        config->tau_step = 1.0;
+        config->seed = 23;
+        config->initial_population = 16;
+        config->env_capacity = 1000;
+        config->steps = 1;
+        config->output_path = testTempString(name);
+        config->verbosity = 0;
+        config->mutations.push_back({0.1f, 1.0f, 1, true});
+        if (format) {
+            config->snapshot_format = *format;
+        }
+        std::filesystem::remove_all(config->output_path);
+        std::filesystem::create_directories(std::filesystem::path(config->output_path) / "statistics");
+        SimulationEngine engine(config);
+        (void)engine.run(1);
+        return CellEvoX::io::populationSnapshotPath(config->output_path, 1);
+    };
+
+    CellEvoX::io::PopulationSnapshotView view;
+    REQUIRE(view.open(write_snapshot("test_sim_view_default", std::nullopt)));
+    REQUIRE(view.header().version == CellEvoX::io::kPopulationSnapshotVersion);
+    REQUIRE(view.zeroCopy());
+    REQUIRE_FALSE(view.records().empty());
+
+    // Columnar output is opt-in and decoded into rows owned by the view.
+    REQUIRE(view.open(write_snapshot("test_sim_view_columnar", SnapshotFormat::Columnar)));
+    REQUIRE_FALSE(view.zeroCopy());
+    REQUIRE_FALSE(view.records().empty());
+}
+
 TEST_CASE("SimulationEngine writes full mutation payload snapshots when enabled in 2D", "[SimulationEngine][PopulationSnapshotIO]") {
     auto config = std::make_shared<SimulationConfig>();
     config->sim_type = SimulationType::STOCHASTIC_TAU_LEAP;
@@ -889,6 +967,157 @@ TEST_CASE("SimulationEngine writes full mutation payload snapshots when enabled
     }));
 }
 
+TEST_CASE("SimulationEngine event log replays to the same populations as snapshots", "[SimulationEngine][PopulationEventLog]") {
+    const auto make_config = [](const std::string& name, PopulationOutputMode output) {
+        auto config = std::make_shared<SimulationConfig>();
+        config->sim_type = SimulationType::STOCHASTIC_TAU_LEAP;
+        config->tau_step = 0.25;
+        config->seed = 31;
+        config->initial_population = 50;
+        config->env_capacity = 2000;
+        config->steps = 40;
+        config->stat_res = 1;
+        config->popul_res = 1;
+        config->output_path = testTempString(name);
+        config->full_mutation_payload = false;
+        config->snapshot_format = SnapshotFormat::Rows;
+        config->population_output = output;
+        config->event_log_keyframe_interval = 3;
+        config->verbosity = 0;
+        config->mutations.push_back({0.05f, 0.2f, 1, true});
+        config->mutations.push_back({0.0f, 0.3f, 2, false});
+        std::filesystem::remove_all(config->output_path);
+        return config;
+    };
+    const auto snapshot_config = make_config("test_event_log_reference", PopulationOutputMode::Snapshots);
+    const auto log_config = make_config("test_event_log_replay", PopulationOutputMode::EventLog);
+    SimulationEngine(snapshot_config).run(snapshot_config->steps);
+    SimulationEngine(log_config).run(log_config->steps);
+
+    using Record = CellEvoX::io::PopulationSnapshotRecord;
+    using Mutation = CellEvoX::io::PopulationSnapshotDriverMutation;
+    // (id, parent, fitness, mutation count, payload) per cell, in id order.
+    using CellKey = std::tuple<uint32_t, uint32_t, float, uint16_t, std::vector<std::pair<uint32_t, uint8_t>>>;
+    const auto canonical = [](const std::vector<Record>& records, const std::vector<Mutation>& payload) {
+        std::vector<CellKey> cells;
+        for (const auto& record : records) {
+            std::vector<std::pair<uint32_t, uint8_t>> mutations;
+            for (uint32_t k = 0; k < record.driver_mutation_count; ++k) {
+                const auto& mutation = payload[record.driver_mutation_offset + k];
+                mutations.emplace_back(mutation.mutation_id, mutation.mutation_type);
+            }
+            std::sort(mutations.begin(), mutations.end());
+            cells.emplace_back(record.id, record.parent_id, record.fitness, record.mutations_count, mutations);
+        }
+        std::sort(cells.begin(), cells.end());
+        return cells;
+    };
+
+    const auto log_path = CellEvoX::io::populationEventLogPath(log_config->output_path);
+    REQUIRE(std::filesystem::exists(log_path));
+    std::vector<int> generations;
+    size_t payload_cells = 0;
+    REQUIRE(CellEvoX::io::forEachLoggedGeneration(
+        log_path,
+        [&](int generation,
+            const CellEvoX::io::PopulationSnapshotFileHeader& header,
+            const std::vector<Record>& records,
+            const std::vector<Mutation>& payload) {
+            generations.push_back(generation);
+            CellEvoX::io::PopulationSnapshotFileHeader expected_header{};
+            std::vector<Record> expected_records;
+            std::vector<Mutation> expected_payload;
+            REQUIRE(CellEvoX::io::readPopulationSnapshot(
+                CellEvoX::io::populationSnapshotPath(snapshot_config->output_path, generation),
+                expected_header, expected_records, expected_payload));
+            REQUIRE(header.tau == Catch::Approx(expected_header.tau));
+            REQUIRE(canonical(records, payload) == canonical(expected_records, expected_payload));
+            payload_cells += static_cast<size_t>(std::count_if(
+                records.begin(), records.end(), [](const Record& r) { return r.driver_mutation_count > 0; }));
+            return true;
+        }));
+    REQUIRE(generations == std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    REQUIRE(payload_cells > 0);
+
+    // Only keyframes are written as snapshot files.
+    for (int generation = 1; generation <= 10; ++generation) {
+        REQUIRE(std::filesystem::exists(
+                    CellEvoX::io::populationSnapshotPath(log_config->output_path, generation)) ==
+                (generation % 3 == 1));
+    }
+
+    // A generation between keyframes is replayed from the keyframe before it.
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<Record> records;
+    std::vector<Mutation> payload;
+    REQUIRE(CellEvoX::io::reconstructLoggedGeneration(log_path, 9, header, records, payload));
+    CellEvoX::io::PopulationSnapshotFileHeader expected_header{};
+    std::vector<Record> expected_records;
+    std::vector<Mutation> expected_payload;
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(snapshot_config->output_path, 9),
+        expected_header, expected_records, expected_payload));
+    REQUIRE(canonical(records, payload) == canonical(expected_records, expected_payload));
+    REQUIRE_FALSE(CellEvoX::io::reconstructLoggedGeneration(log_path, 11, header, records, payload));
+}
+
+TEST_CASE("SimulationEngine writes every generation into one snapshot container", "[SimulationEngine][PopulationSnapshotIO][Container]") {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::STOCHASTIC_TAU_LEAP;
+    config->tau_step = 0.5;
+    config->seed = 37;
+    config->initial_population = 40;
+    config->env_capacity = 1000;
+    config->steps = 12;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempString("test_sim_snapshot_container");
+    config->snapshot_container = true;
+    config->population_output = PopulationOutputMode::EventLog;
+    config->event_log_keyframe_interval = 4;
+    config->verbosity = 0;
+    config->mutations.push_back({0.1f, 0.3f, 1, true});
+    std::filesystem::remove_all(config->output_path);
+
+    const auto run = SimulationEngine(config).run(config->steps);
+
+    const auto population_dir = std::filesystem::path(config->output_path) / "population_data";
+    REQUIRE_FALSE(std::filesystem::exists(population_dir / "population_generation_1.bin"));
+    CellEvoX::io::PopulationSnapshotContainerReader reader;
+    REQUIRE(reader.open(CellEvoX::io::populationSnapshotContainerPath(config->output_path)));
+    REQUIRE_FALSE(reader.recovered());
+    // Generations 1..6 with keyframes every fourth: 1 and 5.
+    REQUIRE(reader.entries().size() == 2);
+    REQUIRE(reader.entries()[0].generation == 1);
+    REQUIRE(reader.entries()[1].generation == 5);
+
+    // Replay of generation 6 starts from the container keyframe at generation 5.
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> replayed;
+    std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> payload;
+    REQUIRE(CellEvoX::io::reconstructLoggedGeneration(
+        CellEvoX::io::populationEventLogPath(config->output_path), 6, header, replayed, payload));
+    REQUIRE(run.generational_popul_report.size() == 6);
+    const auto& [generation, cells] = run.generational_popul_report.back();
+    REQUIRE(generation == 6);
+    REQUIRE(replayed.size() == cells.size());
+    for (const auto& record : replayed) {
+        CellMap::const_accessor accessor;
+        REQUIRE(cells.find(accessor, record.id));
+        REQUIRE(record.fitness == accessor->second.fitness);
+        REQUIRE(record.mutations_count == accessor->second.mutations.size());
+    }
+
+    // One replay session reconstructs every generation, out of order, against the same index.
+    CellEvoX::io::PopulationEventLogReader log_reader;
+    REQUIRE(log_reader.open(CellEvoX::io::populationEventLogPath(config->output_path)));
+    for (int g : {6, 2, 5, 1, 4, 3}) {
+        REQUIRE(log_reader.reconstruct(g, header, replayed, payload));
+        REQUIRE(replayed.size() == run.generational_popul_report[g - 1].second.size());
+    }
+    REQUIRE_FALSE(log_reader.reconstruct(7, header, replayed, payload));
+}
+
 inline bool snapshot_within_domain(
     const std::vector<CellEvoX::io::PopulationSnapshotRecord>& snapshot,
     float domain_size
@@ -1143,6 +1372,78 @@ TEST_CASE("SimulationEngine3DCapacity writes spatial driver-mutation snapshots",
     }));
 }
 
+TEST_CASE("SimulationEngine3DCapacity writes voxel LOD aggregates next to its snapshots", "[SimulationEngine3DCapacity][VoxelLod]") {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, 1);
+
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_CAPACITY;
+    config->tau_step = 1.0;
+    config->seed = 17;
+    config->initial_population = 64;
+    config->env_capacity = 1000;
+    config->steps = 2;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempString("test_sim_3d_capacity_voxel_lod");
+    config->spatial_domain_size = 20.0f;
+    config->mech_substeps = 1;
+    config->verbosity = 0;
+    config->mutations.push_back({0.1f, 0.5f, 1, true});
+    config->mutations.push_back({0.0f, 0.5f, 2, false});
+    config->voxel_lod_resolutions = {1, 8};
+
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+
+    SimulationEngine3DCapacity engine(config);
+    engine.run(2);
+
+    for (const int generation : {1, 2}) {
+        CellEvoX::io::PopulationSnapshotFileHeader header{};
+        std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+        std::vector<CellEvoX::io::PopulationSnapshotDriverMutation> mutations;
+        REQUIRE(CellEvoX::io::readPopulationSnapshot(
+            CellEvoX::io::populationSnapshotPath(config->output_path, generation), header, records,
+            mutations));
+
+        CellEvoX::io::VoxelAggregateFrame frame;
+        REQUIRE(CellEvoX::io::readVoxelAggregates(
+            CellEvoX::io::voxelAggregatePath(config->output_path, generation), frame));
+        REQUIRE(frame.generation == generation);
+        REQUIRE(frame.record_count == records.size());
+        REQUIRE(frame.levels.size() == 2);
+        REQUIRE(frame.levels[0].voxels.size() == 1);
+        REQUIRE(frame.levels[0].voxels[0].cell_count == records.size());
+
+        // Only driver mutations (type 1) define clones, whatever the payload holds.
+        std::set<std::vector<uint32_t>> signatures;
+        for (const auto& record : records) {
+            std::vector<uint32_t> drivers;
+            for (uint32_t m = 0; m < record.driver_mutation_count; ++m) {
+                const auto& mutation = mutations[record.driver_mutation_offset + m];
+                if (mutation.mutation_type == 1) {
+                    drivers.push_back(mutation.mutation_id);
+                }
+            }
+            std::sort(drivers.begin(), drivers.end());
+            signatures.insert(drivers);
+        }
+        REQUIRE(frame.clone_offsets.size() == signatures.size() + 1);
+
+        const auto& fine = frame.levels[1].voxels;
+        uint64_t cells = 0;
+        for (const auto& voxel : fine) {
+            REQUIRE(voxel.voxel < 8u * 8u * 8u);
+            REQUIRE(voxel.dominant_clone < signatures.size());
+            cells += voxel.cell_count;
+        }
+        REQUIRE(cells == records.size());
+        REQUIRE(std::is_sorted(fine.begin(), fine.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.voxel < rhs.voxel;
+        }));
+    }
+}
+
 TEST_CASE("SimulationEngine3DCapacity writes full mutation payload snapshots when enabled", "[SimulationEngine3DCapacity]") {
     tbb::global_control control(tbb::global_control::max_allowed_parallelism, 1);
 
@@ -1382,6 +1683,54 @@ TEST_CASE("SimulationEngine3D is repeatable with the same seed", "[SimulationEng
     REQUIRE(snapshot1 == snapshot2);
 }
 
+TEST_CASE("SimulationEngine3D is deterministic across worker counts", "[SimulationEngine3D][Determinism][Parallel]") {
+    auto make_config = [](const std::string& output_path) {
+        auto config = std::make_shared<SimulationConfig>();
+        config->sim_type = SimulationType::SPATIAL_3D_DENSITY;
+        config->tau_step = 0.25;
+        config->seed = 2027;
+        config->initial_population = 64;
+        config->env_capacity = 512;
+        config->steps = 12;
+        config->stat_res = 1;
+        config->popul_res = 4;
+        config->output_path = output_path;
+        config->spatial_domain_size = 24.0f;
+        config->sample_radius = 3.0f;
+        config->max_local_density = 8.0f;
+        config->spring_constant = 0.2f;
+        config->mech_dt = 0.05f;
+        config->mech_substeps = 2;
+        config->epsilon = 0.1f;
+        config->verbosity = 0;
+        config->mutations.push_back({0.1f, 0.05f, 1, true});
+        return config;
+    };
+
+    auto run_snapshot = [&](int parallelism, const std::string& output_name) {
+        auto config = make_config(testTempString(output_name));
+        std::filesystem::remove_all(config->output_path);
+        std::filesystem::create_directories(config->output_path);
+
+        {
+            tbb::global_control control(tbb::global_control::max_allowed_parallelism, parallelism);
+            SimulationEngine3D engine(config);
+            auto runData = engine.run(config->steps);
+            REQUIRE(runData.total_deaths > 0);
+        }
+
+        return read_binary_file(
+            std::filesystem::path(config->output_path) / "population_data" / "population_generation_3.bin");
+    };
+
+    // Event draws are keyed by step and cell id, not by worker, so any split gives the same run.
+    const auto single_thread_snapshot = run_snapshot(1, "test_sim_3d_density_parallel_det_1");
+    const auto five_thread_snapshot = run_snapshot(5, "test_sim_3d_density_parallel_det_5");
+
+    REQUIRE_FALSE(single_thread_snapshot.empty());
+    REQUIRE(single_thread_snapshot == five_thread_snapshot);
+}
+
 TEST_CASE("SimulationEngine3D stabilizes near local carrying capacity", "[SimulationEngine3D][Correctness]") {
     tbb::global_control control(tbb::global_control::max_allowed_parallelism, 1);
 
@@ -1427,3 +1776,137 @@ TEST_CASE("SimulationEngine3D stabilizes near local carrying capacity", "[Simula
     const double mean_local_neighbors = compute_mean_local_neighbors(snapshot, config->sample_radius);
     REQUIRE(mean_local_neighbors == Catch::Approx(config->max_local_density).margin(1.5));
 }
+
+namespace {
+
+// Runs `config` for `steps` uninterrupted, then again as an interrupted run that stops after
+// `interrupted_steps` and is resumed from its last checkpoint, and requires both to end in the
+// same state and with byte-identical population snapshots.
+template <typename Engine>
+void require_resume_matches_uninterrupted(const std::shared_ptr<SimulationConfig>& config,
+                                          uint32_t interrupted_steps,
+                                          const std::string& name) {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, 1);
+    const auto steps = static_cast<uint32_t>(config->steps);
+
+    auto uninterrupted_config = std::make_shared<SimulationConfig>(*config);
+    uninterrupted_config->output_path = testTempString(name + "_uninterrupted");
+    std::filesystem::remove_all(uninterrupted_config->output_path);
+    std::filesystem::create_directories(uninterrupted_config->output_path + "/statistics");
+    Engine uninterrupted_engine(uninterrupted_config);
+    auto expected = uninterrupted_engine.run(steps);
+
+    auto resumed_config = std::make_shared<SimulationConfig>(*config);
+    resumed_config->output_path = testTempString(name + "_resumed");
+    std::filesystem::remove_all(resumed_config->output_path);
+    std::filesystem::create_directories(resumed_config->output_path + "/statistics");
+    {
+        Engine interrupted_engine(resumed_config);
+        (void)interrupted_engine.run(interrupted_steps);
+    }
+
+    CellEvoX::io::EngineCheckpoint checkpoint;
+    REQUIRE(CellEvoX::io::readEngineCheckpoint(
+        CellEvoX::io::engineCheckpointPath(resumed_config->output_path), checkpoint));
+    REQUIRE(checkpoint.header.completed_steps > 0);
+    REQUIRE(checkpoint.header.completed_steps < interrupted_steps);
+
+    Engine resumed_engine(resumed_config, &checkpoint);
+    REQUIRE(resumed_engine.completedSteps() == checkpoint.header.completed_steps);
+    auto resumed = resumed_engine.run(steps - static_cast<uint32_t>(resumed_engine.completedSteps()));
+
+    REQUIRE(resumed.tau == expected.tau);
+    REQUIRE(resumed.total_deaths == expected.total_deaths);
+    REQUIRE(resumed.generational_stat_report.size() == expected.generational_stat_report.size());
+    REQUIRE(std::memcmp(resumed.generational_stat_report.data(),
+                        expected.generational_stat_report.data(),
+                        expected.generational_stat_report.size() * sizeof(StatSnapshot)) == 0);
+
+    REQUIRE(resumed.cells.size() == expected.cells.size());
+    for (const auto& [cell_id, cell] : expected.cells) {
+        CellMap::const_accessor accessor;
+        REQUIRE(resumed.cells.find(accessor, cell_id));
+        REQUIRE(accessor->second.parent_id == cell.parent_id);
+        REQUIRE(accessor->second.fitness == cell.fitness);
+        REQUIRE(accessor->second.mutations == cell.mutations);
+    }
+    REQUIRE(resumed.cells_graveyard.size() == expected.cells_graveyard.size());
+
+    const auto expected_dir = std::filesystem::path(uninterrupted_config->output_path) / "population_data";
+    const auto resumed_dir = std::filesystem::path(resumed_config->output_path) / "population_data";
+    std::set<std::string> expected_files;
+    std::set<std::string> resumed_files;
+    for (const auto& entry : std::filesystem::directory_iterator(expected_dir)) {
+        expected_files.insert(entry.path().filename().string());
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(resumed_dir)) {
+        resumed_files.insert(entry.path().filename().string());
+    }
+    REQUIRE_FALSE(expected_files.empty());
+    REQUIRE(resumed_files == expected_files);
+    for (const auto& file : expected_files) {
+        INFO(file);
+        REQUIRE(read_binary_file(resumed_dir / file) == read_binary_file(expected_dir / file));
+    }
+
+    std::filesystem::remove_all(uninterrupted_config->output_path);
+    std::filesystem::remove_all(resumed_config->output_path);
+}
+
+std::shared_ptr<SimulationConfig> make_resume_config(SimulationType type) {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = type;
+    config->tau_step = 0.05;
+    config->seed = 4242;
+    config->initial_population = 100;
+    config->env_capacity = 1000;
+    config->steps = 100;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->checkpoint_interval = 2;
+    config->spatial_domain_size = 32.0f;
+    config->spring_constant = 0.2f;
+    config->mech_dt = 0.05f;
+    config->mech_substeps = 1;
+    config->epsilon = 0.1f;
+    config->verbosity = 0;
+    config->mutations.push_back({0.1f, 0.05f, 1, true});
+    config->mutations.push_back({-0.05f, 0.02f, 2, false});
+    return config;
+}
+
+}  // namespace
+
+TEST_CASE("SimulationEngine resumes bit-identically from a checkpoint", "[SimulationEngine][Checkpoint][Determinism]") {
+    auto config = make_resume_config(SimulationType::STOCHASTIC_TAU_LEAP);
+    require_resume_matches_uninterrupted<SimulationEngine>(config, 70, "test_sim_resume_2d");
+}
+
+TEST_CASE("SimulationEngine3DCapacity resumes bit-identically from a checkpoint", "[SimulationEngine3DCapacity][Checkpoint][Determinism]") {
+    auto config = make_resume_config(SimulationType::SPATIAL_3D_CAPACITY);
+    require_resume_matches_uninterrupted<SimulationEngine3DCapacity>(config, 70, "test_sim_resume_capacity");
+}
+
+TEST_CASE("SimulationEngine3D resumes bit-identically from a checkpoint", "[SimulationEngine3D][Checkpoint][Determinism]") {
+    auto config = make_resume_config(SimulationType::SPATIAL_3D_DENSITY);
+    config->tau_step = 0.5;
+    config->initial_population = 16;
+    config->env_capacity = 128;
+    config->steps = 12;
+    config->spatial_domain_size = 20.0f;
+    config->sample_radius = 3.0f;
+    config->max_local_density = 8.0f;
+    config->mech_substeps = 2;
+    require_resume_matches_uninterrupted<SimulationEngine3D>(config, 9, "test_sim_resume_density");
+}
+
+TEST_CASE("SimulationEngine3DLattice resumes bit-identically from a checkpoint", "[SimulationEngine3DLattice][Checkpoint][Determinism]") {
+    auto config = make_resume_config(SimulationType::SPATIAL_3D_LATTICE);
+    config->tau_step = 0.25;
+    config->initial_population = 27;
+    config->env_capacity = 400;
+    config->steps = 40;
+    config->spatial_domain_size = 12.0f;
+    config->checkpoint_interval = 3;
+    require_resume_matches_uninterrupted<SimulationEngine3DLattice>(config, 30, "test_sim_resume_lattice");
+}
@@ -0,0 +1,1520 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <tbb/global_control.h>
+
+#include "io/PopulationSnapshotIO.hpp"
+#include "spatial/DensityField.hpp"
+#include "spatial/LatticeOccupancy.hpp"
+#include "spatial/LiveIdIndex.hpp"
+#include "spatial/MortonReorder.hpp"
+#include "spatial/NeighborKernels.hpp"
+#include "spatial/SpatialHashGrid.hpp"
+#include "spatial/VerletNeighborList.hpp"
+#include "systems/ActiveSetScheduler.hpp"
+#include "systems/MechanicalRelaxation.hpp"
+#include "systems/NutrientField.hpp"
+#include "systems/SimulationEngine3D.hpp"
+#include "systems/SimulationEngine3DCapacity.hpp"
+#include "systems/SimulationEngine3DLattice.hpp"
+#include "utils/SimulationConfig.hpp"
+
+namespace {
+
+std::filesystem::path testTempPath(std::string_view name) {
+    return std::filesystem::temp_directory_path() / "cellevox_tests" / name;
+}
+
+struct RandomCloud {
+    std::vector<float> px;
+    std::vector<float> py;
+    std::vector<float> pz;
+};
+
+RandomCloud makeRandomCloud(size_t count, float extent, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(0.0f, extent);
+    RandomCloud cloud;
+    for (size_t i = 0; i < count; ++i) {
+        cloud.px.push_back(coord(rng));
+        cloud.py.push_back(coord(rng));
+        cloud.pz.push_back(coord(rng));
+    }
+    return cloud;
+}
+
+std::shared_ptr<SimulationConfig> makeCapacityMechanicsConfig(const std::string& output_name) {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_CAPACITY;
+    config->tau_step = 0.1;
+    config->seed = 404;
+    config->initial_population = 216;
+    config->env_capacity = 2000;
+    config->steps = 20;
+    config->stat_res = 1;
+    config->popul_res = 2;
+    config->output_path = testTempPath(output_name).string();
+    config->spatial_domain_size = 10.0f;
+    config->spring_constant = 0.35f;
+    config->mech_dt = 0.08f;
+    config->mech_substeps = 4;
+    config->epsilon = 0.1f;
+    config->verbosity = 0;
+    return config;
+}
+
+std::vector<CellEvoX::io::PopulationSnapshotRecord> runCapacityAndReadSnapshot(
+    const std::shared_ptr<SimulationConfig>& config) {
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+    {
+        SimulationEngine3DCapacity engine(config);
+        engine.run(static_cast<uint32_t>(config->steps));
+    }
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+    const auto last_generation = static_cast<int>(std::floor(config->steps * config->tau_step + 1e-9));
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(config->output_path, last_generation), header, records));
+    std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.id < rhs.id;
+    });
+    return records;
+}
+
+void requireMatchingPositions(const std::vector<CellEvoX::io::PopulationSnapshotRecord>& lhs,
+                              const std::vector<CellEvoX::io::PopulationSnapshotRecord>& rhs,
+                              float tolerance) {
+    REQUIRE(lhs.size() == rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        REQUIRE(lhs[i].id == rhs[i].id);
+        REQUIRE(std::abs(lhs[i].x - rhs[i].x) <= tolerance);
+        REQUIRE(std::abs(lhs[i].y - rhs[i].y) <= tolerance);
+        REQUIRE(std::abs(lhs[i].z - rhs[i].z) <= tolerance);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("SimulationConfig parses Verlet mechanics options", "[SimulationConfig][Mechanics]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_capacity"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"mech_neighbor_mode", "verlet"},
+        {"mech_verlet_skin", 0.5},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    auto config = utils::fromJson(j);
+    REQUIRE(config.mech_neighbor_mode == MechanicsNeighborMode::Verlet);
+    REQUIRE(config.mech_verlet_skin == Catch::Approx(0.5));
+
+    auto invalid = j;
+    invalid["mech_neighbor_mode"] = "octree";
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    auto half_stencil = j;
+    half_stencil["mech_neighbor_mode"] = "half_stencil";
+    REQUIRE(utils::fromJson(half_stencil).mech_neighbor_mode == MechanicsNeighborMode::HalfStencil);
+
+    invalid = j;
+    invalid["mech_verlet_skin"] = -0.1;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+}
+
+TEST_CASE("SimulationConfig parses spatial reorder options", "[SimulationConfig][Mechanics]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_density"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"spatial_reorder", "morton"},
+        {"spatial_reorder_degradation", 1.5},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    auto config = utils::fromJson(j);
+    REQUIRE(config.spatial_reorder == SpatialReorderMode::Morton);
+    REQUIRE(config.spatial_reorder_degradation == Catch::Approx(1.5));
+
+    auto invalid = j;
+    invalid["spatial_reorder"] = "hilbert";
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["spatial_reorder_degradation"] = 0.5;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+}
+
+TEST_CASE("SimulationConfig parses adaptive and local mechanics options", "[SimulationConfig][Mechanics]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_capacity"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"mech_adaptive", true},
+        {"mech_tolerance", 0.005},
+        {"mech_adaptive_dt", true},
+        {"mech_local", true},
+        {"mech_local_threshold", 0.02},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    auto config = utils::fromJson(j);
+    REQUIRE(config.mech_adaptive);
+    REQUIRE(config.mech_tolerance == Catch::Approx(0.005));
+    REQUIRE(config.mech_adaptive_dt);
+    REQUIRE(config.mech_local);
+    REQUIRE(config.mech_local_threshold == Catch::Approx(0.02));
+
+    auto invalid = j;
+    invalid["mech_tolerance"] = -0.1;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["mech_local_threshold"] = -0.1;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+}
+
+TEST_CASE("SimulationConfig parses active-set options", "[SimulationConfig][Mechanics]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_density"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"active_set", true},
+        {"active_set_dormant_interval", 4},
+        {"active_set_displacement_tolerance", 0.01},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    auto config = utils::fromJson(j);
+    REQUIRE(config.active_set);
+    REQUIRE(config.active_set_dormant_interval == 4);
+    REQUIRE(config.active_set_displacement_tolerance == Catch::Approx(0.01));
+
+    auto invalid = j;
+    invalid["active_set_dormant_interval"] = 0;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["active_set_displacement_tolerance"] = -1.0;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+}
+
+TEST_CASE("SimulationConfig parses density estimator", "[SimulationConfig][DensityField]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_density"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    REQUIRE(utils::fromJson(j).density_estimator == DensityEstimatorMode::Exact);
+    j["density_estimator"] = "field";
+    REQUIRE(utils::fromJson(j).density_estimator == DensityEstimatorMode::Field);
+    j["density_estimator"] = "kernel";
+    REQUIRE_THROWS_AS(utils::fromJson(j), std::runtime_error);
+}
+
+TEST_CASE("SimulationConfig parses nutrient field options", "[SimulationConfig][NutrientField]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_density"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"nutrient_field", true},
+        {"nutrient_diffusion", 4.0},
+        {"nutrient_consumption", 0.5},
+        {"nutrient_hypoxia_threshold", 0.3},
+        {"nutrient_necrosis_threshold", 0.1},
+        {"nutrient_vcycles", 3},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    auto config = utils::fromJson(j);
+    REQUIRE(config.nutrient_field);
+    REQUIRE(config.nutrient_diffusion == Catch::Approx(4.0));
+    REQUIRE(config.nutrient_consumption == Catch::Approx(0.5));
+    REQUIRE(config.nutrient_hypoxia_threshold == Catch::Approx(0.3));
+    REQUIRE(config.nutrient_necrosis_threshold == Catch::Approx(0.1));
+    REQUIRE(config.nutrient_vcycles == 3);
+
+    auto invalid = j;
+    invalid["nutrient_diffusion"] = 0.0;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["nutrient_hypoxia_threshold"] = 1.5;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+
+    invalid = j;
+    invalid["nutrient_vcycles"] = 0;
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+}
+
+TEST_CASE("ActiveSetScheduler skips dormant voxels until they are due or woken", "[ActiveSetScheduler][Mechanics]") {
+    // One cell in each of three voxels along x: 0 and 1 are neighbors, 3 is isolated.
+    const std::vector<uint32_t> ids{0, 1, 2};
+    const std::vector<float> px{0.5f, 1.5f, 3.5f};
+    const std::vector<float> py{0.5f, 0.5f, 0.5f};
+    const std::vector<float> pz{0.5f, 0.5f, 0.5f};
+    SpatialHashGrid grid(1.0f, 8.0f);
+    grid.rebuild(ids, px, py, pz);
+
+    CellEvoX::systems::ActiveSetScheduler scheduler;
+    scheduler.beginStep(grid, 1, 3);
+    REQUIRE(scheduler.dueCells() == std::vector<uint32_t>{0, 1, 2});
+    REQUIRE(scheduler.dueElapsedSteps() == std::vector<uint32_t>{1, 1, 1});
+    scheduler.endStep();
+    REQUIRE(scheduler.dormantVoxelCount() == 3);
+
+    // Dormant voxels are skipped until the interval elapses.
+    scheduler.beginStep(grid, 2, 3);
+    REQUIRE(scheduler.dueCells().empty());
+    REQUIRE(scheduler.frozenCells() == std::vector<uint8_t>{1, 1, 1});
+    scheduler.endStep();
+    scheduler.beginStep(grid, 3, 3);
+    REQUIRE(scheduler.dueCells().empty());
+    scheduler.endStep();
+
+    // The catch-up draw covers every skipped step; an event wakes the neighboring voxel too.
+    scheduler.beginStep(grid, 4, 3);
+    REQUIRE(scheduler.dueCells() == std::vector<uint32_t>{0, 1, 2});
+    REQUIRE(scheduler.dueElapsedSteps() == std::vector<uint32_t>{3, 3, 3});
+    scheduler.markChanged(0);
+    scheduler.endStep();
+    REQUIRE(scheduler.dormantVoxelCount() == 1);
+    REQUIRE(scheduler.frozenCells() == std::vector<uint8_t>{0, 0, 0});
+
+    scheduler.beginStep(grid, 5, 3);
+    REQUIRE(scheduler.dueCells() == std::vector<uint32_t>{0, 1});
+    REQUIRE(scheduler.frozenCells() == std::vector<uint8_t>{0, 0, 1});
+    scheduler.markBusy(1);
+    scheduler.endStep();
+    REQUIRE(scheduler.dormantVoxelCount() == 2);
+}
+
+TEST_CASE("MortonReorder sorts cells along the Z-order curve", "[MortonReorder][Mechanics]") {
+    REQUIRE(CellEvoX::spatial::mortonKey(0, 0, 0) == 0);
+    REQUIRE(CellEvoX::spatial::mortonKey(1, 0, 0) == 1);
+    REQUIRE(CellEvoX::spatial::mortonKey(0, 1, 0) == 2);
+    REQUIRE(CellEvoX::spatial::mortonKey(0, 0, 1) == 4);
+    REQUIRE(CellEvoX::spatial::mortonKey(3, 3, 3) == 63);
+    REQUIRE(CellEvoX::spatial::mortonKey(0, 0, (1u << 21) - 1) == 0x4924924924924924ULL);
+
+    auto cloud = makeRandomCloud(5000, 30.0f, 41);
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{3});
+    auto px = cloud.px;
+    auto py = cloud.py;
+    auto pz = cloud.pz;
+
+    const double shuffled_locality = CellEvoX::spatial::meanConsecutiveDistance(px, py, pz);
+    CellEvoX::spatial::MortonReorder reorder(2.0f);
+    REQUIRE(reorder.maybeReorder(ids, px, py, pz, 2.0f));
+    REQUIRE(reorder.baselineLocality() < 0.25 * shuffled_locality);
+    REQUIRE_FALSE(reorder.maybeReorder(ids, px, py, pz, 2.0f));
+
+    for (size_t slot = 0; slot < ids.size(); ++slot) {
+        const size_t source = ids[slot] - 3;
+        REQUIRE(px[slot] == cloud.px[source]);
+        REQUIRE(py[slot] == cloud.py[source]);
+        REQUIRE(pz[slot] == cloud.pz[source]);
+    }
+
+    const auto key_of = [](float x, float y, float z) {
+        return CellEvoX::spatial::mortonKey(static_cast<uint32_t>(x / 2.0f),
+                                            static_cast<uint32_t>(y / 2.0f),
+                                            static_cast<uint32_t>(z / 2.0f));
+    };
+    for (size_t slot = 1; slot < ids.size(); ++slot) {
+        const uint64_t prev_key = key_of(px[slot - 1], py[slot - 1], pz[slot - 1]);
+        const uint64_t key = key_of(px[slot], py[slot], pz[slot]);
+        REQUIRE(prev_key <= key);
+        if (prev_key == key) {
+            REQUIRE(ids[slot - 1] < ids[slot]);
+        }
+    }
+}
+
+TEST_CASE("VerletNeighborList stores every pair inside cutoff plus skin", "[VerletNeighborList][Mechanics]") {
+    const auto cloud = makeRandomCloud(600, 12.0f, 9);
+    const float cutoff = 2.0f;
+    const float skin = 0.4f;
+
+    VerletNeighborList list(cutoff, skin, 12.0f);
+    REQUIRE(list.needsRebuild(cloud.px, cloud.py, cloud.pz));
+    list.build(cloud.px, cloud.py, cloud.pz);
+    REQUIRE(list.size() == cloud.px.size());
+    REQUIRE(list.buildCount() == 1);
+
+    const float list_radius_sq = (cutoff + skin) * (cutoff + skin);
+    size_t expected_pairs = 0;
+    for (size_t i = 0; i < cloud.px.size(); ++i) {
+        std::vector<uint32_t> expected;
+        for (size_t j = 0; j < cloud.px.size(); ++j) {
+            const float dx = cloud.px[i] - cloud.px[j];
+            const float dy = cloud.py[i] - cloud.py[j];
+            const float dz = cloud.pz[i] - cloud.pz[j];
+            if (i != j && dx * dx + dy * dy + dz * dz <= list_radius_sq) {
+                expected.push_back(static_cast<uint32_t>(j));
+            }
+        }
+
+        std::vector<uint32_t> actual;
+        for (size_t slot = list.neighborBegin(i); slot < list.neighborEnd(i); ++slot) {
+            actual.push_back(list.neighborAt(slot));
+        }
+        std::sort(actual.begin(), actual.end());
+        REQUIRE(actual == expected);
+        expected_pairs += expected.size();
+    }
+    REQUIRE(list.pairCount() == expected_pairs);
+}
+
+TEST_CASE("VerletNeighborList requests a rebuild only after half-skin drift", "[VerletNeighborList][Mechanics]") {
+    auto cloud = makeRandomCloud(64, 8.0f, 11);
+    VerletNeighborList list(2.0f, 0.4f, 8.0f);
+    list.build(cloud.px, cloud.py, cloud.pz);
+    REQUIRE_FALSE(list.needsRebuild(cloud.px, cloud.py, cloud.pz));
+
+    cloud.px[5] += 0.15f;
+    REQUIRE_FALSE(list.needsRebuild(cloud.px, cloud.py, cloud.pz));
+
+    cloud.px[5] += 0.1f;
+    REQUIRE(list.needsRebuild(cloud.px, cloud.py, cloud.pz));
+
+    cloud.px[5] -= 0.25f;
+    list.invalidate();
+    REQUIRE(list.needsRebuild(cloud.px, cloud.py, cloud.pz));
+
+    cloud.px.pop_back();
+    cloud.py.pop_back();
+    cloud.pz.pop_back();
+    list.build(cloud.px, cloud.py, cloud.pz);
+    REQUIRE(list.buildCount() == 2);
+    REQUIRE(list.size() == 63);
+}
+
+TEST_CASE("VerletNeighborList remap matches a rebuild after births, deaths and reorders", "[VerletNeighborList][Mechanics]") {
+    const auto cloud = makeRandomCloud(400, 10.0f, 17);
+    const auto births = makeRandomCloud(60, 10.0f, 18);
+    VerletNeighborList list(2.0f, 0.4f, 10.0f);
+    list.build(cloud.px, cloud.py, cloud.pz);
+
+    // Every fifth cell dies, the survivors are reversed and the newborns appended.
+    RandomCloud next;
+    std::vector<uint32_t> previous_slots;
+    for (size_t i = cloud.px.size(); i-- > 0;) {
+        if (i % 5 == 0) {
+            continue;
+        }
+        next.px.push_back(cloud.px[i]);
+        next.py.push_back(cloud.py[i]);
+        next.pz.push_back(cloud.pz[i]);
+        previous_slots.push_back(static_cast<uint32_t>(i));
+    }
+    for (size_t b = 0; b < births.px.size(); ++b) {
+        next.px.push_back(births.px[b]);
+        next.py.push_back(births.py[b]);
+        next.pz.push_back(births.pz[b]);
+        previous_slots.push_back(VerletNeighborList::kNewSlot);
+    }
+
+    list.remap(previous_slots, next.px, next.py, next.pz);
+    REQUIRE(list.buildCount() == 1);
+    REQUIRE(list.remapCount() == 1);
+    REQUIRE(list.size() == next.px.size());
+    REQUIRE_FALSE(list.needsRebuild(next.px, next.py, next.pz));
+
+    VerletNeighborList rebuilt(2.0f, 0.4f, 10.0f);
+    rebuilt.build(next.px, next.py, next.pz);
+    REQUIRE(list.pairCount() == rebuilt.pairCount());
+    const auto neighbors_of = [](const VerletNeighborList& source, size_t i) {
+        std::vector<uint32_t> neighbors;
+        for (size_t slot = source.neighborBegin(i); slot < source.neighborEnd(i); ++slot) {
+            neighbors.push_back(source.neighborAt(slot));
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        return neighbors;
+    };
+    for (size_t i = 0; i < next.px.size(); ++i) {
+        REQUIRE(neighbors_of(list, i) == neighbors_of(rebuilt, i));
+    }
+}
+
+TEST_CASE("MechanicalRelaxation adaptive mode stops once displacements converge", "[MechanicalRelaxation][Mechanics]") {
+    SimulationConfig config;
+    config.spatial_domain_size = 12.0f;
+    config.spring_constant = 0.5f;
+    config.mech_dt = 0.1f;
+    config.mech_substeps = 400;
+    config.mech_adaptive = true;
+    config.mech_tolerance = 1e-3f;
+
+    auto cloud = makeRandomCloud(150, config.spatial_domain_size, 29);
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{0});
+    SpatialHashGrid grid(2.0f, config.spatial_domain_size);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    CellEvoX::systems::MechanicalRelaxation mechanics(config, 2.0f);
+    mechanics.relax(config, ids, cloud.px, cloud.py, cloud.pz, grid);
+    const auto first = mechanics.lastStats();
+    REQUIRE(first.iterations > 1);
+    REQUIRE(first.iterations < config.mech_substeps);
+    REQUIRE(first.max_displacement < config.mech_tolerance);
+    REQUIRE(first.rms_displacement <= first.max_displacement);
+
+    // An already relaxed packing needs a single substep to confirm convergence.
+    mechanics.relax(config, ids, cloud.px, cloud.py, cloud.pz, grid);
+    REQUIRE(mechanics.lastStats().iterations == 1);
+
+    config.mech_adaptive = false;
+    config.mech_substeps = 3;
+    mechanics.relax(config, ids, cloud.px, cloud.py, cloud.pz, grid);
+    REQUIRE(mechanics.lastStats().iterations == 3);
+}
+
+TEST_CASE("MechanicalRelaxation adaptive dt bounds per-substep displacement", "[MechanicalRelaxation][Mechanics]") {
+    SimulationConfig config;
+    config.spatial_domain_size = 12.0f;
+    config.spring_constant = 0.5f;
+    config.mech_dt = 4.0f;
+    config.mech_substeps = 1;
+    config.mech_adaptive = true;
+    config.mech_adaptive_dt = true;
+    config.mech_tolerance = 0.0f;
+
+    auto cloud = makeRandomCloud(150, config.spatial_domain_size, 31);
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{0});
+    SpatialHashGrid grid(2.0f, config.spatial_domain_size);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    CellEvoX::systems::MechanicalRelaxation mechanics(config, 2.0f);
+    for (int step = 0; step < 10; ++step) {
+        const auto before = cloud;
+        mechanics.relax(config, ids, cloud.px, cloud.py, cloud.pz, grid);
+        float max_displacement = 0.0f;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            const float dx = cloud.px[i] - before.px[i];
+            const float dy = cloud.py[i] - before.py[i];
+            const float dz = cloud.pz[i] - before.pz[i];
+            max_displacement = std::max(max_displacement, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+        REQUIRE(max_displacement <= 0.5f + 1e-4f);
+        REQUIRE(mechanics.lastStats().max_displacement == Catch::Approx(max_displacement).margin(1e-4));
+    }
+    REQUIRE(mechanics.lastStats().dt <= config.mech_dt);
+}
+
+TEST_CASE("MechanicalRelaxation local mode only moves cells near the seeds", "[MechanicalRelaxation][Mechanics]") {
+    SimulationConfig config;
+    config.spatial_domain_size = 24.0f;
+    config.spring_constant = 0.5f;
+    config.mech_dt = 0.1f;
+    config.mech_substeps = 10;
+    config.mech_local = true;
+    config.mech_local_threshold = 1e-2f;
+
+    // A non-overlapping 10^3 lattice with spacing 2.2 and one daughter dropped next to a cell.
+    RandomCloud cloud;
+    for (int iz = 0; iz < 10; ++iz) {
+        for (int iy = 0; iy < 10; ++iy) {
+            for (int ix = 0; ix < 10; ++ix) {
+                cloud.px.push_back(1.0f + 2.2f * static_cast<float>(ix));
+                cloud.py.push_back(1.0f + 2.2f * static_cast<float>(iy));
+                cloud.pz.push_back(1.0f + 2.2f * static_cast<float>(iz));
+            }
+        }
+    }
+    const uint32_t seed = static_cast<uint32_t>(cloud.px.size());
+    cloud.px.push_back(cloud.px[555] + 0.3f);
+    cloud.py.push_back(cloud.py[555]);
+    cloud.pz.push_back(cloud.pz[555]);
+    const RandomCloud before = cloud;
+
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{0});
+    SpatialHashGrid grid(2.0f, config.spatial_domain_size);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    CellEvoX::systems::MechanicalRelaxation mechanics(config, 2.0f);
+    mechanics.relaxLocal(config, ids, cloud.px, cloud.py, cloud.pz, grid, {seed});
+    REQUIRE(mechanics.lastStats().iterations == config.mech_substeps);
+
+    std::set<uint32_t> touched(mechanics.touchedCells().begin(), mechanics.touchedCells().end());
+    REQUIRE(touched.count(seed) == 1);
+    REQUIRE(touched.count(555) == 1);
+    REQUIRE(touched.size() < ids.size() / 10);
+    for (uint32_t i = 0; i < ids.size(); ++i) {
+        if (touched.count(i) == 0) {
+            REQUIRE(cloud.px[i] == before.px[i]);
+            REQUIRE(cloud.py[i] == before.py[i]);
+            REQUIRE(cloud.pz[i] == before.pz[i]);
+        }
+    }
+    const float dx = cloud.px[seed] - cloud.px[555];
+    const float dy = cloud.py[seed] - cloud.py[555];
+    const float dz = cloud.pz[seed] - cloud.pz[555];
+    REQUIRE(std::sqrt(dx * dx + dy * dy + dz * dz) > 0.3f);
+
+    // The grid is left rebuilt for the relaxed positions.
+    std::set<uint32_t> near_seed;
+    grid.queryRadius(cloud.px[seed], cloud.py[seed], cloud.pz[seed], 0.1f, [&](uint32_t id) {
+        near_seed.insert(id);
+    });
+    REQUIRE(near_seed.count(seed) == 1);
+}
+
+TEST_CASE("SpatialHashGrid half-stencil visits each close pair exactly once", "[SpatialHashGrid][Mechanics]") {
+    // 6^3 dense voxels, and 120^3 voxels which exceeds the dense limit and uses the hashed ranges.
+    const std::vector<std::pair<float, float>> layouts{{2.0f, 12.0f}, {1.0f, 120.0f}};
+    for (const auto& [voxel_size, domain_size] : layouts) {
+        const auto cloud = makeRandomCloud(domain_size > 100.0f ? 4000 : 500, domain_size, 17);
+        std::vector<uint32_t> ids(cloud.px.size());
+        std::iota(ids.begin(), ids.end(), uint32_t{0});
+
+        SpatialHashGrid grid(voxel_size, domain_size);
+        grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+        const float radius_sq = voxel_size * voxel_size;
+        std::set<std::pair<uint32_t, uint32_t>> expected;
+        for (uint32_t a = 0; a < ids.size(); ++a) {
+            for (uint32_t b = a + 1; b < ids.size(); ++b) {
+                const float dx = cloud.px[a] - cloud.px[b];
+                const float dy = cloud.py[a] - cloud.py[b];
+                const float dz = cloud.pz[a] - cloud.pz[b];
+                if (dx * dx + dy * dy + dz * dz < radius_sq) {
+                    expected.insert({a, b});
+                }
+            }
+        }
+
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> visited_per_cell(ids.size());
+        grid.forEachHalfStencilPair([&](uint32_t a, uint32_t b) {
+            // Colored scheduling guarantees both cells are exclusively owned by this task.
+            visited_per_cell[a].push_back({std::min(a, b), std::max(a, b)});
+        });
+
+        std::multiset<std::pair<uint32_t, uint32_t>> visited;
+        for (const auto& pairs : visited_per_cell) {
+            visited.insert(pairs.begin(), pairs.end());
+        }
+        for (const auto& pair : visited) {
+            REQUIRE(visited.count(pair) == 1);
+        }
+        for (const auto& pair : expected) {
+            REQUIRE(visited.count(pair) == 1);
+        }
+    }
+}
+
+TEST_CASE("SpatialHashGrid dense rebuild orders cells stably by voxel", "[SpatialHashGrid][Mechanics]") {
+    const float voxel_size = 2.0f;
+    const float domain_size = 40.0f;
+    auto cloud = makeRandomCloud(20000, domain_size, 31);
+    // Out-of-domain cells clamp into the boundary voxels.
+    cloud.px.push_back(-3.0f);
+    cloud.py.push_back(45.0f);
+    cloud.pz.push_back(domain_size);
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{7});
+
+    SpatialHashGrid grid(voxel_size, domain_size);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    const auto voxel_of = [&](float x, float y, float z) {
+        const auto index = [&](float value) {
+            return std::clamp(static_cast<int>(std::floor(value / voxel_size)), 0, 19);
+        };
+        return grid.hashVoxel(index(x), index(y), index(z));
+    };
+
+    const auto& source = grid.sortedSourceIndices();
+    REQUIRE(source.size() == ids.size());
+    for (size_t slot = 1; slot < source.size(); ++slot) {
+        const int64_t prev_voxel =
+            voxel_of(grid.sortedX()[slot - 1], grid.sortedY()[slot - 1], grid.sortedZ()[slot - 1]);
+        const int64_t voxel = voxel_of(grid.sortedX()[slot], grid.sortedY()[slot], grid.sortedZ()[slot]);
+        REQUIRE(prev_voxel <= voxel);
+        if (prev_voxel == voxel) {
+            REQUIRE(source[slot - 1] < source[slot]);
+        }
+    }
+
+    size_t visited = 0;
+    grid.forEachCandidateRun(-3.0f, 45.0f, domain_size, 0.5f, [&](size_t begin, size_t end) {
+        for (size_t slot = begin; slot < end; ++slot) {
+            visited += grid.sortedIds()[slot] == ids.back() ? 1 : 0;
+        }
+    });
+    REQUIRE(visited == 1);
+}
+
+TEST_CASE("SpatialHashGrid sparse voxel index answers radius queries on large domains", "[SpatialHashGrid][Mechanics]") {
+    // 1000^3 voxels: only the occupied voxels of a small tumor-like cluster are indexed.
+    const float voxel_size = 1.0f;
+    const float domain_size = 1000.0f;
+    auto cloud = makeRandomCloud(3000, 12.0f, 29);
+    for (size_t i = 0; i < cloud.px.size(); ++i) {
+        cloud.px[i] += 494.0f;
+        cloud.py[i] += 494.0f;
+        cloud.pz[i] += 494.0f;
+    }
+    cloud.px.push_back(0.2f);
+    cloud.py.push_back(999.7f);
+    cloud.pz.push_back(0.4f);
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{0});
+
+    SpatialHashGrid grid(voxel_size, domain_size);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    const float radius = 1.5f;
+    for (size_t i = 0; i < ids.size(); i += 13) {
+        std::vector<uint32_t> expected;
+        for (size_t j = 0; j < ids.size(); ++j) {
+            const float dx = cloud.px[i] - cloud.px[j];
+            const float dy = cloud.py[i] - cloud.py[j];
+            const float dz = cloud.pz[i] - cloud.pz[j];
+            if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                expected.push_back(ids[j]);
+            }
+        }
+
+        std::vector<uint32_t> found;
+        grid.queryRadius(cloud.px[i], cloud.py[i], cloud.pz[i], radius, [&](uint32_t id) {
+            const float dx = cloud.px[i] - cloud.px[id];
+            const float dy = cloud.py[i] - cloud.py[id];
+            const float dz = cloud.pz[i] - cloud.pz[id];
+            if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                found.push_back(id);
+            }
+        });
+        std::sort(found.begin(), found.end());
+        REQUIRE(found == expected);
+    }
+
+    std::vector<uint32_t> corner;
+    grid.queryRadius(0.0f, 1000.0f, 0.0f, radius, [&](uint32_t id) { corner.push_back(id); });
+    REQUIRE(corner == std::vector<uint32_t>{ids.back()});
+}
+
+TEST_CASE("Voxel-sorted neighbor kernels match scalar references", "[SpatialHashGrid][Mechanics]") {
+    const std::vector<std::pair<float, float>> layouts{{2.0f, 16.0f}, {1.0f, 120.0f}};
+    for (const auto& [voxel_size, domain_size] : layouts) {
+        const auto cloud = makeRandomCloud(domain_size > 100.0f ? 20000 : 1500, domain_size, 23);
+        std::vector<uint32_t> ids(cloud.px.size());
+        std::iota(ids.begin(), ids.end(), uint32_t{100});
+
+        SpatialHashGrid grid(voxel_size, domain_size);
+        grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+        const auto& source = grid.sortedSourceIndices();
+        REQUIRE(source.size() == ids.size());
+        for (size_t slot = 0; slot < source.size(); ++slot) {
+            REQUIRE(grid.sortedIds()[slot] == ids[source[slot]]);
+            REQUIRE(grid.sortedX()[slot] == cloud.px[source[slot]]);
+            REQUIRE(grid.sortedY()[slot] == cloud.py[source[slot]]);
+            REQUIRE(grid.sortedZ()[slot] == cloud.pz[source[slot]]);
+        }
+
+        const float sample_radius = 1.5f * voxel_size;
+        const float spring_radius = voxel_size;
+        for (size_t i = 0; i < cloud.px.size(); i += 37) {
+            uint32_t expected_count = 0;
+            float expected_force[3] = {0.0f, 0.0f, 0.0f};
+            for (size_t j = 0; j < cloud.px.size(); ++j) {
+                const float dx = cloud.px[i] - cloud.px[j];
+                const float dy = cloud.py[i] - cloud.py[j];
+                const float dz = cloud.pz[i] - cloud.pz[j];
+                const float dist_sq = dx * dx + dy * dy + dz * dz;
+                if (dist_sq <= sample_radius * sample_radius) {
+                    ++expected_count;
+                }
+                if (dist_sq > 1e-12f && dist_sq < spring_radius * spring_radius) {
+                    const float dist = std::sqrt(dist_sq);
+                    const float scale = 0.4f * (spring_radius - dist) / dist;
+                    expected_force[0] += scale * dx;
+                    expected_force[1] += scale * dy;
+                    expected_force[2] += scale * dz;
+                }
+            }
+
+            REQUIRE(CellEvoX::spatial::countNeighborsWithin(
+                        grid, cloud.px[i], cloud.py[i], cloud.pz[i], sample_radius) == expected_count);
+
+            float force[3] = {0.0f, 0.0f, 0.0f};
+            CellEvoX::spatial::accumulateSpringForce(
+                grid, cloud.px[i], cloud.py[i], cloud.pz[i], spring_radius, 0.4f, force);
+            for (int axis = 0; axis < 3; ++axis) {
+                REQUIRE(force[axis] == Catch::Approx(expected_force[axis]).margin(1e-5));
+            }
+        }
+    }
+}
+
+TEST_CASE("SimulationEngine3DCapacity half-stencil mechanics match grid mechanics", "[SimulationEngine3DCapacity][Mechanics]") {
+    auto grid_config = makeCapacityMechanicsConfig("test_mech_grid_half_reference");
+    auto half_config = makeCapacityMechanicsConfig("test_mech_half_stencil");
+    half_config->mech_neighbor_mode = MechanicsNeighborMode::HalfStencil;
+
+    const auto grid_records = runCapacityAndReadSnapshot(grid_config);
+    const auto half_records = runCapacityAndReadSnapshot(half_config);
+    REQUIRE_FALSE(grid_records.empty());
+    requireMatchingPositions(grid_records, half_records, 1e-3f);
+}
+
+TEST_CASE("SimulationEngine3DCapacity Verlet mechanics match grid mechanics", "[SimulationEngine3DCapacity][Mechanics]") {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, 1);
+
+    auto grid_config = makeCapacityMechanicsConfig("test_mech_grid_reference");
+    auto verlet_config = makeCapacityMechanicsConfig("test_mech_verlet");
+    verlet_config->mech_neighbor_mode = MechanicsNeighborMode::Verlet;
+    verlet_config->mech_verlet_skin = 0.3f;
+
+    const auto grid_records = runCapacityAndReadSnapshot(grid_config);
+    const auto verlet_records = runCapacityAndReadSnapshot(verlet_config);
+    REQUIRE_FALSE(grid_records.empty());
+    requireMatchingPositions(grid_records, verlet_records, 1e-3f);
+}
+
+TEST_CASE("SimulationEngine3DCapacity Morton reordering preserves mechanics", "[SimulationEngine3DCapacity][Mechanics]") {
+    auto reference_config = makeCapacityMechanicsConfig("test_mech_reorder_reference");
+    auto morton_config = makeCapacityMechanicsConfig("test_mech_reorder_morton");
+    morton_config->spatial_reorder = SpatialReorderMode::Morton;
+    // Reorder whenever locality is any worse than right after the previous reorder.
+    morton_config->spatial_reorder_degradation = 1.0f;
+
+    const auto reference_records = runCapacityAndReadSnapshot(reference_config);
+    const auto morton_records = runCapacityAndReadSnapshot(morton_config);
+    REQUIRE_FALSE(reference_records.empty());
+    requireMatchingPositions(reference_records, morton_records, 1e-3f);
+}
+
+TEST_CASE("SimulationEngine3D Morton reordering keeps spatial state consistent", "[SimulationEngine3D][Mechanics]") {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_DENSITY;
+    config->tau_step = 0.5;
+    config->seed = 12;
+    config->initial_population = 343;
+    config->env_capacity = 5000;
+    config->steps = 6;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempPath("test_sim_3d_morton").string();
+    config->spatial_domain_size = 16.0f;
+    config->mech_substeps = 2;
+    config->verbosity = 0;
+    config->spatial_reorder = SpatialReorderMode::Morton;
+    config->spatial_reorder_degradation = 1.0f;
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+
+    SimulationEngine3D engine(config);
+    auto run = engine.run(static_cast<uint32_t>(config->steps));
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(config->output_path, 3), header, records));
+    REQUIRE(records.size() == run.cells.size());
+
+    std::set<uint32_t> ids;
+    for (const auto& record : records) {
+        REQUIRE(ids.insert(record.id).second);
+        REQUIRE(run.cells.count(record.id) == 1);
+        REQUIRE(record.x >= 0.0f);
+        REQUIRE(record.x <= config->spatial_domain_size);
+    }
+}
+
+TEST_CASE("SimulationEngine3D active set keeps spatial state consistent", "[SimulationEngine3D][Mechanics]") {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_DENSITY;
+    config->tau_step = 0.5;
+    config->seed = 21;
+    config->initial_population = 343;
+    config->env_capacity = 5000;
+    config->steps = 8;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempPath("test_sim_3d_active_set").string();
+    config->spatial_domain_size = 16.0f;
+    config->mech_substeps = 2;
+    config->verbosity = 0;
+    config->active_set = true;
+    config->active_set_dormant_interval = 3;
+    config->active_set_displacement_tolerance = 0.05f;
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+
+    SimulationEngine3D engine(config);
+    auto run = engine.run(static_cast<uint32_t>(config->steps));
+    REQUIRE_FALSE(run.cells.empty());
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(config->output_path, 4), header, records));
+    REQUIRE(records.size() == run.cells.size());
+
+    std::set<uint32_t> ids;
+    for (const auto& record : records) {
+        REQUIRE(ids.insert(record.id).second);
+        REQUIRE(run.cells.count(record.id) == 1);
+        REQUIRE(record.x >= 0.0f);
+        REQUIRE(record.x <= config->spatial_domain_size);
+    }
+}
+
+TEST_CASE("SimulationEngine3DCapacity local mechanics keeps spatial state consistent", "[SimulationEngine3DCapacity][Mechanics]") {
+    auto config = makeCapacityMechanicsConfig("test_sim_3d_capacity_local_mechanics");
+    config->mech_local = true;
+    const auto records = runCapacityAndReadSnapshot(config);
+    REQUIRE_FALSE(records.empty());
+
+    std::set<uint32_t> ids;
+    for (const auto& record : records) {
+        REQUIRE(ids.insert(record.id).second);
+        REQUIRE(record.x >= 0.0f);
+        REQUIRE(record.x <= config->spatial_domain_size);
+    }
+}
+
+TEST_CASE("SimulationEngine3D local mechanics keeps spatial state consistent", "[SimulationEngine3D][Mechanics]") {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_DENSITY;
+    config->tau_step = 0.5;
+    config->seed = 33;
+    config->initial_population = 343;
+    config->env_capacity = 5000;
+    config->steps = 6;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempPath("test_sim_3d_local_mechanics").string();
+    config->spatial_domain_size = 16.0f;
+    config->mech_substeps = 4;
+    config->verbosity = 0;
+    config->mech_local = true;
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+
+    SimulationEngine3D engine(config);
+    auto run = engine.run(static_cast<uint32_t>(config->steps));
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(config->output_path, 3), header, records));
+    REQUIRE(records.size() == run.cells.size());
+    for (const auto& record : records) {
+        REQUIRE(run.cells.count(record.id) == 1);
+        REQUIRE(record.z >= 0.0f);
+        REQUIRE(record.z <= config->spatial_domain_size);
+    }
+}
+
+TEST_CASE("SimulationConfig parses spatial_3d_lattice mode", "[SimulationConfig][Lattice]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_lattice"},
+        {"tau_step", 0.05},
+        {"initial_population", 100},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 1},
+        {"output_path", "./output/"},
+        {"spatial_domain_size", 20.0},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    SimulationConfig config = utils::fromJson(j);
+    REQUIRE(config.sim_type == SimulationType::SPATIAL_3D_LATTICE);
+    REQUIRE(std::string(utils::toString(config.sim_type)) == "SPATIAL_3D_LATTICE");
+
+    // A 20-unit domain holds a 10^3 lattice.
+    j["initial_population"] = 1001;
+    REQUIRE_THROWS(utils::fromJson(j));
+    j["initial_population"] = 100;
+    j["spatial_domain_size"] = 4000.0;
+    REQUIRE_THROWS(utils::fromJson(j));
+}
+
+TEST_CASE("LatticeOccupancy tracks voxel owners", "[LatticeOccupancy][Lattice]") {
+    using CellEvoX::spatial::LatticeOccupancy;
+    REQUIRE(LatticeOccupancy::dimForDomain(11.0f, 2.0f) == 5);
+    REQUIRE(LatticeOccupancy::dimForDomain(1.0f, 2.0f) == 1);
+    REQUIRE_THROWS(LatticeOccupancy(0));
+    REQUIRE_THROWS(LatticeOccupancy(LatticeOccupancy::kMaxDim + 1));
+
+    LatticeOccupancy lattice(5);
+    REQUIRE(lattice.voxelCount() == 125);
+    const uint32_t voxel = lattice.voxelIndex(1, 2, 3);
+    REQUIRE(lattice.coordinates(voxel) == std::array<int, 3>{1, 2, 3});
+    REQUIRE_FALSE(lattice.inBounds(5, 0, 0));
+    REQUIRE_FALSE(lattice.inBounds(0, -1, 0));
+
+    REQUIRE_FALSE(lattice.isOccupied(voxel));
+    lattice.occupy(voxel, 42);
+    REQUIRE(lattice.isOccupied(voxel));
+    REQUIRE(lattice.ownerOf(voxel) == 42);
+    REQUIRE(lattice.occupiedCount() == 1);
+
+    // Handing an occupied voxel to a new owner does not change the count.
+    lattice.occupy(voxel, 7);
+    REQUIRE(lattice.ownerOf(voxel) == 7);
+    REQUIRE(lattice.occupiedCount() == 1);
+
+    lattice.release(voxel);
+    lattice.release(voxel);
+    REQUIRE_FALSE(lattice.isOccupied(voxel));
+    REQUIRE(lattice.ownerOf(voxel) == LatticeOccupancy::kNoOwner);
+    REQUIRE(lattice.occupiedCount() == 0);
+
+    // One bit per voxel plus owners of the occupied voxels only.
+    LatticeOccupancy large(256);
+    for (uint32_t id = 0; id < 1000; ++id) {
+        large.occupy(id * 4099u, id);
+    }
+    REQUIRE(large.ownerOf(999u * 4099u) == 999);
+    REQUIRE(large.memoryBytes() < large.voxelCount() / 8 + 1000 * 64);
+
+    std::set<std::array<int, 3>> offsets(LatticeOccupancy::kNeighborOffsets.begin(),
+                                         LatticeOccupancy::kNeighborOffsets.end());
+    REQUIRE(offsets.size() == 26);
+    REQUIRE(offsets.count({0, 0, 0}) == 0);
+}
+
+TEST_CASE("SimulationEngine3DLattice keeps one cell per voxel", "[SimulationEngine3DLattice][Lattice]") {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_LATTICE;
+    config->tau_step = 0.25;
+    config->seed = 91;
+    config->initial_population = 27;
+    // Capacity above the 6^3 lattice so the tumor fills it and daughters must push or be dropped.
+    config->env_capacity = 400;
+    config->steps = 40;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempPath("test_sim_3d_lattice").string();
+    config->spatial_domain_size = 12.0f;
+    config->verbosity = 0;
+    utils::validateConfig(*config);
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+
+    SimulationEngine3DLattice engine(config);
+    auto run = engine.run(static_cast<uint32_t>(config->steps));
+
+    CellEvoX::io::PopulationSnapshotFileHeader header{};
+    std::vector<CellEvoX::io::PopulationSnapshotRecord> records;
+    REQUIRE(CellEvoX::io::readPopulationSnapshot(
+        CellEvoX::io::populationSnapshotPath(config->output_path, 10), header, records));
+    REQUIRE(records.size() == run.cells.size());
+    REQUIRE(records.size() > 27);
+    REQUIRE(records.size() <= 216);
+
+    std::set<uint32_t> ids;
+    std::set<std::array<int, 3>> voxels;
+    for (const auto& record : records) {
+        REQUIRE(ids.insert(record.id).second);
+        REQUIRE(run.cells.count(record.id) == 1);
+        for (const float coordinate : {record.x, record.y, record.z}) {
+            REQUIRE(coordinate > 0.0f);
+            REQUIRE(coordinate < config->spatial_domain_size);
+            // Voxel centers sit on odd integers for the unit cell radius.
+            REQUIRE(std::fmod(coordinate, 2.0f) == 1.0f);
+        }
+        REQUIRE(voxels.insert({static_cast<int>(record.x),
+                               static_cast<int>(record.y),
+                               static_cast<int>(record.z)}).second);
+    }
+}
+
+TEST_CASE("DensityField approximates exact neighbor counts", "[DensityField]") {
+    constexpr float kDomain = 40.0f;
+    const auto cloud = makeRandomCloud(20000, kDomain, 123);
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), 0u);
+    SpatialHashGrid grid(2.0f, kDomain);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    for (const float radius : {3.0f, 8.0f}) {
+        CellEvoX::spatial::DensityField field;
+        field.build(grid, radius);
+        REQUIRE(field.halfWidth() >= 1);
+
+        // Away from the walls a uniform cloud should match the exact count on average.
+        double exact_sum = 0.0;
+        double field_sum = 0.0;
+        size_t samples = 0;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            const float x = cloud.px[i];
+            const float y = cloud.py[i];
+            const float z = cloud.pz[i];
+            const float margin = radius + field.voxelSize();
+            if (std::min({x, y, z}) < margin || std::max({x, y, z}) > kDomain - margin) {
+                continue;
+            }
+            exact_sum += CellEvoX::spatial::countNeighborsWithin(grid, x, y, z, radius);
+            field_sum += field.sample(x, y, z);
+            ++samples;
+        }
+        REQUIRE(samples > 100);
+        REQUIRE(field_sum / exact_sum == Catch::Approx(1.0).margin(0.05));
+    }
+
+    // An empty grid yields zero crowding everywhere.
+    SpatialHashGrid empty_grid(2.0f, kDomain);
+    empty_grid.rebuild({}, {}, {}, {});
+    CellEvoX::spatial::DensityField empty_field;
+    empty_field.build(empty_grid, 3.0f);
+    REQUIRE(empty_field.sample(20.0f, 20.0f, 20.0f) == 0.0f);
+}
+
+TEST_CASE("SimulationEngine3D runs with the density field estimator", "[SimulationEngine3D][DensityField]") {
+    auto config = std::make_shared<SimulationConfig>();
+    config->sim_type = SimulationType::SPATIAL_3D_DENSITY;
+    config->tau_step = 0.5;
+    config->seed = 12;
+    config->initial_population = 343;
+    config->env_capacity = 5000;
+    config->steps = 20;
+    config->stat_res = 1;
+    config->popul_res = 1;
+    config->output_path = testTempPath("test_sim_3d_density_field").string();
+    config->spatial_domain_size = 16.0f;
+    config->mech_substeps = 2;
+    config->verbosity = 0;
+    config->density_estimator = DensityEstimatorMode::Field;
+    std::filesystem::remove_all(config->output_path);
+    std::filesystem::create_directories(config->output_path);
+
+    SimulationEngine3D engine(config);
+    auto run = engine.run(static_cast<uint32_t>(config->steps));
+
+    // Crowding must still regulate growth: the population stays far below exponential growth.
+    REQUIRE(run.cells.size() > 0);
+    REQUIRE(run.cells.size() < 5000);
+}
+
+TEST_CASE("NutrientField multigrid solve depletes the tumor core", "[NutrientField]") {
+    SimulationConfig config;
+    config.spatial_domain_size = 64.0f;
+    config.nutrient_diffusion = 10.0f;
+    config.nutrient_consumption = 1.0f;
+    config.nutrient_vcycles = 2;
+
+    // A dense ball of cells in the middle of the domain.
+    std::vector<float> px;
+    std::vector<float> py;
+    std::vector<float> pz;
+    for (float x = 20.0f; x < 44.0f; x += 1.0f) {
+        for (float y = 20.0f; y < 44.0f; y += 1.0f) {
+            for (float z = 20.0f; z < 44.0f; z += 1.0f) {
+                const float dx = x - 32.0f;
+                const float dy = y - 32.0f;
+                const float dz = z - 32.0f;
+                if (dx * dx + dy * dy + dz * dz < 144.0f) {
+                    px.push_back(x);
+                    py.push_back(y);
+                    pz.push_back(z);
+                }
+            }
+        }
+    }
+    std::vector<uint32_t> ids(px.size());
+    std::iota(ids.begin(), ids.end(), 0u);
+    SpatialHashGrid grid(2.0f, config.spatial_domain_size);
+    grid.rebuild(ids, px, py, pz);
+
+    CellEvoX::systems::NutrientField field(grid);
+    REQUIRE(field.dim() == 32);
+    REQUIRE(field.levelCount() > 3);
+
+    // Warm-started V-cycles keep shrinking the residual.
+    field.update(config, grid);
+    const float first_residual = field.lastResidual();
+    for (int step = 0; step < 8; ++step) {
+        field.update(config, grid);
+    }
+    REQUIRE(field.lastResidual() < first_residual);
+    REQUIRE(field.lastResidual() < 1e-4f);
+
+    const float core = field.concentrationAt(32.0f, 32.0f, 32.0f);
+    const float rim = field.concentrationAt(32.0f, 32.0f, 45.0f);
+    const float outside = field.concentrationAt(32.0f, 32.0f, 60.0f);
+    REQUIRE(core >= 0.0f);
+    REQUIRE(core < rim);
+    REQUIRE(rim < outside);
+    REQUIRE(outside <= 1.0f);
+    REQUIRE(core < 0.2f);
+
+    // Without uptake the field relaxes to the wall concentration.
+    config.nutrient_consumption = 0.0f;
+    for (int step = 0; step < 20; ++step) {
+        field.update(config, grid);
+    }
+    REQUIRE(field.concentrationAt(32.0f, 32.0f, 32.0f) == Catch::Approx(1.0f).margin(1e-3));
+}
+
+TEST_CASE("NutrientField interpolates between voxel centres of a shifted grid", "[NutrientField]") {
+    SimulationConfig config;
+    config.nutrient_diffusion = 10.0f;
+    config.nutrient_consumption = 1.0f;
+    config.nutrient_vcycles = 4;
+
+    // The same block of cells, and a copy shifted far from the origin on a grid fitted over it,
+    // so the second field has a non-zero origin.
+    constexpr float kShift = 200.0f;
+    std::vector<float> px;
+    std::vector<float> py;
+    std::vector<float> pz;
+    for (float x = 8.0f; x < 24.0f; x += 1.0f) {
+        for (float y = 8.0f; y < 24.0f; y += 1.0f) {
+            for (float z = 8.0f; z < 24.0f; z += 1.0f) {
+                px.push_back(x);
+                py.push_back(y);
+                pz.push_back(z);
+            }
+        }
+    }
+    std::vector<uint32_t> ids(px.size());
+    std::iota(ids.begin(), ids.end(), 0u);
+    const auto shifted = [&](std::vector<float> values) {
+        for (float& value : values) {
+            value += kShift;
+        }
+        return values;
+    };
+    const auto spx = shifted(px);
+    const auto spy = shifted(py);
+    const auto spz = shifted(pz);
+
+    SpatialHashGrid grid(2.0f, 32.0f);
+    grid.rebuild(ids, px, py, pz);
+    SpatialHashGrid shifted_grid(2.0f, 32.0f);
+    shifted_grid.fitToBounds({kShift, kShift, kShift}, {kShift + 31.0f, kShift + 31.0f, kShift + 31.0f});
+    shifted_grid.rebuild(ids, spx, spy, spz);
+    REQUIRE(shifted_grid.origin() == Catch::Approx(kShift));
+    REQUIRE(shifted_grid.gridDim() == grid.gridDim());
+
+    CellEvoX::systems::NutrientField field(grid);
+    CellEvoX::systems::NutrientField shifted_field(shifted_grid);
+    for (int step = 0; step < 4; ++step) {
+        field.update(config, grid);
+        shifted_field.update(config, shifted_grid);
+    }
+
+    const float h = field.voxelSize();
+    const float centre = 3.5f * h;  // on the edge of the block, where the field has a slope
+    for (const float offset : {0.0f, 0.25f * h, 0.5f * h, 0.9f * h}) {
+        const float value = field.concentrationAt(centre + offset, centre, centre);
+        REQUIRE(shifted_field.concentrationAt(centre + offset + kShift,
+                                              centre + kShift,
+                                              centre + kShift) == Catch::Approx(value));
+    }
+
+    // Between two voxel centres the value moves linearly from one to the other.
+    const float here = field.concentrationAt(centre, centre, centre);
+    const float next = field.concentrationAt(centre + h, centre, centre);
+    REQUIRE(here != Catch::Approx(next));
+    REQUIRE(field.concentrationAt(centre + 0.25f * h, centre, centre) ==
+            Catch::Approx(0.75f * here + 0.25f * next));
+}
+
+TEST_CASE("SimulationEngine3D nutrient coupling slows growth", "[SimulationEngine3D][NutrientField]") {
+    auto make_config = [](const std::string& name, bool nutrients) {
+        auto config = std::make_shared<SimulationConfig>();
+        config->sim_type = SimulationType::SPATIAL_3D_DENSITY;
+        config->tau_step = 0.5;
+        config->seed = 5;
+        config->initial_population = 343;
+        config->env_capacity = 5000;
+        config->steps = 16;
+        config->stat_res = 1;
+        config->popul_res = 1;
+        config->output_path = testTempPath(name).string();
+        config->spatial_domain_size = 24.0f;
+        config->mech_substeps = 2;
+        config->verbosity = 0;
+        config->nutrient_field = nutrients;
+        config->nutrient_consumption = 2.0f;
+        config->nutrient_diffusion = 1.0f;
+        std::filesystem::remove_all(config->output_path);
+        std::filesystem::create_directories(config->output_path);
+        return config;
+    };
+
+    auto reference_config = make_config("test_sim_3d_no_nutrients", false);
+    SimulationEngine3D reference(reference_config);
+    const auto reference_run = reference.run(static_cast<uint32_t>(reference_config->steps));
+
+    auto nutrient_config = make_config("test_sim_3d_nutrients", true);
+    SimulationEngine3D engine(nutrient_config);
+    const auto nutrient_run = engine.run(static_cast<uint32_t>(nutrient_config->steps));
+
+    REQUIRE(nutrient_run.cells.size() > 0);
+    REQUIRE(nutrient_run.cells.size() < reference_run.cells.size());
+}
+
+TEST_CASE("SimulationConfig parses spatial domain growth", "[SimulationConfig][Mechanics]") {
+    nlohmann::json j = {
+        {"simulation_mode", "spatial_3d_capacity"},
+        {"tau_step", 0.05},
+        {"initial_population", 32},
+        {"env_capacity", 1000},
+        {"steps", 10},
+        {"statistics_resolution", 1},
+        {"population_statistics_res", 2},
+        {"output_path", "./output/"},
+        {"spatial_domain_growth", true},
+        {"mutations", nlohmann::json::array()}
+    };
+
+    auto config = utils::fromJson(j);
+    REQUIRE(config.spatial_domain_growth);
+
+    auto invalid = j;
+    invalid["simulation_mode"] = "spatial_3d_density";
+    REQUIRE_THROWS_AS(utils::fromJson(invalid), std::runtime_error);
+}
+
+TEST_CASE("SpatialHashGrid grows with cells outside the initial domain", "[SpatialHashGrid][Mechanics]") {
+    const float voxel_size = 1.0f;
+    auto cloud = makeRandomCloud(2000, 40.0f, 31);
+    for (size_t i = 0; i < cloud.px.size(); ++i) {
+        cloud.px[i] -= 20.0f;
+        cloud.py[i] -= 20.0f;
+        cloud.pz[i] -= 5.0f;
+    }
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{0});
+
+    SpatialHashGrid grid(voxel_size, 4.0f, true);
+    REQUIRE(grid.gridDim() == 4);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+    REQUIRE(grid.origin() <= -20.0f);
+    // One cubic extent covers [-20, 35) on every axis, plus the refit margin.
+    REQUIRE(grid.gridDim() >= 55);
+    REQUIRE(grid.gridDim() <= 70);
+
+    const float radius = 1.5f;
+    for (size_t i = 0; i < ids.size(); i += 7) {
+        std::vector<uint32_t> expected;
+        for (size_t j = 0; j < ids.size(); ++j) {
+            const float dx = cloud.px[i] - cloud.px[j];
+            const float dy = cloud.py[i] - cloud.py[j];
+            const float dz = cloud.pz[i] - cloud.pz[j];
+            if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                expected.push_back(ids[j]);
+            }
+        }
+
+        std::vector<uint32_t> found;
+        grid.queryRadius(cloud.px[i], cloud.py[i], cloud.pz[i], radius, [&](uint32_t id) {
+            const float dx = cloud.px[i] - cloud.px[id];
+            const float dy = cloud.py[i] - cloud.py[id];
+            const float dz = cloud.pz[i] - cloud.pz[id];
+            if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                found.push_back(id);
+            }
+        });
+        std::sort(found.begin(), found.end());
+        REQUIRE(found == expected);
+    }
+
+    // A much smaller cluster shrinks the grid back around it.
+    auto small = makeRandomCloud(100, 5.0f, 37);
+    std::vector<uint32_t> small_ids(small.px.size());
+    std::iota(small_ids.begin(), small_ids.end(), uint32_t{0});
+    grid.rebuild(small_ids, small.px, small.py, small.pz);
+    REQUIRE(grid.gridDim() <= 10);
+    REQUIRE(grid.origin() <= 0.0f);
+    for (size_t i = 0; i < small_ids.size(); ++i) {
+        REQUIRE(grid.voxelOf(small.px[i], small.py[i], small.pz[i]) ==
+                grid.hashVoxel(static_cast<int>(std::floor(small.px[i] - grid.origin())),
+                               static_cast<int>(std::floor(small.py[i] - grid.origin())),
+                               static_cast<int>(std::floor(small.pz[i] - grid.origin()))));
+    }
+}
+
+TEST_CASE("SpatialHashGrid fitted to a slab sizes each axis separately", "[SpatialHashGrid][Mechanics]") {
+    const float voxel_size = 1.0f;
+    auto cloud = makeRandomCloud(3000, 40.0f, 43);
+    for (size_t i = 0; i < cloud.px.size(); ++i) {
+        cloud.px[i] = 10.0f + cloud.px[i] / 10.0f;  // a 4-unit slab across a 40-unit domain
+    }
+    std::vector<uint32_t> ids(cloud.px.size());
+    std::iota(ids.begin(), ids.end(), uint32_t{0});
+
+    SpatialHashGrid grid(voxel_size, 40.0f);
+    grid.fitToBounds({10.0f, 0.0f, 0.0f}, {14.0f, 39.99f, 39.99f});
+    REQUIRE(grid.gridDims() == std::array<int, 3>{5, 40, 40});
+    REQUIRE(grid.origin() == 10.0f);
+    grid.rebuild(ids, cloud.px, cloud.py, cloud.pz);
+
+    const float radius = voxel_size;
+    size_t expected_pairs = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        for (size_t j = i + 1; j < ids.size(); ++j) {
+            const float dx = cloud.px[i] - cloud.px[j];
+            const float dy = cloud.py[i] - cloud.py[j];
+            const float dz = cloud.pz[i] - cloud.pz[j];
+            expected_pairs += static_cast<size_t>(dx * dx + dy * dy + dz * dz <= radius * radius);
+        }
+    }
+    std::atomic<size_t> found_pairs{0};
+    grid.forEachHalfStencilPair([&](uint32_t a, uint32_t b) {
+        const float dx = cloud.px[a] - cloud.px[b];
+        const float dy = cloud.py[a] - cloud.py[b];
+        const float dz = cloud.pz[a] - cloud.pz[b];
+        if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+            found_pairs.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    REQUIRE(found_pairs.load() == expected_pairs);
+
+    for (size_t i = 0; i < ids.size(); i += 11) {
+        size_t expected = 0;
+        for (size_t j = 0; j < ids.size(); ++j) {
+            const float dx = cloud.px[i] - cloud.px[j];
+            const float dy = cloud.py[i] - cloud.py[j];
+            const float dz = cloud.pz[i] - cloud.pz[j];
+            expected += static_cast<size_t>(dx * dx + dy * dy + dz * dz <= radius * radius);
+        }
+        size_t found = 0;
+        grid.queryRadius(cloud.px[i], cloud.py[i], cloud.pz[i], radius, [&](uint32_t id) {
+            const float dx = cloud.px[i] - cloud.px[id];
+            const float dy = cloud.py[i] - cloud.py[id];
+            const float dz = cloud.pz[i] - cloud.pz[id];
+            found += static_cast<size_t>(dx * dx + dy * dy + dz * dz <= radius * radius);
+        });
+        REQUIRE(found == expected);
+    }
+}
+
+TEST_CASE("SimulationEngine3DCapacity grows past the initial domain", "[SimulationEngine3DCapacity][Mechanics]") {
+    auto bounded_config = makeCapacityMechanicsConfig("test_mech_domain_bounded");
+    bounded_config->spatial_domain_size = 4.0f;
+    auto growing_config = makeCapacityMechanicsConfig("test_mech_domain_growing");
+    growing_config->spatial_domain_size = 4.0f;
+    growing_config->spatial_domain_growth = true;
+
+    const auto bounded_records = runCapacityAndReadSnapshot(bounded_config);
+    const auto growing_records = runCapacityAndReadSnapshot(growing_config);
+    REQUIRE_FALSE(growing_records.empty());
+
+    const auto outside = [](const CellEvoX::io::PopulationSnapshotRecord& record) {
+        return std::min({record.x, record.y, record.z}) < 0.0f ||
+               std::max({record.x, record.y, record.z}) > 4.0f;
+    };
+    REQUIRE(std::none_of(bounded_records.begin(), bounded_records.end(), outside));
+    REQUIRE(std::any_of(growing_records.begin(), growing_records.end(), outside));
+}
+
+TEST_CASE("LiveIdIndex tracks live ids and shrinks after deaths", "[LiveIdIndex][Mechanics]") {
+    using CellEvoX::spatial::LiveIdIndex;
+    LiveIdIndex index;
+    REQUIRE(index.find(0) == LiveIdIndex::kNotFound);
+    index.erase(3);
+    REQUIRE(index.size() == 0);
+
+    // Ids are issued in increasing order and die at random, as in the engines.
+    std::mt19937 rng(11);
+    std::map<uint32_t, uint32_t> reference;
+    uint32_t next_id = 0;
+    for (int round = 0; round < 40; ++round) {
+        for (int k = 0; k < 500; ++k) {
+            const uint32_t id = next_id++;
+            index.insert(id, id * 3);
+            reference[id] = id * 3;
+        }
+        for (auto it = reference.begin(); it != reference.end();) {
+            if (std::uniform_int_distribution<int>(0, 2)(rng) == 0) {
+                index.erase(it->first);
+                it = reference.erase(it);
+            } else {
+                index.update(it->first, it->second + 1);
+                ++it->second;
+                ++it;
+            }
+        }
+        REQUIRE(index.size() == reference.size());
+    }
+    for (uint32_t id = 0; id < next_id; ++id) {
+        const auto it = reference.find(id);
+        REQUIRE(index.find(id) == (it == reference.end() ? LiveIdIndex::kNotFound : it->second));
+    }
+
+    // Memory follows the live population, not the largest id ever issued.
+    const size_t peak_capacity = index.capacity();
+    REQUIRE(peak_capacity <= 8 * reference.size());
+    for (auto it = reference.begin(); it != reference.end();) {
+        if (it->first % 64 != 0) {
+            index.erase(it->first);
+            it = reference.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    REQUIRE(index.size() == reference.size());
+    REQUIRE(index.capacity() < peak_capacity / 8);
+    REQUIRE(index.capacity() <= 8 * std::max<size_t>(reference.size(), 2));
+    for (const auto& [id, value] : reference) {
+        REQUIRE(index.find(id) == value);
+    }
+
+    index.assign({9, 4, 100});
+    REQUIRE(index.size() == 3);
+    REQUIRE(index.find(4) == 1);
+    REQUIRE(index.find(100) == 2);
+    REQUIRE(index.find(0) == LiveIdIndex::kNotFound);
+}
@@ -12,6 +12,12 @@ from typing import Optional
 import pandas as pd
 import numpy as np
 
+try:
+    import pyarrow as pa
+    import pyarrow.ipc as pa_ipc
+except ImportError:  # .arrow exports are optional; every table also exists as CSV
+    pa = None
+
 
 class ResultsParser:
     # Directories scanned for run outputs (relative to repo root)
@@ -23,6 +29,14 @@ class ResultsParser:
         self._scripts_dir = repo_root / "CellEvoX" / "scripts"
         self._muller_cache: dict[tuple, dict] = {}
 
+    @staticmethod
+    def _read_table(csv_path: Path) -> pd.DataFrame:
+        """Reads csv_path, or its memory-mapped .arrow twin when the run wrote one (arrow_export)."""
+        arrow_path = csv_path.with_suffix(".arrow")
+        if pa is not None and arrow_path.is_file():
+            return pa_ipc.open_file(pa.memory_map(str(arrow_path), "r")).read_all().to_pandas()
+        return pd.read_csv(csv_path)
+
     # ── Run Discovery ──────────────────────────────────────────────────────────
 
     def _find_run_dirs(self) -> list[Path]:
@@ -104,7 +118,7 @@ class ResultsParser:
         }
         if stats_file:
             try:
-                df = pd.read_csv(stats_file)
+                df = self._read_table(stats_file)
                 last = df.iloc[-1]
                 summary.update({
                     "final_tau": float(self._row_value(last, ["Tau", "tau", "Generation", "generation"], 0)),
@@ -124,7 +138,7 @@ class ResultsParser:
         if not stats_file:
             return None
         try:
-            df = pd.read_csv(stats_file)
+            df = self._read_table(stats_file)
             # Normalize column names to camelCase
             df.columns = [c.strip() for c in df.columns]
             return {
@@ -149,18 +163,39 @@ class ResultsParser:
             files = sorted(search_dir.glob("population_generation_*.csv"))
 
         if not files:
-            return None
+            return self._get_population_from_snapshots(run_dir, generation)
 
         results = {}
         for f in files[:20]:  # cap at 20 for performance
             gen = self._extract_gen(f.name)
             try:
-                df = pd.read_csv(f)
+                df = self._read_table(f)
                 results[gen] = self._jsonable_df(df).to_dict(orient="records")
             except Exception:
                 pass
         return results
 
+    def _get_population_from_snapshots(self, run_dir: Path, generation: Optional[int]) -> Optional[dict]:
+        """Population rows read from binary snapshots through libcellevox_snapshot, for runs
+        without population CSVs. None when the library is not built."""
+        try:
+            import snapshot_native
+        except ImportError:
+            return None
+        if not snapshot_native.available():
+            return None
+        try:
+            with snapshot_native.NativeRun(run_dir) as run:
+                generations = run.generations if generation is None else [generation]
+                results = {}
+                for gen in [g for g in generations if g in run.generations][:20]:
+                    with run.open(gen) as snapshot:
+                        df = snapshot_native.population_dataframe(snapshot)
+                    results[gen] = self._jsonable_df(df).to_dict(orient="records")
+        except OSError:
+            return None
+        return results or None
+
     def get_muller_data(self, run_id: str) -> Optional[dict]:
         """
         Returns Müller plot data as JSON suitable for Plotly.js stacked area chart.